@@ -6,6 +6,8 @@
 #include "envoy/network/address.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Io {
 
@@ -42,9 +44,21 @@ public:
    */
   IoUringSocket& socket() const { return socket_; }
 
+  /**
+   * Returns the flags of the latest completion of the request, e.g. `IORING_CQE_F_MORE` for a
+   * multishot request which stays armed after the completion. Always 0 for injected completions.
+   */
+  uint32_t completionFlags() const { return completion_flags_; }
+
+  /**
+   * Set the flags of the latest completion of the request.
+   */
+  void setCompletionFlags(uint32_t flags) { completion_flags_ = flags; }
+
 private:
   RequestType type_;
   IoUringSocket& socket_;
+  uint32_t completion_flags_{0};
 };
 
 /**
@@ -64,6 +78,27 @@ using InjectedCompletionUserDataReleasor = std::function<void(Request* user_data
 
 enum class IoUringResult { Ok, Busy, Failed };
 
+/**
+ * Optional io_uring features. Every feature is disabled by default, and an enabled feature is only
+ * used if the running kernel supports it.
+ */
+struct IoUringOptions {
+  // The number of buffers in the provided buffer ring used by multishot recv. Zero disables
+  // multishot recv.
+  uint32_t provided_buffers_{0};
+  // Whether listening sockets accept with multishot accept.
+  bool multishot_accept_{false};
+  // The size of the registered file table. Zero disables registered files.
+  uint32_t registered_files_{0};
+  // Writes of at least this many bytes use zero copy send. Zero disables zero copy send.
+  uint32_t zero_copy_send_threshold_{0};
+};
+
+/**
+ * Optional io_uring operations which depend on the kernel version.
+ */
+enum class IoUringFeature { MultishotAccept, ZeroCopySend };
+
 /**
  * Abstract wrapper around `io_uring`.
  */
@@ -101,6 +136,14 @@ public:
   virtual IoUringResult prepareAccept(os_fd_t fd, struct sockaddr* remote_addr,
                                       socklen_t* remote_addr_len, Request* user_data) PURE;
 
+  /**
+   * Prepares a multishot accept operation and puts it into the submission queue. The operation
+   * posts a completion for every accepted connection until it is canceled or fails.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareAcceptMultishot(os_fd_t fd, Request* user_data) PURE;
+
   /**
    * Prepares a connect system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -118,6 +161,16 @@ public:
   virtual IoUringResult prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                      off_t offset, Request* user_data) PURE;
 
+  /**
+   * Prepares a multishot recv operation which picks its buffers from the provided buffer ring set
+   * up by setupProvidedBuffers(), and puts it into the submission queue. The operation posts a
+   * completion for every received chunk of data until it is canceled, fails, or runs out of
+   * provided buffers.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareRecvMultishot(os_fd_t fd, Request* user_data) PURE;
+
   /**
    * Prepares a writev system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -126,6 +179,16 @@ public:
   virtual IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                       off_t offset, Request* user_data) PURE;
 
+  /**
+   * Prepares a zero copy sendmsg operation and puts it into the submission queue. The buffers
+   * referenced by the message must not be modified until the notification completion, i.e. the
+   * one without `IORING_CQE_F_MORE`, has been received.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareSendmsgZc(os_fd_t fd, const struct msghdr* msg,
+                                         Request* user_data) PURE;
+
   /**
    * Prepares a close system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -175,6 +238,52 @@ public:
    * @param fd is used to refer to the completions will be removed.
    */
   virtual void removeInjectedCompletion(os_fd_t fd) PURE;
+
+  /**
+   * Returns true if the running kernel supports the given feature.
+   */
+  virtual bool isFeatureSupported(IoUringFeature feature) const PURE;
+
+  /**
+   * Sets up a ring of provided buffers for multishot recv.
+   * @param buffer_count the number of buffers, rounded up to a power of two.
+   * @param buffer_size the size of each buffer.
+   * @return false if the kernel does not support multishot recv with provided buffers.
+   */
+  virtual bool setupProvidedBuffers(uint32_t buffer_count, uint32_t buffer_size) PURE;
+
+  /**
+   * Returns the data a completion placed into a provided buffer. The buffer must be handed back
+   * with recycleProvidedBuffer() once the data has been consumed.
+   * @param completion_flags the flags of the completion, which carry the buffer id.
+   * @param length the result of the completion.
+   */
+  virtual absl::string_view providedBuffer(uint32_t completion_flags, uint32_t length) PURE;
+
+  /**
+   * Returns a provided buffer to the ring.
+   * @param completion_flags the flags of the completion the buffer was used by.
+   */
+  virtual void recycleProvidedBuffer(uint32_t completion_flags) PURE;
+
+  /**
+   * Sets up a sparse registered file table.
+   * @param size the number of slots of the table.
+   * @return false if the table cannot be registered.
+   */
+  virtual bool setupRegisteredFiles(uint32_t size) PURE;
+
+  /**
+   * Registers a file descriptor into a free slot of the registered file table. Later operations
+   * on the file descriptor use the slot instead.
+   * @return false if the table is full or the file descriptor cannot be registered.
+   */
+  virtual bool registerFile(os_fd_t fd) PURE;
+
+  /**
+   * Removes a file descriptor from the registered file table, if it has been registered.
+   */
+  virtual void unregisterFile(os_fd_t fd) PURE;
 };
 
 using IoUringPtr = std::unique_ptr<IoUring>;
@@ -376,6 +485,12 @@ public:
    * @param cb the callback function.
    */
   virtual void setFileReadyCb(Event::FileReadyCb cb) PURE;
+
+  /**
+   * Take the next connection accepted by the multishot accept request of a listening socket.
+   * @return the file descriptor of the accepted connection, or INVALID_SOCKET if there is none.
+   */
+  virtual os_fd_t takeAcceptedFd() PURE;
 };
 
 using IoUringSocketPtr = std::unique_ptr<IoUringSocket>;
@@ -405,6 +520,13 @@ public:
   virtual IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb,
                                          bool enable_close_event) PURE;
 
+  /**
+   * Add a listening socket to the worker, which accepts with a multishot accept request.
+   * @return absl::nullopt if multishot accept is disabled or not supported by the kernel, in
+   * which case the caller should accept through the event loop.
+   */
+  virtual OptRef<IoUringSocket> addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb) PURE;
+
   /**
    * Return the current thread's dispatcher.
    */
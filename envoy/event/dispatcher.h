@@ -58,6 +58,19 @@ using PostCb = absl::AnyInvocable<void()>;
 
 using PostCbSharedPtr = std::shared_ptr<PostCb>;
 
+/**
+ * Callback for work deferred with Dispatcher::deferFlush().
+ */
+class DeferredFlushCallback {
+public:
+  virtual ~DeferredFlushCallback() = default;
+
+  /**
+   * Called once all other work queued in the current event loop iteration has run.
+   */
+  virtual void onDeferredFlush() PURE;
+};
+
 /**
  * Minimal interface to the dispatching loop used to create low-level primitives. See Dispatcher
  * below for the full interface.
@@ -233,6 +246,23 @@ public:
    */
   virtual void deferredDelete(DeferredDeletablePtr&& to_delete) PURE;
 
+  /**
+   * Defers a flush until the end of the current event loop iteration, so that all the flushes
+   * requested while processing the iteration's events run together in a single pass after the
+   * events that produced them. Each callback is invoked at most once per request. Dispatchers that
+   * do not batch flushes return false, in which case the caller must schedule the flush itself.
+   * @param callback supplies the callback to invoke. It must remain valid until it is invoked or
+   *        cancelDeferredFlush() is called.
+   * @return whether the flush was deferred.
+   */
+  virtual bool deferFlush(DeferredFlushCallback& callback) PURE;
+
+  /**
+   * Cancels a flush previously deferred with deferFlush(). Does nothing if no flush is pending
+   * for the callback.
+   */
+  virtual void cancelDeferredFlush(DeferredFlushCallback& callback) PURE;
+
   /**
    * Exits the event loop.
    */
@@ -22,6 +22,9 @@
 
 #include "source/common/common/interval_value.h"
 
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
 namespace Envoy {
 namespace Network {
 
@@ -362,6 +365,18 @@ struct UdpRecvData {
   Buffer::OwnedImpl saved_cmsg_;
 };
 
+/**
+ * A datagram read from a udp socket into memory owned by the reader, which is only valid for the
+ * duration of the callback it is passed to.
+ */
+struct UdpRecvPacket {
+  UdpRecvData::LocalPeerAddresses addresses_;
+  absl::string_view payload_;
+  MonotonicTime receive_time_;
+  uint8_t tos_ = 0;
+  absl::string_view saved_cmsg_;
+};
+
 /**
  * Encapsulates the information needed to send a udp packet to a target
  */
@@ -391,6 +406,20 @@ public:
    */
   virtual void onData(UdpRecvData&& data) PURE;
 
+  /**
+   * Called instead of onData() with the datagrams received by a single read of the underlying udp
+   * socket, if supportsPacketBatches() returns true.
+   *
+   * @param packets the datagrams read, whose memory is reused once this returns.
+   */
+  virtual void onDataBatch(absl::Span<const UdpRecvPacket> packets) PURE;
+
+  /**
+   * @return whether datagrams may be delivered through onDataBatch(), which lets the listener read
+   * them into a reusable arena rather than into a buffer per datagram.
+   */
+  virtual bool supportsPacketBatches() const PURE;
+
   /**
    * Called whenever datagrams are dropped due to overflow or truncation.
    * @param dropped supplies the number of dropped datagrams.
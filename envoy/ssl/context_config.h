@@ -6,7 +6,9 @@
 #include <string>
 #include <vector>
 
+#include "envoy/common/optref.h"
 #include "envoy/common/pure.h"
+#include "envoy/extensions/transport_sockets/tls/v3/tls.pb.h"
 #include "envoy/ssl/certificate_validation_context_config.h"
 #include "envoy/ssl/handshaker.h"
 #include "envoy/ssl/tls_certificate_config.h"
@@ -113,6 +115,12 @@ public:
    */
   virtual const std::string& tlsKeyLogPath() const PURE;
 
+  /**
+   * @return true if the record layer of established connections should be offloaded to the
+   * kernel.
+   */
+  virtual bool kernelTlsOffload() const PURE;
+
   /**
    * @return the access log manager object reference
    */
@@ -150,6 +158,13 @@ public:
    */
   virtual size_t maxSessionKeys() const PURE;
 
+  /**
+   * @return the configuration of the cache storing session keys separately for each upstream host,
+   * if configured. Otherwise, session keys are shared by all upstream hosts.
+   */
+  virtual OptRef<const envoy::extensions::transport_sockets::tls::v3::UpstreamTlsSessionCache>
+  sessionCacheConfig() const PURE;
+
   /**
    * @return true if the enforcement that handshake will fail if the keyUsage extension is present
    * and incompatible with the TLS usage is enabled.
@@ -43,6 +43,27 @@ public:
    */
   virtual const std::vector<std::reference_wrapper<const TextReadout>>& textReadouts() PURE;
 
+  /**
+   * @return the subset of counters() with a non-zero delta since the previous flush.
+   */
+  virtual const std::vector<CounterSnapshot>& changedCounters() PURE;
+
+  /**
+   * @return the subset of gauges() which were updated since the previous flush.
+   */
+  virtual const std::vector<std::reference_wrapper<const Gauge>>& changedGauges() PURE;
+
+  /**
+   * @return the subset of histograms() which recorded samples since the previous flush.
+   */
+  virtual const std::vector<std::reference_wrapper<const ParentHistogram>>&
+  changedHistograms() PURE;
+
+  /**
+   * @return the subset of textReadouts() which were set since the previous flush.
+   */
+  virtual const std::vector<std::reference_wrapper<const TextReadout>>& changedTextReadouts() PURE;
+
   /**
    * @return a snapshot of all host/endpoint-specific primitive counters.
    */
@@ -102,12 +102,14 @@ public:
    * Flags:
    * Used: used by all stats types to figure out whether they have been used.
    * Logic...: used by gauges to cache how they should be combined with a parent's value.
+   * Changed: used by gauges and text readouts to track updates since the last sink flush.
    */
   struct Flags {
     static constexpr uint8_t Used = 0x01;
     static constexpr uint8_t LogicAccumulate = 0x02;
     static constexpr uint8_t NeverImport = 0x04;
     static constexpr uint8_t Hidden = 0x08;
+    static constexpr uint8_t Changed = 0x10;
   };
   virtual SymbolTable& symbolTable() PURE;
   virtual const SymbolTable& constSymbolTable() const PURE;
@@ -162,6 +164,13 @@ public:
   }
   virtual uint64_t value() const PURE;
 
+  /**
+   * Clears the changed state of the gauge. Analogous to Counter::latch(), this is called once per
+   * stats flush so that sinks can skip gauges which have not been updated since the previous one.
+   * @return true if the gauge was updated since the last call.
+   */
+  virtual bool latchChanged() PURE;
+
   /**
    * Sets a value from a hot-restart parent. This parent contribution must be
    * kept distinct from the child value, so that when we erase the value it
@@ -213,6 +222,11 @@ public:
    * @return the copy of this TextReadout value.
    */
   virtual std::string value() const PURE;
+  /**
+   * Clears the changed state of the TextReadout. See Gauge::latchChanged().
+   * @return true if the TextReadout was set since the last call.
+   */
+  virtual bool latchChanged() PURE;
 };
 
 using TextReadoutSharedPtr = RefcountPtr<TextReadout>;
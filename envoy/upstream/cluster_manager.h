@@ -274,12 +274,32 @@ public:
    *                       update. It can be overridden by setting `remove_ignored` to true while
    *                       calling removeCluster(). This is useful for clusters whose lifecycle
    *                       is managed with custom implementation, e.g., DFP clusters.
+   * @param cluster_hash supplies the hash of the cluster configuration, if the caller already
+   *                     computed it with MessageUtil::hash(). Otherwise it is computed here.
    * @return true if the action results in an add/update of a cluster, an error
    * status if the config is invalid.
    */
   virtual absl::StatusOr<bool>
   addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
-                     const std::string& version_info, const bool avoid_cds_removal = false) PURE;
+                     const std::string& version_info, const bool avoid_cds_removal = false,
+                     absl::optional<uint64_t> cluster_hash = absl::nullopt) PURE;
+
+  /**
+   * Add or update a cluster received via CDS. This behaves like addOrUpdateCluster(), except that
+   * when ClusterManager.enable_lazy_cds_clusters is set, a cluster that is not loaded yet only has
+   * its configuration recorded. It is loaded when it is first requested through
+   * requestOnDemandClusterDiscovery().
+   *
+   * @param cluster supplies the cluster configuration.
+   * @param version_info supplies the xDS version of the cluster.
+   * @param cluster_hash supplies the hash of the cluster configuration, as computed by
+   *                     MessageUtil::hash().
+   * @return true if the action results in an add/update of a cluster or of its recorded
+   * configuration, an error status if the config is invalid.
+   */
+  virtual absl::StatusOr<bool>
+  addOrUpdateCdsCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                        const std::string& version_info, uint64_t cluster_hash) PURE;
 
   /**
    * Set a callback that will be invoked when all primary clusters have been initialized.
@@ -300,10 +320,31 @@ public:
   initializeSecondaryClusters(const envoy::config::bootstrap::v3::Bootstrap& bootstrap) PURE;
 
   using ClusterInfoMap = absl::flat_hash_map<std::string, std::reference_wrapper<const Cluster>>;
+
+  /**
+   * The clusters received via CDS that are not loaded until first requested. See
+   * addOrUpdateCdsCluster().
+   */
+  class LazyClusters {
+  public:
+    virtual ~LazyClusters() = default;
+
+    /**
+     * @return whether the cluster is a lazy cluster.
+     */
+    virtual bool contains(absl::string_view cluster) const PURE;
+
+    /**
+     * Calls the callback with the name of every lazy cluster.
+     */
+    virtual void iterate(const std::function<void(const std::string&)>& cb) const PURE;
+  };
+
   struct ClusterInfoMaps {
     bool hasCluster(absl::string_view cluster) const {
       return active_clusters_.find(cluster) != active_clusters_.end() ||
-             warming_clusters_.find(cluster) != warming_clusters_.end();
+             warming_clusters_.find(cluster) != warming_clusters_.end() ||
+             (lazy_clusters_.has_value() && lazy_clusters_->contains(cluster));
     }
 
     ClusterConstOptRef getCluster(absl::string_view cluster) const {
@@ -324,6 +365,10 @@ public:
     // Number of clusters that were dynamically added via API (xDS). This will be
     // less than or equal to the number of `active_clusters_` and `warming_clusters_`.
     uint32_t added_via_api_clusters_num_{0};
+
+    // The lazy clusters are looked up in the cluster manager rather than copied, since there may
+    // be many more of them than loaded clusters.
+    OptRef<const LazyClusters> lazy_clusters_;
   };
 
   /**
@@ -107,6 +107,27 @@ public:
   virtual absl::Status onOrcaLoadReport(const OrcaLoadReport& /*report*/) {
     return absl::OkStatus();
   }
+
+  /**
+   * Invoked when a response from this upstream host completes, to update the host lb policy
+   * data with the response time of the request.
+   * NOTE: this method may be called concurrently from multiple threads.
+   * Please ensure that the implementation is thread-safe.
+   *
+   * @param response_time supplies the time from the completion of the downstream request to the
+   *        completion of the upstream response.
+   */
+  virtual void onResponseTime(std::chrono::microseconds /*response_time*/) {}
+
+  /**
+   * Invoked when a request to this upstream host times out or is reset before its response
+   * completes, or when its response is retried.
+   * NOTE: this method may be called concurrently from multiple threads.
+   * Please ensure that the implementation is thread-safe.
+   *
+   * @param elapsed supplies the time from the start of the upstream request to the failure.
+   */
+  virtual void onRequestFailure(std::chrono::microseconds /*elapsed*/) {}
 };
 
 using HostLbPolicyDataPtr = std::unique_ptr<HostLbPolicyData>;
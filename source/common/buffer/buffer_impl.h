@@ -9,6 +9,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/http/stream_reset_handler.h"
 
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/non_copyable.h"
 #include "source/common/common/utility.h"
@@ -37,7 +38,7 @@ namespace Buffer {
 class Slice {
 public:
   using Reservation = RawSlice;
-  using StoragePtr = std::unique_ptr<uint8_t[]>;
+  using StoragePtr = std::unique_ptr<uint8_t[], SliceStorageDeleter>;
 
   struct SizedStorage {
     StoragePtr mem_{};
@@ -57,7 +58,7 @@ public:
    * @param account the account to charge.
    */
   Slice(uint64_t min_capacity, const BufferMemoryAccountSharedPtr& account)
-      : capacity_(sliceSize(min_capacity)), storage_(new uint8_t[capacity_]),
+      : capacity_(sliceSize(min_capacity)), storage_(allocateStorage(capacity_)),
         base_(storage_.get()) {
     if (account) {
       account->charge(capacity_);
@@ -343,6 +344,8 @@ public:
   }
 
   static constexpr uint32_t default_slice_size_ = 16384;
+  static_assert(SlicePool::BlockSize == default_slice_size_,
+                "slice pool blocks must match the default slice size");
 
 public:
   /**
@@ -365,7 +368,23 @@ public:
    */
   static inline SizedStorage newStorage(uint64_t min_capacity) {
     const uint64_t slice_size = sliceSize(min_capacity);
-    return {StoragePtr{new uint8_t[slice_size]}, static_cast<size_t>(slice_size)};
+    return {allocateStorage(slice_size), static_cast<size_t>(slice_size)};
+  }
+
+  /**
+   * Allocate backend storage of exactly `size` bytes. Storage of the default slice size is taken
+   * from the calling thread's SlicePool when pooling is enabled.
+   * @param size the size of the storage, in bytes.
+   * @return the storage.
+   */
+  static inline StoragePtr allocateStorage(uint64_t size) {
+    if (size == default_slice_size_) {
+      SlicePool* pool = SlicePool::threadLocalPool();
+      if (pool != nullptr) {
+        return StoragePtr(pool->allocate(), SliceStorageDeleter{pool});
+      }
+    }
+    return StoragePtr(new uint8_t[size]);
   }
 
 protected:
@@ -785,7 +804,7 @@ private:
         storage.mem_ = std::move(free_list_ref_.back());
         free_list_ref_.pop_back();
       } else {
-        storage.mem_.reset(new uint8_t[Slice::default_slice_size_]);
+        storage.mem_ = Slice::allocateStorage(Slice::default_slice_size_);
       }
 
       return storage;
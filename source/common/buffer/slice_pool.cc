@@ -0,0 +1,184 @@
+#include "source/common/buffer/slice_pool.h"
+
+#include <memory>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/macros.h"
+
+namespace Envoy {
+namespace Buffer {
+
+std::atomic<uint32_t> SlicePool::max_free_blocks_per_thread_{0};
+
+/**
+ * Owns every pool ever created in the process. Pools are never destroyed so that a block can
+ * always be released to the pool it came from, even after the owning thread has exited.
+ */
+class SlicePoolRegistry {
+public:
+  static SlicePoolRegistry& get() { MUTABLE_CONSTRUCT_ON_FIRST_USE(SlicePoolRegistry); }
+
+  SlicePool* acquire() {
+    Thread::LockGuard guard(lock_);
+    if (!orphaned_pools_.empty()) {
+      SlicePool* pool = orphaned_pools_.back();
+      orphaned_pools_.pop_back();
+      pool->adopt();
+      return pool;
+    }
+    pools_.emplace_back(new SlicePool());
+    return pools_.back().get();
+  }
+
+  void park(SlicePool* pool) {
+    Thread::LockGuard guard(lock_);
+    orphaned_pools_.push_back(pool);
+  }
+
+  SlicePoolStats stats() {
+    SlicePoolStats stats;
+    Thread::LockGuard guard(lock_);
+    for (const auto& pool : pools_) {
+      stats.hits_ += pool->hits_.load(std::memory_order_relaxed);
+      stats.misses_ += pool->misses_.load(std::memory_order_relaxed);
+      stats.resident_bytes_ += pool->resident_bytes_.load(std::memory_order_relaxed);
+    }
+    return stats;
+  }
+
+private:
+  Thread::MutexBasicLockable lock_;
+  std::vector<std::unique_ptr<SlicePool>> pools_ ABSL_GUARDED_BY(lock_);
+  std::vector<SlicePool*> orphaned_pools_ ABSL_GUARDED_BY(lock_);
+};
+
+namespace {
+
+// Plain pointer so that it remains safe to read while other thread_local objects are destroyed.
+thread_local SlicePool* tls_pool = nullptr;
+thread_local bool tls_exiting = false;
+
+} // namespace
+
+/**
+ * Orphans the calling thread's pool when the thread exits.
+ */
+class ThreadLocalSlicePoolHolder {
+public:
+  ~ThreadLocalSlicePoolHolder() {
+    tls_exiting = true;
+    if (tls_pool != nullptr) {
+      SlicePool* pool = tls_pool;
+      tls_pool = nullptr;
+      pool->orphan();
+      SlicePoolRegistry::get().park(pool);
+    }
+  }
+
+  void touch() {}
+};
+
+namespace {
+thread_local ThreadLocalSlicePoolHolder tls_holder;
+} // namespace
+
+SlicePool* SlicePool::threadLocalPool() {
+  if (maxFreeBlocksPerThread() == 0) {
+    return nullptr;
+  }
+  if (tls_pool == nullptr) {
+    if (tls_exiting) {
+      return nullptr;
+    }
+    // Make sure the holder is constructed so that its destructor runs on thread exit.
+    tls_holder.touch();
+    tls_pool = SlicePoolRegistry::get().acquire();
+  }
+  return tls_pool;
+}
+
+void SlicePool::setMaxFreeBlocksPerThread(uint32_t max_free_blocks) {
+  max_free_blocks_per_thread_.store(max_free_blocks, std::memory_order_relaxed);
+}
+
+SlicePoolStats SlicePool::stats() { return SlicePoolRegistry::get().stats(); }
+
+bool SlicePool::ownedByCallingThread() const { return tls_pool == this; }
+
+uint8_t* SlicePool::allocate() {
+  ASSERT(ownedByCallingThread());
+  if (free_blocks_.empty() && has_returned_blocks_.load(std::memory_order_acquire)) {
+    reclaimReturnedBlocks();
+  }
+  if (!free_blocks_.empty()) {
+    uint8_t* mem = free_blocks_.back();
+    free_blocks_.pop_back();
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    resident_bytes_.fetch_sub(BlockSize, std::memory_order_relaxed);
+    return mem;
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return new uint8_t[BlockSize];
+}
+
+void SlicePool::release(uint8_t* mem) {
+  const uint32_t max_free_blocks = maxFreeBlocksPerThread();
+  if (ownedByCallingThread()) {
+    if (free_blocks_.size() < max_free_blocks) {
+      free_blocks_.push_back(mem);
+      resident_bytes_.fetch_add(BlockSize, std::memory_order_relaxed);
+    } else {
+      delete[] mem;
+    }
+    return;
+  }
+
+  {
+    Thread::LockGuard guard(return_lock_);
+    if (!orphaned_ && returned_blocks_.size() < max_free_blocks) {
+      returned_blocks_.push_back(mem);
+      resident_bytes_.fetch_add(BlockSize, std::memory_order_relaxed);
+      has_returned_blocks_.store(true, std::memory_order_release);
+      return;
+    }
+  }
+  delete[] mem;
+}
+
+void SlicePool::reclaimReturnedBlocks() {
+  std::vector<uint8_t*> returned_blocks;
+  {
+    Thread::LockGuard guard(return_lock_);
+    returned_blocks.swap(returned_blocks_);
+    has_returned_blocks_.store(false, std::memory_order_relaxed);
+  }
+  // The free list is empty whenever this is called, so all returned blocks fit within the limit
+  // that was enforced when they were queued.
+  free_blocks_.insert(free_blocks_.end(), returned_blocks.begin(), returned_blocks.end());
+}
+
+void SlicePool::orphan() {
+  for (uint8_t* mem : free_blocks_) {
+    delete[] mem;
+  }
+  free_blocks_.clear();
+  free_blocks_.shrink_to_fit();
+
+  Thread::LockGuard guard(return_lock_);
+  for (uint8_t* mem : returned_blocks_) {
+    delete[] mem;
+  }
+  returned_blocks_.clear();
+  has_returned_blocks_.store(false, std::memory_order_relaxed);
+  resident_bytes_.store(0, std::memory_order_relaxed);
+  orphaned_ = true;
+}
+
+void SlicePool::adopt() {
+  Thread::LockGuard guard(return_lock_);
+  orphaned_ = false;
+}
+
+} // namespace Buffer
+} // namespace Envoy
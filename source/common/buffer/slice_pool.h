@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "source/common/common/non_copyable.h"
+#include "source/common/common/thread.h"
+#include "source/common/common/thread_annotations.h"
+
+namespace Envoy {
+namespace Buffer {
+
+class SlicePool;
+
+/**
+ * Deleter for the storage backing a Slice. Storage obtained from a SlicePool is handed back to
+ * that pool; any other storage is returned to the heap.
+ */
+struct SliceStorageDeleter {
+  inline void operator()(uint8_t* mem) const;
+
+  SlicePool* pool_{nullptr};
+};
+
+/**
+ * Totals across all slice pools in the process.
+ */
+struct SlicePoolStats {
+  // Number of blocks served from a free list.
+  uint64_t hits_{};
+  // Number of blocks that had to be allocated from the heap.
+  uint64_t misses_{};
+  // Bytes currently held in free lists and return queues, i.e. not backing any slice.
+  uint64_t resident_bytes_{};
+};
+
+/**
+ * A per-thread pool of fixed size blocks used as slice storage. Each thread (in practice each
+ * worker) allocates blocks from its own free list without taking any lock. A block released on
+ * the thread that owns its pool goes straight back onto the free list; a block released on any
+ * other thread (e.g. a buffer moved across workers) is pushed onto the owning pool's locked
+ * return queue, which the owner drains the next time its free list runs dry.
+ *
+ * Pooling is disabled, and threadLocalPool() returns nullptr, until setMaxFreeBlocksPerThread()
+ * has been called with a non-zero value. Pools outlive the threads that own them: when a thread
+ * exits, its cached blocks are freed and the pool is parked for reuse by the next thread that asks
+ * for one, so blocks still in flight on other threads always have a valid pool to return to.
+ */
+class SlicePool : NonCopyable {
+public:
+  static constexpr uint64_t BlockSize = 16384;
+
+  /**
+   * @return the pool owned by the calling thread, or nullptr if pooling is disabled.
+   */
+  static SlicePool* threadLocalPool();
+
+  /**
+   * Sets the maximum number of free blocks each thread retains. Zero disables pooling; blocks
+   * released afterwards are freed to the heap.
+   */
+  static void setMaxFreeBlocksPerThread(uint32_t max_free_blocks);
+  static uint32_t maxFreeBlocksPerThread() {
+    return max_free_blocks_per_thread_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @return the sum of the stats of every pool in the process.
+   */
+  static SlicePoolStats stats();
+
+  /**
+   * Allocate a block of BlockSize bytes. Must be called on the thread that owns this pool.
+   */
+  uint8_t* allocate();
+
+  /**
+   * Return a block previously obtained from allocate(). May be called from any thread.
+   */
+  void release(uint8_t* mem);
+
+private:
+  SlicePool() = default;
+
+  bool ownedByCallingThread() const;
+  void reclaimReturnedBlocks();
+  // Called on the owning thread when it exits. Frees all cached blocks.
+  void orphan();
+  // Called when a new thread takes ownership of a previously orphaned pool.
+  void adopt();
+
+  static std::atomic<uint32_t> max_free_blocks_per_thread_;
+
+  // Only accessed by the owning thread.
+  std::vector<uint8_t*> free_blocks_;
+
+  Thread::MutexBasicLockable return_lock_;
+  std::vector<uint8_t*> returned_blocks_ ABSL_GUARDED_BY(return_lock_);
+  bool orphaned_ ABSL_GUARDED_BY(return_lock_){};
+  // Lets the owning thread skip the lock when nothing has been returned.
+  std::atomic<bool> has_returned_blocks_{};
+
+  std::atomic<uint64_t> hits_{};
+  std::atomic<uint64_t> misses_{};
+  std::atomic<uint64_t> resident_bytes_{};
+
+  friend class SlicePoolRegistry;
+  friend class ThreadLocalSlicePoolHolder;
+};
+
+void SliceStorageDeleter::operator()(uint8_t* mem) const {
+  if (pool_ != nullptr) {
+    pool_->release(mem);
+  } else {
+    delete[] mem;
+  }
+}
+
+} // namespace Buffer
+} // namespace Envoy
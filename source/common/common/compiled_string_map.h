@@ -163,7 +163,7 @@ private:
     const size_t key_length = node_contents[0].first.size();
     for (size_t i = 0; i < key_length; i++) {
       std::array<bool, 256> hits{};
-      IndexSplitInfo info{static_cast<uint8_t>(i), 255, 0, 0};
+      IndexSplitInfo info{i, 255, 0, 0};
       for (const KV& pair : node_contents) {
         uint8_t v = pair.first[i];
         if (!hits[v]) {
@@ -167,6 +167,28 @@ public:
     return nodes_[result].value_;
   }
 
+  /**
+   * Visits every entry whose key is a prefix of the specified key, from the shortest key to the
+   * longest. Complexity is O(min(longest key prefix, key length)).
+   * @param key the key used to find.
+   * @param visitor called with the value of each entry found. Returning false stops the search.
+   */
+  template <class Visitor> void visitPrefixes(absl::string_view key, Visitor visitor) const {
+    int32_t current = 0;
+    if (nodes_[current].value_ && !visitor(nodes_[current].value_)) {
+      return;
+    }
+    for (uint8_t c : key) {
+      current = getChildIndex(current, c);
+      if (current == NoNode) {
+        return;
+      }
+      if (nodes_[current].value_ && !visitor(nodes_[current].value_)) {
+        return;
+      }
+    }
+  }
+
 private:
   // Flat representation of the tree - each node has a vector of indices to its
   // child nodes.
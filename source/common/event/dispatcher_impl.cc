@@ -1,5 +1,6 @@
 #include "source/common/event/dispatcher_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -75,6 +76,10 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Thread::ThreadFactory& t
       deferred_delete_cb_(base_scheduler_.createSchedulableCallback(
           [this]() -> void { clearDeferredDeleteList(); })),
       post_cb_(base_scheduler_.createSchedulableCallback([this]() -> void { runPostCallbacks(); })),
+      batch_flushes_(
+          Runtime::runtimeFeatureEnabled("envoy.restart_features.dispatcher_batch_flushes")),
+      deferred_flush_cb_(base_scheduler_.createSchedulableCallback(
+          [this]() -> void { runDeferredFlushes(); })),
       current_to_delete_(&to_delete_1_), scaled_timer_manager_(scaled_timer_factory(*this)) {
   ASSERT(!name_.empty());
   FatalErrorHandler::registerFatalErrorHandler(*this);
@@ -244,6 +249,56 @@ SignalEventPtr DispatcherImpl::listenForSignal(signal_t signal_num, SignalCb cb)
   return SignalEventPtr{new SignalEventImpl(*this, signal_num, cb)};
 }
 
+bool DispatcherImpl::deferFlush(DeferredFlushCallback& callback) {
+  ASSERT(isThreadSafe());
+  if (!batch_flushes_) {
+    return false;
+  }
+  pending_flushes_.push_back(&callback);
+  deferred_flush_cb_->scheduleCallbackCurrentIteration();
+  return true;
+}
+
+void DispatcherImpl::cancelDeferredFlush(DeferredFlushCallback& callback) {
+  ASSERT(isThreadSafe());
+  // Both lists only hold the callbacks flushed in a single loop iteration, so a linear scan is
+  // cheap. Cancellation is only expected when a connection closes with a flush pending.
+  for (auto* pending : {&pending_flushes_, &flushing_}) {
+    auto it = std::find(pending->begin(), pending->end(), &callback);
+    if (it != pending->end()) {
+      *it = nullptr;
+    }
+  }
+}
+
+void DispatcherImpl::runDeferredFlushes() {
+  // Let everything else that is already queued in this iteration run first, so that the flush
+  // picks up all the data those callbacks produce. The number of deferrals is bounded so that a
+  // dispatcher that always has active work still flushes every iteration.
+  static constexpr uint32_t MaxFlushDeferrals = 4;
+  if (flush_deferrals_ < MaxFlushDeferrals &&
+      event_base_get_num_events(&base_scheduler_.base(), EVENT_BASE_COUNT_ACTIVE) > 0) {
+    ++flush_deferrals_;
+    deferred_flush_cb_->scheduleCallbackCurrentIteration();
+    return;
+  }
+  flush_deferrals_ = 0;
+
+  ASSERT(flushing_.empty());
+  flushing_.swap(pending_flushes_);
+  touchWatchdog();
+  // Callbacks may defer new flushes while running; those go to pending_flushes_ and re-arm
+  // deferred_flush_cb_.
+  for (size_t i = 0; i < flushing_.size(); i++) {
+    DeferredFlushCallback* callback = flushing_[i];
+    if (callback != nullptr) {
+      flushing_[i] = nullptr;
+      callback->onDeferredFlush();
+    }
+  }
+  flushing_.clear();
+}
+
 void DispatcherImpl::post(PostCb callback) {
   bool do_post;
   {
@@ -82,6 +82,8 @@ public:
   Event::SchedulableCallbackPtr createSchedulableCallback(std::function<void()> cb) override;
   void deferredDelete(DeferredDeletablePtr&& to_delete) override;
   void exit() override;
+  bool deferFlush(DeferredFlushCallback& callback) override;
+  void cancelDeferredFlush(DeferredFlushCallback& callback) override;
   SignalEventPtr listenForSignal(signal_t signal_num, SignalCb cb) override;
   void post(PostCb callback) override;
   void deleteInDispatcherThread(DispatcherThreadDeletableConstPtr deletable) override;
@@ -129,6 +131,7 @@ private:
   void updateApproximateMonotonicTimeInternal();
   void runPostCallbacks();
   void runThreadLocalDelete();
+  void runDeferredFlushes();
 
   // Helper used to touch the watchdog after most schedulable, fd, and timer callbacks.
   void touchWatchdog();
@@ -164,6 +167,16 @@ private:
   Thread::MutexBasicLockable post_lock_;
   std::list<PostCb> post_callbacks_ ABSL_GUARDED_BY(post_lock_);
 
+  // Set when envoy.restart_features.dispatcher_batch_flushes is enabled. Flushes requested via
+  // deferFlush() are collected in pending_flushes_ and run together by deferred_flush_cb_.
+  const bool batch_flushes_;
+  SchedulableCallbackPtr deferred_flush_cb_;
+  std::vector<DeferredFlushCallback*> pending_flushes_;
+  // The batch currently being flushed. Entries cancelled mid-flush are set to nullptr.
+  std::vector<DeferredFlushCallback*> flushing_;
+  // Number of times the current batch has been pushed to the back of the work queue.
+  uint32_t flush_deferrals_{};
+
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
@@ -0,0 +1,154 @@
+#include "source/common/http/character_set_validation.h"
+
+#include "source/common/common/macros.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ENVOY_CHARACTER_SET_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+#ifdef ENVOY_CHARACTER_SET_SIMD
+
+// Each function below scans the whole blocks of `data` starting at `offset` and returns the offset
+// of the first matching character, or the end of the last block scanned if none matched, in which
+// case the caller scans the remaining tail. A character matches if its membership in the set equals
+// `find_in_set`.
+
+__attribute__((target("sse4.2"))) size_t scanSse42(const uint8_t* ascii_rows,
+                                                   const uint8_t* extended_rows, const char* data,
+                                                   size_t offset, size_t size, bool find_in_set) {
+  const __m128i ascii = _mm_load_si128(reinterpret_cast<const __m128i*>(ascii_rows));
+  const __m128i extended = _mm_load_si128(reinterpret_cast<const __m128i*>(extended_rows));
+  // Maps the high nibble to the bit that represents it in a row.
+  const __m128i high_nibble_bits =
+      _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+  const __m128i zero = _mm_setzero_si128();
+  const uint32_t flip = find_in_set ? 0xffff : 0;
+
+  for (; offset + 16 <= size; offset += 16) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+    const __m128i low = _mm_and_si128(chars, nibble_mask);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(chars, 4), nibble_mask);
+    // Pick the extended row for characters with the top bit set.
+    const __m128i rows =
+        _mm_blendv_epi8(_mm_shuffle_epi8(ascii, low), _mm_shuffle_epi8(extended, low), chars);
+    const __m128i in_set = _mm_and_si128(rows, _mm_shuffle_epi8(high_nibble_bits, high));
+    // One bit per character that is not in the set, flipped when looking for characters in it.
+    const uint32_t matches =
+        static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(in_set, zero))) ^ flip;
+    if (matches != 0) {
+      return offset + __builtin_ctz(matches);
+    }
+  }
+  return offset;
+}
+
+__attribute__((target("avx2"))) size_t scanAvx2(const uint8_t* ascii_rows,
+                                                const uint8_t* extended_rows, const char* data,
+                                                size_t offset, size_t size, bool find_in_set) {
+  // The shuffles work within each 128 bit lane, so every lane gets a copy of the rows.
+  const __m256i ascii =
+      _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(ascii_rows)));
+  const __m256i extended = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(extended_rows)));
+  const __m256i high_nibble_bits =
+      _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16,
+                       32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+  const __m256i zero = _mm256_setzero_si256();
+  const uint32_t flip = find_in_set ? 0xffffffff : 0;
+
+  for (; offset + 32 <= size; offset += 32) {
+    const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+    const __m256i low = _mm256_and_si256(chars, nibble_mask);
+    const __m256i high = _mm256_and_si256(_mm256_srli_epi16(chars, 4), nibble_mask);
+    const __m256i rows = _mm256_blendv_epi8(_mm256_shuffle_epi8(ascii, low),
+                                            _mm256_shuffle_epi8(extended, low), chars);
+    const __m256i in_set = _mm256_and_si256(rows, _mm256_shuffle_epi8(high_nibble_bits, high));
+    const uint32_t matches =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(in_set, zero))) ^ flip;
+    if (matches != 0) {
+      return offset + __builtin_ctz(matches);
+    }
+  }
+  return offset;
+}
+
+CharacterScanImpl detectBestImpl() {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return CharacterScanImpl::Avx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return CharacterScanImpl::Sse42;
+  }
+  return CharacterScanImpl::Scalar;
+}
+
+#else
+
+CharacterScanImpl detectBestImpl() { return CharacterScanImpl::Scalar; }
+
+#endif
+
+// Strings shorter than this are scanned with the scalar implementation, which wins on the typical
+// header name.
+constexpr size_t kMinSimdLength = 16;
+
+} // namespace
+
+CharacterScanImpl CharacterSetScanner::bestImpl() {
+  static const CharacterScanImpl best_impl = detectBestImpl();
+  return best_impl;
+}
+
+bool CharacterSetScanner::implSupported(CharacterScanImpl impl) {
+  switch (impl) {
+  case CharacterScanImpl::Scalar:
+    return true;
+  case CharacterScanImpl::Sse42:
+    return bestImpl() != CharacterScanImpl::Scalar;
+  case CharacterScanImpl::Avx2:
+    return bestImpl() == CharacterScanImpl::Avx2;
+  }
+  return false;
+}
+
+size_t CharacterSetScanner::scan(absl::string_view str, bool find_in_set,
+                                 CharacterScanImpl impl) const {
+  const char* data = str.data();
+  const size_t size = str.size();
+  size_t offset = 0;
+#ifdef ENVOY_CHARACTER_SET_SIMD
+  if (size >= kMinSimdLength) {
+    switch (impl) {
+    case CharacterScanImpl::Scalar:
+      break;
+    case CharacterScanImpl::Avx2:
+      offset = scanAvx2(ascii_rows_.data(), extended_rows_.data(), data, offset, size, find_in_set);
+      // Scan the remaining 16 byte block, if any, with SSE4.2 which every AVX2 CPU supports.
+      FALLTHRU;
+    case CharacterScanImpl::Sse42:
+      offset = scanSse42(ascii_rows_.data(), extended_rows_.data(), data, offset, size, find_in_set);
+      break;
+    }
+  }
+#else
+  UNREFERENCED_PARAMETER(impl);
+#endif
+  for (; offset < size; ++offset) {
+    if (testCharInTable(table_, data[offset]) == find_in_set) {
+      return offset;
+    }
+  }
+  return size;
+}
+
+} // namespace Http
+} // namespace Envoy
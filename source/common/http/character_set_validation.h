@@ -1,8 +1,11 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
+#include "absl/strings/string_view.h"
+
 // A set of tables for validating that a character is in a specific
 // character set. Used to validate RFC compliance for various HTTP protocol elements.
 
@@ -72,5 +75,76 @@ inline constexpr std::array<uint32_t, 8> kUriQueryAndFragmentCharTable = {
     0b00000000000000000000000000000000,
 };
 
+// Implementations available to CharacterSetScanner. The SIMD implementations are only compiled on
+// x86-64 and are selected at runtime based on the features supported by the CPU.
+enum class CharacterScanImpl { Scalar, Sse42, Avx2 };
+
+/**
+ * Scans strings for characters in or out of a character table 16 (SSE4.2) or 32 (AVX2) bytes at a
+ * time, falling back to testCharInTable() on other CPUs and for the tail of a string.
+ *
+ * The vectorized lookup splits each byte into nibbles. The low nibble selects a byte from one of
+ * two 16 byte rows (one for ASCII, one for extended ASCII) whose bits say which values of the high
+ * nibble are in the set, so a set of any shape costs the same handful of instructions.
+ */
+class CharacterSetScanner {
+public:
+  constexpr explicit CharacterSetScanner(const std::array<uint32_t, 8>& table) : table_(table) {
+    for (unsigned c = 0; c < 256; ++c) {
+      if (testCharInTable(table, static_cast<char>(c))) {
+        std::array<uint8_t, 16>& rows = c < 0x80 ? ascii_rows_ : extended_rows_;
+        rows[c & 0x0f] |= static_cast<uint8_t>(1 << ((c >> 4) & 0x07));
+      }
+    }
+  }
+
+  /**
+   * @return the offset of the first character of `str` that is not in the set, or str.size() if
+   *         every character is in the set.
+   */
+  size_t findFirstNotInSet(absl::string_view str) const { return scan(str, false, bestImpl()); }
+  size_t findFirstNotInSet(absl::string_view str, CharacterScanImpl impl) const {
+    return scan(str, false, impl);
+  }
+
+  /**
+   * @return the offset of the first character of `str` that is in the set, or str.size() if there
+   *         is none.
+   */
+  size_t findFirstInSet(absl::string_view str) const { return scan(str, true, bestImpl()); }
+  size_t findFirstInSet(absl::string_view str, CharacterScanImpl impl) const {
+    return scan(str, true, impl);
+  }
+
+  /**
+   * @return true if every character of `str` is in the set.
+   */
+  bool containsOnly(absl::string_view str) const { return findFirstNotInSet(str) == str.size(); }
+
+  /**
+   * @return true if any character of `str` is in the set.
+   */
+  bool containsAny(absl::string_view str) const { return findFirstInSet(str) != str.size(); }
+
+  /**
+   * @return the fastest implementation supported by the CPU.
+   */
+  static CharacterScanImpl bestImpl();
+
+  /**
+   * @return true if `impl` can run on this CPU.
+   */
+  static bool implSupported(CharacterScanImpl impl);
+
+private:
+  size_t scan(absl::string_view str, bool find_in_set, CharacterScanImpl impl) const;
+
+  const std::array<uint32_t, 8> table_;
+  // Bit `h` of ascii_rows_[l] is set if the character 0xhl (h < 8) is in the set, and bit `h - 8`
+  // of extended_rows_[l] if the character 0xhl (h >= 8) is.
+  alignas(16) std::array<uint8_t, 16> ascii_rows_{};
+  alignas(16) std::array<uint8_t, 16> extended_rows_{};
+};
+
 } // namespace Http
 } // namespace Envoy
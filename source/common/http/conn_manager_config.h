@@ -34,6 +34,8 @@ namespace Http {
   COUNTER(downstream_cx_destroy_remote)                                                            \
   COUNTER(downstream_cx_destroy_remote_active_rq)                                                  \
   COUNTER(downstream_cx_drain_close)                                                               \
+  COUNTER(downstream_cx_header_pool_hit)                                                           \
+  COUNTER(downstream_cx_header_pool_miss)                                                          \
   COUNTER(downstream_cx_http1_total)                                                               \
   COUNTER(downstream_cx_http2_total)                                                               \
   COUNTER(downstream_cx_http3_total)                                                               \
@@ -76,6 +78,8 @@ namespace Http {
   COUNTER(downstream_rq_ws_on_non_ws_route)                                                        \
   COUNTER(rs_too_large)                                                                            \
   GAUGE(downstream_cx_active, Accumulate)                                                          \
+  GAUGE(downstream_cx_header_pool_blocks, Accumulate)                                              \
+  GAUGE(downstream_cx_header_pool_bytes, Accumulate)                                               \
   GAUGE(downstream_cx_http1_active, Accumulate)                                                    \
   GAUGE(downstream_cx_http2_active, Accumulate)                                                    \
   GAUGE(downstream_cx_http3_active, Accumulate)                                                    \
@@ -560,6 +564,12 @@ public:
    *         Connection Lifetime.
    */
   virtual bool addProxyProtocolConnectionState() const PURE;
+
+  /**
+   * @return the maximum number of header storage blocks each connection keeps for reuse by later
+   *         streams. Zero disables header storage pooling.
+   */
+  virtual uint32_t headerMapPoolMaxBlocks() const PURE;
 };
 
 using ConnectionManagerConfigSharedPtr = std::shared_ptr<ConnectionManagerConfig>;
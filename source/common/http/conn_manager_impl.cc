@@ -130,6 +130,13 @@ ConnectionManagerImpl::ConnectionManagerImpl(
       direction_(direction),
       allow_upstream_half_close_(Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.allow_multiplexed_upstream_half_close")) {
+  if (config_->headerMapPoolMaxBlocks() > 0) {
+    header_map_pool_ = std::make_shared<HeaderMapPool>(
+        config_->headerMapPoolMaxBlocks(), stats_.named_.downstream_cx_header_pool_hit_,
+        stats_.named_.downstream_cx_header_pool_miss_,
+        stats_.named_.downstream_cx_header_pool_blocks_,
+        stats_.named_.downstream_cx_header_pool_bytes_);
+  }
   ENVOY_LOG_ONCE_IF(
       trace, accept_new_http_stream_ == nullptr,
       "LoadShedPoint envoy.load_shed_points.http_connection_manager_decode_headers is not "
@@ -220,6 +227,12 @@ ConnectionManagerImpl::~ConnectionManagerImpl() {
     stats_.named_.downstream_cx_http1_soft_drain_.dec();
   }
 
+  if (header_map_pool_ != nullptr) {
+    // Header maps that are still alive, e.g. held by a deferred deleted stream, return their
+    // storage to the heap from now on.
+    header_map_pool_->drain();
+  }
+
   conn_length_->complete();
   user_agent_.completeConnectionLength(*conn_length_);
 }
@@ -496,6 +509,9 @@ Network::FilterStatus ConnectionManagerImpl::onData(Buffer::Instance& data, bool
     createCodec(data);
   }
 
+  // Header maps created by the codec while dispatching take their storage from this connection's
+  // pool.
+  HeaderMapPool::ActiveScope header_map_pool_scope(header_map_pool_.get());
   bool redispatch;
   do {
     redispatch = false;
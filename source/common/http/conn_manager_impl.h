@@ -42,6 +42,7 @@
 #include "source/common/grpc/common.h"
 #include "source/common/http/conn_manager_config.h"
 #include "source/common/http/filter_manager.h"
+#include "source/common/http/header_map_pool.h"
 #include "source/common/http/user_agent.h"
 #include "source/common/http/utility.h"
 #include "source/common/local_reply/local_reply.h"
@@ -616,6 +617,8 @@ private:
   ConnectionManagerConfigSharedPtr config_;
   ConnectionManagerStats& stats_; // We store a reference here to avoid an extra stats() call on
                                   // the config in the hot path.
+  // Recycles header storage across the streams of this connection. Null if pooling is disabled.
+  HeaderMapPoolSharedPtr header_map_pool_;
   ServerConnectionPtr codec_;
   std::list<ActiveStreamPtr> streams_;
   Stats::TimespanPtr conn_length_;
@@ -1,5 +1,6 @@
 #include "source/common/http/header_map_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -47,6 +48,52 @@ HeaderString::HeaderString(UnionString&& move_value) noexcept {
   ASSERT(valid());
 }
 
+HeaderMapImpl::HeaderEntryArena::~HeaderEntryArena() {
+  for (uint32_t i = 0; i < blocks_.size(); ++i) {
+    if (pool_ != nullptr) {
+      const uint32_t size_class = std::min<uint32_t>(i, HeaderMapPool::NumSizeClasses - 1);
+      pool_->release(size_class, blocks_[i], (InitialBlockNodes << size_class) * node_size_);
+    } else {
+      delete[] blocks_[i];
+    }
+  }
+}
+
+uint8_t* HeaderMapImpl::HeaderEntryArena::allocateBlock(uint32_t size_class, size_t size) {
+  if (blocks_.empty()) {
+    pool_ = HeaderMapPool::active();
+  }
+  return pool_ != nullptr ? pool_->allocate(size_class, size) : new uint8_t[size];
+}
+
+void* HeaderMapImpl::HeaderEntryArena::allocate(size_t node_size) {
+  ASSERT(node_size_ == 0 || node_size_ == node_size);
+  node_size_ = node_size;
+  if (free_nodes_ != nullptr) {
+    FreeNode* node = free_nodes_;
+    free_nodes_ = node->next_;
+    return node;
+  }
+  if (remaining_nodes_ == 0) {
+    static_assert(sizeof(FreeNode) <= sizeof(HeaderEntryImpl));
+    const uint32_t size_class =
+        std::min<uint32_t>(blocks_.size(), HeaderMapPool::NumSizeClasses - 1);
+    ASSERT((InitialBlockNodes << size_class) == next_block_nodes_);
+    next_node_ = allocateBlock(size_class, next_block_nodes_ * node_size);
+    blocks_.push_back(next_node_);
+    remaining_nodes_ = next_block_nodes_;
+    next_block_nodes_ = std::min(next_block_nodes_ * 2, MaxBlockNodes);
+  }
+  void* node = next_node_;
+  next_node_ += node_size;
+  --remaining_nodes_;
+  return node;
+}
+
+void HeaderMapImpl::HeaderEntryArena::deallocate(void* node) {
+  free_nodes_ = new (node) FreeNode{free_nodes_};
+}
+
 // Specialization needed for HeaderMapImpl::HeaderList::insert() when key is LowerCaseString.
 // A fully specialized template must be defined once in the program, hence this may not be in
 // a header file.
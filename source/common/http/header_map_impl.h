@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -14,9 +15,12 @@
 #include "source/common/common/compiled_string_map.h"
 #include "source/common/common/non_copyable.h"
 #include "source/common/common/utility.h"
+#include "source/common/http/header_map_pool.h"
 #include "source/common/http/headers.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/container/inlined_vector.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -114,6 +118,86 @@ public:
   StatefulHeaderKeyFormatterOptRef formatter() { return makeOptRefFromPtr(formatter_.get()); }
 
 protected:
+  /**
+   * Backing storage for the nodes of a HeaderList. Nodes are carved out of blocks owned by the
+   * list rather than allocated from the heap one at a time. Blocks double in size up to a limit,
+   * so a map with 20 headers makes 3 allocations instead of 20, and nodes of removed headers are
+   * recycled through a free list. Since keys and values of up to 128 bytes are stored inline in
+   * their HeaderString, the bytes of most headers end up in these few contiguous blocks too.
+   * Blocks are only freed when the map is destroyed, so memory is bounded by the peak number of
+   * headers in the map. If a HeaderMapPool is active when the first block is needed, all blocks
+   * are taken from and returned to that pool instead of the heap.
+   */
+  class HeaderEntryArena : NonCopyable {
+  public:
+    ~HeaderEntryArena();
+
+    void* allocate(size_t node_size);
+    void deallocate(void* node);
+
+  private:
+    static constexpr uint32_t InitialBlockNodes = 4;
+    static constexpr uint32_t MaxBlockNodes = 64;
+    static_assert(InitialBlockNodes << (HeaderMapPool::NumSizeClasses - 1) == MaxBlockNodes);
+
+    uint8_t* allocateBlock(uint32_t size_class, size_t size);
+
+    struct FreeNode {
+      FreeNode* next_;
+    };
+
+    // 4 inline blocks hold 4 + 8 + 16 + 32 = 60 headers without allocating the vector itself.
+    absl::InlinedVector<uint8_t*, 4> blocks_;
+    FreeNode* free_nodes_{};
+    uint8_t* next_node_{};
+    uint32_t remaining_nodes_{};
+    uint32_t next_block_nodes_{InitialBlockNodes};
+    size_t node_size_{};
+    HeaderMapPoolSharedPtr pool_;
+  };
+
+  /**
+   * Allocator for the std::list of a HeaderList that serves single nodes from a HeaderEntryArena.
+   */
+  template <class T> class HeaderEntryAllocator {
+  public:
+    using value_type = T;
+
+    explicit HeaderEntryAllocator(HeaderEntryArena& arena) : arena_(&arena) {}
+    template <class U>
+    HeaderEntryAllocator(const HeaderEntryAllocator<U>& other) : arena_(other.arena_) {}
+
+    T* allocate(size_t n) {
+      if (n != 1) {
+        return std::allocator<T>().allocate(n);
+      }
+      static_assert(alignof(T) <= alignof(std::max_align_t));
+      return static_cast<T*>(arena_->allocate(sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+      if (n != 1) {
+        std::allocator<T>().deallocate(p, n);
+        return;
+      }
+      arena_->deallocate(p);
+    }
+
+    template <class U> bool operator==(const HeaderEntryAllocator<U>& other) const {
+      return arena_ == other.arena_;
+    }
+    template <class U> bool operator!=(const HeaderEntryAllocator<U>& other) const {
+      return arena_ != other.arena_;
+    }
+
+  private:
+    HeaderEntryArena* arena_;
+
+    template <class U> friend class HeaderEntryAllocator;
+  };
+
+  struct HeaderEntryImpl;
+  using HeaderEntryList = std::list<HeaderEntryImpl, HeaderEntryAllocator<HeaderEntryImpl>>;
+
   struct HeaderEntryImpl : public HeaderEntry, NonCopyable {
     HeaderEntryImpl(const LowerCaseString& key);
     HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value);
@@ -129,9 +213,9 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    HeaderEntryList::iterator entry_;
   };
-  using HeaderNode = std::list<HeaderEntryImpl>::iterator;
+  using HeaderNode = HeaderEntryList::iterator;
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
@@ -193,7 +277,8 @@ protected:
 
   /**
    * List of HeaderEntryImpl that keeps the pseudo headers (key starting with ':') in the front
-   * of the list (as required by nghttp2) and otherwise maintains insertion order.
+   * of the list (as required by nghttp2) and otherwise maintains insertion order. The entries are
+   * allocated from a HeaderEntryArena owned by the list, which keeps their addresses stable.
    * When the list size is greater or equal to 3, all headers are added to a map, to allow fast
    * access given a header key. Once the map is initialized, it will be used even
    * if the number of headers decreases below the threshold.
@@ -210,7 +295,9 @@ protected:
     using HeaderNodeVector = absl::InlinedVector<HeaderNode, 1>;
     using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
 
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    HeaderList()
+        : headers_(HeaderEntryAllocator<HeaderEntryImpl>(arena_)),
+          pseudo_headers_end_(headers_.end()) {}
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
@@ -300,12 +387,12 @@ protected:
      */
     size_t remove(absl::string_view key);
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    HeaderEntryList::iterator begin() { return headers_.begin(); }
+    HeaderEntryList::iterator end() { return headers_.end(); }
+    HeaderEntryList::const_iterator begin() const { return headers_.begin(); }
+    HeaderEntryList::const_iterator end() const { return headers_.end(); }
+    HeaderEntryList::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
+    HeaderEntryList::const_reverse_iterator rend() const { return headers_.rend(); }
     HeaderLazyMap::iterator mapFind(absl::string_view key) { return lazy_map_.find(key); }
     HeaderLazyMap::iterator mapEnd() { return lazy_map_.end(); }
     size_t size() const { return headers_.size(); }
@@ -317,7 +404,9 @@ protected:
     }
 
   private:
-    std::list<HeaderEntryImpl> headers_;
+    // Must outlive headers_.
+    HeaderEntryArena arena_;
+    HeaderEntryList headers_;
     HeaderNode pseudo_headers_end_;
     HeaderLazyMap lazy_map_;
   };
@@ -0,0 +1,87 @@
+#include "source/common/http/header_map_pool.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+thread_local HeaderMapPool* tls_active_pool = nullptr;
+} // namespace
+
+HeaderMapPool::HeaderMapPool(uint32_t max_blocks, Stats::Counter& hits, Stats::Counter& misses,
+                             Stats::Gauge& blocks, Stats::Gauge& bytes)
+    : owner_(std::this_thread::get_id()), max_blocks_(max_blocks), hits_(hits), misses_(misses),
+      blocks_(blocks), bytes_(bytes) {}
+
+HeaderMapPool::~HeaderMapPool() {
+  // The stats may already be gone; drain() has accounted for everything that was cached.
+  for (auto& free_blocks : free_blocks_) {
+    for (uint8_t* block : free_blocks) {
+      delete[] block;
+    }
+  }
+}
+
+HeaderMapPool::ActiveScope::ActiveScope(HeaderMapPool* pool) : previous_(tls_active_pool) {
+  tls_active_pool = pool;
+}
+
+HeaderMapPool::ActiveScope::~ActiveScope() { tls_active_pool = previous_; }
+
+HeaderMapPoolSharedPtr HeaderMapPool::active() {
+  return tls_active_pool != nullptr ? tls_active_pool->shared_from_this() : nullptr;
+}
+
+uint8_t* HeaderMapPool::allocate(uint32_t size_class, size_t size) {
+  ASSERT(size_class < NumSizeClasses);
+  if (!ownedByCallingThread() || max_blocks_ == 0) {
+    return new uint8_t[size];
+  }
+  auto& free_blocks = free_blocks_[size_class];
+  if (free_blocks.empty()) {
+    misses_.inc();
+    return new uint8_t[size];
+  }
+  ASSERT(block_sizes_[size_class] == size);
+  uint8_t* block = free_blocks.back();
+  free_blocks.pop_back();
+  --size_;
+  hits_.inc();
+  blocks_.dec();
+  bytes_.sub(size);
+  return block;
+}
+
+void HeaderMapPool::release(uint32_t size_class, uint8_t* block, size_t size) {
+  ASSERT(size_class < NumSizeClasses);
+  if (!ownedByCallingThread() || size_ >= max_blocks_) {
+    delete[] block;
+    return;
+  }
+  ASSERT(block_sizes_[size_class] == 0 || block_sizes_[size_class] == size);
+  block_sizes_[size_class] = size;
+  free_blocks_[size_class].push_back(block);
+  ++size_;
+  blocks_.inc();
+  bytes_.add(size);
+}
+
+void HeaderMapPool::drain() {
+  ASSERT(ownedByCallingThread());
+  for (uint32_t size_class = 0; size_class < NumSizeClasses; ++size_class) {
+    auto& free_blocks = free_blocks_[size_class];
+    blocks_.sub(free_blocks.size());
+    bytes_.sub(free_blocks.size() * block_sizes_[size_class]);
+    for (uint8_t* block : free_blocks) {
+      delete[] block;
+    }
+    free_blocks.clear();
+    free_blocks.shrink_to_fit();
+  }
+  size_ = 0;
+  max_blocks_ = 0;
+}
+
+} // namespace Http
+} // namespace Envoy
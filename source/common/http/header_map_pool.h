@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "envoy/stats/stats.h"
+
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Http {
+
+class HeaderMapPool;
+using HeaderMapPoolSharedPtr = std::shared_ptr<HeaderMapPool>;
+
+/**
+ * A bounded cache of the blocks that back header map entries, owned by a single downstream
+ * connection. Header maps that start storing entries while the pool is active (see ActiveScope)
+ * draw their blocks from the pool and hand them back when they are destroyed, so that a long lived
+ * connection carrying many streams reuses the same header storage instead of freeing and
+ * reallocating it for every stream.
+ *
+ * Blocks are grouped by size class; every block of a given class has the same size. The pool is
+ * only ever used on the thread that created it. Blocks allocated or released on any other thread
+ * bypass the pool and go straight to the heap.
+ */
+class HeaderMapPool : public std::enable_shared_from_this<HeaderMapPool>, NonCopyable {
+public:
+  static constexpr uint32_t NumSizeClasses = 5;
+
+  /**
+   * @param max_blocks the maximum number of free blocks retained across all size classes.
+   * @param hits incremented whenever a block is served from the pool.
+   * @param misses incremented whenever a block has to be allocated from the heap.
+   * @param blocks tracks the number of free blocks held by the pool.
+   * @param bytes tracks the number of bytes held by the pool.
+   */
+  HeaderMapPool(uint32_t max_blocks, Stats::Counter& hits, Stats::Counter& misses,
+                Stats::Gauge& blocks, Stats::Gauge& bytes);
+  ~HeaderMapPool();
+
+  /**
+   * Makes a pool the active pool of the calling thread for the lifetime of the scope. Scopes may
+   * nest; the previously active pool is restored on destruction.
+   */
+  class ActiveScope : NonCopyable {
+  public:
+    explicit ActiveScope(HeaderMapPool* pool);
+    ~ActiveScope();
+
+  private:
+    HeaderMapPool* const previous_;
+  };
+
+  /**
+   * @return the pool that is active on the calling thread, or nullptr if there is none.
+   */
+  static HeaderMapPoolSharedPtr active();
+
+  /**
+   * Allocate a block of the given size class. Blocks of the same size class must always be
+   * requested with the same size.
+   */
+  uint8_t* allocate(uint32_t size_class, size_t size);
+
+  /**
+   * Return a block obtained from allocate() with the same size class and size.
+   */
+  void release(uint32_t size_class, uint8_t* block, size_t size);
+
+  /**
+   * Free all cached blocks and stop caching. Must be called on the owning thread before the stats
+   * passed to the constructor are destroyed; blocks released afterwards, e.g. by header maps that
+   * outlive the connection, are freed to the heap.
+   */
+  void drain();
+
+  /**
+   * @return the number of free blocks currently held by the pool.
+   */
+  uint32_t size() const { return size_; }
+
+private:
+  bool ownedByCallingThread() const { return std::this_thread::get_id() == owner_; }
+
+  const std::thread::id owner_;
+  uint32_t max_blocks_;
+  uint32_t size_{};
+  std::array<std::vector<uint8_t*>, NumSizeClasses> free_blocks_;
+  std::array<size_t, NumSizeClasses> block_sizes_{};
+  Stats::Counter& hits_;
+  Stats::Counter& misses_;
+  Stats::Gauge& blocks_;
+  Stats::Gauge& bytes_;
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -5,6 +5,7 @@
 #include <cstdint>
 
 #include "source/common/common/assert.h"
+#include "source/common/http/character_set_validation.h"
 #include "source/common/http/headers.h"
 #include "source/common/runtime/runtime_features.h"
 
@@ -28,10 +29,39 @@ constexpr absl::string_view kHttpVersionPrefix = "HTTP/";
 // Allowed characters for field names according to Section 5.1
 // and for methods according to Section 9.1 of RFC 9110:
 // https://www.rfc-editor.org/rfc/rfc9110.html
-constexpr absl::string_view kValidCharacters =
-    "!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~";
-constexpr absl::string_view::iterator kValidCharactersBegin = kValidCharacters.begin();
-constexpr absl::string_view::iterator kValidCharactersEnd = kValidCharacters.end();
+constexpr CharacterSetScanner kTokenScanner(kGenericHeaderNameCharTable);
+
+// Characters allowed in the path and query of a URL by the http-parser library: HTAB, FF and
+// visible ASCII characters.
+constexpr CharacterSetScanner kPathQueryScanner({
+    // control characters
+    0b00000000010010000000000000000000,
+    // !"#$%&'()*+,-./0123456789:;<=>?
+    0b01111111111111111111111111111111,
+    //@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\]^_
+    0b11111111111111111111111111111111,
+    //`abcdefghijklmnopqrstuvwxyz{|}~
+    0b11111111111111111111111111111110,
+    // extended ascii
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+});
+
+// CR and LF, which are removed from header values.
+constexpr CharacterSetScanner kCrLfScanner({
+    // control characters
+    0b00000000001001000000000000000000,
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+    // extended ascii
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+    0b00000000000000000000000000000000,
+});
 
 bool isFirstCharacterOfValidMethod(char c) {
   static constexpr char kValidFirstCharacters[] = {'A', 'B', 'C', 'D', 'G', 'H', 'L', 'M',
@@ -46,10 +76,7 @@ bool isFirstCharacterOfValidMethod(char c) {
 // enabled.
 bool isMethodValid(absl::string_view method, bool allow_custom_methods) {
   if (allow_custom_methods) {
-    return !method.empty() &&
-           std::all_of(method.begin(), method.end(), [](absl::string_view::value_type c) {
-             return std::binary_search(kValidCharactersBegin, kValidCharactersEnd, c);
-           });
+    return !method.empty() && kTokenScanner.containsOnly(method);
   }
 
   static constexpr absl::string_view kValidMethods[] = {
@@ -70,15 +97,9 @@ bool isUrlValid(absl::string_view url, bool is_connect) {
     return false;
   }
 
-  // Same set of characters are allowed for path and query.
-  const auto is_valid_path_query_char = [](char c) {
-    return c == 9 || c == 12 || ('!' <= c && c <= 126);
-  };
-
   // The URL may start with a path.
-  if (auto it = url.begin(); *it == '/' || *it == '*') {
-    ++it;
-    return std::all_of(it, url.end(), is_valid_path_query_char);
+  if (url[0] == '/' || url[0] == '*') {
+    return kPathQueryScanner.containsOnly(url.substr(1));
   }
 
   // If method is not CONNECT, parse scheme.
@@ -119,7 +140,7 @@ bool isUrlValid(absl::string_view url, bool is_connect) {
   // Match http-parser's quirk of allowing any number of '@' characters in host
   // as long as they are not consecutive.
   return std::all_of(host.begin(), host.end(), valid_host_char) && !absl::StrContains(host, "@@") &&
-         std::all_of(path_query.begin(), path_query.end(), is_valid_path_query_char);
+         kPathQueryScanner.containsOnly(path_query);
 }
 
 // Returns true if `version_input` is a valid HTTP version string as defined at
@@ -139,11 +160,7 @@ bool isVersionValid(absl::string_view version_input) {
          version_input[1] == '.' && absl::ascii_isdigit(version_input[2]);
 }
 
-bool isHeaderNameValid(absl::string_view name) {
-  return std::all_of(name.begin(), name.end(), [](absl::string_view::value_type c) {
-    return std::binary_search(kValidCharactersBegin, kValidCharactersEnd, c);
-  });
-}
+bool isHeaderNameValid(absl::string_view name) { return kTokenScanner.containsOnly(name); }
 
 } // anonymous namespace
 
@@ -432,12 +449,13 @@ void BalsaParser::validateAndProcessHeadersOrTrailersImpl(const quiche::BalsaHea
     }
 
     // Remove CR and LF characters to match http-parser behavior.
-    auto is_cr_or_lf = [](char c) { return c == '\r' || c == '\n'; };
-    if (std::any_of(value.begin(), value.end(), is_cr_or_lf)) {
+    if (size_t first_cr_or_lf = kCrLfScanner.findFirstInSet(value);
+        first_cr_or_lf != value.size()) {
       std::string value_without_cr_or_lf;
       value_without_cr_or_lf.reserve(value.size());
-      for (char c : value) {
-        if (!is_cr_or_lf(c)) {
+      value_without_cr_or_lf.append(value.data(), first_cr_or_lf);
+      for (char c : value.substr(first_cr_or_lf)) {
+        if (c != '\r' && c != '\n') {
           value_without_cr_or_lf.push_back(c);
         }
       }
@@ -2,6 +2,8 @@
 
 #include <sys/eventfd.h>
 
+#include "absl/numeric/bits.h"
+
 namespace Envoy {
 namespace Io {
 
@@ -28,9 +30,24 @@ IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polli
   // with SQ ring. We will figure out better handle of entries number in the future.
   int ret = io_uring_queue_init_params(io_uring_size, &ring_, &p);
   RELEASE_ASSERT(ret == 0, fmt::format("unable to initialize io_uring: {}", errorDetails(-ret)));
+
+  struct io_uring_probe* probe = io_uring_get_probe_ring(&ring_);
+  if (probe != nullptr) {
+    // Multishot accept and multishot recv have no opcode of their own. They are detected through
+    // opcodes which were introduced in the same kernel release, 5.19 and 6.0 respectively.
+    multishot_accept_supported_ = io_uring_opcode_supported(probe, IORING_OP_SOCKET);
+    multishot_recv_supported_ = io_uring_opcode_supported(probe, IORING_OP_SEND_ZC);
+    zero_copy_send_supported_ = io_uring_opcode_supported(probe, IORING_OP_SENDMSG_ZC);
+    io_uring_free_probe(probe);
+  }
 }
 
-IoUringImpl::~IoUringImpl() { io_uring_queue_exit(&ring_); }
+IoUringImpl::~IoUringImpl() {
+  if (buf_ring_ != nullptr) {
+    io_uring_free_buf_ring(&ring_, buf_ring_, provided_buffer_count_, ProvidedBufferGroupId);
+  }
+  io_uring_queue_exit(&ring_);
+}
 
 os_fd_t IoUringImpl::registerEventfd() {
   ASSERT(!isEventfdRegistered());
@@ -69,7 +86,11 @@ void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
 
   for (unsigned i = 0; i < count; ++i) {
     struct io_uring_cqe* cqe = cqes_[i];
-    completion_cb(reinterpret_cast<Request*>(cqe->user_data), cqe->res, false);
+    Request* req = reinterpret_cast<Request*>(cqe->user_data);
+    if (req != nullptr) {
+      req->setCompletionFlags(cqe->flags);
+    }
+    completion_cb(req, cqe->res, false);
   }
 
   io_uring_cq_advance(&ring_, count);
@@ -101,6 +122,25 @@ IoUringResult IoUringImpl::prepareAccept(os_fd_t fd, struct sockaddr* remote_add
   }
 
   io_uring_prep_accept(sqe, fd, remote_addr, remote_addr_len, 0);
+  useRegisteredFile(sqe, fd);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareAcceptMultishot(os_fd_t fd, Request* user_data) {
+  ENVOY_LOG(trace, "prepare multishot accept for fd = {}", fd);
+  ASSERT(multishot_accept_supported_);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  // The peer address is not requested since every completion would overwrite it. Accepted sockets
+  // are non-blocking like the ones accepted by `OsSysCallsImpl::accept()`.
+  io_uring_prep_multishot_accept(sqe, fd, nullptr, nullptr, SOCK_NONBLOCK);
+  useRegisteredFile(sqe, fd);
   io_uring_sqe_set_data(sqe, user_data);
   return IoUringResult::Ok;
 }
@@ -117,6 +157,7 @@ IoUringResult IoUringImpl::prepareConnect(os_fd_t fd,
   }
 
   io_uring_prep_connect(sqe, fd, address->sockAddr(), address->sockAddrLen());
+  useRegisteredFile(sqe, fd);
   io_uring_sqe_set_data(sqe, user_data);
   return IoUringResult::Ok;
 }
@@ -132,6 +173,25 @@ IoUringResult IoUringImpl::prepareReadv(os_fd_t fd, const struct iovec* iovecs,
   }
 
   io_uring_prep_readv(sqe, fd, iovecs, nr_vecs, offset);
+  useRegisteredFile(sqe, fd);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareRecvMultishot(os_fd_t fd, Request* user_data) {
+  ENVOY_LOG(trace, "prepare multishot recv for fd = {}", fd);
+  ASSERT(buf_ring_ != nullptr);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_recv_multishot(sqe, fd, nullptr, 0, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = ProvidedBufferGroupId;
+  useRegisteredFile(sqe, fd);
   io_uring_sqe_set_data(sqe, user_data);
   return IoUringResult::Ok;
 }
@@ -147,6 +207,24 @@ IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs,
   }
 
   io_uring_prep_writev(sqe, fd, iovecs, nr_vecs, offset);
+  useRegisteredFile(sqe, fd);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareSendmsgZc(os_fd_t fd, const struct msghdr* msg,
+                                            Request* user_data) {
+  ENVOY_LOG(trace, "prepare zero copy sendmsg for fd = {}", fd);
+  ASSERT(zero_copy_send_supported_);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_sendmsg_zc(sqe, fd, msg, MSG_NOSIGNAL);
+  useRegisteredFile(sqe, fd);
   io_uring_sqe_set_data(sqe, user_data);
   return IoUringResult::Ok;
 }
@@ -160,6 +238,9 @@ IoUringResult IoUringImpl::prepareClose(os_fd_t fd, Request* user_data) {
     return IoUringResult::Failed;
   }
 
+  // A registered file cannot be closed by a regular close operation. Drop the slot first, so that
+  // the close releases the last reference of the file.
+  unregisterFile(fd);
   io_uring_prep_close(sqe, fd);
   io_uring_sqe_set_data(sqe, user_data);
   return IoUringResult::Ok;
@@ -191,6 +272,7 @@ IoUringResult IoUringImpl::prepareShutdown(os_fd_t fd, int how, Request* user_da
   }
 
   io_uring_prep_shutdown(sqe, fd, how);
+  useRegisteredFile(sqe, fd);
   io_uring_sqe_set_data(sqe, user_data);
   return IoUringResult::Ok;
 }
@@ -219,5 +301,125 @@ void IoUringImpl::removeInjectedCompletion(os_fd_t fd) {
   });
 }
 
+bool IoUringImpl::isFeatureSupported(IoUringFeature feature) const {
+  switch (feature) {
+  case IoUringFeature::MultishotAccept:
+    return multishot_accept_supported_;
+  case IoUringFeature::ZeroCopySend:
+    return zero_copy_send_supported_;
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+bool IoUringImpl::setupProvidedBuffers(uint32_t buffer_count, uint32_t buffer_size) {
+  ASSERT(buf_ring_ == nullptr);
+  ASSERT(buffer_count > 0 && buffer_count <= 32768);
+  if (!multishot_recv_supported_) {
+    ENVOY_LOG(info, "multishot recv is not supported by the kernel");
+    return false;
+  }
+
+  const uint32_t count = absl::bit_ceil(buffer_count);
+  int ret = 0;
+  buf_ring_ = io_uring_setup_buf_ring(&ring_, count, ProvidedBufferGroupId, 0, &ret);
+  if (buf_ring_ == nullptr) {
+    ENVOY_LOG(warn, "unable to set up provided buffer ring: {}", errorDetails(-ret));
+    return false;
+  }
+
+  provided_buffer_count_ = count;
+  provided_buffer_size_ = buffer_size;
+  provided_buffers_ = std::make_unique<uint8_t[]>(static_cast<uint64_t>(count) * buffer_size);
+  const int mask = io_uring_buf_ring_mask(count);
+  for (uint32_t i = 0; i < count; i++) {
+    uint8_t* buffer = provided_buffers_.get() + static_cast<uint64_t>(i) * buffer_size;
+    io_uring_buf_ring_add(buf_ring_, buffer, buffer_size, i, mask, i);
+  }
+  io_uring_buf_ring_advance(buf_ring_, count);
+  return true;
+}
+
+absl::string_view IoUringImpl::providedBuffer(uint32_t completion_flags, uint32_t length) {
+  ASSERT(completion_flags & IORING_CQE_F_BUFFER);
+  const uint32_t buffer_id = completion_flags >> IORING_CQE_BUFFER_SHIFT;
+  ASSERT(buffer_id < provided_buffer_count_);
+  ASSERT(length <= provided_buffer_size_);
+  return {reinterpret_cast<const char*>(provided_buffers_.get()) +
+              static_cast<uint64_t>(buffer_id) * provided_buffer_size_,
+          length};
+}
+
+void IoUringImpl::recycleProvidedBuffer(uint32_t completion_flags) {
+  ASSERT(completion_flags & IORING_CQE_F_BUFFER);
+  const uint32_t buffer_id = completion_flags >> IORING_CQE_BUFFER_SHIFT;
+  ASSERT(buffer_id < provided_buffer_count_);
+  io_uring_buf_ring_add(buf_ring_,
+                        provided_buffers_.get() +
+                            static_cast<uint64_t>(buffer_id) * provided_buffer_size_,
+                        provided_buffer_size_, buffer_id,
+                        io_uring_buf_ring_mask(provided_buffer_count_), 0);
+  io_uring_buf_ring_advance(buf_ring_, 1);
+}
+
+bool IoUringImpl::setupRegisteredFiles(uint32_t size) {
+  ASSERT(free_registered_file_slots_.empty());
+  int ret = io_uring_register_files_sparse(&ring_, size);
+  if (ret != 0) {
+    ENVOY_LOG(warn, "unable to register file table: {}", errorDetails(-ret));
+    return false;
+  }
+
+  // Hand out the lowest slots first.
+  free_registered_file_slots_.reserve(size);
+  for (uint32_t slot = size; slot > 0; slot--) {
+    free_registered_file_slots_.push_back(slot - 1);
+  }
+  return true;
+}
+
+bool IoUringImpl::registerFile(os_fd_t fd) {
+  if (free_registered_file_slots_.empty() || SOCKET_INVALID(fd)) {
+    return false;
+  }
+
+  if (registered_file_slots_.size() <= static_cast<size_t>(fd)) {
+    registered_file_slots_.resize(fd + 1, -1);
+  }
+  ASSERT(registered_file_slots_[fd] < 0);
+  const uint32_t slot = free_registered_file_slots_.back();
+  int ret = io_uring_register_files_update(&ring_, slot, &fd, 1);
+  if (ret < 0) {
+    ENVOY_LOG(debug, "unable to register fd = {}: {}", fd, errorDetails(-ret));
+    return false;
+  }
+  free_registered_file_slots_.pop_back();
+  registered_file_slots_[fd] = slot;
+  ENVOY_LOG(trace, "registered fd = {} at slot {}", fd, slot);
+  return true;
+}
+
+void IoUringImpl::unregisterFile(os_fd_t fd) {
+  if (SOCKET_INVALID(fd) || registered_file_slots_.size() <= static_cast<size_t>(fd) ||
+      registered_file_slots_[fd] < 0) {
+    return;
+  }
+
+  const uint32_t slot = registered_file_slots_[fd];
+  const int unregistered_fd = -1;
+  int ret = io_uring_register_files_update(&ring_, slot, &unregistered_fd, 1);
+  RELEASE_ASSERT(ret >= 0, fmt::format("unable to unregister fd: {}", errorDetails(-ret)));
+  registered_file_slots_[fd] = -1;
+  free_registered_file_slots_.push_back(slot);
+  ENVOY_LOG(trace, "unregistered fd = {} from slot {}", fd, slot);
+}
+
+void IoUringImpl::useRegisteredFile(struct io_uring_sqe* sqe, os_fd_t fd) const {
+  if (SOCKET_VALID(fd) && static_cast<size_t>(fd) < registered_file_slots_.size() &&
+      registered_file_slots_[fd] >= 0) {
+    sqe->fd = registered_file_slots_[fd];
+    sqe->flags |= IOSQE_FIXED_FILE;
+  }
+}
+
 } // namespace Io
 } // namespace Envoy
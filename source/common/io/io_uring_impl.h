@@ -34,24 +34,55 @@ public:
   void forEveryCompletion(const CompletionCb& completion_cb) override;
   IoUringResult prepareAccept(os_fd_t fd, struct sockaddr* remote_addr, socklen_t* remote_addr_len,
                               Request* user_data) override;
+  IoUringResult prepareAcceptMultishot(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareConnect(os_fd_t fd, const Network::Address::InstanceConstSharedPtr& address,
                                Request* user_data) override;
   IoUringResult prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                              Request* user_data) override;
+  IoUringResult prepareRecvMultishot(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                               off_t offset, Request* user_data) override;
+  IoUringResult prepareSendmsgZc(os_fd_t fd, const struct msghdr* msg,
+                                 Request* user_data) override;
   IoUringResult prepareClose(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareCancel(Request* cancelling_user_data, Request* user_data) override;
   IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) override;
   IoUringResult submit() override;
   void injectCompletion(os_fd_t fd, Request* user_data, int32_t result) override;
   void removeInjectedCompletion(os_fd_t fd) override;
+  bool isFeatureSupported(IoUringFeature feature) const override;
+  bool setupProvidedBuffers(uint32_t buffer_count, uint32_t buffer_size) override;
+  absl::string_view providedBuffer(uint32_t completion_flags, uint32_t length) override;
+  void recycleProvidedBuffer(uint32_t completion_flags) override;
+  bool setupRegisteredFiles(uint32_t size) override;
+  bool registerFile(os_fd_t fd) override;
+  void unregisterFile(os_fd_t fd) override;
 
 private:
+  // Make the SQE refer to the registered file slot of the file descriptor, if there is one.
+  void useRegisteredFile(struct io_uring_sqe* sqe, os_fd_t fd) const;
+
+  static constexpr uint16_t ProvidedBufferGroupId = 0;
+
   struct io_uring ring_ {};
   std::vector<struct io_uring_cqe*> cqes_;
   os_fd_t event_fd_{INVALID_SOCKET};
   std::list<InjectedCompletion> injected_completions_;
+
+  bool multishot_accept_supported_{false};
+  bool multishot_recv_supported_{false};
+  bool zero_copy_send_supported_{false};
+
+  // The provided buffer ring used by multishot recv, and the memory backing its buffers.
+  struct io_uring_buf_ring* buf_ring_{nullptr};
+  std::unique_ptr<uint8_t[]> provided_buffers_;
+  uint32_t provided_buffer_count_{0};
+  uint32_t provided_buffer_size_{0};
+
+  // The registered file table slot of each file descriptor, indexed by the file descriptor. A
+  // negative value means the file descriptor is not registered.
+  std::vector<int32_t> registered_file_slots_;
+  std::vector<uint32_t> free_registered_file_slots_;
 };
 
 } // namespace Io
@@ -1,5 +1,7 @@
 #include "source/common/io/io_uring_worker_impl.h"
 
+#include "source/common/api/os_sys_calls_impl.h"
+
 namespace Envoy {
 namespace Io {
 
@@ -18,6 +20,12 @@ WriteRequest::WriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector&
   }
 }
 
+SendZcRequest::SendZcRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices)
+    : WriteRequest(socket, slices) {
+  msg_.msg_iov = iov_.get();
+  msg_.msg_iovlen = slices.size();
+}
+
 IoUringSocketEntry::IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb,
                                        bool enable_close_event)
     : fd_(fd), parent_(parent), enable_close_event_(enable_close_event), cb_(std::move(cb)) {}
@@ -60,14 +68,30 @@ void IoUringSocketEntry::onRemoteClose() {
 
 IoUringWorkerImpl::IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                                      uint32_t read_buffer_size, uint32_t write_timeout_ms,
-                                     Event::Dispatcher& dispatcher)
+                                     Event::Dispatcher& dispatcher, const IoUringOptions& options)
     : IoUringWorkerImpl(std::make_unique<IoUringImpl>(io_uring_size, use_submission_queue_polling),
-                        read_buffer_size, write_timeout_ms, dispatcher) {}
+                        read_buffer_size, write_timeout_ms, dispatcher, options) {}
 
 IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size,
-                                     uint32_t write_timeout_ms, Event::Dispatcher& dispatcher)
+                                     uint32_t write_timeout_ms, Event::Dispatcher& dispatcher,
+                                     const IoUringOptions& options)
     : io_uring_(std::move(io_uring)), read_buffer_size_(read_buffer_size),
       write_timeout_ms_(write_timeout_ms), dispatcher_(dispatcher) {
+  // Each optional feature falls back to the basic operations if the kernel does not support it.
+  if (options.provided_buffers_ > 0) {
+    multishot_recv_enabled_ =
+        io_uring_->setupProvidedBuffers(options.provided_buffers_, read_buffer_size_);
+  }
+  multishot_accept_enabled_ = options.multishot_accept_ &&
+                              io_uring_->isFeatureSupported(IoUringFeature::MultishotAccept);
+  if (options.registered_files_ > 0) {
+    registered_files_enabled_ = io_uring_->setupRegisteredFiles(options.registered_files_);
+  }
+  if (options.zero_copy_send_threshold_ > 0 &&
+      io_uring_->isFeatureSupported(IoUringFeature::ZeroCopySend)) {
+    zero_copy_send_threshold_ = options.zero_copy_send_threshold_;
+  }
+
   const os_fd_t event_fd = io_uring_->registerEventfd();
   // We only care about the read event of Eventfd, since we only receive the
   // event here.
@@ -127,6 +151,17 @@ IoUringSocket& IoUringWorkerImpl::addClientSocket(os_fd_t fd, Event::FileReadyCb
   return addSocket(std::move(socket));
 }
 
+OptRef<IoUringSocket> IoUringWorkerImpl::addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb) {
+  if (!multishot_accept_enabled_) {
+    return absl::nullopt;
+  }
+  ENVOY_LOG(trace, "add accept socket, fd = {}", fd);
+  IoUringSocketEntry& socket =
+      addSocket(std::make_unique<IoUringAcceptSocket>(fd, *this, std::move(cb)));
+  socket.enableRead();
+  return socket;
+}
+
 Event::Dispatcher& IoUringWorkerImpl::dispatcher() { return dispatcher_; }
 
 IoUringSocketEntry& IoUringWorkerImpl::addSocket(IoUringSocketEntryPtr&& socket) {
@@ -134,9 +169,33 @@ IoUringSocketEntry& IoUringWorkerImpl::addSocket(IoUringSocketEntryPtr&& socket)
   return *sockets_.back();
 }
 
+void IoUringWorkerImpl::onSubmitRequest(IoUringSocket& socket) {
+  if (!registered_files_enabled_) {
+    return;
+  }
+  // Every socket of this worker is an IoUringSocketEntry created by addSocket().
+  auto& entry = static_cast<IoUringSocketEntry&>(socket);
+  // Registering and unregistering a file costs two io_uring_register() syscalls, while a
+  // registered file only saves the file lookup and reference counting of each later request. Only
+  // sockets which have already submitted this many requests are expected to make up for it, so
+  // most short-lived connections and listeners are never registered.
+  if (entry.status_ == Closed || ++entry.submitted_requests_ != RegisterFileAfterRequests) {
+    return;
+  }
+  entry.file_registered_ = io_uring_->registerFile(entry.fd());
+}
+
+void IoUringWorkerImpl::unregisterFile(IoUringSocketEntry& socket) {
+  if (socket.file_registered_) {
+    io_uring_->unregisterFile(socket.fd());
+    socket.file_registered_ = false;
+  }
+}
+
 Request*
 IoUringWorkerImpl::submitConnectRequest(IoUringSocket& socket,
                                         const Network::Address::InstanceConstSharedPtr& address) {
+  onSubmitRequest(socket);
   Request* req = new Request(Request::RequestType::Connect, socket);
 
   ENVOY_LOG(trace, "submit connect request, fd = {}, req = {}", socket.fd(), fmt::ptr(req));
@@ -153,6 +212,7 @@ IoUringWorkerImpl::submitConnectRequest(IoUringSocket& socket,
 }
 
 Request* IoUringWorkerImpl::submitReadRequest(IoUringSocket& socket) {
+  onSubmitRequest(socket);
   ReadRequest* req = new ReadRequest(socket, read_buffer_size_);
 
   ENVOY_LOG(trace, "submit read request, fd = {}, read req = {}", socket.fd(), fmt::ptr(req));
@@ -170,6 +230,7 @@ Request* IoUringWorkerImpl::submitReadRequest(IoUringSocket& socket) {
 
 Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
                                                const Buffer::RawSliceVector& slices) {
+  onSubmitRequest(socket);
   WriteRequest* req = new WriteRequest(socket, slices);
 
   ENVOY_LOG(trace, "submit write request, fd = {}, req = {}", socket.fd(), fmt::ptr(req));
@@ -219,6 +280,7 @@ Request* IoUringWorkerImpl::submitCancelRequest(IoUringSocket& socket, Request*
 }
 
 Request* IoUringWorkerImpl::submitShutdownRequest(IoUringSocket& socket, int how) {
+  onSubmitRequest(socket);
   Request* req = new Request(Request::RequestType::Shutdown, socket);
 
   ENVOY_LOG(trace, "submit shutdown request, fd = {}, shutdown req = {}", socket.fd(),
@@ -235,9 +297,77 @@ Request* IoUringWorkerImpl::submitShutdownRequest(IoUringSocket& socket, int how
   return req;
 }
 
+Request* IoUringWorkerImpl::submitAcceptMultishotRequest(IoUringSocket& socket) {
+  onSubmitRequest(socket);
+  Request* req = new Request(Request::RequestType::Accept, socket);
+
+  ENVOY_LOG(trace, "submit multishot accept request, fd = {}, req = {}", socket.fd(),
+            fmt::ptr(req));
+
+  auto res = io_uring_->prepareAcceptMultishot(socket.fd(), req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareAcceptMultishot(socket.fd(), req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare multishot accept");
+  }
+  submit();
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitRecvMultishotRequest(IoUringSocket& socket) {
+  ASSERT(multishot_recv_enabled_);
+  onSubmitRequest(socket);
+  Request* req = new Request(Request::RequestType::Read, socket);
+
+  ENVOY_LOG(trace, "submit multishot recv request, fd = {}, req = {}", socket.fd(), fmt::ptr(req));
+
+  auto res = io_uring_->prepareRecvMultishot(socket.fd(), req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareRecvMultishot(socket.fd(), req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare multishot recv");
+  }
+  submit();
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitSendZcRequest(IoUringSocket& socket,
+                                                const Buffer::RawSliceVector& slices) {
+  ASSERT(zero_copy_send_threshold_ > 0);
+  onSubmitRequest(socket);
+  SendZcRequest* req = new SendZcRequest(socket, slices);
+
+  ENVOY_LOG(trace, "submit zero copy send request, fd = {}, req = {}", socket.fd(), fmt::ptr(req));
+
+  auto res = io_uring_->prepareSendmsgZc(socket.fd(), &req->msg_, req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareSendmsgZc(socket.fd(), &req->msg_, req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare zero copy sendmsg");
+  }
+  submit();
+  return req;
+}
+
+void IoUringWorkerImpl::moveProvidedBufferData(uint32_t completion_flags, uint32_t length,
+                                               Buffer::Instance& buffer) {
+  buffer.add(io_uring_->providedBuffer(completion_flags, length));
+  io_uring_->recycleProvidedBuffer(completion_flags);
+}
+
+void IoUringWorkerImpl::recycleProvidedBuffer(uint32_t completion_flags) {
+  io_uring_->recycleProvidedBuffer(completion_flags);
+}
+
 IoUringSocketEntryPtr IoUringWorkerImpl::removeSocket(IoUringSocketEntry& socket) {
   // Remove all the injection completion for this socket.
   io_uring_->removeInjectedCompletion(socket.fd());
+  // The registered file slot is released when the socket is closed, since the file descriptor may
+  // already be reused by the time the socket is removed.
+  ASSERT(!socket.file_registered_);
   return socket.removeFromList(sockets_);
 }
 
@@ -294,7 +424,10 @@ void IoUringWorkerImpl::onFileEvent() {
       break;
     }
 
-    delete req;
+    // A multishot request, or a zero copy send waiting for its notification, stays in flight.
+    if (!(req->completionFlags() & IORING_CQE_F_MORE)) {
+      delete req;
+    }
   });
   delay_submit_ = false;
   submit();
@@ -338,7 +471,8 @@ void IoUringServerSocket::close(bool keep_fd_open, IoUringSocketOnClosedCb cb) {
     return;
   }
 
-  if (read_req_ != nullptr) {
+  // A multishot recv request may already be canceled by disableRead().
+  if (read_req_ != nullptr && read_cancel_req_ == nullptr) {
     ENVOY_LOG(trace, "cancel the read request, fd = {}", fd_);
     read_cancel_req_ = parent_.submitCancelRequest(*this, read_req_);
   }
@@ -372,7 +506,17 @@ void IoUringServerSocket::enableRead() {
   submitReadRequest();
 }
 
-void IoUringServerSocket::disableRead() { IoUringSocketEntry::disableRead(); }
+void IoUringServerSocket::disableRead() {
+  IoUringSocketEntry::disableRead();
+
+  // A multishot recv request keeps reading into the read buffer until it is canceled. Cancel it so
+  // a disabled socket doesn't buffer unbounded data; a regular read request is submitted instead
+  // to watch for the remote close once the cancellation completes.
+  if (read_req_ != nullptr && read_multishot_ && read_cancel_req_ == nullptr) {
+    ENVOY_LOG(trace, "cancel the multishot recv request, fd = {}", fd_);
+    read_cancel_req_ = parent_.submitCancelRequest(*this, read_req_);
+  }
+}
 
 void IoUringServerSocket::write(Buffer::Instance& data) {
   ENVOY_LOG(trace, "write, buffer size = {}, fd = {}", data.length(), fd_);
@@ -429,6 +573,13 @@ void IoUringServerSocket::onCancel(Request* req, int32_t result, bool injected)
 }
 
 void IoUringServerSocket::moveReadDataToBuffer(Request* req, size_t data_length) {
+  if (req->completionFlags() & IORING_CQE_F_BUFFER) {
+    // The data has been received into a buffer of the provided buffer ring. Copy it out so that
+    // the buffer goes back to the kernel right away.
+    parent_.moveProvidedBufferData(req->completionFlags(), data_length, read_buf_);
+    return;
+  }
+
   ReadRequest* read_req = static_cast<ReadRequest*>(req);
   Buffer::BufferFragment* fragment = new Buffer::BufferFragmentImpl(
       read_req->buf_.release(), data_length,
@@ -457,23 +608,30 @@ void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
             "onRead with result {}, fd = {}, injected = {}, status_ = {}, enable_close_event = {}",
             result, fd_, injected, static_cast<int>(status_), enable_close_event_);
   if (!injected) {
-    read_req_ = nullptr;
+    // A multishot recv request stays armed as long as its completions carry IORING_CQE_F_MORE.
+    if (!(req->completionFlags() & IORING_CQE_F_MORE)) {
+      read_req_ = nullptr;
+    }
+    provided_buffers_exhausted_ = result == -ENOBUFS;
     // If the socket is going to close, discard all results.
-    if (status_ == Closed && write_or_shutdown_req_ == nullptr && read_cancel_req_ == nullptr &&
-        write_or_shutdown_cancel_req_ == nullptr) {
+    if (status_ == Closed && read_req_ == nullptr && write_or_shutdown_req_ == nullptr &&
+        read_cancel_req_ == nullptr && write_or_shutdown_cancel_req_ == nullptr) {
       if (result > 0 && keep_fd_open_) {
         moveReadDataToBuffer(req, result);
+      } else if (req->completionFlags() & IORING_CQE_F_BUFFER) {
+        parent_.recycleProvidedBuffer(req->completionFlags());
       }
       closeInternal();
       return;
     }
   }
 
-  // Move read data from request to buffer or store the error.
+  // Move read data from request to buffer or store the error. Running out of provided buffers only
+  // terminates the multishot recv request, it's not an error of the socket.
   if (result > 0) {
     moveReadDataToBuffer(req, result);
   } else {
-    if (result != -ECANCELED) {
+    if (result != -ECANCELED && result != -ENOBUFS) {
       read_error_ = result;
     }
   }
@@ -562,6 +720,15 @@ void IoUringServerSocket::onWrite(Request* req, int32_t result, bool injected) {
   ENVOY_LOG(trace, "onWrite with result {}, fd = {}, injected = {}, status_ = {}", result, fd_,
             injected, static_cast<int>(status_));
   if (!injected) {
+    // A zero copy send completes twice. The first completion carries the result, but the written
+    // data must stay in the write buffer until the notification completion.
+    if (req->completionFlags() & IORING_CQE_F_MORE) {
+      static_cast<SendZcRequest*>(req)->result_ = result;
+      return;
+    }
+    if (req->completionFlags() & IORING_CQE_F_NOTIF) {
+      result = static_cast<SendZcRequest*>(req)->result_;
+    }
     write_or_shutdown_req_ = nullptr;
   }
 
@@ -622,7 +789,12 @@ void IoUringServerSocket::closeInternal() {
 
 void IoUringServerSocket::submitReadRequest() {
   if (!read_req_) {
-    read_req_ = parent_.submitReadRequest(*this);
+    // A multishot recv request keeps reading until it is canceled, so it is only used while the
+    // socket is read enabled. A disabled socket only reads to watch for the remote close.
+    read_multishot_ = status_ == ReadEnabled && parent_.multishotRecvEnabled() &&
+                      !provided_buffers_exhausted_;
+    read_req_ = read_multishot_ ? parent_.submitRecvMultishotRequest(*this)
+                                : parent_.submitReadRequest(*this);
   }
 }
 
@@ -632,7 +804,12 @@ void IoUringServerSocket::submitWriteOrShutdownRequest() {
       Buffer::RawSliceVector slices = write_buf_.getRawSlices(IOV_MAX);
       ENVOY_LOG(trace, "submit write request, write_buf size = {}, num_iovecs = {}, fd = {}",
                 write_buf_.length(), slices.size(), fd_);
-      write_or_shutdown_req_ = parent_.submitWriteRequest(*this, slices);
+      const uint32_t zero_copy_send_threshold = parent_.zeroCopySendThreshold();
+      if (zero_copy_send_threshold > 0 && write_buf_.length() >= zero_copy_send_threshold) {
+        write_or_shutdown_req_ = parent_.submitSendZcRequest(*this, slices);
+      } else {
+        write_or_shutdown_req_ = parent_.submitWriteRequest(*this, slices);
+      }
     } else if (shutdown_.has_value() && !shutdown_.value()) {
       write_or_shutdown_req_ = parent_.submitShutdownRequest(*this, SHUT_WR);
     } else if (status_ == Closed && read_req_ == nullptr && read_cancel_req_ == nullptr &&
@@ -642,6 +819,122 @@ void IoUringServerSocket::submitWriteOrShutdownRequest() {
   }
 }
 
+IoUringAcceptSocket::IoUringAcceptSocket(os_fd_t fd, IoUringWorkerImpl& parent,
+                                         Event::FileReadyCb cb)
+    : IoUringSocketEntry(fd, parent, std::move(cb), false) {}
+
+IoUringAcceptSocket::~IoUringAcceptSocket() { closeAcceptedFds(); }
+
+void IoUringAcceptSocket::close(bool keep_fd_open, IoUringSocketOnClosedCb cb) {
+  ENVOY_LOG(trace, "close the accept socket, fd = {}, status = {}", fd_, static_cast<int>(status_));
+
+  IoUringSocketEntry::close(keep_fd_open, cb);
+  closeAcceptedFds();
+
+  if (accept_req_ == nullptr && accept_cancel_req_ == nullptr) {
+    cleanup();
+    return;
+  }
+  if (accept_req_ != nullptr && accept_cancel_req_ == nullptr) {
+    accept_cancel_req_ = parent_.submitCancelRequest(*this, accept_req_);
+  }
+}
+
+void IoUringAcceptSocket::enableRead() {
+  IoUringSocketEntry::enableRead();
+  ENVOY_LOG(trace, "enable accept, fd = {}", fd_);
+
+  if (!accepted_fds_.empty()) {
+    injectCompletion(Request::RequestType::Accept);
+  }
+  submitAcceptRequest();
+}
+
+void IoUringAcceptSocket::disableRead() {
+  IoUringSocketEntry::disableRead();
+  ENVOY_LOG(trace, "disable accept, fd = {}", fd_);
+
+  // Stop accepting, so that pending connections are held back by the listen backlog while the
+  // listener is disabled.
+  if (accept_req_ != nullptr && accept_cancel_req_ == nullptr) {
+    accept_cancel_req_ = parent_.submitCancelRequest(*this, accept_req_);
+  }
+}
+
+void IoUringAcceptSocket::onAccept(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onAccept(req, result, injected);
+
+  ENVOY_LOG(trace, "onAccept with result {}, fd = {}, injected = {}, status_ = {}", result, fd_,
+            injected, static_cast<int>(status_));
+  if (!injected) {
+    if (!(req->completionFlags() & IORING_CQE_F_MORE)) {
+      accept_req_ = nullptr;
+    }
+    if (result >= 0) {
+      if (status_ == Closed) {
+        Api::OsSysCallsSingleton::get().close(result);
+      } else {
+        accepted_fds_.push_back(result);
+      }
+    } else if (result != -ECANCELED) {
+      ENVOY_LOG(debug, "multishot accept failed, fd = {}, error = {}", fd_, errorDetails(-result));
+    }
+
+    if (status_ == Closed) {
+      if (accept_req_ == nullptr && accept_cancel_req_ == nullptr) {
+        cleanup();
+      }
+      return;
+    }
+    // The request terminates on errors. Arm a new one unless the listener is disabled.
+    if (status_ == ReadEnabled) {
+      submitAcceptRequest();
+    }
+  }
+
+  if (status_ == ReadEnabled && !accepted_fds_.empty()) {
+    THROW_IF_NOT_OK(cb_(Event::FileReadyType::Read));
+    // The listener may stop before taking every accepted connection. Fire again to emulate the
+    // level triggered file event it expects.
+    if (status_ == ReadEnabled && !accepted_fds_.empty()) {
+      injectCompletion(Request::RequestType::Accept);
+    }
+  }
+}
+
+void IoUringAcceptSocket::onCancel(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onCancel(req, result, injected);
+  ASSERT(!injected);
+  if (accept_cancel_req_ == req) {
+    accept_cancel_req_ = nullptr;
+  }
+  if (status_ == Closed && accept_req_ == nullptr && accept_cancel_req_ == nullptr) {
+    cleanup();
+  }
+}
+
+os_fd_t IoUringAcceptSocket::takeAcceptedFd() {
+  if (accepted_fds_.empty()) {
+    return INVALID_SOCKET;
+  }
+  os_fd_t fd = accepted_fds_.front();
+  accepted_fds_.pop_front();
+  return fd;
+}
+
+void IoUringAcceptSocket::submitAcceptRequest() {
+  if (accept_req_ == nullptr) {
+    accept_req_ = parent_.submitAcceptMultishotRequest(*this);
+  }
+}
+
+void IoUringAcceptSocket::closeAcceptedFds() {
+  for (os_fd_t fd : accepted_fds_) {
+    Api::OsSysCallsSingleton::get().close(fd);
+  }
+  accepted_fds_.clear();
+}
+
 IoUringClientSocket::IoUringClientSocket(os_fd_t fd, IoUringWorkerImpl& parent,
                                          Event::FileReadyCb cb, uint32_t write_timeout_ms,
                                          bool enable_close_event)
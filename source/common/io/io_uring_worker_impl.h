@@ -1,5 +1,7 @@
 #pragma once
 
+#include <deque>
+
 #include "envoy/common/io/io_uring.h"
 
 #include "source/common/buffer/buffer_impl.h"
@@ -25,6 +27,16 @@ public:
   std::unique_ptr<struct iovec[]> iov_;
 };
 
+class SendZcRequest : public WriteRequest {
+public:
+  SendZcRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices);
+
+  struct msghdr msg_ {};
+  // The result of the first completion, which is only acted on once the notification completion
+  // has released the buffers.
+  int32_t result_{0};
+};
+
 class IoUringSocketEntry;
 using IoUringSocketEntryPtr = std::unique_ptr<IoUringSocketEntry>;
 
@@ -32,11 +44,14 @@ class IoUringWorkerImpl : public IoUringWorker, private Logger::Loggable<Logger:
 public:
   IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                     uint32_t read_buffer_size, uint32_t write_timeout_ms,
-                    Event::Dispatcher& dispatcher);
+                    Event::Dispatcher& dispatcher, const IoUringOptions& options = {});
   IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size, uint32_t write_timeout_ms,
-                    Event::Dispatcher& dispatcher);
+                    Event::Dispatcher& dispatcher, const IoUringOptions& options = {});
   ~IoUringWorkerImpl() override;
 
+  // The number of requests a socket submits before its file descriptor is registered.
+  static constexpr uint32_t RegisterFileAfterRequests = 32;
+
   // IoUringWorker
   IoUringSocket& addServerSocket(os_fd_t fd, Event::FileReadyCb cb,
                                  bool enable_close_event) override;
@@ -44,6 +59,7 @@ public:
                                  bool enable_close_event) override;
   IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb,
                                  bool enable_close_event) override;
+  OptRef<IoUringSocket> addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb) override;
 
   Request* submitConnectRequest(IoUringSocket& socket,
                                 const Network::Address::InstanceConstSharedPtr& address) override;
@@ -64,9 +80,32 @@ public:
   // Return the number of sockets in this worker.
   uint32_t getNumOfSockets() const override { return sockets_.size(); }
 
+  // Submit a multishot accept request for a listening socket.
+  Request* submitAcceptMultishotRequest(IoUringSocket& socket);
+  // Submit a multishot recv request for a socket. Only valid if multishotRecvEnabled().
+  Request* submitRecvMultishotRequest(IoUringSocket& socket);
+  // Submit a zero copy send request for a socket. Only valid if zeroCopySendThreshold() > 0.
+  Request* submitSendZcRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices);
+
+  // Whether sockets read with multishot recv requests.
+  bool multishotRecvEnabled() const { return multishot_recv_enabled_; }
+  // The minimum size of a write which is sent with zero copy send, 0 if zero copy send is disabled.
+  uint32_t zeroCopySendThreshold() const { return zero_copy_send_threshold_; }
+  // Append the data of a completion with a provided buffer to the buffer and recycle the provided
+  // buffer.
+  void moveProvidedBufferData(uint32_t completion_flags, uint32_t length, Buffer::Instance& buffer);
+  // Recycle the provided buffer of a completion without consuming its data.
+  void recycleProvidedBuffer(uint32_t completion_flags);
+  // Release the registered file slot of a socket, if it has one. This must happen before the file
+  // descriptor is closed or handed back to its owner, since a new socket may reuse the number.
+  void unregisterFile(IoUringSocketEntry& socket);
+
 protected:
   // Add a socket to the worker.
   IoUringSocketEntry& addSocket(IoUringSocketEntryPtr&& socket);
+  // Count a request submitted for the socket, and register its file descriptor once the socket has
+  // submitted enough requests to pay for registering and unregistering it.
+  void onSubmitRequest(IoUringSocket& socket);
   void onFileEvent();
   void submit();
 
@@ -84,6 +123,11 @@ protected:
   // The IoUringWorker will delay the submit the requests which are submitted in request completion
   // callback.
   bool delay_submit_{false};
+  // The optional io_uring features which are enabled and supported by the kernel.
+  bool multishot_recv_enabled_{false};
+  bool multishot_accept_enabled_{false};
+  bool registered_files_enabled_{false};
+  uint32_t zero_copy_send_threshold_{0};
 };
 
 class IoUringSocketEntry : public IoUringSocket,
@@ -101,6 +145,7 @@ public:
   void close(bool, IoUringSocketOnClosedCb cb = nullptr) override {
     status_ = Closed;
     on_closed_cb_ = cb;
+    parent_.unregisterFile(*this);
   }
   void enableRead() override { status_ = ReadEnabled; }
   void disableRead() override { status_ = ReadDisabled; }
@@ -151,8 +196,12 @@ public:
   const OptRef<WriteParam>& getWriteParam() const override { return write_param_; }
 
   void setFileReadyCb(Event::FileReadyCb cb) override { cb_ = std::move(cb); }
+  // Only listening sockets accept connections.
+  os_fd_t takeAcceptedFd() override { return INVALID_SOCKET; }
 
 protected:
+  friend class IoUringWorkerImpl;
+
   /**
    * For the socket to remove itself from the IoUringWorker and defer deletion.
    */
@@ -170,6 +219,10 @@ protected:
   IoUringSocketStatus status_{Initialized};
   // Deliver the remote close as file read event or file close event.
   bool enable_close_event_{false};
+  // The number of requests submitted for the socket, which decides when to register its file.
+  uint32_t submitted_requests_{0};
+  // Whether the file descriptor of the socket takes a registered file slot.
+  bool file_registered_{false};
   // The callback will be invoked when close request is done.
   IoUringSocketOnClosedCb on_closed_cb_{nullptr};
   // This object stores the data get from read request.
@@ -242,6 +295,11 @@ protected:
   Request* write_or_shutdown_cancel_req_{nullptr};
   // This is used for tracking the close request.
   Request* close_req_{nullptr};
+  // Whether read_req_ is a multishot recv request.
+  bool read_multishot_{false};
+  // Set when a multishot recv request is terminated because the provided buffer ring ran dry. The
+  // next read is submitted as a regular read request, which brings its own buffer.
+  bool provided_buffers_exhausted_{false};
 
   void closeInternal();
   void submitReadRequest();
@@ -251,6 +309,36 @@ protected:
   void onWriteCompleted(int32_t result);
 };
 
+/**
+ * A listening socket which accepts connections with a single multishot accept request. Accepted
+ * connections are queued until the listener takes them with takeAcceptedFd(). The listening file
+ * descriptor is owned by the IoHandle, so the socket never closes it.
+ */
+class IoUringAcceptSocket : public IoUringSocketEntry {
+public:
+  IoUringAcceptSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb);
+  ~IoUringAcceptSocket() override;
+
+  // IoUringSocket
+  void close(bool keep_fd_open, IoUringSocketOnClosedCb cb = nullptr) override;
+  void enableRead() override;
+  void disableRead() override;
+  void write(Buffer::Instance&) override { PANIC("not implemented"); }
+  uint64_t write(const Buffer::RawSlice*, uint64_t) override { PANIC("not implemented"); }
+  void shutdown(int) override { PANIC("not implemented"); }
+  void onAccept(Request* req, int32_t result, bool injected) override;
+  void onCancel(Request* req, int32_t result, bool injected) override;
+  os_fd_t takeAcceptedFd() override;
+
+private:
+  void submitAcceptRequest();
+  void closeAcceptedFds();
+
+  Request* accept_req_{nullptr};
+  Request* accept_cancel_req_{nullptr};
+  std::deque<os_fd_t> accepted_fds_;
+};
+
 class IoUringClientSocket : public IoUringServerSocket {
 public:
   IoUringClientSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb,
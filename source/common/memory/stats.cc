@@ -2,6 +2,7 @@
 
 #include <cstdint>
 
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/logger.h"
 
@@ -116,6 +117,7 @@ AllocatorManager::AllocatorManager(
       allocator_manager_stats_(MemoryAllocatorManagerStats{
           MEMORY_ALLOCATOR_MANAGER_STATS(POOL_COUNTER_PREFIX(scope, "tcmalloc."))}),
       api_(api) {
+  Buffer::SlicePool::setMaxFreeBlocksPerThread(config.slice_pool_max_free_blocks_per_thread());
 #if defined(GPERFTOOLS_TCMALLOC)
   if (bytes_to_release_ > 0) {
     ENVOY_LOG_MISC(error,
@@ -128,6 +130,7 @@ AllocatorManager::AllocatorManager(
 };
 
 AllocatorManager::~AllocatorManager() {
+  Buffer::SlicePool::setMaxFreeBlocksPerThread(0);
 #if defined(TCMALLOC)
   if (tcmalloc_routine_dispatcher_) {
     tcmalloc_routine_dispatcher_->exit();
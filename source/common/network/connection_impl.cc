@@ -87,7 +87,7 @@ ConnectionImpl::ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPt
       write_buffer_above_high_watermark_(false), detect_early_close_(true),
       enable_half_close_(false), read_end_stream_raised_(false), read_end_stream_(false),
       write_end_stream_(false), current_write_end_stream_(false), dispatch_buffered_data_(false),
-      transport_wants_read_(false) {
+      transport_wants_read_(false), write_flush_deferred_(false) {
 
   if (!socket_->isOpen()) {
     IS_ENVOY_BUG("Client socket failure");
@@ -277,6 +277,11 @@ void ConnectionImpl::closeSocket(ConnectionEvent close_type) {
     delayed_close_timer_ = nullptr;
   }
 
+  if (write_flush_deferred_) {
+    dispatcher_.cancelDeferredFlush(*this);
+    write_flush_deferred_ = false;
+  }
+
   ENVOY_CONN_LOG(debug, "closing socket: {}", *this, static_cast<uint32_t>(close_type));
   transport_socket_->closeSocket(close_type);
 
@@ -542,12 +547,22 @@ void ConnectionImpl::write(Buffer::Instance& data, bool end_stream, bool through
     // Activating a write event before the socket is connected has the side-effect of tricking
     // doWriteReady into thinking the socket is connected. On macOS, the underlying write may fail
     // with a connection error if a call to write(2) occurs before the connection is completed.
-    if (!connecting_) {
-      ioHandle().activateFileEvents(Event::FileReadyType::Write);
+    if (!connecting_ && !write_flush_deferred_) {
+      if (dispatcher_.deferFlush(*this)) {
+        write_flush_deferred_ = true;
+      } else {
+        ioHandle().activateFileEvents(Event::FileReadyType::Write);
+      }
     }
   }
 }
 
+void ConnectionImpl::onDeferredFlush() {
+  ASSERT(write_flush_deferred_);
+  write_flush_deferred_ = false;
+  onFileEvent(Event::FileReadyType::Write);
+}
+
 void ConnectionImpl::setBufferLimits(uint32_t limit) {
   read_buffer_limit_ = limit;
 
@@ -47,7 +47,9 @@ public:
  * Implementation of Network::Connection, Network::FilterManagerConnection and
  * Envoy::ScopeTrackedObject.
  */
-class ConnectionImpl : public ConnectionImplBase, public TransportSocketCallbacks {
+class ConnectionImpl : public ConnectionImplBase,
+                       public TransportSocketCallbacks,
+                       public Event::DeferredFlushCallback {
 public:
   ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPtr&& socket,
                  TransportSocketPtr&& transport_socket, StreamInfo::StreamInfo& stream_info,
@@ -149,6 +151,9 @@ public:
   // ScopeTrackedObject
   void dumpState(std::ostream& os, int indent_level) const override;
 
+  // Event::DeferredFlushCallback
+  void onDeferredFlush() override;
+
   DetectedCloseType detectedCloseType() const override { return detected_close_type_; }
 
 protected:
@@ -245,6 +250,8 @@ private:
   // read_disable_count_ == 0 to ensure that read resumption happens when remaining bytes are held
   // in transport socket internal buffers.
   bool transport_wants_read_ : 1;
+  // True while a write flush is queued with the dispatcher via deferFlush().
+  bool write_flush_deferred_ : 1;
 };
 
 class ServerConnectionImpl : public ConnectionImpl, virtual public ServerConnection {
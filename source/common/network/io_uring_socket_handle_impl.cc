@@ -39,9 +39,16 @@ IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
   // is still available.
   // TODO(zhxie): for current usage of server socket and client socket, the check may be
   // redundant.
-  if (io_uring_socket_type_ != IoUringSocketType::Unknown &&
-      io_uring_socket_type_ != IoUringSocketType::Accept &&
-      io_uring_worker_factory_.currentThreadRegistered() && io_uring_socket_.has_value()) {
+  if (io_uring_socket_type_ == IoUringSocketType::Accept) {
+    // A listening socket accepting with multishot accept has to stop accepting before the file
+    // descriptor is closed.
+    if (io_uring_worker_factory_.currentThreadRegistered() && io_uring_socket_.has_value() &&
+        io_uring_socket_->getStatus() != Io::IoUringSocketStatus::Closed) {
+      io_uring_socket_.ref().close(true);
+    }
+    ::close(fd_);
+  } else if (io_uring_socket_type_ != IoUringSocketType::Unknown &&
+             io_uring_worker_factory_.currentThreadRegistered() && io_uring_socket_.has_value()) {
     if (io_uring_socket_->getStatus() != Io::IoUringSocketStatus::Closed) {
       io_uring_socket_.ref().close(false);
     }
@@ -62,6 +69,11 @@ Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
     if (file_event_) {
       file_event_.reset();
     }
+    if (io_uring_socket_.has_value()) {
+      // Stop the multishot accept of the listening socket, which keeps the file descriptor open.
+      io_uring_socket_.ref().close(true);
+      io_uring_socket_.reset();
+    }
     ::close(fd_);
   } else {
     io_uring_socket_.ref().close(false);
@@ -186,6 +198,22 @@ IoHandlePtr IoUringSocketHandleImpl::accept(struct sockaddr* addr, socklen_t* ad
 
   ASSERT(io_uring_socket_type_ == IoUringSocketType::Accept);
 
+  if (io_uring_socket_.has_value()) {
+    // The connection has already been accepted by the multishot accept request, which does not
+    // report the peer address. Connections whose peer is already gone are dropped.
+    const socklen_t max_addrlen = *addrlen;
+    for (os_fd_t fd = io_uring_socket_->takeAcceptedFd(); SOCKET_VALID(fd);
+         fd = io_uring_socket_->takeAcceptedFd()) {
+      *addrlen = max_addrlen;
+      if (Api::OsSysCallsSingleton::get().getpeername(fd, addr, addrlen).return_value_ == 0) {
+        return std::make_unique<IoUringSocketHandleImpl>(io_uring_worker_factory_, fd,
+                                                         socket_v6only_, domain_, true);
+      }
+      Api::OsSysCallsSingleton::get().close(fd);
+    }
+    return nullptr;
+  }
+
   Envoy::Api::SysCallSocketResult result =
       Api::OsSysCallsSingleton::get().accept(fd_, addr, addrlen);
   if (SOCKET_INVALID(result.return_value_)) {
@@ -276,9 +304,20 @@ void IoUringSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher,
   }
 
   switch (io_uring_socket_type_) {
-  case IoUringSocketType::Accept:
-    file_event_ = dispatcher.createFileEvent(fd_, cb, trigger, events);
+  case IoUringSocketType::Accept: {
+    // Fall back to accepting through the event loop if multishot accept is not available or the
+    // listener is initialized on a thread without an io_uring worker.
+    OptRef<Io::IoUringWorker> worker = io_uring_worker_factory_.getIoUringWorker();
+    if (worker.has_value()) {
+      io_uring_socket_ = worker->addAcceptSocket(fd_, cb);
+    }
+    if (!io_uring_socket_.has_value()) {
+      file_event_ = dispatcher.createFileEvent(fd_, cb, trigger, events);
+    } else if (!(events & Event::FileReadyType::Read)) {
+      io_uring_socket_->disableRead();
+    }
     break;
+  }
   case IoUringSocketType::Server:
     io_uring_socket_ = io_uring_worker_factory_.getIoUringWorker()->addServerSocket(
         fd_, std::move(cb), events & Event::FileReadyType::Closed);
@@ -297,6 +336,12 @@ void IoUringSocketHandleImpl::activateFileEvents(uint32_t events) {
             ioUringSocketTypeStr());
 
   if (io_uring_socket_type_ == IoUringSocketType::Accept) {
+    if (io_uring_socket_.has_value()) {
+      if (events & Event::FileReadyType::Read) {
+        io_uring_socket_->injectCompletion(Io::Request::RequestType::Accept);
+      }
+      return;
+    }
     ASSERT(file_event_ != nullptr);
     file_event_->activate(events);
     return;
@@ -315,6 +360,14 @@ void IoUringSocketHandleImpl::enableFileEvents(uint32_t events) {
             ioUringSocketTypeStr());
 
   if (io_uring_socket_type_ == IoUringSocketType::Accept) {
+    if (io_uring_socket_.has_value()) {
+      if (events & Event::FileReadyType::Read) {
+        io_uring_socket_->enableRead();
+      } else {
+        io_uring_socket_->disableRead();
+      }
+      return;
+    }
     ASSERT(file_event_ != nullptr);
     file_event_->setEnabled(events);
     return;
@@ -333,6 +386,10 @@ void IoUringSocketHandleImpl::resetFileEvents() {
 
   if (io_uring_socket_type_ == IoUringSocketType::Accept) {
     file_event_.reset();
+    if (io_uring_socket_.has_value()) {
+      io_uring_socket_.ref().close(true);
+      io_uring_socket_.reset();
+    }
     return;
   }
 
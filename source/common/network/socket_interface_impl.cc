@@ -172,13 +172,21 @@ Server::BootstrapExtensionPtr SocketInterfaceImpl::createBootstrapExtension(
       const envoy::extensions::network::socket_interface::v3::DefaultSocketInterface&>(
       config, context.messageValidationVisitor());
   if (message.enable_io_uring() && Io::isIoUringSupported()) {
+    Io::IoUringOptions options;
+    options.provided_buffers_ =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(message, io_uring_provided_buffers, 0);
+    options.multishot_accept_ = message.enable_io_uring_multishot_accept();
+    options.registered_files_ =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(message, io_uring_registered_files, 0);
+    options.zero_copy_send_threshold_ =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(message, io_uring_zero_copy_send_threshold, 0);
     std::shared_ptr<Io::IoUringWorkerFactoryImpl> io_uring_worker_factory =
         std::make_shared<Io::IoUringWorkerFactoryImpl>(
             PROTOBUF_GET_WRAPPED_OR_DEFAULT(message, io_uring_size, 1000),
             message.enable_io_uring_submission_queue_polling(),
             PROTOBUF_GET_WRAPPED_OR_DEFAULT(message, io_uring_read_buffer_size, 8192),
             PROTOBUF_GET_WRAPPED_OR_DEFAULT(message, io_uring_write_timeout_ms, 1000),
-            context.threadLocal());
+            context.threadLocal(), options);
     io_uring_worker_factory_ = io_uring_worker_factory;
 
     return std::make_unique<DefaultSocketInterfaceExtension>(*this, io_uring_worker_factory);
@@ -137,6 +137,22 @@ void UdpListenerImpl::processPacket(Address::InstanceConstSharedPtr local_addres
   cb_.onData(std::move(recvData));
 }
 
+UdpPacketArena* UdpListenerImpl::packetArena() {
+  if (!cb_.supportsPacketBatches()) {
+    return nullptr;
+  }
+  if (packet_arena_ == nullptr) {
+    packet_arena_ =
+        std::make_unique<UdpPacketArena>(NUM_DATAGRAMS_PER_RECEIVE, config_.max_rx_datagram_size_);
+  }
+  return packet_arena_.get();
+}
+
+void UdpListenerImpl::processPacketBatch(absl::Span<const UdpRecvPacket> packets) {
+  ASSERT(!packets.empty());
+  cb_.onDataBatch(packets);
+}
+
 void UdpListenerImpl::handleWriteCallback() {
   ENVOY_UDP_LOG(trace, "handleWriteCallback");
   cb_.onWriteReady(*socket_);
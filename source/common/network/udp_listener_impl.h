@@ -56,6 +56,8 @@ public:
   const IoHandle::UdpSaveCmsgConfig& saveCmsgConfig() const override {
     return cb_.udpSaveCmsgConfig();
   }
+  UdpPacketArena* packetArena() override;
+  void processPacketBatch(absl::Span<const UdpRecvPacket> packets) override;
 
 protected:
   void handleWriteCallback();
@@ -70,6 +72,8 @@ private:
 
   TimeSource& time_source_;
   const ResolvedUdpSocketConfig config_;
+  // The memory datagrams are read into if the callbacks take batches, created on the first read.
+  UdpPacketArenaPtr packet_arena_;
   OptRef<ParentDrainedCallbackRegistrar> parent_drained_callback_registrar_;
   // Taking a weak_ptr to this lets us detect if the listener has been destroyed.
   std::shared_ptr<bool> destruction_checker_ = std::make_shared<bool>(true);
@@ -0,0 +1,20 @@
+#include "source/common/network/udp_packet_arena.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Network {
+
+UdpPacketArena::UdpPacketArena(uint64_t num_datagrams, uint64_t max_datagram_size)
+    : max_datagram_size_(max_datagram_size),
+      size_(std::max(MaxGroReadSize, num_datagrams * max_datagram_size)),
+      memory_(std::make_unique<uint8_t[]>(size_)),
+      datagram_slices_(num_datagrams, absl::FixedArray<Buffer::RawSlice>(1)) {
+  ASSERT(num_datagrams > 0 && max_datagram_size > 0);
+  for (uint64_t i = 0; i < num_datagrams; i++) {
+    datagram_slices_[i][0] = {memory_.get() + i * max_datagram_size, max_datagram_size};
+  }
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/network/io_handle.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * A fixed-size block of memory that UDP datagrams are read into, and which is reused by every read
+ * of a socket. Datagrams read into the arena are only valid until the next read, so the reader
+ * passes them on as views rather than as buffers of their own.
+ */
+class UdpPacketArena {
+public:
+  // The largest read with GRO, as the kernel coalesces at most 64KiB of datagrams.
+  static constexpr uint64_t MaxGroReadSize = 64 * 1024;
+
+  /**
+   * @param num_datagrams supplies the number of datagrams read by a single recvmmsg call.
+   * @param max_datagram_size supplies the size of each of these datagrams.
+   */
+  UdpPacketArena(uint64_t num_datagrams, uint64_t max_datagram_size);
+
+  /**
+   * @return the arena split into one slice per datagram, as passed to recvmmsg.
+   */
+  RawSliceArrays& datagramSlices() { return datagram_slices_; }
+
+  /**
+   * @param length supplies the length of the slice, which must be at most size().
+   * @return a single slice of the arena, as passed to recvmsg.
+   */
+  Buffer::RawSlice slice(uint64_t length) {
+    ASSERT(length <= size_);
+    return {memory_.get(), length};
+  }
+
+  /**
+   * @return the size of the arena, which is at least MaxGroReadSize.
+   */
+  uint64_t size() const { return size_; }
+
+  /**
+   * @return the size of each datagram read by recvmmsg.
+   */
+  uint64_t maxDatagramSize() const { return max_datagram_size_; }
+
+private:
+  const uint64_t max_datagram_size_;
+  const uint64_t size_;
+  const std::unique_ptr<uint8_t[]> memory_;
+  RawSliceArrays datagram_slices_;
+};
+
+using UdpPacketArenaPtr = std::unique_ptr<UdpPacketArena>;
+
+} // namespace Network
+} // namespace Envoy
@@ -29,6 +29,7 @@
 #include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 
@@ -547,11 +548,8 @@ Api::IoCallUint64Result Utility::writeToSocket(IoHandle& handle, Buffer::RawSlic
 
 namespace {
 
-void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
-                            Address::InstanceConstSharedPtr peer_addess,
-                            Address::InstanceConstSharedPtr local_address,
-                            UdpPacketProcessor& udp_packet_processor, MonotonicTime receive_time,
-                            uint8_t tos, Buffer::OwnedImpl saved_cmsg) {
+void checkPeerAddress(uint64_t bytes_read, const Address::InstanceConstSharedPtr& peer_addess,
+                      const Address::InstanceConstSharedPtr& local_address) {
   ENVOY_BUG(peer_addess != nullptr,
             fmt::format("Unable to get remote address on the socket bound to local address: {}.",
                         (local_address == nullptr ? "unknown" : local_address->asString())));
@@ -563,6 +561,14 @@ void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
                         peer_addess->asString(),
                         (local_address == nullptr ? "unknown" : local_address->asString()),
                         bytes_read));
+}
+
+void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
+                            Address::InstanceConstSharedPtr peer_addess,
+                            Address::InstanceConstSharedPtr local_address,
+                            UdpPacketProcessor& udp_packet_processor, MonotonicTime receive_time,
+                            uint8_t tos, Buffer::OwnedImpl saved_cmsg) {
+  checkPeerAddress(bytes_read, peer_addess, local_address);
   udp_packet_processor.processPacket(std::move(local_address), std::move(peer_addess),
                                      std::move(buffer), receive_time, tos, std::move(saved_cmsg));
 }
@@ -725,6 +731,118 @@ Api::IoCallUint64Result readFromSocketRecvMsg(IoHandle& handle,
   return result;
 }
 
+// The datagrams of a single read into an arena, which refer to the memory of the arena. Sized for
+// the datagrams of a GRO read of QUIC packets, which are at least 1200 bytes long.
+using UdpRecvPackets = absl::InlinedVector<UdpRecvPacket, 64>;
+
+absl::string_view savedCmsgView(const Buffer::OwnedImpl& saved_cmsg) {
+  const Buffer::RawSlice slice = saved_cmsg.frontSlice();
+  return {static_cast<const char*>(slice.mem_), slice.len_};
+}
+
+Api::IoCallUint64Result readFromSocketRecvMsgIntoArena(IoHandle& handle,
+                                                       const Address::Instance& local_address,
+                                                       UdpPacketProcessor& udp_packet_processor,
+                                                       UdpPacketArena& arena, bool use_gro,
+                                                       MonotonicTime receive_time,
+                                                       uint32_t* packets_dropped,
+                                                       uint32_t* num_packets_read) {
+  ASSERT(!use_gro || Api::OsSysCallsSingleton::get().supportsUdpGro(),
+         "cannot use GRO when the platform doesn't support it.");
+  if (num_packets_read != nullptr) {
+    *num_packets_read = 0;
+  }
+  uint64_t max_rx_size = udp_packet_processor.maxDatagramSize();
+  if (use_gro) {
+    max_rx_size = num_packets_read != nullptr ? UdpPacketArena::MaxGroReadSize
+                                              : NUM_DATAGRAMS_PER_RECEIVE * max_rx_size;
+  }
+  Buffer::RawSlice slice = arena.slice(max_rx_size);
+  IoHandle::RecvMsgOutput output(1, packets_dropped);
+  ENVOY_LOG_MISC(trace, "starting recvmsg into arena with max={} gro={}", max_rx_size, use_gro);
+  Api::IoCallUint64Result result = handle.recvmsg(&slice, 1, local_address.ip()->port(),
+                                                  udp_packet_processor.saveCmsgConfig(), output);
+  if (!result.ok() || output.msg_[0].truncated_and_dropped_) {
+    return result;
+  }
+
+  IoHandle::RecvMsgPerPacketInfo& info = output.msg_[0];
+  const uint64_t bytes_read = std::min(max_rx_size, result.return_value_);
+  ENVOY_LOG_MISC(trace, "recvmsg bytes {} with gso_size as {}", bytes_read, info.gso_size_);
+  checkPeerAddress(bytes_read, info.peer_address_, info.local_address_);
+
+  // Split the payload read with GRO into its gso_sized datagrams, which stay in the arena.
+  const uint64_t segment_size = info.gso_size_ == 0 ? bytes_read : info.gso_size_;
+  const char* payload = static_cast<const char*>(slice.mem_);
+  UdpRecvPackets packets;
+  uint64_t offset = 0;
+  do {
+    const uint64_t length = std::min(segment_size, bytes_read - offset);
+    packets.push_back({{info.local_address_, info.peer_address_},
+                       absl::string_view(payload + offset, length),
+                       receive_time,
+                       info.tos_,
+                       savedCmsgView(info.saved_cmsg_)});
+    offset += length;
+  } while (offset < bytes_read);
+
+  if (num_packets_read != nullptr) {
+    *num_packets_read = packets.size();
+  }
+  udp_packet_processor.processPacketBatch(packets);
+  return result;
+}
+
+Api::IoCallUint64Result readFromSocketRecvMmsgIntoArena(IoHandle& handle,
+                                                        const Address::Instance& local_address,
+                                                        UdpPacketProcessor& udp_packet_processor,
+                                                        UdpPacketArena& arena,
+                                                        MonotonicTime receive_time,
+                                                        uint32_t* packets_dropped,
+                                                        uint32_t* num_packets_read) {
+  ASSERT(Api::OsSysCallsSingleton::get().supportsMmsg(),
+         "cannot use recvmmsg when the platform doesn't support it.");
+  ASSERT(arena.maxDatagramSize() == udp_packet_processor.maxDatagramSize());
+  if (num_packets_read != nullptr) {
+    *num_packets_read = 0;
+  }
+  RawSliceArrays& slices = arena.datagramSlices();
+  IoHandle::RecvMsgOutput output(slices.size(), packets_dropped);
+  ENVOY_LOG_MISC(trace, "starting recvmmsg into arena with packets={} max={}", slices.size(),
+                 arena.maxDatagramSize());
+  Api::IoCallUint64Result result = handle.recvmmsg(slices, local_address.ip()->port(),
+                                                   udp_packet_processor.saveCmsgConfig(), output);
+  if (!result.ok()) {
+    return result;
+  }
+
+  const uint64_t packets_read = result.return_value_;
+  ENVOY_LOG_MISC(trace, "recvmmsg read {} packets", packets_read);
+  UdpRecvPackets packets;
+  for (uint64_t i = 0; i < packets_read; ++i) {
+    IoHandle::RecvMsgPerPacketInfo& info = output.msg_[i];
+    if (info.truncated_and_dropped_) {
+      continue;
+    }
+    const Buffer::RawSlice& slice = slices[i][0];
+    const uint64_t msg_len = std::min<uint64_t>(info.msg_len_, slice.len_);
+    checkPeerAddress(msg_len, info.peer_address_, info.local_address_);
+    packets.push_back({{info.local_address_, info.peer_address_},
+                       absl::string_view(static_cast<const char*>(slice.mem_), msg_len),
+                       receive_time,
+                       info.tos_,
+                       savedCmsgView(info.saved_cmsg_)});
+  }
+
+  if (num_packets_read != nullptr) {
+    *num_packets_read = packets.size();
+  }
+  if (!packets.empty()) {
+    udp_packet_processor.processPacketBatch(packets);
+  }
+  return result;
+}
+
 } // namespace
 
 Api::IoCallUint64Result
@@ -732,6 +850,17 @@ Utility::readFromSocket(IoHandle& handle, const Address::Instance& local_address
                         UdpPacketProcessor& udp_packet_processor, MonotonicTime receive_time,
                         UdpRecvMsgMethod recv_msg_method, uint32_t* packets_dropped,
                         uint32_t* num_packets_read) {
+  UdpPacketArena* arena = udp_packet_processor.packetArena();
+  if (arena != nullptr) {
+    if (recv_msg_method == UdpRecvMsgMethod::RecvMmsg) {
+      return readFromSocketRecvMmsgIntoArena(handle, local_address, udp_packet_processor, *arena,
+                                             receive_time, packets_dropped, num_packets_read);
+    }
+    return readFromSocketRecvMsgIntoArena(
+        handle, local_address, udp_packet_processor, *arena,
+        recv_msg_method == UdpRecvMsgMethod::RecvMsgWithGro, receive_time, packets_dropped,
+        num_packets_read);
+  }
   if (recv_msg_method == UdpRecvMsgMethod::RecvMsgWithGro) {
     return readFromSocketRecvGro(handle, local_address, udp_packet_processor, receive_time,
                                  packets_dropped, num_packets_read);
@@ -9,7 +9,9 @@
 #include "envoy/network/connection.h"
 #include "envoy/network/listener.h"
 
+#include "source/common/common/assert.h"
 #include "source/common/common/statusor.h"
+#include "source/common/network/udp_packet_arena.h"
 
 #include "absl/strings/string_view.h"
 
@@ -55,6 +57,21 @@ public:
   virtual size_t numPacketsExpectedPerEventLoop() const PURE;
 
   virtual const IoHandle::UdpSaveCmsgConfig& saveCmsgConfig() const PURE;
+
+  /**
+   * The arena to read datagrams into, in which case the datagrams of each read are passed to
+   * processPacketBatch() instead of processPacket(). If nullptr, each datagram is read into a
+   * buffer of its own.
+   */
+  virtual UdpPacketArena* packetArena() { return nullptr; }
+
+  /**
+   * Consume the datagrams read out of the socket by a single read into packetArena().
+   * @param packets contains the datagrams read, whose memory is reused by the next read.
+   */
+  virtual void processPacketBatch(absl::Span<const UdpRecvPacket> /*packets*/) {
+    IS_ENVOY_BUG("processPacketBatch() called on a processor without a packet arena");
+  }
 };
 
 static const uint64_t DEFAULT_UDP_MAX_DATAGRAM_SIZE = 1500;
@@ -49,6 +49,9 @@ ActiveQuicListener::ActiveQuicListener(
       version_manager_(reject_new_connections ? quic::ParsedQuicVersionVector()
                                               : quic::CurrentSupportedHttp3Versions()),
       kernel_worker_routing_(kernel_worker_routing),
+      packet_batches_(Runtime::runtimeFeatureEnabled(
+                          "envoy.reloadable_features.quic_listener_packet_batches") &&
+                      (kernel_worker_routing || concurrency == 1)),
       packets_to_read_to_connection_count_ratio_(packets_to_read_to_connection_count_ratio),
       crypto_server_stream_factory_(crypto_server_stream_factory),
       connection_id_generator_(std::move(cid_generator)),
@@ -138,30 +141,36 @@ void ActiveQuicListener::onListenerShutdown() {
   udp_listener_.reset();
 }
 
+bool ActiveQuicListener::dispatchPacket(const Network::UdpRecvData::LocalPeerAddresses& addresses,
+                                        absl::string_view payload, MonotonicTime receive_time,
+                                        uint8_t tos, absl::string_view saved_cmsg) {
+  quic::QuicSocketAddress peer_address(envoyIpAddressToQuicSocketAddress(addresses.peer_->ip()));
+  quic::QuicSocketAddress self_address(envoyIpAddressToQuicSocketAddress(addresses.local_->ip()));
+  quic::QuicTime timestamp =
+      quic::QuicTime::Zero() +
+      quic::QuicTime::Delta::FromMicroseconds(
+          std::chrono::duration_cast<std::chrono::microseconds>(receive_time.time_since_epoch())
+              .count());
+  // TODO(danzh): pass in TTL and UDP header.
+  quic::QuicReceivedPacket packet(payload.data(), payload.size(), timestamp,
+                                  /*owns_buffer=*/false, /*ttl=*/0, /*ttl_valid=*/false,
+                                  const_cast<char*>(saved_cmsg.data()), saved_cmsg.size(),
+                                  /*owns_header_buffer*/ false,
+                                  getQuicEcnCodepointFromTosByte(tos));
+  return quic_dispatcher_->processPacket(self_address, peer_address, packet);
+}
+
 void ActiveQuicListener::onDataWorker(Network::UdpRecvData&& data) {
   if ((enabled_.has_value() && !enabled_.value().enabled()) || reject_all_) {
     return;
   }
 
-  quic::QuicSocketAddress peer_address(
-      envoyIpAddressToQuicSocketAddress(data.addresses_.peer_->ip()));
-  quic::QuicSocketAddress self_address(
-      envoyIpAddressToQuicSocketAddress(data.addresses_.local_->ip()));
-  quic::QuicTime timestamp =
-      quic::QuicTime::Zero() +
-      quic::QuicTime::Delta::FromMicroseconds(std::chrono::duration_cast<std::chrono::microseconds>(
-                                                  data.receive_time_.time_since_epoch())
-                                                  .count());
   Buffer::RawSlice slice = data.buffer_->frontSlice();
   ASSERT(data.buffer_->length() == slice.len_);
-  // TODO(danzh): pass in TTL and UDP header.
-  quic::QuicReceivedPacket packet(reinterpret_cast<char*>(slice.mem_), slice.len_, timestamp,
-                                  /*owns_buffer=*/false, /*ttl=*/0, /*ttl_valid=*/false,
-                                  reinterpret_cast<char*>(data.saved_cmsg_.frontSlice().mem_),
-                                  data.saved_cmsg_.frontSlice().len_,
-                                  /*owns_header_buffer*/ false,
-                                  getQuicEcnCodepointFromTosByte(data.tos_));
-  if (!quic_dispatcher_->processPacket(self_address, peer_address, packet)) {
+  Buffer::RawSlice cmsg_slice = data.saved_cmsg_.frontSlice();
+  if (!dispatchPacket(data.addresses_, {static_cast<const char*>(slice.mem_), slice.len_},
+                      data.receive_time_, data.tos_,
+                      {static_cast<const char*>(cmsg_slice.mem_), cmsg_slice.len_})) {
     if (non_dispatched_udp_packet_handler_.has_value()) {
       non_dispatched_udp_packet_handler_->handle(worker_index_, std::move(data));
     }
@@ -174,6 +183,28 @@ void ActiveQuicListener::onDataWorker(Network::UdpRecvData&& data) {
   }
 }
 
+void ActiveQuicListener::onDataBatch(absl::Span<const Network::UdpRecvPacket> packets) {
+  // Batches are only delivered if every packet stays on this worker.
+  ASSERT(packet_batches_);
+  if ((enabled_.has_value() && !enabled_.value().enabled()) || reject_all_) {
+    return;
+  }
+
+  for (const Network::UdpRecvPacket& packet : packets) {
+    ASSERT(packet.addresses_.local_ != nullptr);
+    if (!dispatchPacket(packet.addresses_, packet.payload_, packet.receive_time_, packet.tos_,
+                        packet.saved_cmsg_) &&
+        non_dispatched_udp_packet_handler_.has_value()) {
+      // The handler is given a copy of the packet that doesn't refer to the arena of the listener.
+      non_dispatched_udp_packet_handler_->handle(worker_index_, copyPacket(packet));
+    }
+  }
+
+  if (quic_dispatcher_->HasChlosBuffered()) {
+    udp_listener_->activateRead();
+  }
+}
+
 void ActiveQuicListener::onReadReady() {
   if (enabled_.has_value() && !enabled_.value().enabled()) {
     ENVOY_LOG(trace, "Quic listener {}: runtime disabled", config_->name());
@@ -59,6 +59,8 @@ public:
   }
   Network::UdpPacketWriter& udpPacketWriter() override { return *udp_packet_writer_; }
   void onDataWorker(Network::UdpRecvData&& data) override;
+  void onDataBatch(absl::Span<const Network::UdpRecvPacket> packets) override;
+  bool supportsPacketBatches() const override { return packet_batches_; }
   uint32_t destination(const Network::UdpRecvData& data) const override;
   size_t numPacketsExpectedPerEventLoop() const override;
   const Network::IoHandle::UdpSaveCmsgConfig& udpSaveCmsgConfig() const override {
@@ -80,6 +82,11 @@ private:
   friend class ActiveQuicListenerPeer;
 
   void closeConnectionsWithFilterChain(const Network::FilterChain* filter_chain);
+  // Passes a datagram to the QUIC dispatcher, which copies it if it has to be kept.
+  // @return whether the datagram was dispatched.
+  bool dispatchPacket(const Network::UdpRecvData::LocalPeerAddresses& addresses,
+                      absl::string_view payload, MonotonicTime receive_time, uint8_t tos,
+                      absl::string_view saved_cmsg);
 
   uint8_t random_seed_[16];
   std::unique_ptr<quic::QuicCryptoServerConfig> crypto_config_;
@@ -87,6 +94,9 @@ private:
   quic::QuicVersionManager version_manager_;
   std::unique_ptr<EnvoyQuicDispatcher> quic_dispatcher_;
   const bool kernel_worker_routing_;
+  // Whether datagrams are read into the arena of the listener and dispatched in batches, which
+  // requires that they aren't routed to other workers.
+  const bool packet_batches_;
   absl::optional<Runtime::FeatureFlag> enabled_{};
   Network::UdpPacketWriter* udp_packet_writer_;
 
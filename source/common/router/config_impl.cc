@@ -54,6 +54,7 @@
 #include "source/extensions/path/rewrite/uri_template/uri_template_rewrite.h"
 
 #include "absl/container/inlined_vector.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
 
 namespace Envoy {
@@ -932,6 +933,12 @@ bool RouteEntryImplBase::matchRoute(const Http::RequestHeaderMap& headers,
   return matches;
 }
 
+bool RouteEntryImplBase::matchesOnPathOnly() const {
+  return runtime_ == nullptr && !match_grpc_ && config_headers_.empty() &&
+         config_query_parameters_.empty() && tls_context_match_criteria_ == nullptr &&
+         dynamic_metadata_.empty();
+}
+
 const std::string& RouteEntryImplBase::clusterName() const { return cluster_name_; }
 
 const std::string
@@ -1992,6 +1999,68 @@ CommonVirtualHostImpl::create(const envoy::config::route::v3::VirtualHost& virtu
   return ret;
 }
 
+std::unique_ptr<const PathRouteIndex>
+PathRouteIndex::create(absl::Span<const RouteEntryImplBaseConstSharedPtr> routes,
+                       bool ignore_path_parameters) {
+  auto index = std::unique_ptr<PathRouteIndex>(new PathRouteIndex(ignore_path_parameters));
+  uint32_t indexed_routes = 0;
+  for (uint32_t position = 0; position < routes.size(); ++position) {
+    const RouteEntryImplBase& route = *routes[position];
+    const PathMatchType type = route.matchType();
+    if ((type != PathMatchType::Prefix && type != PathMatchType::Exact) ||
+        !route.matchesOnPathOnly()) {
+      index->unindexed_routes_.push_back(position);
+      continue;
+    }
+    if (route.case_sensitive()) {
+      index->case_sensitive_.add(type, route.matcher(), position);
+    } else {
+      index->case_insensitive_.add(type, absl::AsciiStrToLower(route.matcher()), position);
+    }
+    ++indexed_routes;
+  }
+  if (indexed_routes < MinIndexedRoutes) {
+    return nullptr;
+  }
+  return index;
+}
+
+void PathRouteIndex::Tables::add(PathMatchType type, absl::string_view key, uint32_t position) {
+  empty_ = false;
+  // Only the first route with a given key can ever be selected.
+  if (type == PathMatchType::Prefix) {
+    prefixes_.add(key, position + 1, false);
+  } else {
+    paths_.try_emplace(key, position);
+  }
+}
+
+uint32_t PathRouteIndex::Tables::findFirst(absl::string_view path) const {
+  uint32_t first = NoRoute;
+  if (const auto it = paths_.find(path); it != paths_.end()) {
+    first = it->second;
+  }
+  prefixes_.visitPrefixes(path, [&first](uint32_t position) {
+    first = std::min(first, position - 1);
+    return true;
+  });
+  return first;
+}
+
+uint32_t PathRouteIndex::findFirst(absl::string_view path) const {
+  // Mirrors RouteEntryImplBase::sanitizePathBeforePathMatching() and Matchers::PathMatcher.
+  if (ignore_path_parameters_) {
+    path = path.substr(0, path.find_first_of(';'));
+  }
+  path = Http::PathUtil::removeQueryAndFragment(path);
+
+  uint32_t first = case_sensitive_.empty_ ? NoRoute : case_sensitive_.findFirst(path);
+  if (!case_insensitive_.empty_) {
+    first = std::min(first, case_insensitive_.findFirst(absl::AsciiStrToLower(path)));
+  }
+  return first;
+}
+
 VirtualHostImpl::VirtualHostImpl(
     const envoy::config::route::v3::VirtualHost& virtual_host,
     const CommonConfigSharedPtr& global_route_config,
@@ -2041,6 +2110,10 @@ VirtualHostImpl::VirtualHostImpl(
       SET_AND_RETURN_IF_NOT_OK(route_or_error.status(), creation_status);
       routes_.emplace_back(route_or_error.value());
     }
+    if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.router_path_index")) {
+      path_index_ = PathRouteIndex::create(
+          routes_, global_route_config->ignorePathParametersInPathMatching());
+    }
   }
 }
 
@@ -2131,40 +2204,50 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return nullptr;
   }
 
-  // Check for a route that matches the request.
+  // Check for a route that matches the request. The index can only be used when the caller
+  // accepts the first matching route.
+  if (path_index_ != nullptr && cb == nullptr && headers.Path() != nullptr) {
+    return getRouteFromPathIndex(headers, stream_info, random_value);
+  }
   return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    absl::string_view host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
-  // We do a longest wildcard match against the host that's passed in
-  // (e.g. "foo-bar.baz.com" should match "*-bar.baz.com" before matching "*.baz.com" for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
+RouteConstSharedPtr
+VirtualHostImpl::getRouteFromPathIndex(const Http::RequestHeaderMap& headers,
+                                       const StreamInfo::StreamInfo& stream_info,
+                                       uint64_t random_value) const {
+  const uint32_t first_indexed = path_index_->findFirst(headers.getPathValue());
+
+  // Routes that are not indexed still win if they come first and match.
+  for (const uint32_t position : path_index_->unindexedRoutes()) {
+    if (position > first_indexed) {
+      break;
     }
-    const auto match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
+    RouteConstSharedPtr route_entry =
+        routes_[position]->matches(headers, stream_info, random_value);
+    if (route_entry != nullptr) {
+      return route_entry;
     }
   }
+
+  if (first_indexed != PathRouteIndex::NoRoute) {
+    return routes_[first_indexed]->matches(headers, stream_info, random_value);
+  }
+
+  ENVOY_LOG(debug, "route was resolved but final route list did not match incoming request");
   return nullptr;
 }
+
 absl::StatusOr<std::unique_ptr<RouteMatcher>>
 RouteMatcher::create(const envoy::config::route::v3::RouteConfiguration& route_config,
                      const CommonConfigSharedPtr& global_route_config,
                      Server::Configuration::ServerFactoryContext& factory_context,
-                     ProtobufMessage::ValidationVisitor& validator, bool validate_clusters) {
+                     ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+                     bool reuse_virtual_hosts, const RouteMatcher* previous) {
   absl::Status creation_status = absl::OkStatus();
-  auto ret = std::unique_ptr<RouteMatcher>{new RouteMatcher(route_config, global_route_config,
-                                                            factory_context, validator,
-                                                            validate_clusters, creation_status)};
+  auto ret = std::unique_ptr<RouteMatcher>{
+      new RouteMatcher(route_config, global_route_config, factory_context, validator,
+                       validate_clusters, reuse_virtual_hosts, previous, creation_status)};
   RETURN_IF_NOT_OK(creation_status);
   return ret;
 }
@@ -2172,6 +2255,7 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
                            const CommonConfigSharedPtr& global_route_config,
                            Server::Configuration::ServerFactoryContext& factory_context,
                            ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+                           bool reuse_virtual_hosts, const RouteMatcher* previous,
                            absl::Status& creation_status)
     : vhost_scope_(factory_context.scope().scopeFromStatName(
           factory_context.routerContext().virtualClusterStatNames().vhost_)),
@@ -2180,15 +2264,34 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
   if (validate_clusters) {
     validation_clusters = factory_context.clusterManager().clusters();
   }
+  ASSERT(previous == nullptr || reuse_virtual_hosts);
+  uint32_t reused_virtual_hosts = 0;
   for (const auto& virtual_host_config : route_config.virtual_hosts()) {
-    VirtualHostSharedPtr virtual_host = std::make_shared<VirtualHostImpl>(
-        virtual_host_config, global_route_config, factory_context, *vhost_scope_, validator,
-        validation_clusters, creation_status);
-    SET_AND_RETURN_IF_NOT_OK(creation_status, creation_status);
+    VirtualHostSharedPtr virtual_host;
+    uint64_t hash = 0;
+    if (reuse_virtual_hosts) {
+      hash = MessageUtil::hash(virtual_host_config);
+      if (previous != nullptr) {
+        if (const auto it = previous->virtual_hosts_by_hash_.find(hash);
+            it != previous->virtual_hosts_by_hash_.end()) {
+          virtual_host = it->second;
+          ++reused_virtual_hosts;
+        }
+      }
+    }
+    if (virtual_host == nullptr) {
+      virtual_host = std::make_shared<VirtualHostImpl>(virtual_host_config, global_route_config,
+                                                       factory_context, *vhost_scope_, validator,
+                                                       validation_clusters, creation_status);
+      SET_AND_RETURN_IF_NOT_OK(creation_status, creation_status);
+    }
+    if (reuse_virtual_hosts) {
+      virtual_hosts_by_hash_.emplace(hash, virtual_host);
+    }
+    virtual_hosts_.push_back(virtual_host);
     for (const std::string& domain_name : virtual_host_config.domains()) {
       const Http::LowerCaseString lower_case_domain_name(domain_name);
       absl::string_view domain = lower_case_domain_name;
-      bool duplicate_found = false;
       if ("*" == domain) {
         if (default_virtual_host_) {
           creation_status = absl::InvalidArgumentError(fmt::format(
@@ -2196,18 +2299,7 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
           return;
         }
         default_virtual_host_ = virtual_host;
-      } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
-      } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
-      } else {
-        duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
-      }
-      if (duplicate_found) {
+      } else if (!domain_matcher_.add(domain, virtual_host.get())) {
         creation_status = absl::InvalidArgumentError(
             fmt::format("Only unique values for domains are permitted. Duplicate "
                         "entry of domain {} in route {}",
@@ -2216,12 +2308,16 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
       }
     }
   }
+  domain_matcher_.compile();
+  if (previous != nullptr) {
+    ENVOY_LOG(debug, "route config {}: reused {} of {} virtual hosts", route_config.name(),
+              reused_virtual_hosts, virtual_hosts_.size());
+  }
 }
 
 const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMap& headers) const {
   // Fast path the case where we only have a default virtual host.
-  if (virtual_hosts_.empty() && wildcard_virtual_host_suffixes_.empty() &&
-      wildcard_virtual_host_prefixes_.empty()) {
+  if (domain_matcher_.empty()) {
     return default_virtual_host_.get();
   }
 
@@ -2243,25 +2339,8 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMa
   // request with VHost, using wildcard match
   // Lower-case the value of the host header, as hostnames are case insensitive.
   const std::string host = absl::AsciiStrToLower(host_header_value);
-  const auto iter = virtual_hosts_.find(host);
-  if (iter != virtual_hosts_.end()) {
-    return iter->second.get();
-  }
-  if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](absl::string_view h, int l) -> absl::string_view { return h.substr(h.size() - l); });
-    if (vhost != nullptr) {
-      return vhost;
-    }
-  }
-  if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](absl::string_view h, int l) -> absl::string_view { return h.substr(0, l); });
-    if (vhost != nullptr) {
-      return vhost;
-    }
+  if (const VirtualHostImpl* vhost = domain_matcher_.find(host); vhost != nullptr) {
+    return vhost;
   }
   return default_virtual_host_.get();
 }
@@ -2394,25 +2473,73 @@ create(const envoy::config::route::v3::RouteConfiguration& config,
 absl::StatusOr<std::shared_ptr<ConfigImpl>>
 ConfigImpl::create(const envoy::config::route::v3::RouteConfiguration& config,
                    Server::Configuration::ServerFactoryContext& factory_context,
-                   ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default) {
+                   ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default,
+                   const ConfigImpl* previous) {
   absl::Status creation_status = absl::OkStatus();
   auto ret = std::shared_ptr<ConfigImpl>(new ConfigImpl(
-      config, factory_context, validator, validate_clusters_default, creation_status));
+      config, factory_context, validator, validate_clusters_default, creation_status, previous));
   RETURN_IF_NOT_OK(creation_status);
   return ret;
 }
 
+namespace {
+
+const Protobuf::FieldMask& fieldsOutsideVirtualHosts() {
+  CONSTRUCT_ON_FIRST_USE(Protobuf::FieldMask, []() {
+    Protobuf::FieldMask mask;
+    const Protobuf::Descriptor* descriptor =
+        envoy::config::route::v3::RouteConfiguration::descriptor();
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+      if (descriptor->field(i)->number() !=
+          envoy::config::route::v3::RouteConfiguration::kVirtualHostsFieldNumber) {
+        mask.add_paths(std::string(descriptor->field(i)->name()));
+      }
+    }
+    return mask;
+  }());
+}
+
+// Hashes everything in the route configuration except for the virtual hosts, without copying them.
+uint64_t hashWithoutVirtualHosts(const envoy::config::route::v3::RouteConfiguration& config) {
+  envoy::config::route::v3::RouteConfiguration common;
+  ProtobufUtil::FieldMaskUtil::MergeMessageTo(config, fieldsOutsideVirtualHosts(),
+                                              ProtobufUtil::FieldMaskUtil::MergeOptions(), &common);
+  return MessageUtil::hash(common);
+}
+
+} // namespace
+
 ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
                        Server::Configuration::ServerFactoryContext& factory_context,
                        ProtobufMessage::ValidationVisitor& validator,
-                       bool validate_clusters_default, absl::Status& creation_status) {
-  auto config_or_error = CommonConfigImpl::create(config, factory_context, validator);
-  SET_AND_RETURN_IF_NOT_OK(config_or_error.status(), creation_status);
-  shared_config_ = std::move(config_or_error.value());
+                       bool validate_clusters_default, absl::Status& creation_status,
+                       const ConfigImpl* previous) {
+  const bool validate_clusters =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default);
+  // A reused virtual host would not be validated against the current set of clusters.
+  const bool reuse_virtual_hosts =
+      !validate_clusters &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.rds_reuse_virtual_hosts");
+  const RouteMatcher* previous_matcher = nullptr;
+  if (reuse_virtual_hosts) {
+    common_config_hash_ = hashWithoutVirtualHosts(config);
+    // Routes refer to the shared configuration, so virtual hosts can only be reused along with
+    // it.
+    if (previous != nullptr && previous->common_config_hash_ == common_config_hash_) {
+      shared_config_ = previous->shared_config_;
+      previous_matcher = previous->route_matcher_.get();
+    }
+  }
+
+  if (shared_config_ == nullptr) {
+    auto config_or_error = CommonConfigImpl::create(config, factory_context, validator);
+    SET_AND_RETURN_IF_NOT_OK(config_or_error.status(), creation_status);
+    shared_config_ = std::move(config_or_error.value());
+  }
 
-  auto matcher_or_error = RouteMatcher::create(
-      config, shared_config_, factory_context, validator,
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
+  auto matcher_or_error =
+      RouteMatcher::create(config, shared_config_, factory_context, validator, validate_clusters,
+                           reuse_virtual_hosts, previous_matcher);
   SET_AND_RETURN_IF_NOT_OK(matcher_or_error.status(), creation_status);
   route_matcher_ = std::move(matcher_or_error.value());
 }
@@ -23,18 +23,21 @@
 
 #include "source/common/common/matchers.h"
 #include "source/common/common/packed_struct.h"
+#include "source/common/common/trie_lookup_table.h"
 #include "source/common/config/datasource.h"
 #include "source/common/config/metadata.h"
 #include "source/common/http/hash_policy.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/matcher/matcher.h"
 #include "source/common/router/config_utility.h"
+#include "source/common/router/domain_matcher.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/router/metadatamatchcriteria_impl.h"
 #include "source/common/router/router_ratelimit.h"
 #include "source/common/router/tls_context_match_criteria_impl.h"
 #include "source/common/stats/symbol_table.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/types/optional.h"
 
@@ -383,6 +386,61 @@ private:
   const bool include_is_timeout_retry_header_ : 1;
 };
 
+/**
+ * Index over the prefix and exact path routes of a virtual host that match on their path alone,
+ * i.e. have no header, query parameter, runtime, gRPC, TLS context or dynamic metadata conditions.
+ * Prefixes are kept in a trie and exact paths in a hash map, both keyed to the position of the
+ * route in the virtual host, so the first matching indexed route is found in time proportional to
+ * the length of the path rather than the number of routes. Routes that can't be indexed are
+ * listed in order so that callers can evaluate the ones that precede the indexed match and keep
+ * first-match semantics.
+ */
+class PathRouteIndex {
+public:
+  static constexpr uint32_t NoRoute = std::numeric_limits<uint32_t>::max();
+  // Below this many indexable routes a linear scan is as fast as the index.
+  static constexpr uint32_t MinIndexedRoutes = 8;
+
+  /**
+   * @return an index over the given routes, or nullptr if too few of them can be indexed.
+   */
+  static std::unique_ptr<const PathRouteIndex>
+  create(absl::Span<const RouteEntryImplBaseConstSharedPtr> routes,
+         bool ignore_path_parameters);
+
+  /**
+   * @param path the value of the :path header.
+   * @return the position of the first indexed route that matches the path, or NoRoute.
+   */
+  uint32_t findFirst(absl::string_view path) const;
+
+  /**
+   * @return the positions of the routes that are not indexed, in ascending order.
+   */
+  const std::vector<uint32_t>& unindexedRoutes() const { return unindexed_routes_; }
+
+private:
+  explicit PathRouteIndex(bool ignore_path_parameters)
+      : ignore_path_parameters_(ignore_path_parameters) {}
+
+  // Tables of route positions. Positions are stored plus one in the tries, since zero marks an
+  // empty node.
+  struct Tables {
+    void add(PathMatchType type, absl::string_view key, uint32_t position);
+    uint32_t findFirst(absl::string_view path) const;
+
+    TrieLookupTable<uint32_t> prefixes_;
+    absl::flat_hash_map<std::string, uint32_t> paths_;
+    bool empty_{true};
+  };
+
+  const bool ignore_path_parameters_;
+  Tables case_sensitive_;
+  // Keyed by lower cased prefixes and paths.
+  Tables case_insensitive_;
+  std::vector<uint32_t> unindexed_routes_;
+};
+
 /**
  * Virtual host that holds a collection of routes.
  */
@@ -414,7 +472,13 @@ private:
   std::shared_ptr<const SslRedirectRoute> ssl_redirect_route_;
   SslRequirements ssl_requirements_;
 
+  RouteConstSharedPtr getRouteFromPathIndex(const Http::RequestHeaderMap& headers,
+                                            const StreamInfo::StreamInfo& stream_info,
+                                            uint64_t random_value) const;
+
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Null unless enough of routes_ can be looked up by path alone.
+  std::unique_ptr<const PathRouteIndex> path_index_;
   Matcher::MatchTreeSharedPtr<Http::HttpMatchingData> matcher_;
 };
 
@@ -676,6 +740,8 @@ public:
 
   bool matchRoute(const Http::RequestHeaderMap& headers, const StreamInfo::StreamInfo& stream_info,
                   uint64_t random_value) const;
+  // @return true if the route has no match conditions other than its path specifier.
+  bool matchesOnPathOnly() const;
   absl::Status
   validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const;
 
@@ -1097,6 +1163,8 @@ public:
   };
 
 protected:
+  friend class PathRouteIndex;
+
   const std::string prefix_rewrite_;
   Regex::CompiledMatcherPtr regex_rewrite_;
   const PathMatcherSharedPtr path_matcher_;
@@ -1528,11 +1596,19 @@ DECLARE_FACTORY(RouteListMatchActionFactory);
  */
 class RouteMatcher {
 public:
+  /**
+   * @param reuse_virtual_hosts whether virtual hosts are keyed by the hash of their proto, so that
+   *        a later configuration can reuse them.
+   * @param previous if not null, a matcher created with reuse_virtual_hosts for an earlier version
+   *        of this configuration that shares global_route_config. Virtual hosts whose proto is
+   *        unchanged are taken from it instead of being built again.
+   */
   static absl::StatusOr<std::unique_ptr<RouteMatcher>>
   create(const envoy::config::route::v3::RouteConfiguration& config,
          const CommonConfigSharedPtr& global_route_config,
          Server::Configuration::ServerFactoryContext& factory_context,
-         ProtobufMessage::ValidationVisitor& validator, bool validate_clusters);
+         ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+         bool reuse_virtual_hosts = false, const RouteMatcher* previous = nullptr);
 
   RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                             const StreamInfo::StreamInfo& stream_info, uint64_t random_value) const;
@@ -1544,30 +1620,18 @@ private:
                const CommonConfigSharedPtr& global_route_config,
                Server::Configuration::ServerFactoryContext& factory_context,
                ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+               bool reuse_virtual_hosts, const RouteMatcher* previous,
                absl::Status& creation_status);
 
-  using WildcardVirtualHosts =
-      std::map<int64_t, absl::node_hash_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
-  using SubstringFunction = std::function<absl::string_view(absl::string_view, int)>;
-  const VirtualHostImpl* findWildcardVirtualHost(absl::string_view host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
   bool ignorePortInHostMatching() const { return ignore_port_in_host_matching_; }
 
   Stats::ScopeSharedPtr vhost_scope_;
-  absl::node_hash_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
-  // std::greater as a minor optimization to iterate from more to less specific
-  //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
-  //
-  // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
-  // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
-  // and climbs to about 110ns once there are any entries.
-  //
-  // The break-even is 4 entries.
-  WildcardVirtualHosts wildcard_virtual_host_suffixes_;
-  WildcardVirtualHosts wildcard_virtual_host_prefixes_;
-
+  // Owns the virtual hosts, which domain_matcher_ refers to.
+  std::vector<VirtualHostSharedPtr> virtual_hosts_;
+  // The virtual hosts keyed by the hash of their proto, when they may be reused.
+  absl::flat_hash_map<uint64_t, VirtualHostSharedPtr> virtual_hosts_by_hash_;
+  // All the domains other than "*", compiled once per configuration.
+  DomainMatcher<const VirtualHostImpl*> domain_matcher_;
   VirtualHostSharedPtr default_virtual_host_;
   const bool ignore_port_in_host_matching_{false};
 };
@@ -1649,10 +1713,17 @@ private:
  */
 class ConfigImpl : public Config {
 public:
+  /**
+   * @param previous if not null, the configuration that this one replaces. When the settings
+   *        outside of the virtual hosts are unchanged and clusters are not validated, virtual
+   *        hosts whose proto is unchanged are shared with it rather than built again, so that the
+   *        cost of an update scales with what changed.
+   */
   static absl::StatusOr<std::shared_ptr<ConfigImpl>>
   create(const envoy::config::route::v3::RouteConfiguration& config,
          Server::Configuration::ServerFactoryContext& factory_context,
-         ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default);
+         ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default,
+         const ConfigImpl* previous = nullptr);
 
   bool virtualHostExists(const Http::RequestHeaderMap& headers) const {
     return route_matcher_->findVirtualHost(headers) != nullptr;
@@ -1695,10 +1766,12 @@ protected:
   ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
              Server::Configuration::ServerFactoryContext& factory_context,
              ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default,
-             absl::Status& creation_status);
+             absl::Status& creation_status, const ConfigImpl* previous = nullptr);
 
 private:
   CommonConfigSharedPtr shared_config_;
+  // The hash of the configuration without its virtual hosts, set when virtual hosts may be reused.
+  absl::optional<uint64_t> common_config_hash_;
   std::unique_ptr<RouteMatcher> route_matcher_;
 };
 
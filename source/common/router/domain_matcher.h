@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/compiled_string_map.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Matches a lower-cased host against a set of lower-cased domains, which are either exact
+ * ("www.example.com"), suffix wildcards ("*.example.com") or prefix wildcards ("www.example.*").
+ * The precedence is exact, then the longest suffix wildcard, then the longest prefix wildcard. A
+ * wildcard must match at least one character, so "*.example.com" does not match ".example.com".
+ *
+ * Domains are added with add() and the matcher is then compiled once with compile(), after which
+ * it is read-only:
+ * - Exact domains live in a CompiledStringMap, which resolves a host with a handful of character
+ *   comparisons and a single memcmp.
+ * - Wildcards that start (suffix) or end (prefix) at a label boundary, e.g. "*.example.com", which
+ *   is almost all of them, are only probed at the label boundaries of the host, from the longest
+ *   candidate to the shortest and skipping lengths that no wildcard has. The first hit is the
+ *   longest match, so a matching host usually costs a single hash lookup however many wildcards
+ *   there are.
+ * - Any other wildcard, e.g. "*-bar.example.com", is kept in a map keyed by length and only the
+ *   lengths that are longer than the best label aligned match are probed.
+ *
+ * Value is expected to be a cheap, default-constructible handle such as a raw pointer, where the
+ * default value means "no match".
+ */
+template <class Value> class DomainMatcher {
+public:
+  /**
+   * Add a lower-cased domain. Must not be called after compile(). The "*" domain is not handled
+   * here; callers treat it as their default.
+   * @return false if the domain was already added.
+   */
+  bool add(absl::string_view domain, Value value) {
+    ASSERT(!compiled_);
+    ASSERT(domain != "*");
+    if (!domain.empty() && domain.front() == '*') {
+      return suffixes_.add(domain.substr(1), std::move(value));
+    }
+    if (!domain.empty() && domain.back() == '*') {
+      return prefixes_.add(domain.substr(0, domain.size() - 1), std::move(value));
+    }
+    return pending_exact_.emplace(domain, std::move(value)).second;
+  }
+
+  /**
+   * Build the exact domain lookup. Must be called once all domains have been added.
+   */
+  void compile() {
+    ASSERT(!compiled_);
+    compiled_ = true;
+    empty_ = pending_exact_.empty() && suffixes_.empty() && prefixes_.empty();
+    std::vector<typename CompiledStringMap<Value>::KV> contents;
+    contents.reserve(pending_exact_.size());
+    for (auto& [domain, value] : pending_exact_) {
+      contents.emplace_back(domain, std::move(value));
+    }
+    exact_.compile(std::move(contents));
+    pending_exact_ = {};
+  }
+
+  /**
+   * @return true if no domains were added.
+   */
+  bool empty() const { return empty_; }
+
+  /**
+   * @param host the lower-cased host to match.
+   * @return the value of the best matching domain, or a default constructed Value.
+   */
+  Value find(absl::string_view host) const {
+    ASSERT(compiled_);
+    if (Value value = exact_.find(host); value) {
+      return value;
+    }
+    if (Value value = suffixes_.findLongest(host); value) {
+      return value;
+    }
+    return prefixes_.findLongest(host);
+  }
+
+private:
+  /**
+   * The wildcards of one kind. A suffix wildcard is stored without its leading '*' and a prefix
+   * wildcard without its trailing '*'.
+   */
+  class Wildcards {
+  public:
+    explicit Wildcards(bool suffix) : suffix_(suffix) {}
+
+    bool add(absl::string_view wildcard, Value value) {
+      if (wildcard.empty() || (suffix_ ? wildcard.front() : wildcard.back()) != '.') {
+        return unaligned_[wildcard.size()].emplace(wildcard, std::move(value)).second;
+      }
+      if (aligned_lengths_.size() <= wildcard.size()) {
+        aligned_lengths_.resize(wildcard.size() + 1);
+      }
+      aligned_lengths_[wildcard.size()] = true;
+      return aligned_.emplace(wildcard, std::move(value)).second;
+    }
+
+    bool empty() const { return aligned_.empty() && unaligned_.empty(); }
+
+    Value findLongest(absl::string_view host) const {
+      size_t best_length = 0;
+      Value best{};
+      if (!aligned_.empty()) {
+        std::tie(best, best_length) = suffix_ ? findSuffixAligned(host) : findPrefixAligned(host);
+      }
+      // Only wildcards longer than the best label aligned match, and shorter than the host, can
+      // win.
+      for (const auto& [length, wildcards] : unaligned_) {
+        if (length <= best_length) {
+          break;
+        }
+        if (length >= host.size()) {
+          continue;
+        }
+        const auto it = wildcards.find(suffix_ ? host.substr(host.size() - length)
+                                               : host.substr(0, length));
+        if (it != wildcards.end()) {
+          return it->second;
+        }
+      }
+      return best;
+    }
+
+  private:
+    // A label aligned suffix wildcard can only match the host from one of its '.' characters.
+    // Those are tried from the longest candidate to the shortest, skipping any length that no
+    // wildcard has, so the first hit is the longest match. The '.' must not be the first character
+    // of the host, as the wildcard has to match at least one character.
+    std::pair<Value, size_t> findSuffixAligned(absl::string_view host) const {
+      for (size_t dot = host.find('.', 1); dot != absl::string_view::npos;
+           dot = host.find('.', dot + 1)) {
+        const size_t length = host.size() - dot;
+        if (length >= aligned_lengths_.size() || !aligned_lengths_[length]) {
+          continue;
+        }
+        if (const auto it = aligned_.find(host.substr(dot)); it != aligned_.end()) {
+          return {it->second, length};
+        }
+      }
+      return {};
+    }
+
+    // The mirror image of findSuffixAligned(), trying the '.' characters from the end of the host.
+    std::pair<Value, size_t> findPrefixAligned(absl::string_view host) const {
+      if (host.size() < 2) {
+        return {};
+      }
+      for (size_t dot = host.rfind('.', host.size() - 2); dot != absl::string_view::npos;
+           dot = dot > 0 ? host.rfind('.', dot - 1) : absl::string_view::npos) {
+        const size_t length = dot + 1;
+        if (length >= aligned_lengths_.size() || !aligned_lengths_[length]) {
+          continue;
+        }
+        if (const auto it = aligned_.find(host.substr(0, length)); it != aligned_.end()) {
+          return {it->second, length};
+        }
+      }
+      return {};
+    }
+
+    const bool suffix_;
+    // Wildcards that start (suffix) or end (prefix) with a '.', and which of their lengths exist.
+    absl::flat_hash_map<std::string, Value> aligned_;
+    std::vector<bool> aligned_lengths_;
+    // All other wildcards, keyed by length from the longest to the shortest.
+    std::map<size_t, absl::node_hash_map<std::string, Value>, std::greater<>> unaligned_;
+  };
+
+  bool compiled_{};
+  bool empty_{true};
+  absl::flat_hash_map<std::string, Value> pending_exact_;
+  CompiledStringMap<Value> exact_;
+  Wildcards suffixes_{true};
+  Wildcards prefixes_{false};
+};
+
+} // namespace Router
+} // namespace Envoy
@@ -1224,6 +1224,7 @@ void Filter::onResponseTimeout() {
     if (upstream_request->upstreamHost()) {
       upstream_request->upstreamHost()->stats().rq_timeout_.inc();
     }
+    updateLbPolicyDataOnFailure(*upstream_request);
 
     if (upstream_request->awaitingHeaders()) {
       if (cluster_->timeoutBudgetStats().has_value()) {
@@ -1313,6 +1314,7 @@ void Filter::onPerTryTimeoutCommon(UpstreamRequest& upstream_request, Stats::Cou
 
   updateOutlierDetection(Upstream::Outlier::Result::LocalOriginTimeout, upstream_request,
                          absl::optional<uint64_t>(enumToInt(timeout_response_code_)));
+  updateLbPolicyDataOnFailure(upstream_request);
 
   if (maybeRetryReset(Http::StreamResetReason::LocalReset, upstream_request, TimeoutRetry::Yes)) {
     return;
@@ -1359,6 +1361,20 @@ void Filter::updateOutlierDetection(Upstream::Outlier::Result result,
   }
 }
 
+void Filter::updateLbPolicyDataOnFailure(UpstreamRequest& upstream_request) {
+  if (!upstream_request.upstreamHost() || callbacks_->streamInfo().healthCheck()) {
+    return;
+  }
+  // Requests that never complete would otherwise not be seen by latency aware load balancing
+  // policies at all, making hosts that time out look idle.
+  OptRef<Upstream::HostLbPolicyData> host_lb_policy_data =
+      upstream_request.upstreamHost()->lbPolicyData();
+  if (host_lb_policy_data.has_value()) {
+    host_lb_policy_data->onRequestFailure(std::chrono::duration_cast<std::chrono::microseconds>(
+        callbacks_->dispatcher().timeSource().monotonicTime() - upstream_request.startTime()));
+  }
+}
+
 void Filter::chargeUpstreamAbort(Http::Code code, bool dropped, UpstreamRequest& upstream_request) {
   if (downstream_response_started_) {
     if (upstream_request.grpcRqSuccessDeferred()) {
@@ -1493,6 +1509,7 @@ void Filter::onUpstreamReset(Http::StreamResetReason reset_reason,
     // config param set to true.
     updateOutlierDetection(Upstream::Outlier::Result::LocalOriginConnectFailed, upstream_request,
                            absl::nullopt);
+    updateLbPolicyDataOnFailure(upstream_request);
   }
 
   if (maybeRetryReset(reset_reason, upstream_request, TimeoutRetry::No)) {
@@ -1706,6 +1723,7 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::ResponseHeaderMapPt
         runRetryOptionsPredicates(upstream_request);
         pending_retries_++;
         upstream_request.upstreamHost()->stats().rq_error_.inc();
+        updateLbPolicyDataOnFailure(upstream_request);
         Http::CodeStats& code_stats = httpContext().codeStats();
         code_stats.chargeBasicResponseStat(cluster_->statsScope(), stats_.stat_names_.retry_,
                                            static_cast<Http::Code>(response_code),
@@ -1859,8 +1877,9 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
     upstream_request.resetStream();
   }
   Event::Dispatcher& dispatcher = callbacks_->dispatcher();
+  const MonotonicTime response_complete_time = dispatcher.timeSource().monotonicTime();
   std::chrono::milliseconds response_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-      dispatcher.timeSource().monotonicTime() - downstream_request_complete_time_);
+      response_complete_time - downstream_request_complete_time_);
 
   Upstream::ClusterTimeoutBudgetStatsOptRef tb_stats = cluster()->timeoutBudgetStats();
   if (tb_stats.has_value()) {
@@ -1868,6 +1887,17 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
         FilterUtility::percentageOfTimeout(response_time, timeout_.global_timeout_));
   }
 
+  if (!callbacks_->streamInfo().healthCheck() &&
+      DateUtil::timePointValid(downstream_request_complete_time_)) {
+    // Latency aware load balancing policies track the response times of the hosts they pick.
+    OptRef<Upstream::HostLbPolicyData> host_lb_policy_data =
+        upstream_request.upstreamHost()->lbPolicyData();
+    if (host_lb_policy_data.has_value()) {
+      host_lb_policy_data->onResponseTime(std::chrono::duration_cast<std::chrono::microseconds>(
+          response_complete_time - downstream_request_complete_time_));
+    }
+  }
+
   if (config_->emit_dynamic_stats_ && !callbacks_->streamInfo().healthCheck() &&
       DateUtil::timePointValid(downstream_request_complete_time_)) {
     upstream_request.upstreamHost()->outlierDetector().putResponseTime(response_time);
@@ -200,20 +200,28 @@ public:
   // Stats::Gauge
   void add(uint64_t amount) override {
     child_value_ += amount;
-    flags_ |= Flags::Used;
+    flags_ |= Flags::Used | Flags::Changed;
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
     child_value_ = value;
-    flags_ |= Flags::Used;
+    flags_ |= Flags::Used | Flags::Changed;
   }
   void sub(uint64_t amount) override {
     ASSERT(child_value_ >= amount);
     ASSERT(used() || amount == 0);
     child_value_ -= amount;
+    // sub() did not previously write flags_, so avoid adding a read-modify-write to every call
+    // once the gauge has already been marked as changed in this flush interval.
+    if (!(flags_ & Flags::Changed)) {
+      flags_ |= Flags::Changed;
+    }
   }
   uint64_t value() const override { return child_value_ + parent_value_; }
+  bool latchChanged() override {
+    return (flags_ & Flags::Changed) && (flags_.fetch_and(~Flags::Changed) & Flags::Changed);
+  }
 
   // TODO(diazalan): Rename importMode and to more generic name
   ImportMode importMode() const override {
@@ -260,7 +268,11 @@ public:
     }
   }
 
-  void setParentValue(uint64_t value) override { parent_value_ = value; }
+  void setParentValue(uint64_t value) override {
+    if (parent_value_.exchange(value) != value) {
+      flags_ |= Flags::Changed;
+    }
+  }
 
 private:
   std::atomic<uint64_t> parent_value_{0};
@@ -284,12 +296,15 @@ public:
     std::string value_copy(value);
     absl::MutexLock lock(&mutex_);
     value_ = std::move(value_copy);
-    flags_ |= Flags::Used;
+    flags_ |= Flags::Used | Flags::Changed;
   }
   std::string value() const override {
     absl::MutexLock lock(&mutex_);
     return value_;
   }
+  bool latchChanged() override {
+    return (flags_ & Flags::Changed) && (flags_.fetch_and(~Flags::Changed) & Flags::Changed);
+  }
 
 private:
   mutable absl::Mutex mutex_;
@@ -1,6 +1,7 @@
 #include "source/common/stats/histogram_impl.h"
 
 #include <algorithm>
+#include <limits>
 #include <string>
 
 #include "source/common/common/utility.h"
@@ -113,6 +114,71 @@ HistogramSettingsImpl::HistogramSettingsImpl(const envoy::config::metrics::v3::S
         return configs;
       }()) {}
 
+HistogramBucketRecorder::~HistogramBucketRecorder() {
+  if (spill_ != nullptr) {
+    hist_free(spill_);
+  }
+}
+
+void HistogramBucketRecorder::recordValue(uint64_t value) {
+  // This is the same conversion hist_insert_intscale() does, so the bins match exactly. For
+  // positive values the bin is val / 10 * 10^exp, with val in [10, 99] and exp counting up from 0
+  // for single digit values.
+  const hist_bucket_t bucket = int_scale_to_hist_bucket(value, 0);
+  if (bucket.val == 0) {
+    ++zero_count_;
+    return;
+  }
+  if (bucket.val < 0 || bucket.exp < 0 || bucket.exp >= static_cast<int>(MaxDecades)) {
+    spill(bucket, 1);
+    return;
+  }
+  std::unique_ptr<DecadeCounts>& decade = decades_[bucket.exp];
+  if (decade == nullptr) {
+    decade = std::make_unique<DecadeCounts>();
+  }
+  uint32_t& count = decade->counts_[bucket.val - 10];
+  if (++count == std::numeric_limits<uint32_t>::max()) {
+    spill(bucket, count);
+    count = 0;
+  }
+}
+
+void HistogramBucketRecorder::spill(hist_bucket_t bucket, uint64_t count) {
+  if (spill_ == nullptr) {
+    spill_ = hist_alloc();
+  }
+  hist_insert_raw(spill_, bucket, count);
+}
+
+void HistogramBucketRecorder::mergeInto(histogram_t* target) {
+  if (zero_count_ > 0) {
+    hist_insert_intscale(target, 0, 0, zero_count_);
+    zero_count_ = 0;
+  }
+  for (uint32_t exp = 0; exp < MaxDecades; ++exp) {
+    if (decades_[exp] == nullptr) {
+      continue;
+    }
+    // The arrays are kept for the next interval, as a histogram tends to see the same range of
+    // values over time.
+    std::array<uint32_t, BinsPerDecade>& counts = decades_[exp]->counts_;
+    for (uint32_t i = 0; i < BinsPerDecade; ++i) {
+      if (counts[i] > 0) {
+        hist_bucket_t bucket;
+        bucket.val = static_cast<int8_t>(i + 10);
+        bucket.exp = static_cast<int8_t>(exp);
+        hist_insert_raw(target, bucket, counts[i]);
+        counts[i] = 0;
+      }
+    }
+  }
+  if (spill_ != nullptr) {
+    hist_accumulate(target, &spill_, 1);
+    hist_clear(spill_);
+  }
+}
+
 const ConstSupportedBuckets& HistogramSettingsImpl::buckets(absl::string_view stat_name) const {
   for (const auto& config : configs_) {
     if (config.first.match(stat_name)) {
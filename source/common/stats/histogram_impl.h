@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "envoy/config/metrics/v3/stats.pb.h"
@@ -73,6 +75,46 @@ private:
   const Histogram::Unit unit_{Histogram::Unit::Unspecified};
 };
 
+/**
+ * Accumulates integer samples for later insertion into a circllhist. Samples are counted in flat
+ * arrays with one slot per circllhist bin, allocated a decade at a time on first use, which avoids
+ * the bin search and the occasional reallocation hist_insert_intscale() does for each sample.
+ * mergeInto() produces exactly the histogram that inserting the samples directly would have.
+ *
+ * This class is not thread-safe.
+ */
+class HistogramBucketRecorder : NonCopyable {
+public:
+  HistogramBucketRecorder() = default;
+  ~HistogramBucketRecorder();
+
+  void recordValue(uint64_t value);
+
+  /**
+   * Adds all samples recorded since the previous call to target, and clears the recorder.
+   * @param target the histogram to accumulate into.
+   */
+  void mergeInto(histogram_t* target);
+
+private:
+  // A circllhist bin holds two significant decimal digits, so each decade has 90 bins (10..99).
+  static constexpr uint32_t BinsPerDecade = 90;
+  // Covers every power of ten representable by a non-negative int64_t.
+  static constexpr uint32_t MaxDecades = 20;
+
+  struct alignas(64) DecadeCounts {
+    std::array<uint32_t, BinsPerDecade> counts_{};
+  };
+
+  void spill(hist_bucket_t bucket, uint64_t count);
+
+  std::array<std::unique_ptr<DecadeCounts>, MaxDecades> decades_;
+  uint64_t zero_count_{0};
+  // Holds samples which fall outside decades_, and counts which would overflow a uint32_t slot.
+  // Allocated on first use, which does not happen for typical values.
+  histogram_t* spill_{nullptr};
+};
+
 class HistogramImplHelper : public MetricImpl<Histogram> {
 public:
   HistogramImplHelper(StatName name, StatName tag_extracted_name,
@@ -1,14 +1,17 @@
 #include "source/common/stats/symbol_table.h"
 
 #include <algorithm>
+#include <bit>
 #include <iostream>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 #include "source/common/common/assert.h"
 #include "source/common/common/logger.h"
 #include "source/common/common/utility.h"
 
+#include "absl/hash/hash.h"
 #include "absl/strings/str_cat.h"
 
 namespace Envoy {
@@ -261,11 +264,8 @@ bool StatName::startsWith(StatName prefix) const {
 
 std::vector<absl::string_view> SymbolTable::decodeStrings(StatName stat_name) const {
   std::vector<absl::string_view> strings;
-  Thread::LockGuard lock(lock_);
   Encoding::decodeTokens(
-      stat_name,
-      [this, &strings](Symbol symbol)
-          ABSL_NO_THREAD_SAFETY_ANALYSIS { strings.push_back(fromSymbol(symbol)); },
+      stat_name, [this, &strings](Symbol symbol) { strings.push_back(fromSymbol(symbol)); },
       [&strings](absl::string_view str) { strings.push_back(str); });
   return strings;
 }
@@ -288,7 +288,7 @@ void SymbolTable::Encoding::appendToMemBlock(StatName stat_name,
 
 SymbolTable::SymbolTable()
     // Have to be explicitly initialized, if we want to use the ABSL_GUARDED_BY macro.
-    : next_symbol_(FirstValidSymbol), monotonic_counter_(FirstValidSymbol) {}
+    : monotonic_counter_(FirstValidSymbol) {}
 
 SymbolTable::~SymbolTable() {
   // To avoid leaks into the symbol table, we expect all StatNames to be freed.
@@ -312,18 +312,19 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
   std::vector<Symbol> symbols;
   symbols.reserve(tokens.size());
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
-  {
-    Thread::LockGuard lock(lock_);
+  ++num_lookups_;
+  if (track_recent_lookups_.load(std::memory_order_relaxed)) {
+    absl::MutexLock lock(&recent_lookups_lock_);
     recent_lookups_.lookup(name);
-    for (auto& token : tokens) {
-      // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
-      // length below some threshold, say 4 bytes. It might be preferable not to
-      // reserve Symbols for every 3 digit number found (for example) in ipv4
-      // addresses.
-      symbols.push_back(toSymbol(token));
-    }
+  }
+
+  // Populate the Symbol objects, which involves bumping ref-counts in this.
+  for (auto& token : tokens) {
+    // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
+    // length below some threshold, say 4 bytes. It might be preferable not to
+    // reserve Symbols for every 3 digit number found (for example) in ipv4
+    // addresses.
+    symbols.push_back(toSymbol(token));
   }
 
   // Now efficiently encode the array of 32-bit symbols into a uint8_t array.
@@ -331,9 +332,12 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
 }
 
 uint64_t SymbolTable::numSymbols() const {
-  Thread::LockGuard lock(lock_);
-  ASSERT(encode_map_.size() == decode_map_.size());
-  return encode_map_.size();
+  uint64_t num_symbols = 0;
+  for (const Shard& encode_shard : shards_) {
+    absl::ReaderMutexLock lock(&encode_shard.mutex_);
+    num_symbols += encode_shard.encode_map_.size();
+  }
+  return num_symbols;
 }
 
 std::string SymbolTable::toString(const StatName& stat_name) const {
@@ -341,49 +345,43 @@ std::string SymbolTable::toString(const StatName& stat_name) const {
 }
 
 void SymbolTable::incRefCount(const StatName& stat_name) {
-  // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
+  // The caller holds a reference to each symbol, so none of them can be
+  // removed concurrently, and the counts can be bumped without locking.
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-
-    ASSERT(decode_search != decode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-
-    ++encode_search->second.ref_count_;
+    ++sharedSymbol(symbol).ref_count_;
   }
 }
 
 void SymbolTable::free(const StatName& stat_name) {
-  // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
-
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end());
-
-    // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
-      decode_map_.erase(decode_search);
-      encode_map_.erase(encode_search);
-      pool_.push(symbol);
+    SharedSymbol& shared_symbol = sharedSymbol(symbol);
+
+    // While other references remain, the count can be decremented without
+    // locking: it cannot reach zero, so the symbol stays in the table.
+    uint32_t ref_count = shared_symbol.ref_count_.load(std::memory_order_relaxed);
+    while (ref_count > 1 &&
+           !shared_symbol.ref_count_.compare_exchange_weak(ref_count, ref_count - 1)) {
+    }
+    if (ref_count > 1) {
+      continue;
+    }
+
+    // This may be the last reference. Take the shard lock exclusively, so that
+    // toSymbol() cannot find and revive the symbol while it is being removed.
+    const absl::string_view token = shared_symbol.str_->toStringView();
+    Shard& token_shard = shard(token);
+    absl::MutexLock lock(&token_shard.mutex_);
+    if (--shared_symbol.ref_count_ == 0) {
+      // Clear the slot before the symbol can be handed out again, and erase the
+      // map entry, which frees shared_symbol and its token, last.
+      symbolSlot(symbol)->store(nullptr, std::memory_order_release);
+      releaseSymbol(symbol);
+      const size_t erased = token_shard.encode_map_.erase(token);
+      ASSERT(erased == 1);
     }
   }
 }
@@ -392,15 +390,15 @@ uint64_t SymbolTable::getRecentLookups(const RecentLookupsFn& iter) const {
   uint64_t total = 0;
   absl::flat_hash_map<std::string, uint64_t> name_count_map;
 
-  // We don't want to hold lock_ while calling the iterator, but we need it to
-  // access recent_lookups_, so we buffer in name_count_map.
+  // We don't want to hold recent_lookups_lock_ while calling the iterator, but
+  // we need it to access recent_lookups_, so we buffer in name_count_map.
   {
-    Thread::LockGuard lock(lock_);
+    absl::MutexLock lock(&recent_lookups_lock_);
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             ABSL_NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
-    total += recent_lookups_.total();
   }
+  total += num_lookups_;
 
   // Now we have the collated name-count map data: we need to vectorize and
   // sort. We define the pair with the count first as std::pair::operator<
@@ -445,17 +443,19 @@ DynamicSpans SymbolTable::getDynamicSpans(StatName stat_name) const {
 }
 
 void SymbolTable::setRecentLookupCapacity(uint64_t capacity) {
-  Thread::LockGuard lock(lock_);
+  absl::MutexLock lock(&recent_lookups_lock_);
   recent_lookups_.setCapacity(capacity);
+  track_recent_lookups_ = capacity > 0;
 }
 
 void SymbolTable::clearRecentLookups() {
-  Thread::LockGuard lock(lock_);
+  absl::MutexLock lock(&recent_lookups_lock_);
   recent_lookups_.clear();
+  num_lookups_ = 0;
 }
 
 uint64_t SymbolTable::recentLookupCapacity() const {
-  Thread::LockGuard lock(lock_);
+  absl::MutexLock lock(&recent_lookups_lock_);
   return recent_lookups_.capacity();
 }
 
@@ -465,60 +465,106 @@ StatNameSetPtr SymbolTable::makeSet(absl::string_view name) {
   return stat_name_set;
 }
 
+SymbolTable::Shard& SymbolTable::shard(absl::string_view token) {
+  return shards_[absl::Hash<absl::string_view>()(token) % NumShards];
+}
+
 Symbol SymbolTable::toSymbol(absl::string_view sv) {
-  Symbol result;
-  auto encode_find = encode_map_.find(sv);
-  // If the string segment doesn't already exist,
-  if (encode_find == encode_map_.end()) {
-    // We create the actual string, place it in the decode_map_, and then insert
-    // a string_view pointing to it in the encode_map_. This allows us to only
-    // store the string once. We use unique_ptr so copies are not made as
-    // flat_hash_map moves values around.
-    InlineStringPtr str = InlineString::create(sv);
-    auto encode_insert = encode_map_.insert({str->toStringView(), SharedSymbol(next_symbol_)});
-    ASSERT(encode_insert.second);
-    auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
-    ASSERT(decode_insert.second);
-
-    result = next_symbol_;
-    newSymbol();
-  } else {
-    // If the insertion didn't take place, return the actual value at that location and up the
-    // refcount at that location
-    result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+  Shard& token_shard = shard(sv);
+
+  // Most lookups are for tokens already in the table, which only need the
+  // shard's lock in shared mode.
+  {
+    absl::ReaderMutexLock lock(&token_shard.mutex_);
+    auto encode_find = token_shard.encode_map_.find(sv);
+    if (encode_find != token_shard.encode_map_.end()) {
+      SharedSymbol& shared_symbol = *encode_find->second;
+      ++shared_symbol.ref_count_;
+      return shared_symbol.symbol_;
+    }
   }
-  return result;
+
+  absl::MutexLock lock(&token_shard.mutex_);
+  // Another thread may have added the token since we released the lock.
+  auto encode_find = token_shard.encode_map_.find(sv);
+  if (encode_find != token_shard.encode_map_.end()) {
+    SharedSymbol& shared_symbol = *encode_find->second;
+    ++shared_symbol.ref_count_;
+    return shared_symbol.symbol_;
+  }
+
+  // The SharedSymbol holds the only copy of the string: the encode map key is a
+  // string_view into it. We use unique_ptr so it does not move as
+  // flat_hash_map moves values around, and so the decode side can point to it.
+  const Symbol symbol = newSymbol();
+  auto shared_symbol = std::make_unique<SharedSymbol>(sv, symbol);
+  symbolSlot(symbol)->store(shared_symbol.get(), std::memory_order_release);
+  const absl::string_view key = shared_symbol->str_->toStringView();
+  auto encode_insert = token_shard.encode_map_.emplace(key, std::move(shared_symbol));
+  ASSERT(encode_insert.second);
+  return symbol;
 }
 
-absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
-  auto search = decode_map_.find(symbol);
-  RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
-  return search->second->toStringView();
+std::pair<uint32_t, uint64_t> SymbolTable::symbolSegment(Symbol symbol) {
+  // Segment k holds the 2^(FirstSegmentBits + k) symbols starting at
+  // 2^(FirstSegmentBits + k) - 2^FirstSegmentBits.
+  const uint64_t index = static_cast<uint64_t>(symbol) + (uint64_t(1) << FirstSegmentBits);
+  const uint32_t segment = std::bit_width(index) - 1 - FirstSegmentBits;
+  return {segment, index - (uint64_t(1) << (segment + FirstSegmentBits))};
 }
 
-void SymbolTable::newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+std::atomic<SymbolTable::SharedSymbol*>* SymbolTable::symbolSlot(Symbol symbol) const {
+  const auto [segment, offset] = symbolSegment(symbol);
+  std::atomic<SharedSymbol*>* slots = segments_[segment].load(std::memory_order_acquire);
+  if (slots == nullptr) {
+    return nullptr;
+  }
+  return &slots[offset];
+}
+
+SymbolTable::SharedSymbol& SymbolTable::sharedSymbol(Symbol symbol) const {
+  std::atomic<SharedSymbol*>* slot = symbolSlot(symbol);
+  SharedSymbol* shared_symbol =
+      slot == nullptr ? nullptr : slot->load(std::memory_order_acquire);
+  RELEASE_ASSERT(shared_symbol != nullptr,
+                 "no such symbol; please see "
+                 "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
+                 "debugging-symbol-table-assertions");
+  return *shared_symbol;
+}
+
+absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const {
+  return sharedSymbol(symbol).str_->toStringView();
+}
+
+Symbol SymbolTable::newSymbol() {
+  absl::MutexLock lock(&symbol_lock_);
+  Symbol symbol;
   if (pool_.empty()) {
-    next_symbol_ = ++monotonic_counter_;
+    symbol = monotonic_counter_++;
+    // This should catch integer overflow for the new symbol.
+    ASSERT(monotonic_counter_ != 0);
   } else {
-    next_symbol_ = pool_.top();
+    symbol = pool_.top();
     pool_.pop();
   }
-  // This should catch integer overflow for the new symbol.
-  ASSERT(monotonic_counter_ != 0);
+
+  // Allocate the segment holding the symbol's slot on first use.
+  const uint32_t segment = symbolSegment(symbol).first;
+  if (segment_storage_[segment] == nullptr) {
+    segment_storage_[segment] =
+        std::make_unique<std::atomic<SharedSymbol*>[]>(uint64_t(1) << (segment + FirstSegmentBits));
+    segments_[segment].store(segment_storage_[segment].get(), std::memory_order_release);
+  }
+  return symbol;
 }
 
-bool SymbolTable::lessThan(const StatName& a, const StatName& b) const {
-  // Proactively take the table lock in anticipation that we'll need to
-  // convert at least one symbol to a string_view, and it's easier not to
-  // bother to lazily take the lock.
-  Thread::LockGuard lock(lock_);
-  return lessThanLockHeld(a, b);
+void SymbolTable::releaseSymbol(Symbol symbol) {
+  absl::MutexLock lock(&symbol_lock_);
+  pool_.push(symbol);
 }
 
-bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+bool SymbolTable::lessThan(const StatName& a, const StatName& b) const {
   Encoding::TokenIter a_iter(a), b_iter(b);
   while (true) {
     Encoding::TokenIter::TokenType a_type = a_iter.next();
@@ -548,16 +594,16 @@ bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTable::debugPrint() const {
-  Thread::LockGuard lock(lock_);
-  std::vector<Symbol> symbols;
-  for (const auto& p : decode_map_) {
-    symbols.push_back(p.first);
+  std::vector<std::tuple<Symbol, std::string, uint32_t>> symbols;
+  for (const Shard& encode_shard : shards_) {
+    absl::ReaderMutexLock lock(&encode_shard.mutex_);
+    for (const auto& p : encode_shard.encode_map_) {
+      symbols.emplace_back(p.second->symbol_, std::string(p.first), p.second->ref_count_.load());
+    }
   }
   std::sort(symbols.begin(), symbols.end());
-  for (Symbol symbol : symbols) {
-    const InlineString& token = *decode_map_.find(symbol)->second;
-    const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+  for (const auto& [symbol, token, ref_count] : symbols) {
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token, ref_count);
   }
 }
 #endif
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <stack>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "source/common/common/assert.h"
@@ -19,6 +22,7 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -72,6 +76,12 @@ using SymbolVec = std::vector<Symbol>;
  * that if a string is encoded, the resulting stat is destroyed, and then that
  * same string is re-encoded, it may or may not encode to the same underlying
  * symbol.
+ *
+ * Decoding symbols takes no locks. Encoding a token which is already in the
+ * table takes a shared lock on one of several shards, chosen by the token's
+ * hash, so concurrent encodes of common tokens do not serialize. Only adding a
+ * new token or removing the last reference to one takes a shard lock
+ * exclusively.
  */
 class SymbolTable final {
 public:
@@ -324,8 +334,6 @@ public:
    */
   DynamicSpans getDynamicSpans(StatName stat_name) const;
 
-  bool lessThanLockHeld(const StatName& a, const StatName& b) const;
-
   template <class GetStatName, class Obj> struct StatNameCompare {
     StatNameCompare(const SymbolTable& symbol_table, GetStatName getter)
         : symbol_table_(symbol_table), getter_(getter) {}
@@ -337,9 +345,7 @@ public:
   };
 
   /**
-   * Sorts a range by StatName. This API is more efficient than
-   * calling std::sort directly as it takes a single lock for the
-   * entire sort, rather than locking on each comparison.
+   * Sorts a range by StatName.
    *
    * @param begin the beginning of the range to sort
    * @param end the end of the range to sort
@@ -347,9 +353,6 @@ public:
    */
   template <class Obj, class Iter, class GetStatName>
   void sortByStatNames(Iter begin, Iter end, GetStatName get_stat_name) const {
-    // Grab the lock once before sorting begins, so we don't have to re-take
-    // it on every comparison.
-    Thread::LockGuard lock(lock_);
     StatNameCompare<GetStatName, Obj> compare(*this, get_stat_name);
     std::sort(begin, end, compare);
   }
@@ -396,15 +399,16 @@ private:
   void incRefCount(const StatName& stat_name);
 
   struct SharedSymbol {
-    SharedSymbol(Symbol symbol) : symbol_(symbol) {}
-
-    Symbol symbol_;
-    uint32_t ref_count_{1};
+    SharedSymbol(absl::string_view str, Symbol symbol)
+        : str_(InlineString::create(str)), symbol_(symbol) {}
+
+    const InlineStringPtr str_;
+    const Symbol symbol_;
+    // Only the transition to zero requires the exclusive lock of the symbol's
+    // shard. See free().
+    std::atomic<uint32_t> ref_count_{1};
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
-
   /**
    * Decodes a uint8_t array into an array of period-delimited strings. Note
    * that some of the strings may have periods in them, in the case where
@@ -426,20 +430,45 @@ private:
    * @param sv the individual string to be encoded as a symbol.
    * @return Symbol the encoded string.
    */
-  Symbol toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  Symbol toSymbol(absl::string_view sv);
 
   /**
-   * Convenience function for decode(), decoding one symbol at a time.
+   * Convenience function for decode(), decoding one symbol at a time. The
+   * caller must hold a reference to the symbol.
    *
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const;
+
+  /**
+   * @return the SharedSymbol for a symbol the caller holds a reference to.
+   */
+  SharedSymbol& sharedSymbol(Symbol symbol) const;
 
   /**
-   * Stages a new symbol for use. To be called after a successful insertion.
+   * @return the slot holding the SharedSymbol for symbol, or nullptr if the
+   * segment containing it has not been allocated.
    */
-  void newSymbol();
+  std::atomic<SharedSymbol*>* symbolSlot(Symbol symbol) const;
+
+  /**
+   * Locates the slot of a symbol in the segmented decode array.
+   *
+   * @param symbol the symbol to locate.
+   * @return the index of the segment holding the symbol and the offset of its slot in it.
+   */
+  static std::pair<uint32_t, uint64_t> symbolSegment(Symbol symbol);
+
+  /**
+   * Takes a symbol from the free pool, or allocates a new one, ensuring it has a slot.
+   */
+  Symbol newSymbol();
+
+  /**
+   * Returns a symbol whose slot has been cleared to the free pool.
+   */
+  void releaseSymbol(Symbol symbol);
 
   /**
    * Tokenizes name, finds or allocates symbols for each token, and adds them
@@ -451,30 +480,55 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::MutexLock lock(&symbol_lock_);
     return monotonic_counter_;
   }
 
-  // Stores the symbol to be used at next insertion. This should exist ahead of insertion time so
-  // that if insertion succeeds, the value written is the correct one.
-  Symbol next_symbol_ ABSL_GUARDED_BY(lock_);
+  // The encode map owns the SharedSymbol for each token. Using absl::string_view
+  // lets us only store the complete string once, in the SharedSymbol.
+  using EncodeMap = absl::flat_hash_map<absl::string_view, std::unique_ptr<SharedSymbol>>;
+
+  // The encode map is split into shards by the hash of the token. Shards are
+  // aligned to cache lines so that threads using different shards do not
+  // contend on the same line.
+  static constexpr uint32_t NumShards = 16;
+  struct alignas(64) Shard {
+    mutable absl::Mutex mutex_;
+    EncodeMap encode_map_ ABSL_GUARDED_BY(mutex_);
+  };
+  Shard& shard(absl::string_view token);
+  std::array<Shard, NumShards> shards_;
+
+  // The decode side maps symbols to SharedSymbols with an array of atomic
+  // pointers, so it can be read without locks. The array grows in segments of
+  // doubling size, starting at 2^FirstSegmentBits entries, which are never
+  // moved or freed while the table is alive. Symbols are small integers
+  // allocated densely from the free pool and counter below, so the array stays
+  // proportional to the number of live symbols.
+  static constexpr uint32_t FirstSegmentBits = 6;
+  static constexpr uint32_t NumSegments = 33 - FirstSegmentBits;
+  using Segment = std::unique_ptr<std::atomic<SharedSymbol*>[]>;
+  std::array<std::atomic<std::atomic<SharedSymbol*>*>, NumSegments> segments_{};
+
+  // Guards symbol allocation. This is only taken when a token is added to or
+  // removed from the table, after the shard lock.
+  absl::Mutex symbol_lock_;
 
   // If the free pool is exhausted, we monotonically increase this counter.
-  Symbol monotonic_counter_;
-
-  // Bitmap implementation.
-  // The encode map stores both the symbol and the ref count of that symbol.
-  // Using absl::string_view lets us only store the complete string once, in the decode map.
-  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol>;
-  using DecodeMap = absl::flat_hash_map<Symbol, InlineStringPtr>;
-  EncodeMap encode_map_ ABSL_GUARDED_BY(lock_);
-  DecodeMap decode_map_ ABSL_GUARDED_BY(lock_);
+  Symbol monotonic_counter_ ABSL_GUARDED_BY(symbol_lock_);
 
   // Free pool of symbols for re-use.
   // TODO(ambuc): There might be an optimization here relating to storing ranges of freed symbols
   // using an Envoy::IntervalSet.
-  std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
-  RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+  std::stack<Symbol> pool_ ABSL_GUARDED_BY(symbol_lock_);
+  std::array<Segment, NumSegments> segment_storage_ ABSL_GUARDED_BY(symbol_lock_);
+
+  // The total is counted outside recent_lookups_lock_, which is only needed when
+  // a recent-lookup capacity has been configured.
+  std::atomic<uint64_t> num_lookups_{0};
+  std::atomic<bool> track_recent_lookups_{false};
+  mutable absl::Mutex recent_lookups_lock_;
+  RecentLookups recent_lookups_ ABSL_GUARDED_BY(recent_lookups_lock_);
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
@@ -1065,7 +1119,7 @@ template <class GetStatName, class Obj>
 bool SymbolTable::StatNameCompare<GetStatName, Obj>::operator()(const Obj& a, const Obj& b) const {
   StatName a_stat_name = getter_(a);
   StatName b_stat_name = getter_(b);
-  return symbol_table_.lessThanLockHeld(a_stat_name, b_stat_name);
+  return symbol_table_.lessThan(a_stat_name, b_stat_name);
 }
 
 using SymbolTablePtr = std::unique_ptr<SymbolTable>;
@@ -202,8 +202,10 @@ void ThreadLocalStoreImpl::initializeThreading(Event::Dispatcher& main_thread_di
   threading_ever_initialized_ = true;
   main_thread_dispatcher_ = &main_thread_dispatcher;
   tls_cache_ = ThreadLocal::TypedSlot<TlsCache>::makeUnique(tls);
-  tls_cache_->set(
-      [](Event::Dispatcher&) -> std::shared_ptr<TlsCache> { return std::make_shared<TlsCache>(); });
+  tls_cache_->set([main_thread_dispatcher = main_thread_dispatcher_](
+                      Event::Dispatcher& dispatcher) -> std::shared_ptr<TlsCache> {
+    return std::make_shared<TlsCache>(&dispatcher != main_thread_dispatcher);
+  });
   tls_ = tls;
 }
 
@@ -741,6 +743,72 @@ TextReadout& ThreadLocalStoreImpl::ScopeImpl::textReadoutFromStatNameWithTags(
       tls_cache, tls_rejected_stats, parent_.null_text_readout_);
 }
 
+template <class StatType>
+StatType& ThreadLocalStoreImpl::ScopeImpl::statFromString(
+    const std::string& name,
+    StringMap<std::reference_wrapper<StatType>> TlsCacheEntry::*tls_string_cache,
+    StatType& null_stat, const std::function<StatType&(StatName)>& make_stat) {
+  StringMap<std::reference_wrapper<StatType>>* tls_cache = nullptr;
+  if (!parent_.shutting_down_ && parent_.tls_cache_) {
+    TlsCache& cache = parent_.tlsCache();
+    if (cache.worker_thread_) {
+      // The entry already exists when make_stat looks it up again below, so
+      // tls_cache is not invalidated by that.
+      tls_cache = &(cache.insertScope(scope_id_).*tls_string_cache);
+      auto iter = tls_cache->find(name);
+      if (iter != tls_cache->end()) {
+        return iter->second;
+      }
+    }
+  }
+
+  StatNameManagedStorage storage(name, symbolTable());
+  StatType& stat = make_stat(storage.statName());
+  if (tls_cache != nullptr && &stat != &null_stat) {
+    tls_cache->emplace(name, stat);
+  }
+  return stat;
+}
+
+Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromString(const std::string& name) {
+  return statFromString<Counter>(
+      name, &TlsCacheEntry::counters_by_string_, parent_.null_counter_,
+      [this](StatName stat_name) -> Counter& { return counterFromStatName(stat_name); });
+}
+
+Gauge& ThreadLocalStoreImpl::ScopeImpl::gaugeFromString(const std::string& name,
+                                                        Gauge::ImportMode import_mode) {
+  // Hidden gauges bypass stats rejection, so the cache would conflate them with
+  // rejected gauges of the same name. They are rare enough not to need it.
+  if (import_mode == Gauge::ImportMode::HiddenAccumulate) {
+    StatNameManagedStorage storage(name, symbolTable());
+    return gaugeFromStatName(storage.statName(), import_mode);
+  }
+  Gauge& gauge = statFromString<Gauge>(
+      name, &TlsCacheEntry::gauges_by_string_, parent_.null_gauge_,
+      [this, import_mode](StatName stat_name) -> Gauge& {
+        return gaugeFromStatName(stat_name, import_mode);
+      });
+  // A cached gauge still needs the import mode merged, as gaugeFromStatName() would do.
+  gauge.mergeImportMode(import_mode);
+  return gauge;
+}
+
+Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromString(const std::string& name,
+                                                                Histogram::Unit unit) {
+  return statFromString<Histogram>(
+      name, &TlsCacheEntry::histograms_by_string_, parent_.null_histogram_,
+      [this, unit](StatName stat_name) -> Histogram& {
+        return histogramFromStatName(stat_name, unit);
+      });
+}
+
+TextReadout& ThreadLocalStoreImpl::ScopeImpl::textReadoutFromString(const std::string& name) {
+  return statFromString<TextReadout>(
+      name, &TlsCacheEntry::text_readouts_by_string_, parent_.null_text_readout_,
+      [this](StatName stat_name) -> TextReadout& { return textReadoutFromStatName(stat_name); });
+}
+
 CounterOptConstRef ThreadLocalStoreImpl::ScopeImpl::findCounter(StatName name) const {
   Thread::LockGuard lock(parent_.lock_);
   return findStatLockHeld<Counter>(name, central_cache_->counters_);
@@ -807,27 +875,21 @@ ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Uni
                                                    const StatNameTagVector& stat_name_tags,
                                                    SymbolTable& symbol_table)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
-      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {
-  histograms_[0] = hist_alloc();
-  histograms_[1] = hist_alloc();
-}
+      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {}
 
-ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
-  MetricImpl::clear(symbol_table_);
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
-}
+ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() { MetricImpl::clear(symbol_table_); }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
-  used_ = true;
+  recorders_[current_active_].recordValue(value);
+  // Avoid a sequentially consistent store on every sample once the histogram has been used.
+  if (!used_.load(std::memory_order_relaxed)) {
+    used_ = true;
+  }
 }
 
 void ThreadLocalHistogramImpl::merge(histogram_t* target) {
-  histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
-  hist_accumulate(target, other_histogram, 1);
-  hist_clear(*other_histogram);
+  recorders_[otherHistogramIndex()].mergeInto(target);
 }
 
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
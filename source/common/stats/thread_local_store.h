@@ -40,7 +40,7 @@ public:
   void merge(histogram_t* target);
 
   /**
-   * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
+   * Called in the beginning of merge process. Swaps the recorder used for collection so that we do
    * not have to lock the histogram in high throughput TLS writes.
    */
   void beginMerge() {
@@ -66,7 +66,7 @@ private:
   Histogram::Unit unit_;
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_{0};
-  histogram_t* histograms_[2];
+  HistogramBucketRecorder recorders_[2];
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -261,6 +261,18 @@ private:
     // StatName set here in the TLS cache to avoid taking a lock to compute
     // rejection.
     StatNameHashSet rejected_stats_;
+
+    // Worker threads also cache the stats they look up by string, e.g. with
+    // counterFromString(). Encoding a string into a StatName, and freeing it
+    // again, each take the symbol table lock, which all workers contend on when
+    // they look up the same stats while handling requests. With this cache a
+    // worker only encodes a name the first time it sees it. Like the maps
+    // above, the stats are owned by the CentralCacheEntry. Rejected stats are
+    // not cached here, so the memory is only spent on stats that are recorded.
+    StringMap<std::reference_wrapper<Counter>> counters_by_string_;
+    StringMap<std::reference_wrapper<Gauge>> gauges_by_string_;
+    StringMap<std::reference_wrapper<Histogram>> histograms_by_string_;
+    StringMap<std::reference_wrapper<TextReadout>> text_readouts_by_string_;
   };
 
   struct CentralCacheEntry : public RefcountHelper {
@@ -295,23 +307,10 @@ private:
     const SymbolTable& constSymbolTable() const final { return parent_.constSymbolTable(); }
     SymbolTable& symbolTable() final { return parent_.symbolTable(); }
 
-    Counter& counterFromString(const std::string& name) override {
-      StatNameManagedStorage storage(name, symbolTable());
-      return counterFromStatName(storage.statName());
-    }
-
-    Gauge& gaugeFromString(const std::string& name, Gauge::ImportMode import_mode) override {
-      StatNameManagedStorage storage(name, symbolTable());
-      return gaugeFromStatName(storage.statName(), import_mode);
-    }
-    Histogram& histogramFromString(const std::string& name, Histogram::Unit unit) override {
-      StatNameManagedStorage storage(name, symbolTable());
-      return histogramFromStatName(storage.statName(), unit);
-    }
-    TextReadout& textReadoutFromString(const std::string& name) override {
-      StatNameManagedStorage storage(name, symbolTable());
-      return textReadoutFromStatName(storage.statName());
-    }
+    Counter& counterFromString(const std::string& name) override;
+    Gauge& gaugeFromString(const std::string& name, Gauge::ImportMode import_mode) override;
+    Histogram& histogramFromString(const std::string& name, Histogram::Unit unit) override;
+    TextReadout& textReadoutFromString(const std::string& name) override;
 
     template <class StatMap, class StatFn> bool iterHelper(StatFn fn, const StatMap& map) const {
       for (auto& iter : map) {
@@ -393,6 +392,22 @@ private:
                            MakeStatFn<StatType> make_stat, StatRefMap<StatType>* tls_cache,
                            StatNameHashSet* tls_rejected_stats, StatType& null_stat);
 
+    /**
+     * Looks up a stat by its string name, first in the string cache of the
+     * calling worker thread, and otherwise by encoding the name and calling
+     * make_stat, caching the result.
+     *
+     * @param name the name of the stat, relative to the scope.
+     * @param tls_string_cache the member of TlsCacheEntry holding the string cache for StatType.
+     * @param null_stat the stat returned for rejected names, which is not cached.
+     * @param make_stat a function looking up the stat by its encoded name.
+     */
+    template <class StatType>
+    StatType& statFromString(
+        const std::string& name,
+        StringMap<std::reference_wrapper<StatType>> TlsCacheEntry::*tls_string_cache,
+        StatType& null_stat, const std::function<StatType&(StatName)>& make_stat);
+
     template <class StatType>
     using StatTypeOptConstRef = absl::optional<std::reference_wrapper<const StatType>>;
 
@@ -448,6 +463,8 @@ private:
   };
 
   struct TlsCache : public ThreadLocal::ThreadLocalObject {
+    explicit TlsCache(bool worker_thread) : worker_thread_(worker_thread) {}
+
     TlsCacheEntry& insertScope(uint64_t scope_id);
     void eraseScopes(const std::vector<uint64_t>& scope_ids);
     void eraseHistograms(const std::vector<uint64_t>& histograms);
@@ -463,6 +480,11 @@ private:
 
     // Maps from histogram ID (monotonically increasing) to a TLS histogram.
     absl::flat_hash_map<uint64_t, TlsHistogramSharedPtr> tls_histogram_cache_;
+
+    // Whether this cache belongs to a thread other than the main thread. Only
+    // those threads cache stats by string name; the main thread looks up most
+    // stats once, when creating them, so caching them would only cost memory.
+    const bool worker_thread_;
   };
 
   using ScopeImplSharedPtr = std::shared_ptr<ScopeImpl>;
@@ -12,6 +12,7 @@
 
 #include "envoy/admin/v3/certs.pb.h"
 #include "envoy/common/exception.h"
+#include "envoy/common/key_value_store.h"
 #include "envoy/common/platform.h"
 #include "envoy/ssl/ssl_socket_extended_info.h"
 #include "envoy/stats/scope.h"
@@ -22,6 +23,7 @@
 #include "source/common/common/fmt.h"
 #include "source/common/common/hex.h"
 #include "source/common/common/utility.h"
+#include "source/common/config/utility.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
@@ -93,11 +95,41 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
               static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
           ClientContextImpl* client_context_impl = dynamic_cast<ClientContextImpl*>(context_impl);
           RELEASE_ASSERT(client_context_impl != nullptr, ""); // for Coverity
-          return client_context_impl->newSessionKey(session);
+          return client_context_impl->newSessionKey(ssl, session);
         });
+
+    const auto session_cache_config = config.sessionCacheConfig();
+    if (session_cache_config.has_value()) {
+      KeyValueStorePtr store;
+      if (session_cache_config->has_key_value_config()) {
+        auto& factory = Config::Utility::getAndCheckFactory<KeyValueStoreFactory>(
+            session_cache_config->key_value_config().config());
+        store = factory.createStore(session_cache_config->key_value_config(),
+                                    factory_context.messageValidationVisitor(),
+                                    factory_context.mainThreadDispatcher(),
+                                    factory_context.api().fileSystem());
+      }
+      session_cache_ = std::make_unique<ClientSessionCache>(
+          scope, max_session_keys_,
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(*session_cache_config, max_hosts, 1024),
+          factory_context.mainThreadDispatcher(), std::move(store),
+          tls_contexts_[0].ssl_ctx_.get());
+    }
   }
 }
 
+int ClientContextImpl::sessionCacheKeyIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int session_cache_key_index = SSL_get_ex_new_index(
+        0, nullptr, nullptr, nullptr,
+        [](void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
+          delete static_cast<std::string*>(ptr);
+        });
+    RELEASE_ASSERT(session_cache_key_index >= 0, "");
+    return session_cache_key_index;
+  }());
+}
+
 absl::StatusOr<bssl::UniquePtr<SSL>>
 ClientContextImpl::newSsl(const Network::TransportSocketOptionsConstSharedPtr& options,
                           Upstream::HostDescriptionConstSharedPtr host) {
@@ -158,7 +190,18 @@ ClientContextImpl::newSsl(const Network::TransportSocketOptionsConstSharedPtr& o
 
   SSL_set_enforce_rsa_key_usage(ssl_con.get(), enforce_rsa_key_usage_);
 
-  if (max_session_keys_ > 0) {
+  if (session_cache_ != nullptr) {
+    // Sessions are only offered to the host and SNI that they were established with.
+    auto key = std::make_unique<std::string>(
+        host != nullptr ? absl::StrCat(host->address()->asString(), "/", server_name_indication)
+                        : server_name_indication);
+    bssl::UniquePtr<SSL_SESSION> session = session_cache_->lookup(*key);
+    if (session != nullptr) {
+      SSL_set_session(ssl_con.get(), session.get());
+    }
+    // The key is owned by the connection, and read back when the server issues new sessions.
+    SSL_set_ex_data(ssl_con.get(), sessionCacheKeyIndex(), key.release());
+  } else if (max_session_keys_ > 0) {
     if (session_keys_single_use_) {
       // Stored single-use session keys, use write/write locks.
       absl::WriterMutexLock l(&session_keys_mu_);
@@ -187,7 +230,16 @@ ClientContextImpl::newSsl(const Network::TransportSocketOptionsConstSharedPtr& o
   return ssl_con;
 }
 
-int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
+int ClientContextImpl::newSessionKey(SSL* ssl, SSL_SESSION* session) {
+  if (session_cache_ != nullptr) {
+    const auto* key = static_cast<const std::string*>(SSL_get_ex_data(ssl, sessionCacheKeyIndex()));
+    if (key == nullptr) {
+      return 0; // Tell BoringSSL that we did not take ownership of the session.
+    }
+    session_cache_->insert(*key, bssl::UniquePtr<SSL_SESSION>(session));
+    return 1; // Tell BoringSSL that we took ownership of the session.
+  }
+
   // In case we ever store single-use session key (TLS 1.3),
   // we need to switch to using write/write locks.
   if (SSL_SESSION_should_be_single_use(session)) {
@@ -22,6 +22,7 @@
 #include "source/common/tls/cert_validator/cert_validator.h"
 #include "source/common/tls/context_impl.h"
 #include "source/common/tls/context_manager_impl.h"
+#include "source/common/tls/session_cache.h"
 #include "source/common/tls/stats.h"
 
 #include "absl/synchronization/mutex.h"
@@ -46,13 +47,17 @@ public:
   absl::StatusOr<bssl::UniquePtr<SSL>>
   newSsl(const Network::TransportSocketOptionsConstSharedPtr& options,
          Upstream::HostDescriptionConstSharedPtr host) override;
+  bool allowRenegotiation() const override { return allow_renegotiation_; }
 
 private:
   ClientContextImpl(Stats::Scope& scope, const Envoy::Ssl::ClientContextConfig& config,
                     Server::Configuration::CommonFactoryContext& factory_context,
                     absl::Status& creation_status);
 
-  int newSessionKey(SSL_SESSION* session);
+  int newSessionKey(SSL* ssl, SSL_SESSION* session);
+
+  // Index of the key of the per host session cache in the ex_data of SSL connections.
+  static int sessionCacheKeyIndex();
 
   const std::string server_name_indication_;
   const bool auto_host_sni_;
@@ -62,6 +67,9 @@ private:
   absl::Mutex session_keys_mu_;
   std::deque<bssl::UniquePtr<SSL_SESSION>> session_keys_ ABSL_GUARDED_BY(session_keys_mu_);
   bool session_keys_single_use_{false};
+  // If configured, caches the session keys of each upstream host separately, in place of
+  // session_keys_.
+  std::unique_ptr<ClientSessionCache> session_cache_;
 };
 
 } // namespace Tls
@@ -45,6 +45,7 @@ public:
   const Network::Address::IpList& tlsKeyLogLocal() const override { return *tls_keylog_local_; };
   const Network::Address::IpList& tlsKeyLogRemote() const override { return *tls_keylog_remote_; };
   const std::string& tlsKeyLogPath() const override { return tls_keylog_path_; };
+  bool kernelTlsOffload() const override { return kernel_tls_offload_; }
   AccessLog::AccessLogManager& accessLogManager() const override {
     return factory_context_.serverFactoryContext().accessLogManager();
   }
@@ -116,6 +117,7 @@ private:
   const std::string tls_keylog_path_;
   std::unique_ptr<Network::Address::IpList> tls_keylog_local_;
   std::unique_ptr<Network::Address::IpList> tls_keylog_remote_;
+  const bool kernel_tls_offload_;
 };
 
 class ClientContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ClientContextConfig {
@@ -133,6 +135,10 @@ public:
   bool autoSniSanMatch() const override { return auto_sni_san_match_; }
   bool allowRenegotiation() const override { return allow_renegotiation_; }
   size_t maxSessionKeys() const override { return max_session_keys_; }
+  OptRef<const envoy::extensions::transport_sockets::tls::v3::UpstreamTlsSessionCache>
+  sessionCacheConfig() const override {
+    return makeOptRefFromPtr(session_cache_config_.get());
+  }
   bool enforceRsaKeyUsage() const override { return enforce_rsa_key_usage_; }
 
 private:
@@ -149,6 +155,9 @@ private:
   const bool allow_renegotiation_;
   const bool enforce_rsa_key_usage_;
   const size_t max_session_keys_;
+  const std::unique_ptr<
+      const envoy::extensions::transport_sockets::tls::v3::UpstreamTlsSessionCache>
+      session_cache_config_;
 };
 
 } // namespace Tls
@@ -93,6 +93,16 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return whether the record layer of established connections should be offloaded to the kernel.
+   */
+  bool kernelTlsOffload() const { return kernel_tls_offload_; }
+
+  /**
+   * @return whether connections may renegotiate after the handshake.
+   */
+  virtual bool allowRenegotiation() const { return false; }
+
   /**
    * The global SSL-library index used for storing a pointer to the SslExtendedSocketInfo
    * class in the SSL instance, for retrieval in callbacks.
@@ -173,6 +183,7 @@ protected:
   const Network::Address::IpList tls_keylog_local_;
   const Network::Address::IpList tls_keylog_remote_;
   AccessLog::AccessLogFileSharedPtr tls_keylog_file_;
+  const bool kernel_tls_offload_;
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
@@ -0,0 +1,283 @@
+#include "source/common/tls/kernel_tls.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
+#include "absl/container/fixed_array.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "openssl/hkdf.h"
+#include "openssl/mem.h"
+
+#ifdef __linux__
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+#ifdef __linux__
+
+namespace {
+
+// AES-GCM nonces are made of a fixed salt followed by a per record part.
+constexpr size_t SaltLength = 4;
+constexpr size_t NonceLength = 12;
+
+// The key and nonce of one direction of a connection.
+struct TrafficKeys {
+  ~TrafficKeys() { OPENSSL_cleanse(key_.data(), key_.size()); }
+
+  std::vector<uint8_t> key_;
+  std::array<uint8_t, NonceLength> nonce_{};
+};
+
+void storeBigEndian(uint64_t value, uint8_t* out) {
+  for (int i = 7; i >= 0; --i) {
+    out[i] = value & 0xff;
+    value >>= 8;
+  }
+}
+
+// Returns the key length of connections that can be offloaded.
+absl::StatusOr<size_t> aesGcmKeyLength(const SSL* ssl) {
+  const uint16_t version = SSL_version(ssl);
+  if (version != TLS1_2_VERSION && version != TLS1_3_VERSION) {
+    return absl::UnimplementedError(absl::StrCat("unsupported version ", SSL_get_version(ssl)));
+  }
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+  case NID_aes_128_gcm:
+    return TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+  case NID_aes_256_gcm:
+    return TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+  default:
+    return absl::UnimplementedError(
+        absl::StrCat("unsupported cipher ", SSL_CIPHER_get_name(cipher)));
+  }
+}
+
+absl::StatusOr<TrafficKeys> tls12TrafficKeys(const SSL* ssl, size_t key_length, bool write,
+                                             uint64_t sequence) {
+  // The key block holds the MAC keys, which are empty for AEADs, then the keys and then the salts
+  // of the client and the server, see RFC 5246 section 6.3.
+  const size_t key_block_length = SSL_get_key_block_len(ssl);
+  if (key_block_length != 2 * (key_length + SaltLength)) {
+    return absl::InternalError(absl::StrCat("unexpected key block length ", key_block_length));
+  }
+  std::vector<uint8_t> key_block(key_block_length);
+  if (!SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    return absl::InternalError("failed to generate the key block");
+  }
+
+  const bool client = write != static_cast<bool>(SSL_is_server(ssl));
+  TrafficKeys keys;
+  const uint8_t* key = key_block.data() + (client ? 0 : key_length);
+  keys.key_.assign(key, key + key_length);
+  const uint8_t* salt = key_block.data() + 2 * key_length + (client ? 0 : SaltLength);
+  std::copy(salt, salt + SaltLength, keys.nonce_.begin());
+  // BoringSSL sends the sequence number as the per record part of the nonce.
+  storeBigEndian(sequence, keys.nonce_.data() + SaltLength);
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+  return keys;
+}
+
+// HKDF-Expand-Label with an empty context, see RFC 8446 section 7.1.
+bool hkdfExpandLabel(uint8_t* out, size_t out_length, const EVP_MD* digest, const uint8_t* secret,
+                     size_t secret_length, absl::string_view label) {
+  constexpr absl::string_view LabelPrefix = "tls13 ";
+  std::vector<uint8_t> info;
+  info.push_back(out_length >> 8);
+  info.push_back(out_length & 0xff);
+  info.push_back(LabelPrefix.size() + label.size());
+  info.insert(info.end(), LabelPrefix.begin(), LabelPrefix.end());
+  info.insert(info.end(), label.begin(), label.end());
+  info.push_back(0);
+  return HKDF_expand(out, out_length, digest, secret, secret_length, info.data(), info.size());
+}
+
+absl::StatusOr<TrafficKeys> tls13TrafficKeys(const SSL* ssl, size_t key_length, bool write) {
+#ifdef OPENSSL_IS_AWSLC
+  UNREFERENCED_PARAMETER(ssl);
+  UNREFERENCED_PARAMETER(key_length);
+  UNREFERENCED_PARAMETER(write);
+  return absl::UnimplementedError("TLS 1.3 traffic secrets are not available");
+#else
+  bssl::Span<const uint8_t> read_secret;
+  bssl::Span<const uint8_t> write_secret;
+  if (!bssl::SSL_get_traffic_secrets(ssl, &read_secret, &write_secret)) {
+    return absl::InternalError("failed to get the traffic secrets");
+  }
+  const bssl::Span<const uint8_t> secret = write ? write_secret : read_secret;
+  const EVP_MD* digest = SSL_CIPHER_get_handshake_digest(SSL_get_current_cipher(ssl));
+
+  TrafficKeys keys;
+  keys.key_.resize(key_length);
+  if (!hkdfExpandLabel(keys.key_.data(), keys.key_.size(), digest, secret.data(), secret.size(),
+                       "key") ||
+      !hkdfExpandLabel(keys.nonce_.data(), keys.nonce_.size(), digest, secret.data(),
+                       secret.size(), "iv")) {
+    return absl::InternalError("failed to derive the traffic keys");
+  }
+  return keys;
+#endif
+}
+
+template <class CryptoInfo>
+absl::Status setCryptoInfo(os_fd_t fd, int direction, uint16_t version, uint16_t cipher_type,
+                           const TrafficKeys& keys, uint64_t sequence) {
+  static_assert(sizeof(CryptoInfo::salt) == SaltLength);
+  static_assert(sizeof(CryptoInfo::salt) + sizeof(CryptoInfo::iv) == NonceLength);
+  CryptoInfo info{};
+  RELEASE_ASSERT(keys.key_.size() == sizeof(info.key), "unexpected key length");
+  info.info.version = version;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, keys.key_.data(), sizeof(info.key));
+  memcpy(info.salt, keys.nonce_.data(), sizeof(info.salt));
+  memcpy(info.iv, keys.nonce_.data() + sizeof(info.salt), sizeof(info.iv));
+  storeBigEndian(sequence, info.rec_seq);
+
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().setsockopt(fd, SOL_TLS, direction, &info, sizeof(info));
+  OPENSSL_cleanse(&info, sizeof(info));
+  if (result.return_value_ != 0) {
+    return absl::InternalError(absl::StrCat("failed to install the ",
+                                            direction == TLS_TX ? "write" : "read",
+                                            " keys: ", errorDetails(result.errno_)));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status installKeys(SSL* ssl, os_fd_t fd, bool write) {
+  const absl::StatusOr<size_t> key_length = aesGcmKeyLength(ssl);
+  RETURN_IF_NOT_OK_REF(key_length.status());
+  const uint64_t sequence = write ? SSL_get_write_sequence(ssl) : SSL_get_read_sequence(ssl);
+  const bool tls13 = SSL_version(ssl) == TLS1_3_VERSION;
+  const absl::StatusOr<TrafficKeys> keys =
+      tls13 ? tls13TrafficKeys(ssl, *key_length, write)
+            : tls12TrafficKeys(ssl, *key_length, write, sequence);
+  RETURN_IF_NOT_OK_REF(keys.status());
+
+  const uint16_t version = tls13 ? TLS_1_3_VERSION : TLS_1_2_VERSION;
+  const int direction = write ? TLS_TX : TLS_RX;
+  if (*key_length == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+    return setCryptoInfo<tls12_crypto_info_aes_gcm_128>(fd, direction, version,
+                                                        TLS_CIPHER_AES_GCM_128, *keys, sequence);
+  }
+  return setCryptoInfo<tls12_crypto_info_aes_gcm_256>(fd, direction, version,
+                                                      TLS_CIPHER_AES_GCM_256, *keys, sequence);
+}
+
+} // namespace
+
+absl::Status enableTransmit(SSL* ssl, os_fd_t fd) {
+  // Checked before attaching the TLS upper layer protocol, so that unsupported connections are
+  // left untouched. The protocol on its own doesn't change how the socket behaves.
+  RETURN_IF_NOT_OK(aesGcmKeyLength(ssl).status());
+  static constexpr char Ulp[] = "tls";
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().setsockopt(fd, IPPROTO_TCP, TCP_ULP, Ulp, sizeof(Ulp));
+  if (result.return_value_ != 0) {
+    return absl::UnavailableError(
+        absl::StrCat("kernel TLS is not available: ", errorDetails(result.errno_)));
+  }
+  return installKeys(ssl, fd, true);
+}
+
+absl::Status enableReceive(SSL* ssl, os_fd_t fd) {
+  // Records already read by BoringSSL would be lost to the kernel.
+  if (SSL_has_pending(ssl)) {
+    return absl::FailedPreconditionError("data past the handshake was already read");
+  }
+  return installKeys(ssl, fd, false);
+}
+
+Api::SysCallSizeResult receive(os_fd_t fd, Buffer::RawSlice* slices, uint64_t num_slice,
+                               uint8_t& record_type) {
+  absl::FixedArray<iovec> iov(num_slice);
+  for (uint64_t i = 0; i < num_slice; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+  }
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))];
+  msghdr message{};
+  message.msg_iov = iov.data();
+  message.msg_iovlen = num_slice;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  const Api::SysCallSizeResult result = Api::OsSysCallsSingleton::get().recvmsg(fd, &message, 0);
+  // Without a control message, the records hold application data.
+  record_type = RecordTypeApplicationData;
+  if (result.return_value_ > 0) {
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (cmsg->cmsg_level == SOL_TLS && cmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+        record_type = *CMSG_DATA(cmsg);
+      }
+    }
+  }
+  return result;
+}
+
+Api::SysCallSizeResult sendCloseNotify(os_fd_t fd) {
+  uint8_t alert[] = {SSL3_AL_WARNING, SSL_AD_CLOSE_NOTIFY};
+  iovec iov{alert, sizeof(alert)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))] = {};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = RecordTypeAlert;
+  return Api::OsSysCallsSingleton::get().sendmsg(fd, &message, 0);
+}
+
+#else
+
+absl::Status enableTransmit(SSL*, os_fd_t) {
+  return absl::UnimplementedError("kernel TLS is only supported on Linux");
+}
+
+absl::Status enableReceive(SSL*, os_fd_t) {
+  return absl::UnimplementedError("kernel TLS is only supported on Linux");
+}
+
+Api::SysCallSizeResult receive(os_fd_t, Buffer::RawSlice*, uint64_t, uint8_t&) {
+  PANIC("not implemented");
+}
+
+Api::SysCallSizeResult sendCloseNotify(os_fd_t) { PANIC("not implemented"); }
+
+#endif
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
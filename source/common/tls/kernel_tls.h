@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+
+#include "absl/status/status.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Kernel TLS (kTLS) offload of the record layer of established TLS connections. Once the keys of
+ * a direction are installed on the socket, the kernel encrypts or decrypts the records of that
+ * direction, and application data is written and read with plain socket calls.
+ *
+ * Only TLS 1.2 and TLS 1.3 connections using AES-GCM cipher suites on Linux can be offloaded.
+ */
+namespace KernelTls {
+
+// TLS record content types, see RFC 8446 section 5.1.
+constexpr uint8_t RecordTypeAlert = 21;
+constexpr uint8_t RecordTypeHandshake = 22;
+constexpr uint8_t RecordTypeApplicationData = 23;
+
+/**
+ * Installs the write keys of an established connection on its socket. Once the write keys are
+ * installed, BoringSSL must no longer write to the connection, since its write sequence number is
+ * no longer advanced.
+ * @param ssl supplies the connection, whose handshake is complete and whose writes are flushed.
+ * @param fd supplies the socket of the connection.
+ * @return absl::Status an error if the connection can't be offloaded, in which case nothing was
+ * installed and the connection stays in userspace.
+ */
+absl::Status enableTransmit(SSL* ssl, os_fd_t fd);
+
+/**
+ * Installs the read keys of an established connection on its socket, whose write keys must
+ * already be installed. Once the read keys are installed, BoringSSL must no longer read from the
+ * connection.
+ * @param ssl supplies the connection.
+ * @param fd supplies the socket of the connection.
+ * @return absl::Status an error if reads can't be offloaded, e.g. because BoringSSL has already
+ * read data past the handshake, in which case reads stay in userspace.
+ */
+absl::Status enableReceive(SSL* ssl, os_fd_t fd);
+
+/**
+ * Reads the plaintext of the next records from a socket whose reads are offloaded. Reads never
+ * span records of different types.
+ * @param fd supplies the socket.
+ * @param slices supplies the slices to read into.
+ * @param num_slice supplies the number of slices.
+ * @param record_type set to the content type of the records that were read.
+ * @return Api::SysCallSizeResult the number of bytes read, 0 at the end of the stream.
+ */
+Api::SysCallSizeResult receive(os_fd_t fd, Buffer::RawSlice* slices, uint64_t num_slice,
+                               uint8_t& record_type);
+
+/**
+ * Sends a close_notify alert on a socket whose writes are offloaded.
+ * @param fd supplies the socket.
+ * @return Api::SysCallSizeResult the result of the underlying sendmsg.
+ */
+Api::SysCallSizeResult sendCloseNotify(os_fd_t fd);
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,381 @@
+#include "source/common/tls/private_key/thread_pool_private_key_provider.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+#include "envoy/extensions/transport_sockets/tls/v3/thread_pool_private_key_provider.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+#include "source/common/config/datasource.h"
+#include "source/common/config/utility.h"
+#include "source/common/protobuf/message_validator_impl.h"
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+SINGLETON_MANAGER_REGISTRATION(thread_pool_private_key_provider_pool_manager);
+
+bool PrivateKeyOperation::run() {
+  if (!signature_algorithm_.has_value()) {
+    RSA* rsa = EVP_PKEY_get0_RSA(pkey_.get());
+    if (rsa == nullptr) {
+      return false;
+    }
+    size_t out_len;
+    out_.resize(RSA_size(rsa));
+    if (!RSA_decrypt(rsa, &out_len, out_.data(), out_.size(), in_.data(), in_.size(),
+                     RSA_NO_PADDING)) {
+      return false;
+    }
+    out_.resize(out_len);
+    return true;
+  }
+
+  if (EVP_PKEY_id(pkey_.get()) != SSL_get_signature_algorithm_key_type(*signature_algorithm_)) {
+    return false;
+  }
+  // The digest is nullptr for Ed25519, which signs the whole input.
+  const EVP_MD* md = SSL_get_signature_algorithm_digest(*signature_algorithm_);
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pctx, md, nullptr, pkey_.get())) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(*signature_algorithm_) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) ||
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1 /* salt length is digest length */))) {
+    return false;
+  }
+  size_t out_len = EVP_PKEY_size(pkey_.get());
+  out_.resize(out_len);
+  if (!EVP_DigestSign(ctx.get(), out_.data(), &out_len, in_.data(), in_.size())) {
+    return false;
+  }
+  out_.resize(out_len);
+  return true;
+}
+
+PrivateKeyOperationPool::PrivateKeyOperationPool(Thread::ThreadFactory& thread_factory,
+                                                 uint32_t num_threads,
+                                                 uint32_t max_pending_operations,
+                                                 uint32_t max_batch_size,
+                                                 PrivateKeyOperationPoolStats stats)
+    : max_pending_operations_(max_pending_operations), max_batch_size_(max_batch_size),
+      stats_(stats) {
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(thread_factory.createThread([this]() { threadRoutine(); },
+                                                   Thread::Options{"private_key"}));
+  }
+}
+
+PrivateKeyOperationPool::~PrivateKeyOperationPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutting_down_ = true;
+    stats_.pending_.sub(queue_.size());
+    queue_.clear();
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+bool PrivateKeyOperationPool::enqueue(PrivateKeyOperationSharedPtr operation) {
+  absl::MutexLock lock(&mutex_);
+  if (queue_.size() >= max_pending_operations_) {
+    return false;
+  }
+  queue_.push_back(std::move(operation));
+  stats_.pending_.inc();
+  return true;
+}
+
+void PrivateKeyOperationPool::cancel(PrivateKeyOperation& operation) {
+  ASSERT(operation.dispatcher_.isThreadSafe());
+  absl::MutexLock lock(&mutex_);
+  operation.cancelled_ = true;
+}
+
+void PrivateKeyOperationPool::threadRoutine() {
+  std::vector<PrivateKeyOperationSharedPtr> batch;
+  batch.reserve(max_batch_size_);
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+        return shutting_down_ || !queue_.empty();
+      };
+      mutex_.Await(absl::Condition(&condition));
+      if (shutting_down_) {
+        break;
+      }
+      const size_t batch_size = std::min<size_t>(queue_.size(), max_batch_size_);
+      for (size_t i = 0; i < batch_size; ++i) {
+        if (!queue_.front()->cancelled_) {
+          batch.push_back(std::move(queue_.front()));
+        }
+        queue_.pop_front();
+      }
+      stats_.pending_.sub(batch_size);
+    }
+
+    stats_.batches_.inc();
+    for (const PrivateKeyOperationSharedPtr& operation : batch) {
+      operation->succeeded_ = operation->run();
+    }
+
+    // Hand the results back with a single post to each worker. The mutex is held while posting,
+    // so that the operations can't be cancelled, and their dispatchers can't go away, meanwhile.
+    absl::flat_hash_map<Event::Dispatcher*, std::vector<PrivateKeyOperationSharedPtr>> completed;
+    {
+      absl::MutexLock lock(&mutex_);
+      for (PrivateKeyOperationSharedPtr& operation : batch) {
+        if (!operation->cancelled_) {
+          completed[&operation->dispatcher_].push_back(std::move(operation));
+        }
+      }
+      for (auto& [dispatcher, operations] : completed) {
+        dispatcher->post([operations = std::move(operations)]() {
+          for (const PrivateKeyOperationSharedPtr& operation : operations) {
+            operation->done_ = true;
+            if (!operation->cancelled_) {
+              operation->cb_.onPrivateKeyMethodComplete();
+            }
+          }
+        });
+      }
+    }
+    batch.clear();
+  }
+}
+
+ThreadPoolPrivateKeyConnection::ThreadPoolPrivateKeyConnection(
+    Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher,
+    bssl::UniquePtr<EVP_PKEY> pkey, PrivateKeyOperationPool& pool,
+    ThreadPoolPrivateKeyProviderStats& stats)
+    : cb_(cb), dispatcher_(dispatcher), pkey_(std::move(pkey)), pool_(pool), stats_(stats) {}
+
+ThreadPoolPrivateKeyConnection::~ThreadPoolPrivateKeyConnection() {
+  if (operation_ != nullptr && !operation_->done_) {
+    pool_.cancel(*operation_);
+  }
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::start(
+    absl::optional<uint16_t> signature_algorithm, const uint8_t* in, size_t in_len, uint8_t* out,
+    size_t* out_len, size_t max_out) {
+  auto operation =
+      std::make_shared<PrivateKeyOperation>(dispatcher_, cb_, bssl::UpRef(pkey_), in, in_len);
+  operation->signature_algorithm_ = signature_algorithm;
+  if (pool_.enqueue(operation)) {
+    stats_.offloaded_.inc();
+    operation_ = std::move(operation);
+    return ssl_private_key_retry;
+  }
+
+  // Too many operations are pending, so the handshake is better off waiting for this one on the
+  // worker than in the queue.
+  stats_.inlined_.inc();
+  operation->succeeded_ = operation->run();
+  return copyResult(*operation, out, out_len, max_out);
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::complete(uint8_t* out, size_t* out_len,
+                                                                  size_t max_out) {
+  if (operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  // The handshake may be resumed for other reasons before the operation is done.
+  if (!operation_->done_) {
+    return ssl_private_key_retry;
+  }
+  PrivateKeyOperationSharedPtr operation = std::move(operation_);
+  return copyResult(*operation, out, out_len, max_out);
+}
+
+ssl_private_key_result_t
+ThreadPoolPrivateKeyConnection::copyResult(const PrivateKeyOperation& operation, uint8_t* out,
+                                           size_t* out_len, size_t max_out) {
+  if (!operation.succeeded_) {
+    stats_.failed_.inc();
+    return ssl_private_key_failure;
+  }
+  if (operation.out_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  std::copy(operation.out_.begin(), operation.out_.end(), out);
+  *out_len = operation.out_.size();
+  return ssl_private_key_success;
+}
+
+PrivateKeyOperationPoolManager::PrivateKeyOperationPoolManager(
+    Thread::ThreadFactory& thread_factory, Stats::Scope& scope)
+    : thread_factory_(thread_factory), stats_(generateStats(scope)) {}
+
+PrivateKeyOperationPoolSharedPtr PrivateKeyOperationPoolManager::getPool(
+    uint32_t num_threads, uint32_t max_pending_operations, uint32_t max_batch_size) {
+  const auto key = std::make_tuple(num_threads, max_pending_operations, max_batch_size);
+  auto it = pools_.find(key);
+  if (it != pools_.end()) {
+    PrivateKeyOperationPoolSharedPtr pool = it->second.lock();
+    if (pool != nullptr) {
+      return pool;
+    }
+  }
+
+  absl::erase_if(pools_, [](const auto& entry) { return entry.second.expired(); });
+  auto pool = std::make_shared<PrivateKeyOperationPool>(
+      thread_factory_, num_threads, max_pending_operations, max_batch_size, stats_);
+  pools_[key] = pool;
+  return pool;
+}
+
+PrivateKeyOperationPoolStats PrivateKeyOperationPoolManager::generateStats(Stats::Scope& scope) {
+  std::string prefix("thread_pool_private_key_provider.");
+  return {ALL_PRIVATE_KEY_OPERATION_POOL_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                               POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+namespace {
+
+ThreadPoolPrivateKeyConnection* getConnection(SSL* ssl) {
+  return static_cast<ThreadPoolPrivateKeyConnection*>(
+      SSL_get_ex_data(ssl, ThreadPoolPrivateKeyMethodProvider::connectionIndex()));
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  return connection == nullptr ? ssl_private_key_failure
+                               : connection->start(signature_algorithm, in, in_len, out, out_len,
+                                                   max_out);
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, uint8_t* out, size_t* out_len,
+                                           size_t max_out, const uint8_t* in, size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  return connection == nullptr
+             ? ssl_private_key_failure
+             : connection->start(absl::nullopt, in, in_len, out, out_len, max_out);
+}
+
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  return connection == nullptr ? ssl_private_key_failure
+                               : connection->complete(out, out_len, max_out);
+}
+
+} // namespace
+
+ThreadPoolPrivateKeyProviderStats
+ThreadPoolPrivateKeyMethodProvider::generateStats(Stats::Scope& scope) {
+  std::string prefix("thread_pool_private_key_provider.");
+  return {ALL_THREAD_POOL_PRIVATE_KEY_PROVIDER_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+}
+
+ThreadPoolPrivateKeyMethodProvider::ThreadPoolPrivateKeyMethodProvider(
+    const envoy::extensions::transport_sockets::tls::v3::ThreadPoolPrivateKeyMethodConfig& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context)
+    : stats_(generateStats(factory_context.statsScope())) {
+  Server::Configuration::ServerFactoryContext& server_context =
+      factory_context.serverFactoryContext();
+  const std::string private_key = THROW_OR_RETURN_VALUE(
+      Config::DataSource::read(config.private_key(), false, server_context.api()), std::string);
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  pkey_.reset(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey_ == nullptr) {
+    throw EnvoyException("Failed to read private key.");
+  }
+  const int key_type = EVP_PKEY_id(pkey_.get());
+  if (key_type != EVP_PKEY_RSA && key_type != EVP_PKEY_EC && key_type != EVP_PKEY_ED25519) {
+    throw EnvoyException("Not supported key type, only RSA, EC and Ed25519 are supported.");
+  }
+
+  method_ = std::make_shared<SSL_PRIVATE_KEY_METHOD>();
+  method_->sign = privateKeySign;
+  method_->decrypt = privateKeyDecrypt;
+  method_->complete = privateKeyComplete;
+
+  pool_manager_ = server_context.singletonManager().getTyped<PrivateKeyOperationPoolManager>(
+      SINGLETON_MANAGER_REGISTERED_NAME(thread_pool_private_key_provider_pool_manager),
+      [&server_context] {
+        return std::make_shared<PrivateKeyOperationPoolManager>(
+            server_context.api().threadFactory(), server_context.serverScope());
+      });
+  const uint32_t num_threads = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, num_threads, std::max(1U, server_context.options().concurrency()));
+  pool_ = pool_manager_->getPool(
+      num_threads, PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_pending_operations, 1024),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_batch_size, 16));
+}
+
+void ThreadPoolPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  if (SSL_get_ex_data(ssl, connectionIndex()) != nullptr) {
+    throw EnvoyException("Not registering the thread pool provider twice for same context");
+  }
+  SSL_set_ex_data(ssl, connectionIndex(),
+                  new ThreadPoolPrivateKeyConnection(cb, dispatcher, bssl::UpRef(pkey_), *pool_,
+                                                     stats_));
+}
+
+void ThreadPoolPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+  delete connection;
+}
+
+bool ThreadPoolPrivateKeyMethodProvider::checkFips() {
+  // The operations are the regular BoringSSL ones, so the key only needs to meet the same
+  // requirements as keys used without a provider.
+  switch (EVP_PKEY_id(pkey_.get())) {
+  case EVP_PKEY_RSA: {
+    const int bits = RSA_bits(EVP_PKEY_get0_RSA(pkey_.get()));
+    return bits == 2048 || bits == 3072 || bits == 4096;
+  }
+  case EVP_PKEY_EC: {
+    const int curve =
+        EC_GROUP_get_curve_name(EC_KEY_get0_group(EVP_PKEY_get0_EC_KEY(pkey_.get())));
+    return curve == NID_X9_62_prime256v1 || curve == NID_secp384r1;
+  }
+  default:
+    return false;
+  }
+}
+
+int ThreadPoolPrivateKeyMethodProvider::connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+    return index;
+  }());
+}
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+ThreadPoolPrivateKeyMethodFactory::createPrivateKeyMethodProviderInstance(
+    const envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider& proto_config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  envoy::extensions::transport_sockets::tls::v3::ThreadPoolPrivateKeyMethodConfig config;
+  THROW_IF_NOT_OK(Config::Utility::translateOpaqueConfig(
+      proto_config.typed_config(), ProtobufMessage::getNullValidationVisitor(), config));
+  MessageUtil::validate(config, factory_context.messageValidationVisitor());
+  return std::make_shared<ThreadPoolPrivateKeyMethodProvider>(config, factory_context);
+}
+
+REGISTER_FACTORY(ThreadPoolPrivateKeyMethodFactory, Ssl::PrivateKeyMethodProviderInstanceFactory);
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
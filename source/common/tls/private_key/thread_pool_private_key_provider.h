@@ -0,0 +1,229 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/transport_sockets/tls/v3/thread_pool_private_key_provider.pb.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/ssl/private_key/private_key_config.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#define ALL_THREAD_POOL_PRIVATE_KEY_PROVIDER_STATS(COUNTER)                                        \
+  COUNTER(offloaded)                                                                               \
+  COUNTER(inlined)                                                                                 \
+  COUNTER(failed)
+
+/**
+ * Wrapper struct for thread pool private key provider stats. @see stats_macros.h
+ */
+struct ThreadPoolPrivateKeyProviderStats {
+  ALL_THREAD_POOL_PRIVATE_KEY_PROVIDER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+#define ALL_PRIVATE_KEY_OPERATION_POOL_STATS(COUNTER, GAUGE)                                       \
+  COUNTER(batches)                                                                                 \
+  GAUGE(pending, NeverImport)
+
+/**
+ * Wrapper struct for the stats of the thread pools shared by the providers. @see stats_macros.h
+ */
+struct PrivateKeyOperationPoolStats {
+  ALL_PRIVATE_KEY_OPERATION_POOL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A private key operation of a TLS handshake. Operations are created on a worker, run on the
+ * thread pool, and completed back on the worker.
+ */
+struct PrivateKeyOperation {
+  PrivateKeyOperation(Event::Dispatcher& dispatcher, Ssl::PrivateKeyConnectionCallbacks& cb,
+                      bssl::UniquePtr<EVP_PKEY> pkey, const uint8_t* in, size_t in_len)
+      : dispatcher_(dispatcher), cb_(cb), pkey_(std::move(pkey)), in_(in, in + in_len) {}
+
+  // Runs the operation, storing its result in out_. Returns whether the operation succeeded.
+  bool run();
+
+  Event::Dispatcher& dispatcher_;
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  const bssl::UniquePtr<EVP_PKEY> pkey_;
+  const std::vector<uint8_t> in_;
+  // Signing algorithm, or nullopt for decryption.
+  absl::optional<uint16_t> signature_algorithm_;
+
+  // Set by the thread pool before handing the operation back to the worker.
+  std::vector<uint8_t> out_;
+  bool succeeded_{};
+
+  // Set on the worker once the operation was handed back to it.
+  bool done_{};
+  // Set on the worker, with the pool mutex held, once the connection no longer waits for the
+  // operation. The pool never hands cancelled operations back, so that it never touches the
+  // dispatcher of a connection that may be gone.
+  bool cancelled_{};
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+
+/**
+ * Bounded pool of threads running private key operations. Threads take batches of operations from
+ * a shared queue, and hand the results back to each worker with a single post per batch.
+ */
+class PrivateKeyOperationPool : public Logger::Loggable<Logger::Id::connection> {
+public:
+  PrivateKeyOperationPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads,
+                          uint32_t max_pending_operations, uint32_t max_batch_size,
+                          PrivateKeyOperationPoolStats stats);
+  ~PrivateKeyOperationPool();
+
+  /**
+   * Queues an operation to be run on the pool.
+   * @param operation supplies the operation.
+   * @return false if too many operations are pending, in which case the operation isn't queued.
+   */
+  bool enqueue(PrivateKeyOperationSharedPtr operation);
+
+  /**
+   * Stops the pool from handing the operation back. Must be called on the worker of the operation.
+   * @param operation supplies the operation.
+   */
+  void cancel(PrivateKeyOperation& operation);
+
+private:
+  void threadRoutine();
+
+  const uint32_t max_pending_operations_;
+  const uint32_t max_batch_size_;
+  PrivateKeyOperationPoolStats stats_;
+  absl::Mutex mutex_;
+  std::deque<PrivateKeyOperationSharedPtr> queue_ ABSL_GUARDED_BY(mutex_);
+  bool shutting_down_ ABSL_GUARDED_BY(mutex_){};
+  // The threads must be initialized last so that the above members are already fully initialized.
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using PrivateKeyOperationPoolSharedPtr = std::shared_ptr<PrivateKeyOperationPool>;
+
+/**
+ * Server wide registry of the thread pools, so that all the providers with the same pool settings
+ * share one pool instead of each starting its own threads. Only used on the main thread.
+ */
+class PrivateKeyOperationPoolManager : public Singleton::Instance {
+public:
+  PrivateKeyOperationPoolManager(Thread::ThreadFactory& thread_factory, Stats::Scope& scope);
+
+  /**
+   * @return the pool with the given settings, which is created if no provider uses it yet.
+   */
+  PrivateKeyOperationPoolSharedPtr getPool(uint32_t num_threads, uint32_t max_pending_operations,
+                                           uint32_t max_batch_size);
+
+  static PrivateKeyOperationPoolStats generateStats(Stats::Scope& scope);
+
+private:
+  Thread::ThreadFactory& thread_factory_;
+  const PrivateKeyOperationPoolStats stats_;
+  // Pools are owned by the providers using them, and destroyed with the last one.
+  absl::flat_hash_map<std::tuple<uint32_t, uint32_t, uint32_t>,
+                      std::weak_ptr<PrivateKeyOperationPool>>
+      pools_;
+};
+
+using PrivateKeyOperationPoolManagerSharedPtr = std::shared_ptr<PrivateKeyOperationPoolManager>;
+
+/**
+ * The state of the provider for a TLS connection, stored in its ex_data.
+ */
+class ThreadPoolPrivateKeyConnection {
+public:
+  ThreadPoolPrivateKeyConnection(Ssl::PrivateKeyConnectionCallbacks& cb,
+                                 Event::Dispatcher& dispatcher, bssl::UniquePtr<EVP_PKEY> pkey,
+                                 PrivateKeyOperationPool& pool,
+                                 ThreadPoolPrivateKeyProviderStats& stats);
+  ~ThreadPoolPrivateKeyConnection();
+
+  // Starts an operation, which is run inline if the pool can't take it.
+  ssl_private_key_result_t start(absl::optional<uint16_t> signature_algorithm, const uint8_t* in,
+                                 size_t in_len, uint8_t* out, size_t* out_len, size_t max_out);
+  // Returns the result of the pending operation, if it's done.
+  ssl_private_key_result_t complete(uint8_t* out, size_t* out_len, size_t max_out);
+
+private:
+  ssl_private_key_result_t copyResult(const PrivateKeyOperation& operation, uint8_t* out,
+                                      size_t* out_len, size_t max_out);
+
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  Event::Dispatcher& dispatcher_;
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  PrivateKeyOperationPool& pool_;
+  ThreadPoolPrivateKeyProviderStats& stats_;
+  PrivateKeyOperationSharedPtr operation_;
+};
+
+/**
+ * Private key method provider running the private key operations on a thread pool.
+ */
+class ThreadPoolPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider,
+                                           public Logger::Loggable<Logger::Id::connection> {
+public:
+  ThreadPoolPrivateKeyMethodProvider(
+      const envoy::extensions::transport_sockets::tls::v3::ThreadPoolPrivateKeyMethodConfig&
+          config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context);
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  bool isAvailable() override { return true; }
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override {
+    return method_;
+  }
+
+  const PrivateKeyOperationPool& pool() const { return *pool_; }
+
+  static int connectionIndex();
+  static ThreadPoolPrivateKeyProviderStats generateStats(Stats::Scope& scope);
+
+private:
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  ThreadPoolPrivateKeyProviderStats stats_;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  // Keeps the registry alive, so that providers created later still find the pool.
+  PrivateKeyOperationPoolManagerSharedPtr pool_manager_;
+  PrivateKeyOperationPoolSharedPtr pool_;
+};
+
+class ThreadPoolPrivateKeyMethodFactory : public Ssl::PrivateKeyMethodProviderInstanceFactory {
+public:
+  // Ssl::PrivateKeyMethodProviderInstanceFactory
+  Ssl::PrivateKeyMethodProviderSharedPtr createPrivateKeyMethodProviderInstance(
+      const envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider& config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context) override;
+  std::string name() const override { return "envoy.tls.key_providers.thread_pool"; }
+};
+
+DECLARE_FACTORY(ThreadPoolPrivateKeyMethodFactory);
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
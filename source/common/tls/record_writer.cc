@@ -0,0 +1,116 @@
+#include "source/common/tls/record_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+bool RecordWriter::supported(const SSL* ssl) {
+#ifdef OPENSSL_IS_AWSLC
+  UNREFERENCED_PARAMETER(ssl);
+  return false;
+#else
+  return !SSL_is_dtls(ssl) && SSL_version(ssl) <= TLS1_2_VERSION;
+#endif
+}
+
+bool RecordWriter::seal(SSL* ssl, const Buffer::Instance& plaintext) {
+#ifdef OPENSSL_IS_AWSLC
+  UNREFERENCED_PARAMETER(ssl);
+  UNREFERENCED_PARAMETER(plaintext);
+  PANIC("not supported");
+#else
+  ASSERT(empty() && !SSL_in_init(ssl));
+  records_.clear();
+  next_record_ = 0;
+
+  const uint64_t plaintext_length =
+      std::min(plaintext.length(), MaxRecordLength * MaxRecordsPerBatch);
+  uint64_t batch_length = 0;
+  for (uint64_t remaining = plaintext_length; remaining > 0;) {
+    const size_t length = std::min(remaining, MaxRecordLength);
+    batch_length +=
+        bssl::SealRecordPrefixLen(ssl, length) + length + bssl::SealRecordSuffixLen(ssl, length);
+    remaining -= length;
+  }
+
+  // The records of a batch are sealed back to back into a single slice of the output.
+  Buffer::ReservationSingleSlice reservation = output_.reserveSingleSlice(batch_length);
+  uint8_t* out = static_cast<uint8_t*>(reservation.slice().mem_);
+  const Buffer::RawSliceVector slices = plaintext.getRawSlices();
+  size_t slice_index = 0;
+  uint64_t slice_offset = 0;
+  for (uint64_t remaining = plaintext_length; remaining > 0;) {
+    const size_t length = std::min(remaining, MaxRecordLength);
+    const size_t prefix_length = bssl::SealRecordPrefixLen(ssl, length);
+    const size_t suffix_length = bssl::SealRecordSuffixLen(ssl, length);
+    uint8_t* body = out + prefix_length;
+
+    const uint8_t* in;
+    if (slices[slice_index].len_ - slice_offset >= length) {
+      // The plaintext of the record is contiguous, and is encrypted straight from its slice.
+      in = static_cast<const uint8_t*>(slices[slice_index].mem_) + slice_offset;
+      slice_offset += length;
+    } else {
+      // Coalesce the plaintext of the record, and encrypt it in place.
+      for (uint64_t copied = 0; copied < length;) {
+        const uint64_t n = std::min(length - copied, slices[slice_index].len_ - slice_offset);
+        memcpy(body + copied, static_cast<const uint8_t*>(slices[slice_index].mem_) + slice_offset,
+               n);
+        copied += n;
+        slice_offset += n;
+        if (slice_offset == slices[slice_index].len_) {
+          slice_index++;
+          slice_offset = 0;
+        }
+      }
+      in = body;
+    }
+    if (slice_index < slices.size() && slice_offset == slices[slice_index].len_) {
+      slice_index++;
+      slice_offset = 0;
+    }
+
+    if (!bssl::SealRecord(ssl, bssl::MakeSpan(out, prefix_length), bssl::MakeSpan(body, length),
+                          bssl::MakeSpan(body + length, suffix_length),
+                          bssl::MakeConstSpan(in, length))) {
+      // Nothing is committed, and the connection is closed.
+      return false;
+    }
+    const uint64_t record_length = prefix_length + length + suffix_length;
+    records_.push_back({record_length, length});
+    out += record_length;
+    remaining -= length;
+  }
+
+  reservation.commit(batch_length);
+  write_sequence_ = SSL_get_write_sequence(ssl);
+  return true;
+#endif
+}
+
+uint64_t RecordWriter::onWritten(uint64_t bytes) {
+  uint64_t plaintext_written = 0;
+  while (bytes > 0) {
+    ASSERT(next_record_ < records_.size());
+    PendingRecord& record = records_[next_record_];
+    const uint64_t n = std::min(bytes, record.ciphertext_remaining_);
+    record.ciphertext_remaining_ -= n;
+    bytes -= n;
+    if (record.ciphertext_remaining_ == 0) {
+      plaintext_written += record.plaintext_length_;
+      next_record_++;
+    }
+  }
+  return plaintext_written;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
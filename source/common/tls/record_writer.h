@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+
+#include "source/common/buffer/buffer_impl.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/types/optional.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Writes the application data of an established connection as TLS records that are sealed directly
+ * into a per-connection output buffer, instead of going through SSL_write and the socket BIO.
+ * Plaintext is coalesced into records of the maximum size, records whose plaintext lies in a single
+ * slice are encrypted straight from that slice, and a batch of records is written to the socket
+ * with a single call.
+ *
+ * The plaintext of a record must stay at the front of the write buffer until the record is fully
+ * written, so that the connection doesn't consider data written while its record is still pending.
+ *
+ * BoringSSL only supports sealing records outside of its write path for TLS 1.2 and below.
+ */
+class RecordWriter {
+public:
+  // Maximum plaintext length of a TLS record.
+  static constexpr uint64_t MaxRecordLength = 16384;
+  // Number of records sealed ahead of the socket at a time.
+  static constexpr uint64_t MaxRecordsPerBatch = 4;
+
+  /**
+   * @param ssl supplies an established connection.
+   * @return whether the records of the connection can be sealed by the writer.
+   */
+  static bool supported(const SSL* ssl);
+
+  /**
+   * Seals the next batch of records from the front of the plaintext. Must only be called once the
+   * previous batch was fully written, and while BoringSSL has nothing of its own to write.
+   * @param ssl supplies the connection.
+   * @param plaintext supplies the data to write, which isn't drained.
+   * @return false if a record couldn't be sealed, in which case the error is left in the error
+   * queue of the connection.
+   */
+  bool seal(SSL* ssl, const Buffer::Instance& plaintext);
+
+  /**
+   * Accounts for the bytes of the output written to the socket.
+   * @param bytes supplies the number of bytes written, which were drained from the output.
+   * @return uint64_t the number of plaintext bytes whose records are now fully written, which the
+   * caller drains from the front of the plaintext.
+   */
+  uint64_t onWritten(uint64_t bytes);
+
+  /**
+   * Records the write sequence number of the connection after BoringSSL wrote records of its own.
+   * @param ssl supplies the connection.
+   */
+  void sync(const SSL* ssl) { write_sequence_ = SSL_get_write_sequence(ssl); }
+
+  /**
+   * @param ssl supplies the connection.
+   * @return whether the records written by BoringSSL are accounted for, i.e. whether records sealed
+   * now follow the records already written without anything in between.
+   */
+  bool inSync(const SSL* ssl) const { return write_sequence_ == SSL_get_write_sequence(ssl); }
+
+  /**
+   * @return the sealed records that are still to be written to the socket.
+   */
+  Buffer::Instance& output() { return output_; }
+
+  /**
+   * @return whether all sealed records were written.
+   */
+  bool empty() const { return output_.length() == 0; }
+
+private:
+  struct PendingRecord {
+    uint64_t ciphertext_remaining_;
+    uint64_t plaintext_length_;
+  };
+
+  Buffer::OwnedImpl output_;
+  absl::InlinedVector<PendingRecord, MaxRecordsPerBatch> records_;
+  size_t next_record_{};
+  // The write sequence number following the last record sealed or accounted for. Unset until then,
+  // so that the first record of a connection is written by BoringSSL, which flushes anything it
+  // still has pending.
+  absl::optional<uint64_t> write_sequence_;
+};
+
+using RecordWriterPtr = std::unique_ptr<RecordWriter>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
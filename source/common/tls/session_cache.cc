@@ -0,0 +1,212 @@
+#include "source/common/tls/session_cache.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/base64.h"
+
+#include "absl/hash/hash.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+ClientSessionCacheStats ClientSessionCache::generateStats(Stats::Scope& scope) {
+  std::string prefix("ssl.session_cache.");
+  return {ALL_CLIENT_SESSION_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                         POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+ClientSessionCache::ClientSessionCache(Stats::Scope& scope, size_t max_sessions_per_key,
+                                       size_t max_keys, Event::Dispatcher& main_thread_dispatcher,
+                                       KeyValueStorePtr store, const SSL_CTX* ssl_ctx)
+    : stats_(generateStats(scope)), max_sessions_per_key_(max_sessions_per_key),
+      max_keys_per_shard_(std::max<size_t>(1, (max_keys + NumShards - 1) / NumShards)),
+      main_thread_dispatcher_(main_thread_dispatcher) {
+  ASSERT(max_sessions_per_key_ > 0);
+  if (store != nullptr) {
+    persistence_ = std::make_shared<Persistence>(std::move(store));
+    load(ssl_ctx);
+  }
+}
+
+ClientSessionCache::~ClientSessionCache() {
+  for (Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.mutex_);
+    stats_.hosts_.sub(shard.index_.size());
+  }
+  if (persistence_ == nullptr) {
+    return;
+  }
+  // The store must be flushed and destroyed on the main thread, where it owns its flush timer.
+  if (main_thread_dispatcher_.isThreadSafe()) {
+    persistence_->flush();
+  } else {
+    main_thread_dispatcher_.post(
+        [persistence = std::move(persistence_)]() { persistence->flush(); });
+  }
+}
+
+void ClientSessionCache::load(const SSL_CTX* ssl_ctx) {
+  persistence_->store_->iterate([this, ssl_ctx](const std::string& key, const std::string& value) {
+    const std::string bytes = Base64::decode(value);
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_from_bytes(
+        reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), ssl_ctx));
+    if (session == nullptr) {
+      ENVOY_LOG(debug, "ignoring invalid persisted TLS session for {}", key);
+      return KeyValueStore::Iterate::Continue;
+    }
+    // Keys evicted while loading are not removed from the store, since this may be iterating it.
+    insertIntoShard(key, std::move(session));
+    stats_.loaded_.inc();
+    return KeyValueStore::Iterate::Continue;
+  });
+}
+
+ClientSessionCache::Shard& ClientSessionCache::shardFor(absl::string_view key) {
+  return shards_[absl::Hash<absl::string_view>()(key) % NumShards];
+}
+
+bssl::UniquePtr<SSL_SESSION> ClientSessionCache::lookup(absl::string_view key) {
+  Shard& shard = shardFor(key);
+  bssl::UniquePtr<SSL_SESSION> session;
+  bool consumed_single_use_session = false;
+  bssl::UniquePtr<SSL_SESSION> next_session;
+  {
+    absl::MutexLock lock(&shard.mutex_);
+    auto it = shard.index_.find(key);
+    if (it != shard.index_.end()) {
+      std::list<Entry>::iterator entry = it->second;
+      shard.entries_.splice(shard.entries_.begin(), shard.entries_, entry);
+      // Use the most recently stored session, since it has the highest probability of still being
+      // recognized/accepted by the server.
+      session = bssl::UpRef(entry->sessions_.front());
+      // Remove single-use sessions (TLS 1.3) after first use.
+      if (SSL_SESSION_should_be_single_use(session.get())) {
+        entry->sessions_.pop_front();
+        consumed_single_use_session = true;
+        if (entry->sessions_.empty()) {
+          shard.entries_.erase(entry);
+          shard.index_.erase(it);
+          stats_.hosts_.dec();
+        } else if (persistence_ != nullptr) {
+          next_session = bssl::UpRef(entry->sessions_.front());
+        }
+      }
+    }
+  }
+
+  if (session == nullptr) {
+    stats_.miss_.inc();
+    return nullptr;
+  }
+  stats_.hit_.inc();
+  if (consumed_single_use_session && persistence_ != nullptr) {
+    persist(key, next_session.get());
+  }
+  return session;
+}
+
+void ClientSessionCache::insert(absl::string_view key, bssl::UniquePtr<SSL_SESSION> session) {
+  ASSERT(session != nullptr);
+  bssl::UniquePtr<SSL_SESSION> persisted_session;
+  if (persistence_ != nullptr) {
+    persisted_session = bssl::UpRef(session);
+  }
+  const std::vector<std::string> evicted_keys = insertIntoShard(key, std::move(session));
+  if (persistence_ != nullptr) {
+    for (const std::string& evicted_key : evicted_keys) {
+      persist(evicted_key, nullptr);
+    }
+    persist(key, persisted_session.get());
+  }
+}
+
+std::vector<std::string> ClientSessionCache::insertIntoShard(absl::string_view key,
+                                                             bssl::UniquePtr<SSL_SESSION> session) {
+  std::vector<std::string> evicted_keys;
+  Shard& shard = shardFor(key);
+  absl::MutexLock lock(&shard.mutex_);
+  std::list<Entry>::iterator entry;
+  auto it = shard.index_.find(key);
+  if (it == shard.index_.end()) {
+    shard.entries_.push_front(Entry{std::string(key), {}});
+    entry = shard.entries_.begin();
+    shard.index_.emplace(std::string(key), entry);
+    stats_.hosts_.inc();
+    // Evict the least recently used keys.
+    while (shard.index_.size() > max_keys_per_shard_) {
+      Entry& evicted = shard.entries_.back();
+      evicted_keys.push_back(std::move(evicted.key_));
+      shard.index_.erase(evicted_keys.back());
+      shard.entries_.pop_back();
+      stats_.hosts_.dec();
+      stats_.evicted_.inc();
+    }
+  } else {
+    entry = it->second;
+    shard.entries_.splice(shard.entries_.begin(), shard.entries_, entry);
+  }
+
+  std::deque<bssl::UniquePtr<SSL_SESSION>>& sessions = entry->sessions_;
+  // Evict the oldest sessions, and add the new one at the front so that it's used first.
+  while (sessions.size() >= max_sessions_per_key_) {
+    sessions.pop_back();
+  }
+  sessions.push_front(std::move(session));
+  return evicted_keys;
+}
+
+void ClientSessionCache::persist(absl::string_view key, const SSL_SESSION* session) {
+  absl::optional<PendingWrite> write;
+  if (session != nullptr) {
+    // The store expires the session along with the session itself.
+    const uint32_t timeout = SSL_SESSION_get_timeout(session);
+    uint8_t* bytes;
+    size_t length;
+    if (timeout == 0 || !SSL_SESSION_is_resumable(session) ||
+        !SSL_SESSION_to_bytes(session, &bytes, &length)) {
+      return;
+    }
+    write = PendingWrite{Base64::encode(reinterpret_cast<const char*>(bytes), length),
+                         std::chrono::seconds(timeout)};
+    OPENSSL_free(bytes);
+  }
+
+  bool flush_scheduled;
+  {
+    absl::MutexLock lock(&persistence_->mutex_);
+    flush_scheduled = !persistence_->pending_writes_.empty();
+    persistence_->pending_writes_[std::string(key)] = std::move(write);
+  }
+  // Only one flush is posted for all the writes made until it runs.
+  if (!flush_scheduled) {
+    main_thread_dispatcher_.post(
+        [weak_persistence = std::weak_ptr<Persistence>(persistence_)]() {
+          if (std::shared_ptr<Persistence> persistence = weak_persistence.lock()) {
+            persistence->flush();
+          }
+        });
+  }
+}
+
+void ClientSessionCache::Persistence::flush() {
+  absl::flat_hash_map<std::string, absl::optional<PendingWrite>> pending_writes;
+  {
+    absl::MutexLock lock(&mutex_);
+    pending_writes.swap(pending_writes_);
+  }
+  for (const auto& [key, write] : pending_writes) {
+    if (write.has_value()) {
+      store_->addOrUpdate(key, write->value_, write->ttl_);
+    } else {
+      store_->remove(key);
+    }
+  }
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
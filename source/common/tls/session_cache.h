@@ -0,0 +1,143 @@
+#pragma once
+
+#include <openssl/ssl.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/key_value_store.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#define ALL_CLIENT_SESSION_CACHE_STATS(COUNTER, GAUGE)                                             \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(evicted)                                                                                 \
+  COUNTER(loaded)                                                                                  \
+  GAUGE(hosts, NeverImport)
+
+/**
+ * Wrapper struct for client session cache stats. @see stats_macros.h
+ */
+struct ClientSessionCacheStats {
+  ALL_CLIENT_SESSION_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Cache of client TLS sessions, keyed by the upstream host and SNI they were established with, so
+ * that sessions are only offered to the hosts that issued them. A single cache is shared by all of
+ * the workers using a client context. Keys are spread over shards, each with its own lock and its
+ * own least recently used eviction of keys, so that handshakes on different workers rarely
+ * contend with each other.
+ *
+ * Sessions may be persisted to a key value store, in which case they are loaded back from it when
+ * the cache is created. The store is only ever accessed on the main thread: writes from workers are
+ * coalesced and posted to it.
+ */
+class ClientSessionCache : Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @param scope supplies the scope of the cache statistics.
+   * @param max_sessions_per_key supplies the maximum number of sessions to keep for each key.
+   * @param max_keys supplies the maximum number of keys to keep sessions for.
+   * @param main_thread_dispatcher supplies the dispatcher of the thread owning the store.
+   * @param store supplies the store to persist sessions to, or nullptr not to persist them.
+   * @param ssl_ctx supplies the context to load the persisted sessions with.
+   */
+  ClientSessionCache(Stats::Scope& scope, size_t max_sessions_per_key, size_t max_keys,
+                     Event::Dispatcher& main_thread_dispatcher, KeyValueStorePtr store,
+                     const SSL_CTX* ssl_ctx);
+  ~ClientSessionCache();
+
+  /**
+   * @param key supplies the key to look up.
+   * @return the most recently inserted session of the key, or nullptr if there is none. Sessions
+   *         that should only be used once are removed from the cache.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::string_view key);
+
+  /**
+   * Inserts a session for the key, evicting its oldest session if the key already holds the
+   * maximum number of sessions.
+   * @param key supplies the key of the session.
+   * @param session supplies the session.
+   */
+  void insert(absl::string_view key, bssl::UniquePtr<SSL_SESSION> session);
+
+  static ClientSessionCacheStats generateStats(Stats::Scope& scope);
+
+  static constexpr size_t NumShards = 16;
+
+private:
+  struct Entry {
+    std::string key_;
+    // Most recently inserted sessions first.
+    std::deque<bssl::UniquePtr<SSL_SESSION>> sessions_;
+  };
+
+  struct Shard {
+    absl::Mutex mutex_;
+    // Most recently used keys first.
+    std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+    absl::flat_hash_map<std::string, std::list<Entry>::iterator> index_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  struct PendingWrite {
+    std::string value_;
+    std::chrono::seconds ttl_;
+  };
+
+  // State shared with the callbacks posted to the main thread, which may outlive the cache.
+  struct Persistence {
+    Persistence(KeyValueStorePtr store) : store_(std::move(store)) {}
+
+    // Applies the pending writes to the store. Must be called on the main thread.
+    void flush();
+
+    // Only accessed on the main thread.
+    KeyValueStorePtr store_;
+    absl::Mutex mutex_;
+    // The latest write of each key since the last flush, or nullopt to remove the key.
+    absl::flat_hash_map<std::string, absl::optional<PendingWrite>>
+        pending_writes_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Shard& shardFor(absl::string_view key);
+  // Inserts the session and returns the keys evicted to make room for it.
+  std::vector<std::string> insertIntoShard(absl::string_view key,
+                                           bssl::UniquePtr<SSL_SESSION> session);
+  void load(const SSL_CTX* ssl_ctx);
+  // Persists the session as the latest one of the key, or removes the key if it is nullptr.
+  void persist(absl::string_view key, const SSL_SESSION* session);
+
+  ClientSessionCacheStats stats_;
+  const size_t max_sessions_per_key_;
+  const size_t max_keys_per_shard_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  std::shared_ptr<Persistence> persistence_;
+  std::array<Shard, NumShards> shards_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
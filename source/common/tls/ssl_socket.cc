@@ -1,12 +1,18 @@
 #include "source/common/tls/ssl_socket.h"
 
+#include <typeinfo>
+
 #include "envoy/stats/scope.h"
 
 #include "source/common/common/assert.h"
 #include "source/common/common/empty_string.h"
 #include "source/common/common/hex.h"
+#include "source/common/common/utility.h"
 #include "source/common/http/headers.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/tls/io_handle_bio.h"
+#include "source/common/tls/kernel_tls.h"
 #include "source/common/tls/ssl_handshaker.h"
 #include "source/common/tls/utility.h"
 
@@ -117,6 +123,10 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (ktls_receive_) {
+    return doReadKernelTls(read_buffer);
+  }
+
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
@@ -172,6 +182,62 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
   return {action, bytes_read, end_stream};
 }
 
+Network::IoResult SslSocket::doReadKernelTls(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  bool end_stream = false;
+  uint64_t bytes_read = 0;
+  while (true) {
+    Buffer::Reservation reservation = read_buffer.reserveForRead();
+    uint8_t record_type;
+    const Api::SysCallSizeResult result =
+        KernelTls::receive(callbacks_->ioHandle().fdDoNotUse(), reservation.slices(),
+                           reservation.numSlices(), record_type);
+    ENVOY_CONN_LOG(trace, "kernel tls read returns: {}", callbacks_->connection(),
+                   result.return_value_);
+    if (result.return_value_ < 0) {
+      if (result.errno_ != SOCKET_ERROR_AGAIN) {
+        // The kernel fails reads of records that can't be decrypted.
+        failure_reason_ = absl::StrCat("TLS_error:|kernel TLS read: ", errorDetails(result.errno_),
+                                       ":TLS_error_end");
+        ctx_->stats().connection_error_.inc();
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+    if (result.return_value_ == 0) {
+      // Non-graceful shutdown by closing the underlying socket.
+      end_stream = true;
+      break;
+    }
+    if (record_type != KernelTls::RecordTypeApplicationData) {
+      const uint8_t* record = static_cast<const uint8_t*>(reservation.slices()[0].mem_);
+      if (record_type == KernelTls::RecordTypeAlert && result.return_value_ == 2 &&
+          record[1] == SSL_AD_CLOSE_NOTIFY) {
+        // Graceful shutdown using close_notify TLS alert.
+        end_stream = true;
+      } else {
+        // Other alerts are fatal, and post-handshake messages such as key updates can't be handed
+        // back to BoringSSL.
+        failure_reason_ = absl::StrCat("TLS_error:|kernel TLS read: unexpected record of type ",
+                                       static_cast<int>(record_type), ":TLS_error_end");
+        ctx_->stats().connection_error_.inc();
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+
+    reservation.commit(result.return_value_);
+    bytes_read += result.return_value_;
+    if (callbacks_->shouldDrainReadBuffer()) {
+      callbacks_->setTransportSocketIsReadable();
+      break;
+    }
+  }
+
+  ENVOY_CONN_LOG(trace, "kernel tls read {} bytes", callbacks_->connection(), bytes_read);
+  return {action, bytes_read, end_stream};
+}
+
 void SslSocket::onPrivateKeyMethodComplete() { resumeHandshake(); }
 
 void SslSocket::resumeHandshake() {
@@ -191,6 +257,15 @@ Network::Connection& SslSocket::connection() const { return callbacks_->connecti
 
 void SslSocket::onSuccess(SSL* ssl) {
   ctx_->logHandshake(ssl);
+  if (ctx_->kernelTlsOffload()) {
+    enableKernelTls();
+  }
+  // Renegotiations are written by BoringSSL while reading, which can't be ordered with the records
+  // sealed by the writer.
+  if (!ktls_transmit_ && !ctx_->allowRenegotiation() && RecordWriter::supported(ssl) &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.tls_seal_records")) {
+    record_writer_ = std::make_unique<RecordWriter>();
+  }
   if (callbacks_->connection().streamInfo().upstreamInfo()) {
     callbacks_->connection()
         .streamInfo()
@@ -206,6 +281,47 @@ void SslSocket::onSuccess(SSL* ssl) {
 
 void SslSocket::onFailure() { drainErrorQueue(); }
 
+void SslSocket::enableKernelTls() {
+  // Offloaded reads and alerts use the file descriptor directly, bypassing the IO handle. Other IO
+  // handles may own reads of their own, e.g. io_uring's multishot receives, or intercept reads and
+  // writes, so only the default one is offloaded.
+  if (typeid(callbacks_->ioHandle()) != typeid(Network::IoSocketHandleImpl)) {
+    ENVOY_CONN_LOG(debug, "kernel TLS offload unavailable: unsupported IO handle",
+                   callbacks_->connection());
+    ctx_->stats().ktls_fallback_.inc();
+    return;
+  }
+  SSL* ssl = rawSsl();
+  const os_fd_t fd = callbacks_->ioHandle().fdDoNotUse();
+  absl::Status status = KernelTls::enableTransmit(ssl, fd);
+  if (!status.ok()) {
+    ENVOY_CONN_LOG(debug, "kernel TLS offload unavailable: {}", callbacks_->connection(),
+                   status.message());
+    ctx_->stats().ktls_fallback_.inc();
+    return;
+  }
+  ktls_transmit_ = true;
+  ctx_->stats().ktls_transmit_.inc();
+  // BoringSSL's write state is stale once writes are offloaded. Should BoringSSL still need to
+  // write, e.g. to answer a key update, the write fails and closes the connection instead of
+  // corrupting it.
+  SSL_set0_wbio(ssl, BIO_new_mem_buf("", 0));
+
+  // The kernel can't hand handshake messages received after the handshake back to BoringSSL, such
+  // as the session tickets sent to TLS 1.3 clients, or renegotiations.
+  if (!SSL_is_server(ssl) && (SSL_version(ssl) == TLS1_3_VERSION || ctx_->allowRenegotiation())) {
+    return;
+  }
+  status = KernelTls::enableReceive(ssl, fd);
+  if (!status.ok()) {
+    ENVOY_CONN_LOG(debug, "kernel TLS read offload unavailable: {}", callbacks_->connection(),
+                   status.message());
+    return;
+  }
+  ktls_receive_ = true;
+  ctx_->stats().ktls_receive_.inc();
+}
+
 PostIoAction SslSocket::doHandshake() { return info_->doHandshake(); }
 
 void SslSocket::drainErrorQueue() {
@@ -263,6 +379,36 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (ktls_transmit_) {
+    return doWriteKernelTls(write_buffer, end_stream);
+  }
+
+  if (record_writer_ != nullptr) {
+    return doWriteRecords(write_buffer, end_stream);
+  }
+
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    // TODO(mattklein123): As it relates to our fairness efforts, we might want to limit the number
+    // of iterations of this loop, either by pure iterations, bytes written, etc.
+    const absl::optional<uint64_t> bytes_written = sslWrite(write_buffer);
+    if (!bytes_written.has_value()) {
+      return {PostIoAction::Close, total_bytes_written, false};
+    }
+    if (bytes_written.value() == 0) {
+      break;
+    }
+    total_bytes_written += bytes_written.value();
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
+absl::optional<uint64_t> SslSocket::sslWrite(Buffer::Instance& write_buffer) {
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
@@ -271,39 +417,96 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
   }
 
-  uint64_t total_bytes_written = 0;
-  while (bytes_to_write > 0) {
-    // TODO(mattklein123): As it relates to our fairness efforts, we might want to limit the number
-    // of iterations of this loop, either by pure iterations, bytes written, etc.
+  // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
+  // it again with the same parameters. This is done by tracking last write size, but not write
+  // data, since linearize() will return the same undrained data anyway.
+  ASSERT(bytes_to_write <= write_buffer.length());
+  int rc = SSL_write(rawSsl(), write_buffer.linearize(bytes_to_write), bytes_to_write);
+  ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
+  if (rc > 0) {
+    ASSERT(rc == static_cast<int>(bytes_to_write));
+    write_buffer.drain(rc);
+    return rc;
+  }
 
-    // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
-    // it again with the same parameters. This is done by tracking last write size, but not write
-    // data, since linearize() will return the same undrained data anyway.
-    ASSERT(bytes_to_write <= write_buffer.length());
-    int rc = SSL_write(rawSsl(), write_buffer.linearize(bytes_to_write), bytes_to_write);
-    ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
-    if (rc > 0) {
-      ASSERT(rc == static_cast<int>(bytes_to_write));
-      total_bytes_written += rc;
-      write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
-    } else {
-      int err = SSL_get_error(rawSsl(), rc);
-      ENVOY_CONN_LOG(trace, "ssl error occurred while write: {}", callbacks_->connection(),
-                     Utility::getErrorDescription(err));
-      switch (err) {
-      case SSL_ERROR_WANT_WRITE:
-        bytes_to_retry_ = bytes_to_write;
-        break;
-      case SSL_ERROR_WANT_READ:
-      // Renegotiation has started. We don't handle renegotiation so just fall through.
-      default:
-        drainErrorQueue();
+  int err = SSL_get_error(rawSsl(), rc);
+  ENVOY_CONN_LOG(trace, "ssl error occurred while write: {}", callbacks_->connection(),
+                 Utility::getErrorDescription(err));
+  switch (err) {
+  case SSL_ERROR_WANT_WRITE:
+    bytes_to_retry_ = bytes_to_write;
+    return 0;
+  case SSL_ERROR_WANT_READ:
+  // Renegotiation has started. We don't handle renegotiation so just fall through.
+  default:
+    drainErrorQueue();
+    return absl::nullopt;
+  }
+}
+
+Network::IoResult SslSocket::doWriteRecords(Buffer::Instance& write_buffer, bool end_stream) {
+  uint64_t total_bytes_written = 0;
+  while (true) {
+    if (!record_writer_->empty()) {
+      Api::IoCallUint64Result result = callbacks_->ioHandle().write(record_writer_->output());
+      ENVOY_CONN_LOG(trace, "ssl record write returns: {}", callbacks_->connection(),
+                     result.return_value_);
+      if (!result.ok()) {
+        if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+          break;
+        }
+        ENVOY_CONN_LOG(debug, "ssl record write error: {}", callbacks_->connection(),
+                       result.err_->getErrorDetails());
         return {PostIoAction::Close, total_bytes_written, false};
       }
-
+      // The plaintext of a record is only drained once the record is fully written.
+      const uint64_t bytes_written = record_writer_->onWritten(result.return_value_);
+      write_buffer.drain(bytes_written);
+      total_bytes_written += bytes_written;
+    } else if (write_buffer.length() == 0) {
       break;
+    } else if (bytes_to_retry_ > 0 || SSL_in_init(rawSsl()) ||
+               !record_writer_->inSync(rawSsl())) {
+      // BoringSSL has records of its own to write first, such as a record whose write must be
+      // retried. Writing the next record with SSL_write flushes them in order.
+      const absl::optional<uint64_t> bytes_written = sslWrite(write_buffer);
+      if (!bytes_written.has_value()) {
+        return {PostIoAction::Close, total_bytes_written, false};
+      }
+      if (bytes_written.value() == 0) {
+        break;
+      }
+      record_writer_->sync(rawSsl());
+      total_bytes_written += bytes_written.value();
+    } else if (!record_writer_->seal(rawSsl(), write_buffer)) {
+      drainErrorQueue();
+      return {PostIoAction::Close, total_bytes_written, false};
+    }
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
+Network::IoResult SslSocket::doWriteKernelTls(Buffer::Instance& write_buffer, bool end_stream) {
+  // The kernel splits the data into records, so the slices are written as they are.
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    Api::IoCallUint64Result result = callbacks_->ioHandle().write(write_buffer);
+    ENVOY_CONN_LOG(trace, "kernel tls write returns: {}", callbacks_->connection(),
+                   result.return_value_);
+    if (!result.ok()) {
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        break;
+      }
+      ENVOY_CONN_LOG(debug, "kernel tls write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      return {PostIoAction::Close, total_bytes_written, false};
     }
+    total_bytes_written += result.return_value_;
   }
 
   if (write_buffer.length() == 0 && end_stream) {
@@ -321,19 +524,31 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
-    int rc = SSL_shutdown(rawSsl());
-    if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
-      // Windows operate under `EmulatedEdge`. These are level events that are artificially
-      // made to behave like edge events. And if the rc is 0 then in that case we want read
-      // activation resumption. This code is protected with an `constexpr` if, to minimize the tax
-      // on POSIX systems that operate in Edge events.
-      if (rc == 0) {
-        // See https://www.openssl.org/docs/manmaster/man3/SSL_shutdown.html
-        // if return value is 0,  Call SSL_read() to do a bidirectional shutdown.
-        callbacks_->setTransportSocketIsReadable();
+    if (ktls_transmit_) {
+      // BoringSSL can no longer write, so the kernel sends the close_notify alert.
+      const Api::SysCallSizeResult result =
+          KernelTls::sendCloseNotify(callbacks_->ioHandle().fdDoNotUse());
+      ENVOY_CONN_LOG(debug, "kernel TLS shutdown: rc={}", callbacks_->connection(),
+                     result.return_value_);
+    } else if (record_writer_ != nullptr && !record_writer_->empty()) {
+      // The close_notify alert can't be written ahead of the sealed records that are still
+      // pending, so the connection is closed without it.
+      ENVOY_CONN_LOG(debug, "SSL shutdown: records pending", callbacks_->connection());
+    } else {
+      int rc = SSL_shutdown(rawSsl());
+      if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
+        // Windows operate under `EmulatedEdge`. These are level events that are artificially
+        // made to behave like edge events. And if the rc is 0 then in that case we want read
+        // activation resumption. This code is protected with an `constexpr` if, to minimize the
+        // tax on POSIX systems that operate in Edge events.
+        if (rc == 0) {
+          // See https://www.openssl.org/docs/manmaster/man3/SSL_shutdown.html
+          // if return value is 0,  Call SSL_read() to do a bidirectional shutdown.
+          callbacks_->setTransportSocketIsReadable();
+        }
       }
+      ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
     }
-    ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
     drainErrorQueue();
     info_->setState(Ssl::SocketState::ShutdownSent);
   }
@@ -16,6 +16,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/network/transport_socket_options_impl.h"
 #include "source/common/tls/context_impl.h"
+#include "source/common/tls/record_writer.h"
 #include "source/common/tls/ssl_handshaker.h"
 #include "source/common/tls/utility.h"
 
@@ -94,6 +95,13 @@ private:
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
   Network::PostIoAction doHandshake();
+  void enableKernelTls();
+  Network::IoResult doReadKernelTls(Buffer::Instance& read_buffer);
+  Network::IoResult doWriteKernelTls(Buffer::Instance& write_buffer, bool end_stream);
+  Network::IoResult doWriteRecords(Buffer::Instance& write_buffer, bool end_stream);
+  // Writes the next record with SSL_write. Returns the number of bytes written, which is 0 if the
+  // write needs to be retried, or nullopt on error.
+  absl::optional<uint64_t> sslWrite(Buffer::Instance& write_buffer);
   void drainErrorQueue();
   void shutdownSsl();
   void shutdownBasic();
@@ -104,6 +112,11 @@ private:
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
   std::string failure_reason_;
+  // Whether the writes and reads of the connection are offloaded to the kernel.
+  bool ktls_transmit_{};
+  bool ktls_receive_{};
+  // Set when the records of the connection are sealed outside of SSL_write.
+  RecordWriterPtr record_writer_;
 
   SslHandshakerImplSharedPtr info_;
 };
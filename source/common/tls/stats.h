@@ -21,6 +21,9 @@ namespace Tls {
   COUNTER(ocsp_staple_omitted)                                                                     \
   COUNTER(ocsp_staple_responses)                                                                   \
   COUNTER(ocsp_staple_requests)                                                                    \
+  COUNTER(ktls_transmit)                                                                           \
+  COUNTER(ktls_receive)                                                                            \
+  COUNTER(ktls_fallback)                                                                           \
   COUNTER(was_key_usage_invalid)
 
 /**
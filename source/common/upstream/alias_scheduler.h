@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "envoy/common/random_generator.h"
+#include "envoy/upstream/scheduler.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+// Alias Table Scheduler
+// ---------------------
+// This scheduler performs weighted random selection in constant time using Vose's alias method.
+// The table holds one column per object. Each column is split into two parts: the object the
+// column belongs to, with the probability needed to make up that object's weight, and an "alias"
+// object filling the rest of the column. A pick draws a column uniformly, then flips a biased coin
+// to choose between the column's object and its alias.
+//
+// Adding an object will cause the scheduler to rebuild the table on the first pick that follows,
+// which is linear on the number of objects. Subsequent picks are constant time, regardless of the
+// number of objects or the range of their weights. Adding objects is always constant time.
+//
+// Picks are independent weighted random selections, so unlike EDF the scheduler does not spread
+// the picks of an object evenly over time. It only converges to the expected selection
+// probabilities over many picks.
+//
+// NOTE: While the base scheduler interface allows for mutation of object weights with each pick,
+// this implementation only uses the weights provided when objects are added. It is meant for
+// objects whose weights rarely change, in which case the scheduler should be rebuilt when they do.
+template <class C> class AliasScheduler : public Scheduler<C> {
+public:
+  AliasScheduler(Random::RandomGenerator& random) : random_(random) {}
+
+  std::shared_ptr<C> peekAgain(std::function<double(const C&)>) override {
+    std::shared_ptr<C> picked = pick(random_.random());
+    if (picked != nullptr) {
+      prepick_queue_.emplace(picked);
+    }
+    return picked;
+  }
+
+  std::shared_ptr<C> pickAndAdd(std::function<double(const C&)>) override {
+    while (!prepick_queue_.empty()) {
+      // In case some entries are expired, pop the queue until an unexpired entry is found.
+      std::shared_ptr<C> prepicked_obj = prepick_queue_.front().lock();
+      prepick_queue_.pop();
+      if (prepicked_obj != nullptr) {
+        return prepicked_obj;
+      }
+    }
+    return pick(random_.random());
+  }
+
+  void add(double weight, std::shared_ptr<C> entry) override {
+    ASSERT(weight > 0);
+    entries_.push_back({weight, std::move(entry)});
+    rebuild_table_ = true;
+  }
+
+  bool empty() const override { return entries_.empty(); }
+
+  /**
+   * Picks an object using the given random value, without consuming any random numbers from the
+   * scheduler's generator. The low 32 bits of the value choose the column of the table and the high
+   * 32 bits choose between the column's object and its alias, so the value should be uniformly
+   * distributed over all 64 bits.
+   * @param random_value the random value to pick with.
+   * @return the picked object, or nullptr if the scheduler holds no unexpired objects.
+   */
+  std::shared_ptr<C> pick(uint64_t random_value) {
+    while (!entries_.empty()) {
+      maybeRebuildTable();
+      const uint64_t index = ((random_value & 0xFFFFFFFF) * table_.size()) >> 32;
+      const Column& column = table_[index];
+      const uint32_t entry_index = (random_value >> 32) < column.threshold_ ? index : column.alias_;
+      std::shared_ptr<C> obj = entries_[entry_index].entry_.lock();
+      if (obj != nullptr) {
+        return obj;
+      }
+      // The picked object expired. Drop all of the expired objects and try again with a fresh
+      // random value, as the old one is biased towards the expired object's columns.
+      purgeExpired();
+      random_value = random_.random();
+    }
+    return nullptr;
+  }
+
+private:
+  struct Entry {
+    double weight_;
+    std::weak_ptr<C> entry_;
+  };
+
+  struct Column {
+    // The column's own object is picked if the coin is below the threshold, which is the
+    // probability of picking it scaled to 2^32. A threshold of 2^32 never picks the alias.
+    uint64_t threshold_;
+    uint32_t alias_;
+  };
+
+  void purgeExpired() {
+    std::vector<Entry> entries;
+    entries.reserve(entries_.size());
+    for (auto& entry : entries_) {
+      if (!entry.entry_.expired()) {
+        entries.push_back(std::move(entry));
+      }
+    }
+    entries_ = std::move(entries);
+    rebuild_table_ = true;
+  }
+
+  // If needed, such as after object expiry or addition, rebuild the alias table using Vose's
+  // method: columns whose object is below the average weight are topped up by an object above it.
+  void maybeRebuildTable() {
+    if (!rebuild_table_) {
+      return;
+    }
+
+    const size_t size = entries_.size();
+    double weight_sum = 0;
+    for (const auto& entry : entries_) {
+      weight_sum += entry.weight_;
+    }
+
+    // Weights scaled so that the average weight is 1.
+    std::vector<double> scaled_weights;
+    scaled_weights.reserve(size);
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (uint32_t i = 0; i < size; ++i) {
+      scaled_weights.push_back(entries_[i].weight_ * size / weight_sum);
+      (scaled_weights.back() < 1.0 ? small : large).push_back(i);
+    }
+
+    table_.assign(size, Column{FullThreshold, 0});
+    while (!small.empty() && !large.empty()) {
+      const uint32_t less = small.back();
+      small.pop_back();
+      const uint32_t more = large.back();
+      large.pop_back();
+
+      table_[less] = {static_cast<uint64_t>(scaled_weights[less] * FullThreshold), more};
+      scaled_weights[more] = (scaled_weights[more] + scaled_weights[less]) - 1.0;
+      (scaled_weights[more] < 1.0 ? small : large).push_back(more);
+    }
+    // Any columns left over are full up to floating point error, and keep their default of never
+    // picking the alias.
+
+    rebuild_table_ = false;
+  }
+
+  static constexpr uint64_t FullThreshold = uint64_t(1) << 32;
+
+  Random::RandomGenerator& random_;
+
+  // Objects already picked via peekAgain().
+  std::queue<std::weak_ptr<C>> prepick_queue_;
+
+  // The objects in the order they were added, along with their weights.
+  std::vector<Entry> entries_;
+
+  // The alias table, with one column per object in entries_.
+  std::vector<Column> table_;
+
+  // Keeps state that determines whether the alias table needs to be rebuilt, as any addition or
+  // expiry of objects changes the selection probabilities of all of them.
+  bool rebuild_table_{true};
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -7,6 +7,7 @@
 
 #include "source/common/common/fmt.h"
 #include "source/common/config/resource_name.h"
+#include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/flat_hash_set.h"
@@ -50,7 +51,8 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
             fmt::format("{}: duplicate cluster {} found", cluster_name, cluster_name));
         continue;
       }
-      auto update_or_error = cm_.addOrUpdateCluster(cluster, resource.get().version());
+      auto update_or_error = cm_.addOrUpdateCdsCluster(cluster, resource.get().version(),
+                                                       MessageUtil::hash(cluster));
       if (!update_or_error.status().ok()) {
         exception_msgs.push_back(
             fmt::format("{}: {}", cluster_name, update_or_error.status().message()));
@@ -3,6 +3,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/grpc/common.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -44,9 +45,11 @@ absl::Status CdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourc
                                         const std::string& version_info) {
   auto all_existing_clusters = cm_.clusters();
   // Exclude the clusters which CDS wants to add.
+  absl::flat_hash_set<absl::string_view> added_clusters;
   for (const auto& resource : resources) {
     all_existing_clusters.active_clusters_.erase(resource.get().name());
     all_existing_clusters.warming_clusters_.erase(resource.get().name());
+    added_clusters.insert(resource.get().name());
   }
   Protobuf::RepeatedPtrField<std::string> to_remove_repeated;
   for (const auto& [cluster_name, _] : all_existing_clusters.active_clusters_) {
@@ -60,6 +63,14 @@ absl::Status CdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourc
       *to_remove_repeated.Add() = cluster_name;
     }
   }
+  if (all_existing_clusters.lazy_clusters_.has_value()) {
+    all_existing_clusters.lazy_clusters_->iterate(
+        [&added_clusters, &to_remove_repeated](const std::string& cluster_name) {
+          if (!added_clusters.contains(cluster_name)) {
+            *to_remove_repeated.Add() = cluster_name;
+          }
+        });
+  }
   return onConfigUpdate(resources, to_remove_repeated, version_info);
 }
 
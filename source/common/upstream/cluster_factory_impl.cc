@@ -14,13 +14,8 @@
 namespace Envoy {
 namespace Upstream {
 
-absl::StatusOr<std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr>>
-ClusterFactoryImplBase::create(const envoy::config::cluster::v3::Cluster& cluster,
-                               Server::Configuration::ServerFactoryContext& server_context,
-                               ClusterManager& cm, LazyCreateDnsResolver dns_resolver_fn,
-                               Ssl::ContextManager& ssl_context_manager,
-                               Outlier::EventLoggerSharedPtr outlier_event_logger,
-                               bool added_via_api) {
+absl::StatusOr<ClusterFactory*>
+ClusterFactoryImplBase::getFactory(const envoy::config::cluster::v3::Cluster& cluster) {
   std::string cluster_name;
   std::string cluster_config_type_name;
 
@@ -74,6 +69,19 @@ ClusterFactoryImplBase::create(const envoy::config::cluster::v3::Cluster& cluste
         "Cannot use hostname for consistent hashing loadbalancing for cluster of type: '{}'",
         cluster_name));
   }
+  return factory;
+}
+
+absl::StatusOr<std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr>>
+ClusterFactoryImplBase::create(const envoy::config::cluster::v3::Cluster& cluster,
+                               Server::Configuration::ServerFactoryContext& server_context,
+                               ClusterManager& cm, LazyCreateDnsResolver dns_resolver_fn,
+                               Ssl::ContextManager& ssl_context_manager,
+                               Outlier::EventLoggerSharedPtr outlier_event_logger,
+                               bool added_via_api) {
+  absl::StatusOr<ClusterFactory*> factory_or_error = getFactory(cluster);
+  RETURN_IF_NOT_OK_REF(factory_or_error.status());
+  ClusterFactory* factory = factory_or_error.value();
 
   ClusterFactoryContextImpl context(server_context, cm, dns_resolver_fn, ssl_context_manager,
                                     std::move(outlier_event_logger), added_via_api);
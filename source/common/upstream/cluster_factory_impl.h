@@ -101,6 +101,12 @@ private:
 class ClusterFactoryImplBase : public ClusterFactory {
 public:
   using LazyCreateDnsResolver = std::function<Network::DnsResolverSharedPtr()>;
+  /**
+   * Static method to get the registered cluster factory of a cluster, without creating it.
+   */
+  static absl::StatusOr<ClusterFactory*>
+  getFactory(const envoy::config::cluster::v3::Cluster& cluster);
+
   /**
    * Static method to get the registered cluster factory and create an instance of cluster.
    */
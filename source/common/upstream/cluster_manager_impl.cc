@@ -23,6 +23,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/thread.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/custom_config_validators_impl.h"
 #include "source/common/config/null_grpc_mux_impl.h"
@@ -329,6 +330,7 @@ ClusterManagerImpl::ClusterManagerImpl(
     : server_(server), factory_(factory), runtime_(runtime), stats_(stats), tls_(tls),
       xds_manager_(xds_manager), random_(api.randomGenerator()),
       deferred_cluster_creation_(bootstrap.cluster_manager().enable_deferred_cluster_creation()),
+      lazy_cds_clusters_(bootstrap.cluster_manager().enable_lazy_cds_clusters()),
       bind_config_(bootstrap.cluster_manager().has_upstream_bind_config()
                        ? absl::make_optional(bootstrap.cluster_manager().upstream_bind_config())
                        : absl::nullopt),
@@ -891,7 +893,8 @@ void ClusterManagerImpl::applyUpdates(ClusterManagerCluster& cluster, uint32_t p
 absl::StatusOr<bool>
 ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                                        const std::string& version_info,
-                                       const bool avoid_cds_removal) {
+                                       const bool avoid_cds_removal,
+                                       absl::optional<uint64_t> cluster_hash) {
   // First we need to see if this new config is new or an update to an existing dynamic cluster.
   // We don't allow updates to statically configured clusters in the main configuration. We check
   // both the warming clusters and the active clusters to see if we need an update or the update
@@ -899,7 +902,7 @@ ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster
   const std::string& cluster_name = cluster.name();
   const auto existing_active_cluster = active_clusters_.find(cluster_name);
   const auto existing_warming_cluster = warming_clusters_.find(cluster_name);
-  const uint64_t new_hash = MessageUtil::hash(cluster);
+  const uint64_t new_hash = cluster_hash.has_value() ? *cluster_hash : MessageUtil::hash(cluster);
   if (existing_warming_cluster != warming_clusters_.end()) {
     // If the cluster is the same as the warming cluster of the same name, block the update.
     if (existing_warming_cluster->second->blockUpdate(new_hash)) {
@@ -976,7 +979,97 @@ void ClusterManagerImpl::clusterWarmingToActive(const std::string& cluster_name)
   warming_clusters_.erase(warming_it);
 }
 
+absl::StatusOr<bool>
+ClusterManagerImpl::addOrUpdateCdsCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                          const std::string& version_info,
+                                          uint64_t cluster_hash) {
+  // Clusters that are already loaded, or requested while they were not, are updated as usual.
+  const std::string& cluster_name = cluster.name();
+  if (!lazy_cds_clusters_ || active_clusters_.contains(cluster_name) ||
+      warming_clusters_.contains(cluster_name) ||
+      pending_cluster_creations_.contains(cluster_name)) {
+    return addOrUpdateCluster(cluster, version_info, /*avoid_cds_removal=*/false, cluster_hash);
+  }
+
+  auto existing_lazy_cluster = lazy_clusters_.find(cluster_name);
+  const bool is_new = existing_lazy_cluster == lazy_clusters_.end();
+  if (!is_new && existing_lazy_cluster->second.config_hash_ == cluster_hash) {
+    return false;
+  }
+  // Reject an invalid cluster now, so that it is not ACKed, rather than when it is first
+  // requested.
+  RETURN_IF_NOT_OK(validateLazyCluster(cluster));
+  ENVOY_LOG(debug, "{} lazy cluster {}", is_new ? "adding" : "updating", cluster_name);
+  LazyCluster& lazy_cluster = lazy_clusters_[cluster_name];
+  lazy_cluster.config_ = cluster;
+  lazy_cluster.version_info_ = version_info;
+  lazy_cluster.config_hash_ = cluster_hash;
+  lazy_cluster.last_updated_ = time_source_.systemTime();
+  // The cluster_added counter is only bumped once the cluster is loaded.
+  cm_stats_.lazy_clusters_.set(lazy_clusters_.size());
+  return true;
+}
+
+absl::Status
+ClusterManagerImpl::validateLazyCluster(const envoy::config::cluster::v3::Cluster& cluster) {
+  // Only run the checks that do not need the cluster to be built, since building it for every
+  // lazy cluster would cost as much as loading it. Errors found by the cluster and load balancer
+  // factories are reported when the cluster is first requested.
+  RETURN_IF_NOT_OK(ClusterFactoryImplBase::getFactory(cluster).status());
+
+  const TypedLoadBalancerFactory* lb_factory = nullptr;
+  if (cluster.has_load_balancing_policy() ||
+      cluster.lb_policy() == envoy::config::cluster::v3::Cluster::LOAD_BALANCING_POLICY_CONFIG) {
+    for (const auto& policy : cluster.load_balancing_policy().policies()) {
+      lb_factory = Config::Utility::getAndCheckFactory<TypedLoadBalancerFactory>(
+          policy.typed_extension_config(), /*is_optional=*/true);
+      if (lb_factory != nullptr) {
+        break;
+      }
+    }
+    if (lb_factory == nullptr) {
+      return absl::InvalidArgumentError(
+          fmt::format("cluster: didn't find a registered load balancer factory "
+                      "implementation for cluster: '{}'",
+                      cluster.name()));
+    }
+  } else {
+    auto lb_pair = LegacyLbPolicyConfigHelper::getTypedLbConfigFromLegacyProto(
+        server_.serverFactoryContext(), cluster);
+    RETURN_IF_NOT_OK_REF(lb_pair.status());
+    lb_factory = lb_pair->factory;
+  }
+
+  // Whether a cluster provides its own load balancer is only known without building it for the
+  // built-in cluster types, of which only ORIGINAL_DST provides one.
+  if (cluster.has_cluster_type()) {
+    return absl::OkStatus();
+  }
+  const bool has_cluster_lb = cluster.type() == envoy::config::cluster::v3::Cluster::ORIGINAL_DST;
+  return checkClusterProvidedLb(cluster.name(), *lb_factory, has_cluster_lb);
+}
+
+absl::Status ClusterManagerImpl::loadLazyCluster(LazyClusterMap::iterator lazy_cluster) {
+  ENVOY_LOG(debug, "cm odcds: loading lazy cluster {}", lazy_cluster->first);
+  // Take the cluster out of the lazy map first, so that addOrUpdateCluster() sees it as a new
+  // cluster.
+  LazyCluster cluster = std::move(lazy_cluster->second);
+  lazy_clusters_.erase(lazy_cluster);
+  cm_stats_.lazy_clusters_.set(lazy_clusters_.size());
+  cm_stats_.lazy_cluster_loaded_.inc();
+  return addOrUpdateCluster(cluster.config_, cluster.version_info_, /*avoid_cds_removal=*/false,
+                            cluster.config_hash_)
+      .status();
+}
+
 bool ClusterManagerImpl::removeCluster(const std::string& cluster_name, const bool remove_ignored) {
+  if (lazy_clusters_.erase(cluster_name) > 0) {
+    // A cluster that was never loaded has nothing else to tear down.
+    ENVOY_LOG(debug, "removing lazy cluster {}", cluster_name);
+    cm_stats_.lazy_clusters_.set(lazy_clusters_.size());
+    return true;
+  }
+
   bool removed = false;
   auto existing_active_cluster = active_clusters_.find(cluster_name);
   if (existing_active_cluster != active_clusters_.end() &&
@@ -1057,19 +1150,8 @@ ClusterManagerImpl::loadCluster(const envoy::config::cluster::v3::Cluster& clust
   TypedLoadBalancerFactory& typed_lb_factory = cluster_info->loadBalancerFactory();
   const bool cluster_provided_lb =
       typed_lb_factory.name() == "envoy.load_balancing_policies.cluster_provided";
-
-  if (cluster_provided_lb && lb == nullptr) {
-    return absl::InvalidArgumentError(
-        fmt::format("cluster manager: cluster provided LB specified but cluster "
-                    "'{}' did not provide one. Check cluster documentation.",
-                    cluster_info->name()));
-  }
-  if (!cluster_provided_lb && lb != nullptr) {
-    return absl::InvalidArgumentError(
-        fmt::format("cluster manager: cluster provided LB not specified but cluster "
-                    "'{}' provided one. Check cluster documentation.",
-                    cluster_info->name()));
-  }
+  RETURN_IF_NOT_OK(checkClusterProvidedLb(cluster_info->name(), cluster_info->loadBalancerFactory(),
+                                          lb != nullptr));
 
   if (new_cluster->healthChecker() != nullptr) {
     new_cluster->healthChecker()->addHostCheckCompleteCb(
@@ -1120,6 +1202,26 @@ ClusterManagerImpl::loadCluster(const envoy::config::cluster::v3::Cluster& clust
   return result;
 }
 
+absl::Status ClusterManagerImpl::checkClusterProvidedLb(absl::string_view cluster_name,
+                                                        const TypedLoadBalancerFactory& lb_factory,
+                                                        bool has_cluster_lb) {
+  const bool cluster_provided_lb =
+      lb_factory.name() == "envoy.load_balancing_policies.cluster_provided";
+  if (cluster_provided_lb && !has_cluster_lb) {
+    return absl::InvalidArgumentError(
+        fmt::format("cluster manager: cluster provided LB specified but cluster "
+                    "'{}' did not provide one. Check cluster documentation.",
+                    cluster_name));
+  }
+  if (!cluster_provided_lb && has_cluster_lb) {
+    return absl::InvalidArgumentError(
+        fmt::format("cluster manager: cluster provided LB not specified but cluster "
+                    "'{}' provided one. Check cluster documentation.",
+                    cluster_name));
+  }
+  return absl::OkStatus();
+}
+
 void ClusterManagerImpl::updateClusterCounts() {
   // This if/else block implements a control flow mechanism that can be used by an ADS
   // implementation to properly sequence CDS and RDS updates. It is not enforcing on ADS. ADS can
@@ -1778,15 +1880,31 @@ ClusterManagerImpl::requestOnDemandClusterDiscovery(OdCdsApiSharedPtr odcds, std
       // it means that it was other worker thread that requested the discovery.
       return;
     }
-    // Start the discovery. If the cluster gets discovered, cluster manager will warm it up and
-    // invoke the cluster lifecycle callbacks, that will in turn invoke our callback.
-    odcds->updateOnDemand(name);
+    auto lazy_cluster = lazy_clusters_.find(name);
+    if (lazy_cluster == lazy_clusters_.end()) {
+      // Start the discovery. If the cluster gets discovered, cluster manager will warm it up and
+      // invoke the cluster lifecycle callbacks, that will in turn invoke our callback.
+      odcds->updateOnDemand(name);
+    }
     // Setup the discovery timeout timer to avoid keeping callbacks indefinitely.
     auto timer = dispatcher_.createTimer([this, name] { notifyExpiredDiscovery(name); });
     timer->enableTimer(timeout);
     // Keep odcds handle alive for the duration of the discovery process.
-    pending_cluster_creations_.insert(
-        {std::move(name), ClusterCreation{std::move(odcds), std::move(timer)}});
+    pending_cluster_creations_.insert({name, ClusterCreation{std::move(odcds), std::move(timer)}});
+
+    if (lazy_cluster != lazy_clusters_.end()) {
+      // The cluster is already known from CDS, so it only needs to be loaded. Once warmed, the
+      // cluster lifecycle callbacks invoke our callback, as for a discovered cluster. This is done
+      // after registering the pending creation, as warming may complete synchronously.
+      absl::Status status;
+      TRY_ASSERT_MAIN_THREAD { status = loadLazyCluster(lazy_cluster); }
+      END_TRY
+      CATCH(const EnvoyException& e, { status = absl::InvalidArgumentError(e.what()); });
+      if (!status.ok()) {
+        ENVOY_LOG(warn, "cm odcds: failed to load lazy cluster {}: {}", name, status.message());
+        notifyMissingCluster(name);
+      }
+    }
   });
 
   // We can't "just" return handle here, because handle is a part of the structured binding done
@@ -1892,6 +2010,18 @@ ClusterManagerImpl::dumpClusterConfigs(const Matchers::StringMatcher& name_match
                                           *(dynamic_cluster.mutable_last_updated()));
   }
 
+  // Lazy clusters are ACKed CDS clusters that are not loaded yet, so they are dumped as active.
+  for (const auto& [cluster_name, cluster] : lazy_clusters_) {
+    if (!name_matcher.match(cluster_name)) {
+      continue;
+    }
+    auto& dynamic_cluster = *config_dump->mutable_dynamic_active_clusters()->Add();
+    dynamic_cluster.set_version_info(cluster.version_info_);
+    dynamic_cluster.mutable_cluster()->PackFrom(cluster.config_);
+    TimestampUtil::systemClockToTimestamp(cluster.last_updated_,
+                                          *(dynamic_cluster.mutable_last_updated()));
+  }
+
   return config_dump;
 }
 
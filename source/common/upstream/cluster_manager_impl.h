@@ -214,7 +214,9 @@ private:
   COUNTER(cluster_updated_via_merge)                                                               \
   COUNTER(update_merge_cancelled)                                                                  \
   COUNTER(update_out_of_merge_window)                                                              \
+  COUNTER(lazy_cluster_loaded)                                                                     \
   GAUGE(active_clusters, NeverImport)                                                              \
+  GAUGE(lazy_clusters, NeverImport)                                                                \
   GAUGE(warming_clusters, NeverImport)
 
 /**
@@ -251,9 +253,13 @@ public:
   std::size_t warmingClusterCount() const { return warming_clusters_.size(); }
 
   // Upstream::ClusterManager
-  absl::StatusOr<bool> addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
-                                          const std::string& version_info,
-                                          const bool avoid_cds_removal = false) override;
+  absl::StatusOr<bool>
+  addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                     const std::string& version_info, const bool avoid_cds_removal = false,
+                     absl::optional<uint64_t> cluster_hash = absl::nullopt) override;
+  absl::StatusOr<bool> addOrUpdateCdsCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                             const std::string& version_info,
+                                             uint64_t cluster_hash) override;
 
   void setPrimaryClustersInitializedCb(PrimaryClustersReadyCallback callback) override {
     init_helper_.setPrimaryClustersInitializedCb(callback);
@@ -277,6 +283,7 @@ public:
         ++clusters_maps.added_via_api_clusters_num_;
       }
     }
+    clusters_maps.lazy_clusters_ = lazy_cluster_lookup_;
     // The number of clusters that were added via API must be at most the number
     // of active clusters + number of warming clusters.
     ASSERT(clusters_maps.added_via_api_clusters_num_ <=
@@ -861,11 +868,48 @@ private:
 
   using ClusterCreationsMap = absl::flat_hash_map<std::string, ClusterCreation>;
 
+  /**
+   * The configuration of a cluster received via CDS that is not loaded until it is first
+   * requested through on-demand discovery.
+   */
+  struct LazyCluster {
+    envoy::config::cluster::v3::Cluster config_;
+    std::string version_info_;
+    uint64_t config_hash_;
+    SystemTime last_updated_;
+  };
+
+  using LazyClusterMap = absl::flat_hash_map<std::string, LazyCluster>;
+
+  /**
+   * Lets ClusterInfoMaps look up the lazy clusters without copying their names.
+   */
+  class LazyClusterLookup : public LazyClusters {
+  public:
+    explicit LazyClusterLookup(const LazyClusterMap& clusters) : clusters_(clusters) {}
+
+    // ClusterManager::LazyClusters
+    bool contains(absl::string_view cluster) const override { return clusters_.contains(cluster); }
+    void iterate(const std::function<void(const std::string&)>& cb) const override {
+      for (const auto& cluster : clusters_) {
+        cb(cluster.first);
+      }
+    }
+
+  private:
+    const LazyClusterMap& clusters_;
+  };
+
   void applyUpdates(ClusterManagerCluster& cluster, uint32_t priority, PendingUpdates& updates);
   bool scheduleUpdate(ClusterManagerCluster& cluster, uint32_t priority, bool mergeable,
                       const uint64_t timeout);
   ProtobufTypes::MessagePtr dumpClusterConfigs(const Matchers::StringMatcher& name_matcher);
   static ClusterManagerStats generateStats(Stats::Scope& scope);
+  absl::Status validateLazyCluster(const envoy::config::cluster::v3::Cluster& cluster);
+  absl::Status loadLazyCluster(LazyClusterMap::iterator lazy_cluster);
+  static absl::Status checkClusterProvidedLb(absl::string_view cluster_name,
+                                             const TypedLoadBalancerFactory& lb_factory,
+                                             bool has_cluster_lb);
 
   /**
    * @return ClusterDataPtr contains the previous cluster in the cluster_map, or
@@ -919,6 +963,7 @@ private:
   Config::XdsManager& xds_manager_;
   Random::RandomGenerator& random_;
   const bool deferred_cluster_creation_;
+  const bool lazy_cds_clusters_;
   absl::optional<envoy::config::core::v3::BindConfig> bind_config_;
   Outlier::EventLoggerSharedPtr outlier_event_logger_;
   const LocalInfo::LocalInfo& local_info_;
@@ -953,6 +998,8 @@ private:
 
   std::unique_ptr<Config::SubscriptionFactoryImpl> subscription_factory_;
   ClusterSet primary_clusters_;
+  LazyClusterMap lazy_clusters_;
+  const LazyClusterLookup lazy_cluster_lookup_{lazy_clusters_};
 
   bool initialized_{};
   bool ads_mux_initialized_{};
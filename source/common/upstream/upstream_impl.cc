@@ -381,6 +381,28 @@ createUpstreamLocalAddressSelector(
   return selector_or_error.value();
 }
 
+bool sameHosts(const HostVector& lhs, const HostVector& rhs) { return lhs == rhs; }
+
+template <class TagT>
+bool sameHosts(const Phantom<HostVector, TagT>& lhs, const Phantom<HostVector, TagT>& rhs) {
+  return lhs == rhs;
+}
+
+bool sameHosts(const HostsPerLocality& lhs, const HostsPerLocality& rhs) {
+  return lhs.hasLocalLocality() == rhs.hasLocalLocality() && lhs.get() == rhs.get();
+}
+
+// Replaces a freshly partitioned host vector with the one currently installed when both hold the
+// same hosts in the same order. Vectors are shared with the worker copies of the host set, so
+// preserving their identity lets load balancers skip the work for vectors an update left alone.
+template <class T>
+void reuseIfUnchanged(std::shared_ptr<const T>& updated, const std::shared_ptr<const T>& current) {
+  if (updated != nullptr && current != nullptr && updated != current &&
+      sameHosts(*updated, *current)) {
+    updated = current;
+  }
+}
+
 } // namespace
 
 // Allow disabling ALPN checks for transport sockets. See
@@ -710,6 +732,18 @@ void HostSetImpl::updateHosts(PrioritySet::UpdateHostsParams&& update_hosts_para
     ASSERT(overprovisioning_factor.value() > 0);
     overprovisioning_factor_ = overprovisioning_factor.value();
   }
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.incremental_host_set_updates")) {
+    reuseIfUnchanged(update_hosts_params.hosts, hosts_);
+    reuseIfUnchanged(update_hosts_params.healthy_hosts, healthy_hosts_);
+    reuseIfUnchanged(update_hosts_params.degraded_hosts, degraded_hosts_);
+    reuseIfUnchanged(update_hosts_params.excluded_hosts, excluded_hosts_);
+    reuseIfUnchanged(update_hosts_params.hosts_per_locality, hosts_per_locality_);
+    reuseIfUnchanged(update_hosts_params.healthy_hosts_per_locality, healthy_hosts_per_locality_);
+    reuseIfUnchanged(update_hosts_params.degraded_hosts_per_locality,
+                     degraded_hosts_per_locality_);
+    reuseIfUnchanged(update_hosts_params.excluded_hosts_per_locality,
+                     excluded_hosts_per_locality_);
+  }
   hosts_ = std::move(update_hosts_params.hosts);
   healthy_hosts_ = std::move(update_hosts_params.healthy_hosts);
   degraded_hosts_ = std::move(update_hosts_params.degraded_hosts);
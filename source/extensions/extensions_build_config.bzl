@@ -506,6 +506,7 @@ EXTENSIONS = {
     "envoy.load_balancing_policies.subset":            "//source/extensions/load_balancing_policies/subset:config",
     "envoy.load_balancing_policies.cluster_provided":  "//source/extensions/load_balancing_policies/cluster_provided:config",
     "envoy.load_balancing_policies.client_side_weighted_round_robin": "//source/extensions/load_balancing_policies/client_side_weighted_round_robin:config",
+    "envoy.load_balancing_policies.peak_ewma":         "//source/extensions/load_balancing_policies/peak_ewma:config",
 
     #
     # HTTP Early Header Mutation
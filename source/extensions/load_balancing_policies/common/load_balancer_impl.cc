@@ -28,20 +28,6 @@ static const std::string RuntimeZoneEnabled = "upstream.zone_routing.enabled";
 static const std::string RuntimeMinClusterSize = "upstream.zone_routing.min_cluster_size";
 static const std::string RuntimePanicThreshold = "upstream.healthy_panic_threshold";
 
-// Returns true if the weights of all the hosts in the HostVector are equal.
-bool hostWeightsAreEqual(const HostVector& hosts) {
-  if (hosts.size() <= 1) {
-    return true;
-  }
-  const uint32_t weight = hosts[0]->weight();
-  for (size_t i = 1; i < hosts.size(); ++i) {
-    if (hosts[i]->weight() != weight) {
-      return false;
-    }
-  }
-  return true;
-}
-
 } // namespace
 
 std::pair<int32_t, size_t> distributeLoad(PriorityLoad& per_priority_load,
@@ -848,6 +834,19 @@ const HostVector& ZoneAwareLoadBalancerBase::hostSourceToHosts(HostsSource hosts
   PANIC_DUE_TO_CORRUPT_ENUM;
 }
 
+bool ZoneAwareLoadBalancerBase::hostWeightsAreEqual(const HostVector& hosts) {
+  if (hosts.size() <= 1) {
+    return true;
+  }
+  const uint32_t weight = hosts[0]->weight();
+  for (size_t i = 1; i < hosts.size(); ++i) {
+    if (hosts[i]->weight() != weight) {
+      return false;
+    }
+  }
+  return true;
+}
+
 EdfLoadBalancerBase::EdfLoadBalancerBase(
     const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterLbStats& stats,
     Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
@@ -869,12 +868,13 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
                                          ? PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(
                                                slow_start_config.value(), min_weight_percent, 10) /
                                                100.0
-                                         : 0.1) {
-  // We fully recompute the schedulers for a given host set here on membership change, which is
-  // consistent with what other LB implementations do (e.g. thread aware).
-  // The downside of a full recompute is that time complexity is O(n * log n),
-  // so we will need to do better at delta tracking to scale (see
-  // https://github.com/envoyproxy/envoy/issues/2874).
+                                         : 0.1),
+      incremental_host_set_updates_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.incremental_host_set_updates")) {
+  // We recompute the schedulers for a given host set here on membership change, which is
+  // consistent with what other LB implementations do (e.g. thread aware). A full recompute is
+  // O(n * log n), so weighted schedulers whose hosts are unchanged or only gained hosts are updated
+  // in place instead (see https://github.com/envoyproxy/envoy/issues/2874).
   priority_update_cb_ = priority_set.addPriorityUpdateCb(
       [this](uint32_t priority, const HostVector&, const HostVector&) {
         refresh(priority);
@@ -919,10 +919,55 @@ void EdfLoadBalancerBase::recalculateHostsInSlowStart(const HostVector& hosts) {
   }
 }
 
+bool EdfLoadBalancerBase::updateSchedulerInPlace(Scheduler& scheduler, const HostVector& hosts) {
+  // Slow start weights depend on when hosts were added, and alias tables are built from the
+  // weights at the time, so those schedulers are always rebuilt to pick up weight changes.
+  if (!incremental_host_set_updates_ || scheduler.weighted_ == nullptr ||
+      scheduler.hosts_ == nullptr || isSlowStartEnabled() || useAliasTable()) {
+    return false;
+  }
+  if (scheduler.hosts_ == &hosts) {
+    return true;
+  }
+
+  // Host vectors are partitioned from the cluster's hosts in order, so if hosts were only added
+  // the previous hosts are an ordered subsequence of the new ones. Weight changes need no action
+  // as the EDF scheduler re-reads weights every time a host is picked.
+  const HostVector& previous_hosts = *scheduler.hosts_;
+  if (hosts.size() < previous_hosts.size()) {
+    return false;
+  }
+  HostVector hosts_added;
+  size_t matched = 0;
+  for (const auto& host : hosts) {
+    if (matched < previous_hosts.size() && previous_hosts[matched] == host) {
+      ++matched;
+    } else {
+      hosts_added.push_back(host);
+    }
+  }
+  if (matched != previous_hosts.size()) {
+    return false;
+  }
+  for (const auto& host : hosts_added) {
+    scheduler.weighted_->add(hostWeight(*host), host);
+  }
+  return true;
+}
+
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
-  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
+  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts,
+                                       std::shared_ptr<const void> hosts_owner) {
+    auto& scheduler = scheduler_[source];
+    if (updateSchedulerInPlace(scheduler, hosts)) {
+      refreshHostSource(source);
+      scheduler.hosts_owner_ = std::move(hosts_owner);
+      scheduler.hosts_ = &hosts;
+      return;
+    }
+
     // Nuke existing scheduler if it exists.
-    auto& scheduler = scheduler_[source] = Scheduler{};
+    scheduler = Scheduler{};
     refreshHostSource(source);
     if (isSlowStartEnabled()) {
       recalculateHostsInSlowStart(hosts);
@@ -937,7 +982,7 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
       return;
     }
 
-    // If there are no hosts or a single one, there is no need for an EDF scheduler
+    // If there are no hosts or a single one, there is no need for a weighted scheduler
     // (thus lowering memory and CPU overhead), as the (possibly) single host
     // will be the one always selected by the scheduler.
     if (hosts.size() <= 1) {
@@ -949,33 +994,72 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
     // weighted 1. This is because currently we don't refresh host sets if only weights change.
     // We should probably change this to refresh at all times. See the comment in
     // BaseDynamicClusterImpl::updateDynamicHostList about this.
-    scheduler.edf_ = std::make_unique<EdfScheduler<Host>>(EdfScheduler<Host>::createWithPicks(
-        hosts,
-        // We use a fixed weight here. While the weight may change without
-        // notification, this will only be stale until this host is next picked,
-        // at which point it is reinserted into the EdfScheduler with its new
-        // weight in chooseHost().
-        [this](const Host& host) { return hostWeight(host); }, seed_));
+    if (useAliasTable() && !isSlowStartEnabled()) {
+      auto alias_scheduler = std::make_unique<AliasScheduler<Host>>(random_);
+      for (const auto& host : hosts) {
+        alias_scheduler->add(hostWeight(*host), host);
+      }
+      scheduler.weighted_ = std::move(alias_scheduler);
+    } else {
+      scheduler.weighted_ =
+          std::make_unique<EdfScheduler<Host>>(EdfScheduler<Host>::createWithPicks(
+              hosts,
+              // We use a fixed weight here. While the weight may change without
+              // notification, this will only be stale until this host is next picked,
+              // at which point it is reinserted into the EdfScheduler with its new
+              // weight in chooseHost().
+              [this](const Host& host) { return hostWeight(host); }, seed_));
+    }
+    scheduler.hosts_owner_ = std::move(hosts_owner);
+    scheduler.hosts_ = &hosts;
   };
   // Populate EdfSchedulers for each valid HostsSource value for the host set at this priority.
   const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts());
+  // The hosts are always taken from the shared vectors kept alive by the schedulers, so that a
+  // scheduler's hosts_ can never point at a vector that has since been modified.
+  const HostVectorConstSharedPtr hosts = host_set->hostsPtr();
+  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), *hosts, hosts);
+  const HealthyHostVectorConstSharedPtr healthy_hosts = host_set->healthyHostsPtr();
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
-                   host_set->healthyHosts());
+                   healthy_hosts->get(), healthy_hosts);
+  const DegradedHostVectorConstSharedPtr degraded_hosts = host_set->degradedHostsPtr();
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::DegradedHosts),
-                   host_set->degradedHosts());
-  for (uint32_t locality_index = 0;
-       locality_index < host_set->healthyHostsPerLocality().get().size(); ++locality_index) {
+                   degraded_hosts->get(), degraded_hosts);
+  const HostsPerLocalityConstSharedPtr healthy_hosts_per_locality =
+      host_set->healthyHostsPerLocalityPtr();
+  for (uint32_t locality_index = 0; locality_index < healthy_hosts_per_locality->get().size();
+       ++locality_index) {
     add_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityHealthyHosts, locality_index),
-        host_set->healthyHostsPerLocality().get()[locality_index]);
+        healthy_hosts_per_locality->get()[locality_index], healthy_hosts_per_locality);
   }
-  for (uint32_t locality_index = 0;
-       locality_index < host_set->degradedHostsPerLocality().get().size(); ++locality_index) {
+  const HostsPerLocalityConstSharedPtr degraded_hosts_per_locality =
+      host_set->degradedHostsPerLocalityPtr();
+  for (uint32_t locality_index = 0; locality_index < degraded_hosts_per_locality->get().size();
+       ++locality_index) {
     add_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityDegradedHosts, locality_index),
-        host_set->degradedHostsPerLocality().get()[locality_index]);
+        degraded_hosts_per_locality->get()[locality_index], degraded_hosts_per_locality);
   }
+
+  // Drop the schedulers of localities that no longer exist at this priority, which would otherwise
+  // keep their hosts alive.
+  const size_t num_healthy_localities = healthy_hosts_per_locality->get().size();
+  const size_t num_degraded_localities = degraded_hosts_per_locality->get().size();
+  absl::erase_if(scheduler_, [priority, num_healthy_localities,
+                              num_degraded_localities](const auto& entry) {
+    const HostsSource& source = entry.first;
+    if (source.priority_ != priority) {
+      return false;
+    }
+    if (source.source_type_ == HostsSource::SourceType::LocalityHealthyHosts) {
+      return source.locality_index_ >= num_healthy_localities;
+    }
+    if (source.source_type_ == HostsSource::SourceType::LocalityDegradedHosts) {
+      return source.locality_index_ >= num_degraded_localities;
+    }
+    return false;
+  });
 }
 
 bool EdfLoadBalancerBase::isSlowStartEnabled() const {
@@ -1012,10 +1096,10 @@ HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* con
 
   // As has been commented in both EdfLoadBalancerBase::refresh and
   // BaseDynamicClusterImpl::updateDynamicHostList, we must do a runtime pivot here to determine
-  // whether to use EDF or do unweighted (fast) selection. EDF is non-null iff the original
-  // weights of 2 or more hosts differ.
-  if (scheduler.edf_ != nullptr) {
-    return scheduler.edf_->peekAgain([this](const Host& host) { return hostWeight(host); });
+  // whether to use EDF or do unweighted (fast) selection. The weighted scheduler is non-null iff
+  // the original weights of 2 or more hosts differ.
+  if (scheduler.weighted_ != nullptr) {
+    return scheduler.weighted_->peekAgain([this](const Host& host) { return hostWeight(host); });
   } else {
     const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
     if (hosts_to_use.empty()) {
@@ -1038,10 +1122,11 @@ HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* cont
 
   // As has been commented in both EdfLoadBalancerBase::refresh and
   // BaseDynamicClusterImpl::updateDynamicHostList, we must do a runtime pivot here to determine
-  // whether to use EDF or do unweighted (fast) selection. EDF is non-null iff the original
-  // weights of 2 or more hosts differ.
-  if (scheduler.edf_ != nullptr) {
-    auto host = scheduler.edf_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
+  // whether to use EDF or do unweighted (fast) selection. The weighted scheduler is non-null iff
+  // the original weights of 2 or more hosts differ.
+  if (scheduler.weighted_ != nullptr) {
+    auto host =
+        scheduler.weighted_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
     return host;
   } else {
     const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
@@ -21,6 +21,7 @@
 
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_protos.h"
+#include "source/common/upstream/alias_scheduler.h"
 #include "source/common/upstream/edf_scheduler.h"
 #include "source/common/upstream/load_balancer_context_base.h"
 
@@ -323,6 +324,11 @@ protected:
    */
   const HostVector& hostSourceToHosts(HostsSource hosts_source) const;
 
+  /**
+   * @return true if the weights of all the hosts in the HostVector are equal.
+   */
+  static bool hostWeightsAreEqual(const HostVector& hosts);
+
 private:
   enum class LocalityRoutingState {
     // Locality based routing is off.
@@ -469,10 +475,14 @@ public:
 
 protected:
   struct Scheduler {
-    // EdfScheduler for weighted LB. The edf_ is only created when the original
-    // host weights of 2 or more hosts differ. When not present, the
-    // implementation of chooseHostOnce falls back to unweightedHostPick.
-    std::unique_ptr<EdfScheduler<Host>> edf_;
+    // EdfScheduler, or AliasScheduler if useAliasTable() is set, for weighted LB. The weighted_
+    // scheduler is only created when the original host weights of 2 or more hosts differ. When
+    // not present, the implementation of chooseHostOnce falls back to unweightedHostPick.
+    std::unique_ptr<Upstream::Scheduler<Host>> weighted_;
+    // The hosts weighted_ was built from, and the shared vector owning them. The owner is kept
+    // alive so that the next refresh can tell whether the hosts of the source changed.
+    std::shared_ptr<const void> hosts_owner_;
+    const HostVector* hosts_{};
   };
 
   void initialize();
@@ -497,11 +507,19 @@ private:
   friend class EdfLoadBalancerBasePeer;
   virtual void refreshHostSource(const HostsSource& source) PURE;
   virtual double hostWeight(const Host& host) const PURE;
+  // Whether weighted picks use an alias table rather than EDF when slow start is disabled, giving
+  // O(1) weighted random picks instead of O(log n) smooth weighted picks.
+  virtual bool useAliasTable() const { return false; }
   virtual HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
                                                 const HostsSource& source) PURE;
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                                 const HostsSource& source) PURE;
 
+  // Brings an existing weighted scheduler up to date with the new hosts of its source, if they are
+  // the same as the ones it was built from, possibly with some hosts added. Returns false if the
+  // scheduler must be rebuilt instead.
+  bool updateSchedulerInPlace(Scheduler& scheduler, const HostVector& hosts);
+
   // Scheduler for each valid HostsSource.
   absl::flat_hash_map<HostsSource, Scheduler, HostsSourceHash> scheduler_;
   Common::CallbackHandlePtr priority_update_cb_;
@@ -514,6 +532,9 @@ protected:
   TimeSource& time_source_;
   MonotonicTime latest_host_added_time_;
   const double slow_start_min_weight_percent_;
+
+private:
+  const bool incremental_host_set_updates_;
 };
 
 } // namespace Upstream
@@ -1,5 +1,8 @@
 #include "source/extensions/load_balancing_policies/common/thread_aware_lb_impl.h"
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <random>
 
@@ -95,58 +98,203 @@ absl::Status normalizeWeights(const HostSet& host_set, bool in_panic,
 
 } // namespace
 
+SINGLETON_MANAGER_REGISTRATION(thread_aware_lb_table_build_thread);
+
+TableBuildThread::TableBuildThread(Thread::ThreadFactory& thread_factory) {
+  thread_ = thread_factory.createThread([this]() { run(); }, Thread::Options{"lb_table_build"});
+}
+
+TableBuildThread::~TableBuildThread() {
+  {
+    absl::MutexLock lock(&mutex_);
+    // All load balancers hold the thread, so they have cancelled their builds by now.
+    ASSERT(queues_.empty());
+    shutdown_ = true;
+  }
+  thread_->join();
+}
+
+TableBuildThreadSharedPtr TableBuildThread::get(Singleton::Manager& singleton_manager,
+                                                Thread::ThreadFactory& thread_factory) {
+  return singleton_manager.getTyped<TableBuildThread>(
+      SINGLETON_MANAGER_REGISTERED_NAME(thread_aware_lb_table_build_thread),
+      [&thread_factory] { return std::make_shared<TableBuildThread>(thread_factory); });
+}
+
+bool TableBuildThread::post(Queue& queue, std::function<void()> build) {
+  absl::MutexLock lock(&mutex_);
+  const bool collapsed = queue.pending_ != nullptr;
+  if (!collapsed) {
+    queues_.push_back(&queue);
+  }
+  queue.pending_ = std::move(build);
+  return collapsed;
+}
+
+void TableBuildThread::cancel(Queue& queue) {
+  std::function<void()> pending;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (queue.pending_ != nullptr) {
+      queues_.erase(std::find(queues_.begin(), queues_.end(), &queue));
+      pending = std::move(queue.pending_);
+      queue.pending_ = nullptr;
+    }
+    const auto not_running = [this, &queue]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+      return running_ != &queue;
+    };
+    mutex_.Await(absl::Condition(&not_running));
+  }
+  // The dropped build is destroyed outside of the lock, as it may own the last reference to
+  // large tables.
+}
+
+void TableBuildThread::run() {
+  while (true) {
+    std::function<void()> build;
+    {
+      absl::MutexLock lock(&mutex_);
+      running_ = nullptr;
+      mutex_.Await(absl::Condition(this, &TableBuildThread::hasWork));
+      if (shutdown_) {
+        return;
+      }
+      Queue* queue = queues_.front();
+      queues_.pop_front();
+      build = std::move(queue->pending_);
+      queue->pending_ = nullptr;
+      running_ = queue;
+    }
+    build();
+  }
+}
+
+ThreadAwareLoadBalancerBase::ThreadAwareLoadBalancerBase(
+    const PrioritySet& priority_set, ClusterLbStats& stats, Runtime::Loader& runtime,
+    Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
+    bool locality_weighted_balancing, Stats::Scope& scope, absl::string_view stat_prefix,
+    TimeSource& time_source, TableBuildThreadSharedPtr table_build_thread)
+    : LoadBalancerBase(priority_set, stats, runtime, random, healthy_panic_threshold),
+      factory_(std::make_shared<LoadBalancerFactoryImpl>(stats, random)),
+      locality_weighted_balancing_(locality_weighted_balancing),
+      table_build_scope_(scope.createScope(std::string(stat_prefix))),
+      table_build_stats_(generateTableBuildStats(*table_build_scope_)), time_source_(time_source),
+      table_build_thread_(std::move(table_build_thread)) {}
+
+ThreadAwareLbTableBuildStats
+ThreadAwareLoadBalancerBase::generateTableBuildStats(Stats::Scope& scope) {
+  return {ALL_THREAD_AWARE_LB_TABLE_BUILD_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope))};
+}
+
 absl::Status ThreadAwareLoadBalancerBase::initialize() {
-  // TODO(mattklein123): In the future, once initialized and the initial LB is built, it would be
-  // better to use a background thread for computing LB updates. This has the substantial benefit
-  // that if the LB computation thread falls behind, host set updates can be trivially collapsed.
-  // I will look into doing this in a follow up. Doing everything using a background thread heavily
-  // complicated initialization as the load balancer would need its own initialized callback. I
-  // think the synchronous/asynchronous split is probably the best option.
+  // Once initialized and the initial LB is built synchronously, table builds can optionally be
+  // moved to a background thread. This has the substantial benefit that if the build thread falls
+  // behind, host set updates are trivially collapsed, and that large tables are never built on
+  // the main thread. Doing everything using a background thread would heavily complicate
+  // initialization as the load balancer would need its own initialized callback, so the first
+  // build is always synchronous.
   priority_update_cb_ = priority_set_.addPriorityUpdateCb(
       [this](uint32_t, const HostVector&, const HostVector&) -> absl::Status { return refresh(); });
 
-  return refresh();
+  RETURN_IF_NOT_OK(refresh());
+  build_tables_in_background_ = table_build_thread_ != nullptr;
+  return absl::OkStatus();
+}
+
+void ThreadAwareLoadBalancerBase::stopTableBuilds() {
+  if (table_build_thread_ != nullptr) {
+    table_builds_stopped_.store(true, std::memory_order_relaxed);
+    table_build_thread_->cancel(table_build_queue_);
+  }
 }
 
 absl::Status ThreadAwareLoadBalancerBase::refresh() {
-  auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
+  auto table_build = std::make_shared<TableBuild>();
+  table_build->per_priority_state_ = std::make_shared<std::vector<PerPriorityStatePtr>>(
       priority_set_.hostSetsPerPriority().size());
-  auto healthy_per_priority_load =
+  table_build->healthy_per_priority_load_ =
       std::make_shared<HealthyLoad>(per_priority_load_.healthy_priority_load_);
-  auto degraded_per_priority_load =
+  table_build->degraded_per_priority_load_ =
       std::make_shared<DegradedLoad>(per_priority_load_.degraded_priority_load_);
 
+  // Weights are always normalized on the main thread, as the host sets may only be read there.
   for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
     const uint32_t priority = host_set->priority();
-    (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
-    const auto& per_priority_state = (*per_priority_state_vector)[priority];
+    (*table_build->per_priority_state_)[priority] = std::make_unique<PerPriorityState>();
+    const auto& per_priority_state = (*table_build->per_priority_state_)[priority];
     // Copy panic flag from LoadBalancerBase. It is calculated when there is a change
     // in hosts set or hosts' health.
     per_priority_state->global_panic_ = per_priority_panic_[priority];
 
     // Normalize host and locality weights such that the sum of all normalized weights is 1.
-    NormalizedHostWeightVector normalized_host_weights;
-    double min_normalized_weight = 1.0;
-    double max_normalized_weight = 0.0;
-    absl::Status status = normalizeWeights(*host_set, per_priority_state->global_panic_,
-                                           normalized_host_weights, min_normalized_weight,
-                                           max_normalized_weight, locality_weighted_balancing_);
+    absl::Status status = normalizeWeights(
+        *host_set, per_priority_state->global_panic_, per_priority_state->normalized_host_weights_,
+        per_priority_state->min_normalized_weight_, per_priority_state->max_normalized_weight_,
+        locality_weighted_balancing_);
     RETURN_IF_NOT_OK(status);
-    per_priority_state->current_lb_ = createLoadBalancer(
-        std::move(normalized_host_weights), min_normalized_weight, max_normalized_weight);
   }
 
+  if (build_tables_in_background_) {
+    auto build = [this, table_build = std::move(table_build)]() { buildTables(*table_build); };
+    if (table_build_thread_->post(table_build_queue_, std::move(build))) {
+      table_build_stats_.table_builds_collapsed_.inc();
+    }
+  } else {
+    buildTables(*table_build);
+  }
+  return absl::OkStatus();
+}
+
+void ThreadAwareLoadBalancerBase::buildTables(TableBuild& table_build) {
+  const MonotonicTime start_time = time_source_.monotonicTime();
+  for (uint32_t priority = 0; priority < table_build.per_priority_state_->size(); ++priority) {
+    if (table_builds_stopped_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    PerPriorityState& per_priority_state = *(*table_build.per_priority_state_)[priority];
+
+    // Host set updates frequently only affect some of the priorities, so the tables of the last
+    // build are reused if they were built from the same hosts and weights.
+    if (built_per_priority_state_ != nullptr && priority < built_per_priority_state_->size()) {
+      const PerPriorityState& built = *(*built_per_priority_state_)[priority];
+      if (built.normalized_host_weights_ == per_priority_state.normalized_host_weights_ &&
+          built.min_normalized_weight_ == per_priority_state.min_normalized_weight_ &&
+          built.max_normalized_weight_ == per_priority_state.max_normalized_weight_) {
+        per_priority_state.current_lb_ = built.current_lb_;
+        table_build_stats_.tables_reused_.inc();
+        continue;
+      }
+    }
+
+    per_priority_state.current_lb_ = createLoadBalancer(per_priority_state.normalized_host_weights_,
+                                                        per_priority_state.min_normalized_weight_,
+                                                        per_priority_state.max_normalized_weight_);
+  }
+  built_per_priority_state_ = table_build.per_priority_state_;
+
+  const uint64_t build_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     time_source_.monotonicTime() - start_time)
+                                     .count();
+
   {
     absl::WriterMutexLock lock(&factory_->mutex_);
-    factory_->healthy_per_priority_load_ = healthy_per_priority_load;
-    factory_->degraded_per_priority_load_ = degraded_per_priority_load;
-    factory_->per_priority_state_ = per_priority_state_vector;
+    factory_->healthy_per_priority_load_ = table_build.healthy_per_priority_load_;
+    factory_->degraded_per_priority_load_ = table_build.degraded_per_priority_load_;
+    factory_->per_priority_state_ = table_build.per_priority_state_;
+    factory_->version_.fetch_add(1, std::memory_order_release);
   }
-  return absl::OkStatus();
+
+  // The stats are only updated once the tables are published, so that a build that is counted can
+  // always be observed by the workers.
+  table_build_stats_.table_builds_.inc();
+  table_build_stats_.table_build_time_ms_.add(build_time_ms);
+  table_build_stats_.last_table_build_time_ms_.set(build_time_ms);
 }
 
 HostSelectionResponse
 ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* context) {
+  maybeRefresh();
+
   // Make sure we correctly return nullptr for any early chooseHost() calls.
   if (per_priority_state_ == nullptr) {
     return {nullptr};
@@ -185,15 +333,25 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
   return host;
 }
 
-LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create(LoadBalancerParams) {
-  auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_);
+void ThreadAwareLoadBalancerBase::LoadBalancerImpl::maybeRefresh() {
+  // The version only changes when a table build is published, so in the common case this is a
+  // single atomic load and the lock is never taken.
+  if (factory_->version_.load(std::memory_order_acquire) == version_) {
+    return;
+  }
 
   // We must protect current_lb_ via a RW lock since it is accessed and written to by multiple
   // threads. All complex processing has already been precalculated however.
-  absl::ReaderMutexLock lock(&mutex_);
-  lb->healthy_per_priority_load_ = healthy_per_priority_load_;
-  lb->degraded_per_priority_load_ = degraded_per_priority_load_;
-  lb->per_priority_state_ = per_priority_state_;
+  absl::ReaderMutexLock lock(&factory_->mutex_);
+  version_ = factory_->version_.load(std::memory_order_relaxed);
+  healthy_per_priority_load_ = factory_->healthy_per_priority_load_;
+  degraded_per_priority_load_ = factory_->degraded_per_priority_load_;
+  per_priority_state_ = factory_->per_priority_state_;
+}
+
+LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create(LoadBalancerParams) {
+  auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_, shared_from_this());
+  lb->maybeRefresh();
   return lb;
 }
 
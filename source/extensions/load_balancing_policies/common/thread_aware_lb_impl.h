@@ -1,9 +1,17 @@
 #pragma once
 
+#include <atomic>
 #include <bitset>
+#include <deque>
 
 #include "envoy/common/callback.h"
+#include "envoy/common/time.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
 
 #include "source/common/common/logger.h"
 #include "source/common/config/metadata.h"
@@ -19,6 +27,79 @@ namespace Upstream {
 using NormalizedHostWeightVector = std::vector<std::pair<HostConstSharedPtr, double>>;
 using NormalizedHostWeightMap = std::map<HostConstSharedPtr, double>;
 
+/**
+ * All thread aware load balancer table build stats. These are updated from the table build thread
+ * if tables are built in the background, so only counters and gauges may be used.
+ * @see stats_macros.h
+ */
+#define ALL_THREAD_AWARE_LB_TABLE_BUILD_STATS(COUNTER, GAUGE)                                      \
+  COUNTER(table_build_time_ms)                                                                     \
+  COUNTER(table_builds)                                                                            \
+  COUNTER(table_builds_collapsed)                                                                  \
+  COUNTER(tables_reused)                                                                           \
+  GAUGE(last_table_build_time_ms, NeverImport)
+
+/**
+ * Struct definition for all thread aware load balancer table build stats. @see stats_macros.h
+ */
+struct ThreadAwareLbTableBuildStats {
+  ALL_THREAD_AWARE_LB_TABLE_BUILD_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * The thread the tables of all thread aware load balancers configured to build them in the
+ * background are built on. It is shared by the whole server, rather than started by every load
+ * balancer, and runs the builds of different load balancers in the order they were posted.
+ */
+class TableBuildThread : public Singleton::Instance {
+public:
+  /**
+   * The builds of a single load balancer. A build posted while another one is pending replaces it,
+   * so that a burst of host set updates results in a single build of the latest hosts.
+   */
+  class Queue {
+  private:
+    friend class TableBuildThread;
+    // Guarded by the mutex of the thread. Set if and only if the queue is in the thread's queues.
+    std::function<void()> pending_;
+  };
+
+  explicit TableBuildThread(Thread::ThreadFactory& thread_factory);
+  ~TableBuildThread() override;
+
+  /**
+   * @return the thread shared by the server, which is started if it is not running yet.
+   */
+  static std::shared_ptr<TableBuildThread> get(Singleton::Manager& singleton_manager,
+                                               Thread::ThreadFactory& thread_factory);
+
+  /**
+   * Posts a build to a queue.
+   * @return true if the build replaced a pending one.
+   */
+  bool post(Queue& queue, std::function<void()> build);
+
+  /**
+   * Drops the pending build of a queue. Builds of other queues are neither run nor waited for, but
+   * a build of the queue that is already running is waited for, as it references the state of its
+   * load balancer.
+   */
+  void cancel(Queue& queue);
+
+private:
+  void run();
+  bool hasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return shutdown_ || !queues_.empty();
+  }
+
+  absl::Mutex mutex_;
+  std::deque<Queue*> queues_ ABSL_GUARDED_BY(mutex_);
+  const Queue* running_ ABSL_GUARDED_BY(mutex_){};
+  bool shutdown_ ABSL_GUARDED_BY(mutex_){};
+  Thread::ThreadPtr thread_;
+};
+using TableBuildThreadSharedPtr = std::shared_ptr<TableBuildThread>;
+
 class ThreadAwareLoadBalancerBase : public LoadBalancerBase, public ThreadAwareLoadBalancer {
 public:
   /**
@@ -90,6 +171,8 @@ public:
   LoadBalancerFactorySharedPtr factory() override { return factory_; }
   absl::Status initialize() override;
 
+  const ThreadAwareLbTableBuildStats& tableBuildStats() const { return table_build_stats_; }
+
   // Upstream::LoadBalancer
   HostSelectionResponse chooseHost(LoadBalancerContext*) override { return {nullptr}; }
   // Preconnect not implemented for hash based load balancing
@@ -107,23 +190,56 @@ public:
   }
 
 protected:
+  /**
+   * @param scope supplies the scope table build stats are created in.
+   * @param stat_prefix supplies the prefix of the table build stats within the scope.
+   * @param time_source supplies the time source used to measure table builds.
+   * @param table_build_thread if set, supplies the thread which tables are built on once the load
+   *        balancer is initialized, rather than on the main thread. Derived classes setting it must
+   *        call stopTableBuilds() in their destructor.
+   */
   ThreadAwareLoadBalancerBase(const PrioritySet& priority_set, ClusterLbStats& stats,
                               Runtime::Loader& runtime, Random::RandomGenerator& random,
-                              uint32_t healthy_panic_threshold, bool locality_weighted_balancing)
-      : LoadBalancerBase(priority_set, stats, runtime, random, healthy_panic_threshold),
-        factory_(new LoadBalancerFactoryImpl(stats, random)),
-        locality_weighted_balancing_(locality_weighted_balancing) {}
+                              uint32_t healthy_panic_threshold, bool locality_weighted_balancing,
+                              Stats::Scope& scope, absl::string_view stat_prefix,
+                              TimeSource& time_source,
+                              TableBuildThreadSharedPtr table_build_thread);
+
+  /**
+   * Stops building tables in the background. A pending build is dropped, and an ongoing build is
+   * abandoned before its next table. Builds call createLoadBalancer(), so this must be called
+   * before any state it uses is destroyed.
+   */
+  void stopTableBuilds();
 
 private:
   struct PerPriorityState {
     std::shared_ptr<HashingLoadBalancer> current_lb_;
     bool global_panic_{};
+    // The inputs current_lb_ was built from, so that it can be reused by builds with the same
+    // inputs.
+    NormalizedHostWeightVector normalized_host_weights_;
+    double min_normalized_weight_{1.0};
+    double max_normalized_weight_{0.0};
   };
   using PerPriorityStatePtr = std::unique_ptr<PerPriorityState>;
+  using PerPriorityStateVectorSharedPtr = std::shared_ptr<std::vector<PerPriorityStatePtr>>;
+
+  // The state published to worker load balancers by a table build. The per priority states are
+  // only missing their current_lb_ until the tables are built.
+  struct TableBuild {
+    PerPriorityStateVectorSharedPtr per_priority_state_;
+    std::shared_ptr<HealthyLoad> healthy_per_priority_load_;
+    std::shared_ptr<DegradedLoad> degraded_per_priority_load_;
+  };
+  using TableBuildSharedPtr = std::shared_ptr<TableBuild>;
+
+  struct LoadBalancerFactoryImpl;
 
   struct LoadBalancerImpl : public LoadBalancer {
-    LoadBalancerImpl(ClusterLbStats& stats, Random::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+    LoadBalancerImpl(ClusterLbStats& stats, Random::RandomGenerator& random,
+                     std::shared_ptr<LoadBalancerFactoryImpl> factory)
+        : stats_(stats), random_(random), factory_(std::move(factory)) {}
 
     // Upstream::LoadBalancer
     HostSelectionResponse chooseHost(LoadBalancerContext* context) override;
@@ -139,14 +255,21 @@ private:
       return {};
     }
 
+    // Picks up the state published by a table build completed after this load balancer was
+    // created.
+    void maybeRefresh();
+
     ClusterLbStats& stats_;
     Random::RandomGenerator& random_;
-    std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
+    const std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+    uint64_t version_{};
+    PerPriorityStateVectorSharedPtr per_priority_state_;
     std::shared_ptr<HealthyLoad> healthy_per_priority_load_;
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_;
   };
 
-  struct LoadBalancerFactoryImpl : public LoadBalancerFactory {
+  struct LoadBalancerFactoryImpl : public LoadBalancerFactory,
+                                   public std::enable_shared_from_this<LoadBalancerFactoryImpl> {
     LoadBalancerFactoryImpl(ClusterLbStats& stats, Random::RandomGenerator& random)
         : stats_(stats), random_(random) {}
 
@@ -156,8 +279,11 @@ private:
 
     ClusterLbStats& stats_;
     Random::RandomGenerator& random_;
+    // Incremented every time a table build is published, so that worker load balancers can
+    // cheaply check whether they are up to date.
+    std::atomic<uint64_t> version_{};
     absl::Mutex mutex_;
-    std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_ ABSL_GUARDED_BY(mutex_);
+    PerPriorityStateVectorSharedPtr per_priority_state_ ABSL_GUARDED_BY(mutex_);
     // This is split out of PerPriorityState so LoadBalancerBase::ChoosePriority can be reused.
     std::shared_ptr<HealthyLoad> healthy_per_priority_load_ ABSL_GUARDED_BY(mutex_);
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_ ABSL_GUARDED_BY(mutex_);
@@ -167,10 +293,23 @@ private:
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double max_normalized_weight) PURE;
   absl::Status refresh();
+  void buildTables(TableBuild& table_build);
+  static ThreadAwareLbTableBuildStats generateTableBuildStats(Stats::Scope& scope);
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
   const bool locality_weighted_balancing_{};
   Common::CallbackHandlePtr priority_update_cb_;
+  Stats::ScopeSharedPtr table_build_scope_;
+  ThreadAwareLbTableBuildStats table_build_stats_;
+  TimeSource& time_source_;
+  const TableBuildThreadSharedPtr table_build_thread_;
+  TableBuildThread::Queue table_build_queue_;
+  // Set once the initial build is done, if tables are built in the background.
+  bool build_tables_in_background_{};
+  std::atomic<bool> table_builds_stopped_{};
+  // The state of the last table build, whose tables are reused by the next build for priorities
+  // with unchanged inputs. Only accessed by the thread building tables.
+  PerPriorityStateVectorSharedPtr built_per_priority_state_;
 };
 
 } // namespace Upstream
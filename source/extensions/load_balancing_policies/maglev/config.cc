@@ -13,7 +13,7 @@ Upstream::ThreadAwareLoadBalancerPtr
 Factory::create(OptRef<const Upstream::LoadBalancerConfig> lb_config,
                 const Upstream::ClusterInfo& cluster_info,
                 const Upstream::PrioritySet& priority_set, Runtime::Loader& runtime,
-                Random::RandomGenerator& random, TimeSource&) {
+                Random::RandomGenerator& random, TimeSource& time_source) {
 
   auto active_or_legacy =
       Common::ActiveOrLegacy<Upstream::TypedMaglevLbConfig, Upstream::LegacyMaglevLbConfig>::get(
@@ -24,14 +24,15 @@ Factory::create(OptRef<const Upstream::LoadBalancerConfig> lb_config,
     return std::make_unique<Upstream::MaglevLoadBalancer>(
         priority_set, cluster_info.lbStats(), cluster_info.statsScope(), runtime, random,
         active_or_legacy.hasLegacy() ? active_or_legacy.legacy()->lbConfig() : absl::nullopt,
-        cluster_info.lbConfig());
+        cluster_info.lbConfig(), time_source);
   }
 
   return std::make_unique<Upstream::MaglevLoadBalancer>(
       priority_set, cluster_info.lbStats(), cluster_info.statsScope(), runtime, random,
       static_cast<uint32_t>(PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(
           cluster_info.lbConfig(), healthy_panic_threshold, 100, 50)),
-      active_or_legacy.active()->lb_config_);
+      active_or_legacy.active()->lb_config_, time_source,
+      active_or_legacy.active()->table_build_thread_);
 }
 
 /**
@@ -67,7 +67,9 @@ LegacyMaglevLbConfig::LegacyMaglevLbConfig(const ClusterProto& cluster) {
   }
 }
 
-TypedMaglevLbConfig::TypedMaglevLbConfig(const MaglevLbProto& lb_config) : lb_config_(lb_config) {}
+TypedMaglevLbConfig::TypedMaglevLbConfig(const MaglevLbProto& lb_config,
+                                         TableBuildThreadSharedPtr table_build_thread)
+    : lb_config_(lb_config), table_build_thread_(std::move(table_build_thread)) {}
 
 ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
 MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
@@ -290,11 +292,13 @@ MaglevLoadBalancer::MaglevLoadBalancer(
     const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
     Runtime::Loader& runtime, Random::RandomGenerator& random,
     OptRef<const envoy::config::cluster::v3::Cluster::MaglevLbConfig> config,
-    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
+    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+    TimeSource& time_source)
     : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random,
                                   PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(
                                       common_config, healthy_panic_threshold, 100, 50),
-                                  common_config.has_locality_weighted_lb_config()),
+                                  common_config.has_locality_weighted_lb_config(), scope,
+                                  "maglev_lb.", time_source, {}),
       scope_(scope.createScope("maglev_lb.")), stats_(generateStats(*scope_)),
       table_size_(config ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.ref(), table_size,
                                                            MaglevTable::DefaultTableSize)
@@ -315,9 +319,11 @@ MaglevLoadBalancer::MaglevLoadBalancer(
 MaglevLoadBalancer::MaglevLoadBalancer(
     const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
     Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
-    const envoy::extensions::load_balancing_policies::maglev::v3::Maglev& config)
+    const envoy::extensions::load_balancing_policies::maglev::v3::Maglev& config,
+    TimeSource& time_source, TableBuildThreadSharedPtr table_build_thread)
     : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, healthy_panic_threshold,
-                                  config.has_locality_weighted_lb_config()),
+                                  config.has_locality_weighted_lb_config(), scope, "maglev_lb.",
+                                  time_source, std::move(table_build_thread)),
       scope_(scope.createScope("maglev_lb.")), stats_(generateStats(*scope_)),
       table_size_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, table_size, MaglevTable::DefaultTableSize)),
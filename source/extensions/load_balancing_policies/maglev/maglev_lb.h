@@ -42,9 +42,12 @@ private:
  */
 class TypedMaglevLbConfig : public Upstream::LoadBalancerConfig {
 public:
-  TypedMaglevLbConfig(const MaglevLbProto& config);
+  TypedMaglevLbConfig(const MaglevLbProto& config,
+                      TableBuildThreadSharedPtr table_build_thread = nullptr);
 
   const MaglevLbProto lb_config_;
+  // Only set if tables should be built in the background.
+  const TableBuildThreadSharedPtr table_build_thread_;
 };
 
 /**
@@ -181,12 +184,17 @@ public:
   MaglevLoadBalancer(const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
                      Runtime::Loader& runtime, Random::RandomGenerator& random,
                      OptRef<const envoy::config::cluster::v3::Cluster::MaglevLbConfig> config,
-                     const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config);
+                     const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+                     TimeSource& time_source);
 
   MaglevLoadBalancer(const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
                      Runtime::Loader& runtime, Random::RandomGenerator& random,
                      uint32_t healthy_panic_threshold,
-                     const envoy::extensions::load_balancing_policies::maglev::v3::Maglev& config);
+                     const envoy::extensions::load_balancing_policies::maglev::v3::Maglev& config,
+                     TimeSource& time_source,
+                     TableBuildThreadSharedPtr table_build_thread = nullptr);
+
+  ~MaglevLoadBalancer() override { stopTableBuilds(); }
 
   const MaglevLoadBalancerStats& stats() const { return stats_; }
   uint64_t tableSize() const { return table_size_; }
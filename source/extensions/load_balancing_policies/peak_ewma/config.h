@@ -0,0 +1,51 @@
+#pragma once
+
+#include "envoy/extensions/load_balancing_policies/peak_ewma/v3/peak_ewma.pb.h"
+#include "envoy/extensions/load_balancing_policies/peak_ewma/v3/peak_ewma.pb.validate.h"
+#include "envoy/server/factory_context.h"
+#include "envoy/upstream/load_balancer.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/upstream/load_balancer_factory_base.h"
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace PeakEwma {
+
+using PeakEwmaLbProto = envoy::extensions::load_balancing_policies::peak_ewma::v3::PeakEwma;
+
+class Factory : public Upstream::TypedLoadBalancerFactoryBase<PeakEwmaLbProto> {
+public:
+  Factory()
+      : Upstream::TypedLoadBalancerFactoryBase<PeakEwmaLbProto>(
+            "envoy.load_balancing_policies.peak_ewma") {}
+
+  Upstream::ThreadAwareLoadBalancerPtr create(OptRef<const Upstream::LoadBalancerConfig> lb_config,
+                                              const Upstream::ClusterInfo& cluster_info,
+                                              const Upstream::PrioritySet& priority_set,
+                                              Runtime::Loader& runtime,
+                                              Envoy::Random::RandomGenerator& random,
+                                              TimeSource& time_source) override {
+    ASSERT(dynamic_cast<const Upstream::PeakEwmaLbConfig*>(lb_config.ptr()) != nullptr);
+    const auto& typed_lb_config = dynamic_cast<const Upstream::PeakEwmaLbConfig&>(*lb_config);
+    return std::make_unique<Upstream::PeakEwmaThreadAwareLoadBalancer>(
+        typed_lb_config, cluster_info, priority_set, runtime, random, time_source);
+  }
+
+  absl::StatusOr<Upstream::LoadBalancerConfigPtr>
+  loadConfig(Server::Configuration::ServerFactoryContext&,
+             const Protobuf::Message& config) override {
+    ASSERT(dynamic_cast<const PeakEwmaLbProto*>(&config) != nullptr);
+    const PeakEwmaLbProto& typed_config = dynamic_cast<const PeakEwmaLbProto&>(config);
+    return Upstream::LoadBalancerConfigPtr{new Upstream::PeakEwmaLbConfig(typed_config)};
+  }
+};
+
+DECLARE_FACTORY(Factory);
+
+} // namespace PeakEwma
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,170 @@
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Upstream {
+
+PeakEwmaLbConfig::PeakEwmaLbConfig(const PeakEwmaLbProto& lb_proto)
+    : lb_proto_(lb_proto),
+      decay_time_(
+          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(lb_proto, decay_time, 10000))),
+      default_rtt_(
+          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(lb_proto, default_rtt, 10))),
+      failure_penalty_(std::chrono::milliseconds(
+          PROTOBUF_GET_MS_OR_DEFAULT(lb_proto, failure_penalty, 1000))) {}
+
+PeakEwmaHostLbPolicyData::PeakEwmaHostLbPolicyData(std::chrono::microseconds decay_time,
+                                                   std::chrono::microseconds failure_penalty,
+                                                   TimeSource& time_source)
+    : decay_time_us_(decay_time.count()), failure_penalty_us_(failure_penalty.count()),
+      time_source_(time_source), last_update_time_(time_source.monotonicTime()) {
+  ASSERT(decay_time_us_ > 0);
+}
+
+double PeakEwmaHostLbPolicyData::decayFactor(MonotonicTime last_update_time,
+                                             MonotonicTime now) const {
+  if (now <= last_update_time) {
+    return 1.0;
+  }
+  const double elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(now - last_update_time).count();
+  return std::exp(-elapsed_us / decay_time_us_);
+}
+
+void PeakEwmaHostLbPolicyData::onResponseTime(std::chrono::microseconds response_time) {
+  addSample(response_time.count());
+}
+
+void PeakEwmaHostLbPolicyData::onRequestFailure(std::chrono::microseconds elapsed) {
+  // Failed requests did not get a response time, so the penalty keeps hosts that time out or
+  // reset requests quickly from looking cheaper than hosts that respond.
+  addSample(elapsed.count() + failure_penalty_us_);
+}
+
+void PeakEwmaHostLbPolicyData::addSample(double sample_us) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  const double decay = decayFactor(last_update_time_.exchange(now), now);
+  last_rtt_us_.store(sample_us);
+
+  double current = rtt_us_.load();
+  double updated;
+  do {
+    // Response times above the average replace it, so that latency spikes are reflected at once,
+    // while lower response times are only blended in as the weight of the average decays.
+    updated = sample_us > current ? sample_us : current * decay + sample_us * (1.0 - decay);
+  } while (!rtt_us_.compare_exchange_weak(current, updated));
+}
+
+double PeakEwmaHostLbPolicyData::rtt(MonotonicTime now, bool requests_outstanding) const {
+  // Decaying towards zero while no responses complete makes idle hosts look cheaper over time,
+  // so that they are eventually probed again after a latency spike. Hosts with outstanding
+  // requests are not idle: their requests may be stuck, so the decay stops at the last sample.
+  const double decayed = rtt_us_.load() * decayFactor(last_update_time_.load(), now);
+  return requests_outstanding ? std::max(decayed, last_rtt_us_.load()) : decayed;
+}
+
+PeakEwmaLoadBalancer::PeakEwmaLoadBalancer(
+    const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterLbStats& stats,
+    Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
+    const PeakEwmaLbConfig& lb_config, TimeSource& time_source)
+    : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                                healthy_panic_threshold,
+                                LoadBalancerConfigHelper::localityLbConfigFromProto(
+                                    lb_config.lb_proto_)),
+      default_rtt_us_(lb_config.default_rtt_.count()), time_source_(time_source) {}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::peekAnotherHost(LoadBalancerContext* context) {
+  if (tooManyPreconnects(stashed_random_.size(), total_healthy_hosts_)) {
+    return nullptr;
+  }
+  return peekOrChoose(context, true);
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
+  return peekOrChoose(context, false);
+}
+
+double PeakEwmaLoadBalancer::hostCost(const Host& host, MonotonicTime now) const {
+  const auto lb_policy_data = host.typedLbPolicyData<PeakEwmaHostLbPolicyData>();
+  const uint64_t active_requests = host.stats().rq_active_.value();
+  double rtt_us = lb_policy_data.has_value() ? lb_policy_data->rtt(now, active_requests > 0) : 0;
+  if (rtt_us <= 0) {
+    rtt_us = default_rtt_us_;
+  }
+  return rtt_us * (active_requests + 1);
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::peekOrChoose(LoadBalancerContext* context, bool peek) {
+  const uint64_t random_hash = random(peek);
+  const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random_hash);
+  if (!hosts_source) {
+    return nullptr;
+  }
+
+  const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
+  if (hosts_to_use.empty()) {
+    return nullptr;
+  }
+  if (hosts_to_use.size() == 1) {
+    return hosts_to_use[0];
+  }
+
+  // Both candidates are derived from the same random value, so that peeked and chosen hosts stay
+  // consistent. The second candidate skips over the first one so the two are always distinct.
+  const uint64_t size = hosts_to_use.size();
+  const uint64_t first = (random_hash & 0xFFFFFFFF) % size;
+  const uint64_t second = (first + 1 + (random_hash >> 32) % (size - 1)) % size;
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  return hostCost(*hosts_to_use[second], now) < hostCost(*hosts_to_use[first], now)
+             ? hosts_to_use[second]
+             : hosts_to_use[first];
+}
+
+LoadBalancerPtr
+PeakEwmaThreadAwareLoadBalancer::WorkerLocalLbFactory::create(LoadBalancerParams params) {
+  return std::make_unique<PeakEwmaLoadBalancer>(
+      params.priority_set, params.local_priority_set, cluster_info_.lbStats(), runtime_, random_,
+      PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(cluster_info_.lbConfig(),
+                                                     healthy_panic_threshold, 100, 50),
+      lb_config_, time_source_);
+}
+
+PeakEwmaThreadAwareLoadBalancer::PeakEwmaThreadAwareLoadBalancer(
+    const PeakEwmaLbConfig& lb_config, const ClusterInfo& cluster_info,
+    const PrioritySet& priority_set, Runtime::Loader& runtime, Random::RandomGenerator& random,
+    TimeSource& time_source)
+    : lb_config_(lb_config), priority_set_(priority_set), time_source_(time_source),
+      factory_(std::make_shared<WorkerLocalLbFactory>(lb_config, cluster_info, runtime, random,
+                                                      time_source)) {}
+
+void PeakEwmaThreadAwareLoadBalancer::addLbPolicyDataToHosts(const HostVector& hosts) {
+  for (const auto& host : hosts) {
+    if (!host->lbPolicyData().has_value()) {
+      host->setLbPolicyData(std::make_unique<PeakEwmaHostLbPolicyData>(
+          lb_config_.decay_time_, lb_config_.failure_penalty_, time_source_));
+    }
+  }
+}
+
+absl::Status PeakEwmaThreadAwareLoadBalancer::initialize() {
+  // Ensure that all hosts have peak EWMA data before any worker picks them.
+  for (const HostSetPtr& host_set : priority_set_.hostSetsPerPriority()) {
+    addLbPolicyDataToHosts(host_set->hosts());
+  }
+
+  priority_update_cb_ = priority_set_.addPriorityUpdateCb(
+      [this](uint32_t, const HostVector& hosts_added, const HostVector&) -> absl::Status {
+        addLbPolicyDataToHosts(hosts_added);
+        return absl::OkStatus();
+      });
+
+  return absl::OkStatus();
+}
+
+} // namespace Upstream
+} // namespace Envoy
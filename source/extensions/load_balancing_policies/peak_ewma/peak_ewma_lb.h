@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/load_balancing_policies/peak_ewma/v3/peak_ewma.pb.h"
+#include "envoy/upstream/load_balancer.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/common/callback_impl.h"
+#include "source/extensions/load_balancing_policies/common/load_balancer_impl.h"
+
+namespace Envoy {
+namespace Upstream {
+
+using PeakEwmaLbProto = envoy::extensions::load_balancing_policies::peak_ewma::v3::PeakEwma;
+
+/**
+ * Load balancer config used to wrap the peak EWMA config proto.
+ */
+class PeakEwmaLbConfig : public Upstream::LoadBalancerConfig {
+public:
+  PeakEwmaLbConfig(const PeakEwmaLbProto& lb_proto);
+
+  const PeakEwmaLbProto lb_proto_;
+  // The time over which the weight of past response times decays by a factor of e.
+  const std::chrono::microseconds decay_time_;
+  // The response time assumed for hosts without response time samples.
+  const std::chrono::microseconds default_rtt_;
+  // The time added to the elapsed time of requests that time out or are reset.
+  const std::chrono::microseconds failure_penalty_;
+};
+
+/**
+ * Per host peak EWMA of response times. Hosts are shared between the load balancers of all the
+ * worker threads, so the state is only accessed with atomic operations and never locked.
+ */
+class PeakEwmaHostLbPolicyData : public HostLbPolicyData {
+public:
+  PeakEwmaHostLbPolicyData(std::chrono::microseconds decay_time,
+                           std::chrono::microseconds failure_penalty, TimeSource& time_source);
+
+  // Upstream::HostLbPolicyData
+  void onResponseTime(std::chrono::microseconds response_time) override;
+  void onRequestFailure(std::chrono::microseconds elapsed) override;
+
+  /**
+   * @param now supplies the current time.
+   * @param requests_outstanding supplies whether the host has active requests.
+   * @return the peak EWMA of the response times of the host in microseconds, decayed up to now,
+   *         or 0 if the host has not reported any response time yet. While requests are
+   *         outstanding, the EWMA does not decay below the last reported response time.
+   */
+  double rtt(MonotonicTime now, bool requests_outstanding) const;
+
+private:
+  double decayFactor(MonotonicTime last_update_time, MonotonicTime now) const;
+  void addSample(double sample_us);
+
+  const double decay_time_us_;
+  const double failure_penalty_us_;
+  TimeSource& time_source_;
+  // The EWMA and the time it was last updated are updated separately, so concurrent updates may
+  // decay the EWMA by slightly more or less than the elapsed time. The error is bounded by the
+  // time between the concurrent updates, which is negligible compared to the decay time.
+  std::atomic<double> rtt_us_{0};
+  // The last reported response time, including the penalty of failed requests.
+  std::atomic<double> last_rtt_us_{0};
+  std::atomic<MonotonicTime> last_update_time_;
+};
+
+/**
+ * Load balancer that samples two distinct hosts at random and picks the one with the lower cost,
+ * where the cost of a host is the peak EWMA of its response times multiplied by its number of
+ * active requests plus one. Host weights are ignored.
+ */
+class PeakEwmaLoadBalancer : public ZoneAwareLoadBalancerBase {
+public:
+  PeakEwmaLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                       ClusterLbStats& stats, Runtime::Loader& runtime,
+                       Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
+                       const PeakEwmaLbConfig& lb_config, TimeSource& time_source);
+
+  // Upstream::ZoneAwareLoadBalancerBase
+  HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
+  HostConstSharedPtr peekAnotherHost(LoadBalancerContext* context) override;
+
+private:
+  HostConstSharedPtr peekOrChoose(LoadBalancerContext* context, bool peek);
+  double hostCost(const Host& host, MonotonicTime now) const;
+
+  const double default_rtt_us_;
+  TimeSource& time_source_;
+};
+
+/**
+ * Thread aware load balancer that attaches the peak EWMA state to the hosts of the cluster on the
+ * main thread. Worker load balancers read the state directly from the hosts, so they do not need
+ * to be recreated when the hosts change.
+ */
+class PeakEwmaThreadAwareLoadBalancer : public ThreadAwareLoadBalancer {
+public:
+  PeakEwmaThreadAwareLoadBalancer(const PeakEwmaLbConfig& lb_config,
+                                  const ClusterInfo& cluster_info, const PrioritySet& priority_set,
+                                  Runtime::Loader& runtime, Random::RandomGenerator& random,
+                                  TimeSource& time_source);
+
+  // Upstream::ThreadAwareLoadBalancer
+  LoadBalancerFactorySharedPtr factory() override { return factory_; }
+  absl::Status initialize() override;
+
+private:
+  class WorkerLocalLbFactory : public LoadBalancerFactory {
+  public:
+    WorkerLocalLbFactory(const PeakEwmaLbConfig& lb_config, const ClusterInfo& cluster_info,
+                         Runtime::Loader& runtime, Random::RandomGenerator& random,
+                         TimeSource& time_source)
+        : lb_config_(lb_config), cluster_info_(cluster_info), runtime_(runtime), random_(random),
+          time_source_(time_source) {}
+
+    // Upstream::LoadBalancerFactory
+    LoadBalancerPtr create(LoadBalancerParams params) override;
+    bool recreateOnHostChange() const override { return false; }
+
+  private:
+    const PeakEwmaLbConfig& lb_config_;
+    const ClusterInfo& cluster_info_;
+    Runtime::Loader& runtime_;
+    Random::RandomGenerator& random_;
+    TimeSource& time_source_;
+  };
+
+  void addLbPolicyDataToHosts(const HostVector& hosts);
+
+  const PeakEwmaLbConfig& lb_config_;
+  const PrioritySet& priority_set_;
+  TimeSource& time_source_;
+  std::shared_ptr<WorkerLocalLbFactory> factory_;
+  Common::CallbackHandlePtr priority_update_cb_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
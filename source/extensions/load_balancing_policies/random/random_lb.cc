@@ -3,6 +3,57 @@
 namespace Envoy {
 namespace Upstream {
 
+void RandomLoadBalancer::initialize() {
+  if (!use_alias_table_) {
+    return;
+  }
+  // Alias tables are rebuilt whenever the hosts of a priority change, in O(n) per host source.
+  priority_update_cb_ = priority_set_.addPriorityUpdateCb(
+      [this](uint32_t priority, const HostVector&, const HostVector&) {
+        refresh(priority);
+        return absl::OkStatus();
+      });
+  for (uint32_t priority = 0; priority < priority_set_.hostSetsPerPriority().size(); ++priority) {
+    refresh(priority);
+  }
+}
+
+void RandomLoadBalancer::refresh(uint32_t priority) {
+  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
+    // If all of the weights are equal, a uniform pick from the hosts is already weighted
+    // correctly and needs no table.
+    if (hostWeightsAreEqual(hosts)) {
+      alias_tables_.erase(source);
+      return;
+    }
+    auto alias_table = std::make_unique<AliasScheduler<Host>>(random_);
+    for (const auto& host : hosts) {
+      alias_table->add(host->weight(), host);
+    }
+    alias_tables_[source] = std::move(alias_table);
+  };
+  const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
+  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts());
+  add_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
+                   host_set->healthyHosts());
+  add_hosts_source(HostsSource(priority, HostsSource::SourceType::DegradedHosts),
+                   host_set->degradedHosts());
+  const auto& healthy_hosts_per_locality = host_set->healthyHostsPerLocality().get();
+  for (uint32_t locality_index = 0; locality_index < healthy_hosts_per_locality.size();
+       ++locality_index) {
+    add_hosts_source(
+        HostsSource(priority, HostsSource::SourceType::LocalityHealthyHosts, locality_index),
+        healthy_hosts_per_locality[locality_index]);
+  }
+  const auto& degraded_hosts_per_locality = host_set->degradedHostsPerLocality().get();
+  for (uint32_t locality_index = 0; locality_index < degraded_hosts_per_locality.size();
+       ++locality_index) {
+    add_hosts_source(
+        HostsSource(priority, HostsSource::SourceType::LocalityDegradedHosts, locality_index),
+        degraded_hosts_per_locality[locality_index]);
+  }
+}
+
 HostConstSharedPtr RandomLoadBalancer::peekAnotherHost(LoadBalancerContext* context) {
   if (tooManyPreconnects(stashed_random_.size(), total_healthy_hosts_)) {
     return nullptr;
@@ -26,6 +77,14 @@ HostConstSharedPtr RandomLoadBalancer::peekOrChoose(LoadBalancerContext* context
     return nullptr;
   }
 
+  if (use_alias_table_) {
+    // Picking with the same random value keeps peeked and chosen hosts consistent.
+    auto alias_table_it = alias_tables_.find(*hosts_source);
+    if (alias_table_it != alias_tables_.end()) {
+      return alias_table_it->second->pick(random_hash);
+    }
+  }
+
   return hosts_to_use[random_hash % hosts_to_use.size()];
 }
 
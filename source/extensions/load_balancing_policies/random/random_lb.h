@@ -1,12 +1,14 @@
 #pragma once
 
+#include "source/common/upstream/alias_scheduler.h"
 #include "source/extensions/load_balancing_policies/common/load_balancer_impl.h"
 
 namespace Envoy {
 namespace Upstream {
 
 /**
- * Random load balancer that picks a random host out of all hosts.
+ * Random load balancer that picks a random host out of all hosts. If configured to use alias
+ * tables, hosts are picked with probability proportional to their weights.
  */
 class RandomLoadBalancer : public ZoneAwareLoadBalancerBase {
 public:
@@ -26,7 +28,10 @@ public:
       const envoy::extensions::load_balancing_policies::random::v3::Random& random_config)
       : ZoneAwareLoadBalancerBase(
             priority_set, local_priority_set, stats, runtime, random, healthy_panic_threshold,
-            LoadBalancerConfigHelper::localityLbConfigFromProto(random_config)) {}
+            LoadBalancerConfigHelper::localityLbConfigFromProto(random_config)),
+        use_alias_table_(random_config.use_alias_table()) {
+    initialize();
+  }
 
   // Upstream::ZoneAwareLoadBalancerBase
   HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
@@ -34,6 +39,16 @@ public:
 
 protected:
   HostConstSharedPtr peekOrChoose(LoadBalancerContext* context, bool peek);
+
+private:
+  void initialize();
+  void refresh(uint32_t priority);
+
+  const bool use_alias_table_{};
+  // Alias table for each HostsSource whose host weights differ, if alias tables are enabled.
+  absl::flat_hash_map<HostsSource, std::unique_ptr<AliasScheduler<Host>>, HostsSourceHash>
+      alias_tables_;
+  Common::CallbackHandlePtr priority_update_cb_;
 };
 
 } // namespace Upstream
@@ -11,7 +11,7 @@ Upstream::ThreadAwareLoadBalancerPtr
 Factory::create(OptRef<const Upstream::LoadBalancerConfig> lb_config,
                 const Upstream::ClusterInfo& cluster_info,
                 const Upstream::PrioritySet& priority_set, Runtime::Loader& runtime,
-                Random::RandomGenerator& random, TimeSource&) {
+                Random::RandomGenerator& random, TimeSource& time_source) {
 
   auto active_or_legacy =
       Common::ActiveOrLegacy<Upstream::TypedRingHashLbConfig,
@@ -22,14 +22,15 @@ Factory::create(OptRef<const Upstream::LoadBalancerConfig> lb_config,
     return std::make_unique<Upstream::RingHashLoadBalancer>(
         priority_set, cluster_info.lbStats(), cluster_info.statsScope(), runtime, random,
         active_or_legacy.hasLegacy() ? active_or_legacy.legacy()->lbConfig() : absl::nullopt,
-        cluster_info.lbConfig());
+        cluster_info.lbConfig(), time_source);
   }
 
   return std::make_unique<Upstream::RingHashLoadBalancer>(
       priority_set, cluster_info.lbStats(), cluster_info.statsScope(), runtime, random,
       PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(cluster_info.lbConfig(),
                                                      healthy_panic_threshold, 100, 50),
-      active_or_legacy.active()->lb_config_);
+      active_or_legacy.active()->lb_config_, time_source,
+      active_or_legacy.active()->table_build_thread_);
 }
 
 /**
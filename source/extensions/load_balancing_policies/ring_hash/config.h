@@ -29,12 +29,16 @@ public:
                                               TimeSource& time_source) override;
 
   absl::StatusOr<Upstream::LoadBalancerConfigPtr>
-  loadConfig(Server::Configuration::ServerFactoryContext&,
+  loadConfig(Server::Configuration::ServerFactoryContext& context,
              const Protobuf::Message& config) override {
     ASSERT(dynamic_cast<const RingHashLbProto*>(&config) != nullptr);
     const RingHashLbProto& typed_config = dynamic_cast<const RingHashLbProto&>(config);
     // TODO(wbocode): to merge the legacy and typed config and related constructors into one.
-    return Upstream::LoadBalancerConfigPtr{new Upstream::TypedRingHashLbConfig(typed_config)};
+    return Upstream::LoadBalancerConfigPtr{new Upstream::TypedRingHashLbConfig(
+        typed_config, typed_config.consistent_hashing_lb_config().build_tables_in_background()
+                          ? Upstream::TableBuildThread::get(context.singletonManager(),
+                                                            context.api().threadFactory())
+                          : nullptr)};
   }
 
   absl::StatusOr<Upstream::LoadBalancerConfigPtr>
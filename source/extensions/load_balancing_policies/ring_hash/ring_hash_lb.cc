@@ -21,18 +21,21 @@ LegacyRingHashLbConfig::LegacyRingHashLbConfig(const ClusterProto& cluster) {
   }
 }
 
-TypedRingHashLbConfig::TypedRingHashLbConfig(const RingHashLbProto& lb_config)
-    : lb_config_(lb_config) {}
+TypedRingHashLbConfig::TypedRingHashLbConfig(
+    const RingHashLbProto& lb_config, TableBuildThreadSharedPtr table_build_thread)
+    : lb_config_(lb_config), table_build_thread_(std::move(table_build_thread)) {}
 
 RingHashLoadBalancer::RingHashLoadBalancer(
     const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
     Runtime::Loader& runtime, Random::RandomGenerator& random,
     OptRef<const envoy::config::cluster::v3::Cluster::RingHashLbConfig> config,
-    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
+    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+    TimeSource& time_source)
     : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random,
                                   PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(
                                       common_config, healthy_panic_threshold, 100, 50),
-                                  common_config.has_locality_weighted_lb_config()),
+                                  common_config.has_locality_weighted_lb_config(), scope,
+                                  "ring_hash_lb.", time_source, {}),
       scope_(scope.createScope("ring_hash_lb.")), stats_(generateStats(*scope_)),
       min_ring_size_(config.has_value() ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(
                                               config.ref(), minimum_ring_size, DefaultMinRingSize)
@@ -60,9 +63,11 @@ RingHashLoadBalancer::RingHashLoadBalancer(
 RingHashLoadBalancer::RingHashLoadBalancer(
     const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
     Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
-    const envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash& config)
+    const envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash& config,
+    TimeSource& time_source, TableBuildThreadSharedPtr table_build_thread)
     : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, healthy_panic_threshold,
-                                  config.has_locality_weighted_lb_config()),
+                                  config.has_locality_weighted_lb_config(), scope, "ring_hash_lb.",
+                                  time_source, std::move(table_build_thread)),
       scope_(scope.createScope("ring_hash_lb.")), stats_(generateStats(*scope_)),
       min_ring_size_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, minimum_ring_size, DefaultMinRingSize)),
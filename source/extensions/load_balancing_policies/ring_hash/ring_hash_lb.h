@@ -43,9 +43,12 @@ private:
  */
 class TypedRingHashLbConfig : public Upstream::LoadBalancerConfig {
 public:
-  TypedRingHashLbConfig(const RingHashLbProto& lb_config);
+  TypedRingHashLbConfig(const RingHashLbProto& lb_config,
+                        TableBuildThreadSharedPtr table_build_thread = nullptr);
 
   const RingHashLbProto lb_config_;
+  // Only set if tables should be built in the background.
+  const TableBuildThreadSharedPtr table_build_thread_;
 };
 
 /**
@@ -77,12 +80,16 @@ public:
   RingHashLoadBalancer(const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
                        Runtime::Loader& runtime, Random::RandomGenerator& random,
                        OptRef<const envoy::config::cluster::v3::Cluster::RingHashLbConfig> config,
-                       const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config);
+                       const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+                       TimeSource& time_source);
 
   RingHashLoadBalancer(
       const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
       Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
-      const envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash& config);
+      const envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash& config,
+      TimeSource& time_source, TableBuildThreadSharedPtr table_build_thread = nullptr);
+
+  ~RingHashLoadBalancer() override { stopTableBuilds(); }
 
   const RingHashLoadBalancerStats& stats() const { return stats_; }
 
@@ -6,8 +6,8 @@ namespace Envoy {
 namespace Upstream {
 
 /**
- * A round robin load balancer. When in weighted mode, EDF scheduling is used. When in not
- * weighted mode, simple RR index selection is used.
+ * A round robin load balancer. When in weighted mode, EDF scheduling is used, or alias table
+ * selection if configured. When in not weighted mode, simple RR index selection is used.
  */
 class RoundRobinLoadBalancer : public EdfLoadBalancerBase {
 public:
@@ -38,11 +38,13 @@ public:
       : EdfLoadBalancerBase(
             priority_set, local_priority_set, stats, runtime, random, healthy_panic_threshold,
             LoadBalancerConfigHelper::localityLbConfigFromProto(round_robin_config),
-            LoadBalancerConfigHelper::slowStartConfigFromProto(round_robin_config), time_source) {
+            LoadBalancerConfigHelper::slowStartConfigFromProto(round_robin_config), time_source),
+        use_alias_table_(round_robin_config.use_alias_table()) {
     initialize();
   }
 
 private:
+  bool useAliasTable() const override { return use_alias_table_; }
   void refreshHostSource(const HostsSource& source) override {
     // insert() is used here on purpose so that we don't overwrite the index if the host source
     // already exists. Note that host sources will never be removed, but given how uncommon this
@@ -80,6 +82,7 @@ private:
     return hosts_to_use[rr_indexes_[source]++ % hosts_to_use.size()];
   }
 
+  const bool use_alias_table_{};
   uint64_t peekahead_index_{};
   absl::flat_hash_map<HostsSource, uint64_t, HostsSourceHash> rr_indexes_;
 };
@@ -18,6 +18,7 @@
 #include "source/common/config/utility.h"
 #include "source/common/network/socket_interface.h"
 #include "source/common/network/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/stats/symbol_table.h"
 
 #include "absl/strings/str_join.h"
@@ -28,6 +29,20 @@ namespace StatSinks {
 namespace Common {
 namespace Statsd {
 
+namespace {
+
+// A zero increment is a no-op for statsd, so only counters which moved since the last flush need to
+// be written.
+const std::vector<Stats::MetricSnapshot::CounterSnapshot>&
+countersToFlush(Stats::MetricSnapshot& snapshot) {
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.statsd_skip_unchanged_counters")) {
+    return snapshot.changedCounters();
+  }
+  return snapshot.counters();
+}
+
+} // namespace
+
 UdpStatsdSink::WriterImpl::WriterImpl(UdpStatsdSink& parent)
     : parent_(parent), io_handle_(Network::ioHandleForAddr(Network::Socket::Type::Datagram,
                                                            parent_.server_address_, {})) {}
@@ -59,7 +74,7 @@ void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   Writer& writer = tls_->getTyped<Writer>();
   Buffer::OwnedImpl buffer;
 
-  for (const auto& counter : snapshot.counters()) {
+  for (const auto& counter : countersToFlush(snapshot)) {
     if (counter.counter_.get().used()) {
       const std::string counter_str = buildMessage(counter.counter_.get(), counter.delta_, "|c");
       writeBuffer(buffer, writer, counter_str);
@@ -219,7 +234,7 @@ TcpStatsdSink::create(const LocalInfo::LocalInfo& local_info, const std::string&
 void TcpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   TlsSink& tls_sink = tls_->getTyped<TlsSink>();
   tls_sink.beginFlush(true);
-  for (const auto& counter : snapshot.counters()) {
+  for (const auto& counter : countersToFlush(snapshot)) {
     if (counter.counter_.get().used()) {
       tls_sink.flushCounter(counter.counter_.get().name(), counter.delta_);
     }
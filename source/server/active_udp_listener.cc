@@ -4,6 +4,7 @@
 #include "envoy/server/listener_manager.h"
 #include "envoy/stats/scope.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/network/udp_listener_impl.h"
 #include "source/common/network/utility.h"
 
@@ -60,6 +61,24 @@ void ActiveUdpListenerBase::onData(Network::UdpRecvData&& data) {
   }
 }
 
+void ActiveUdpListenerBase::onDataBatch(absl::Span<const Network::UdpRecvPacket> packets) {
+  for (const Network::UdpRecvPacket& packet : packets) {
+    onData(copyPacket(packet));
+  }
+}
+
+Network::UdpRecvData ActiveUdpListenerBase::copyPacket(const Network::UdpRecvPacket& packet) {
+  Network::UdpRecvData data{packet.addresses_,
+                            std::make_unique<Buffer::OwnedImpl>(packet.payload_),
+                            packet.receive_time_,
+                            packet.tos_,
+                            {}};
+  if (!packet.saved_cmsg_.empty()) {
+    data.saved_cmsg_.add(packet.saved_cmsg_);
+  }
+  return data;
+}
+
 ActiveRawUdpListener::ActiveRawUdpListener(uint32_t worker_index, uint32_t concurrency,
                                            Network::UdpConnectionHandler& parent,
                                            Network::SocketSharedPtr listen_socket_ptr,
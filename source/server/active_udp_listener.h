@@ -34,6 +34,8 @@ public:
 
   // Network::UdpListenerCallbacks
   void onData(Network::UdpRecvData&& data) final;
+  void onDataBatch(absl::Span<const Network::UdpRecvPacket> packets) override;
+  bool supportsPacketBatches() const override { return false; }
   uint32_t workerIndex() const final { return worker_index_; }
   void post(Network::UdpRecvData&& data) final;
   void onDatagramsDropped(uint32_t dropped) final {
@@ -44,6 +46,9 @@ public:
   Network::Listener* listener() override { return udp_listener_.get(); }
 
 protected:
+  // Copies a datagram out of the memory of the listener, e.g. to route it to another worker.
+  static Network::UdpRecvData copyPacket(const Network::UdpRecvPacket& packet);
+
   uint32_t destination(const Network::UdpRecvData& /*data*/) const override {
     // By default, route to the current worker.
     return worker_index_;
@@ -1,6 +1,8 @@
 #include "source/server/admin/prometheus_stats.h"
 
+#include <algorithm>
 #include <cmath>
+#include <map>
 
 #include "source/common/common/empty_string.h"
 #include "source/common/common/macros.h"
@@ -8,6 +10,7 @@
 #include "source/common/stats/histogram_impl.h"
 #include "source/common/upstream/host_utility.h"
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
 
@@ -27,6 +30,13 @@ std::string sanitizeName(const absl::string_view name) {
   // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
   // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
   // The initial [a-zA-Z_] constraint is always satisfied by the namespace prefix.
+  //
+  // Tag names are sanitized for every metric that is output, and they rarely need it, so check
+  // for that before running the regex.
+  if (std::all_of(name.begin(), name.end(),
+                  [](char c) { return absl::ascii_isalnum(c) || c == '_'; })) {
+    return std::string(name);
+  }
   return promRegex().replaceAll(name, "_");
 }
 
@@ -130,86 +140,121 @@ std::string generateHistogramOutput(const Stats::ParentHistogram& histogram,
   return output;
 };
 
-/**
- * Processes a stat type (counter, gauge, histogram) by generating all output lines, sorting
- * them by tag-extracted metric name, and then outputting them in the correct sorted order into
- * response.
+template <class StatType>
+using GenerateOutputFn = std::function<std::string(const StatType& metric,
+                                                   const std::string& prefixed_tag_extracted_name)>;
+
+/*
+ * From
+ * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
  *
- * @param response The buffer to put the output into.
- * @param used_only Whether to only output stats that are used.
- * @param regex A filter on which stats to output.
- * @param metrics The metrics to output stats for. This must contain all stats of the given type
- *        to be included in the same output.
- * @param generate_output A function which returns the output text for this metric.
- * @param type The name of the prometheus metric type for used in TYPE annotations.
+ * All lines for a given metric must be provided as one single group, with the optional HELP and
+ * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
+ * expositions is preferred but not required, i.e. do not sort if the computational cost is
+ * prohibitive.
+ *
+ * So the metrics of one type are grouped into families by their tag-extracted name, which is
+ * computed once when the stat is created. The families are sorted by that name.
+ *
+ * The metrics in each family are an unsorted collection of dumb-pointers (no need to increment
+ * then decrement every refcount; ownership is held throughout by the caller). They are sorted
+ * when the family is output.
  */
 template <class StatType>
-uint64_t outputStatType(
-    Buffer::Instance& response, const StatsParams& params,
-    const std::vector<Stats::RefcountPtr<StatType>>& metrics,
-    const std::function<std::string(
-        const StatType& metric, const std::string& prefixed_tag_extracted_name)>& generate_output,
-    absl::string_view type, const Stats::CustomStatNamespaces& custom_namespaces) {
+using MetricFamilies =
+    std::map<Stats::StatName, std::vector<const StatType*>, Stats::StatNameLessThan>;
 
-  /*
-   * From
-   * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
-   *
-   * All lines for a given metric must be provided as one single group, with the optional HELP and
-   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
-   * expositions is preferred but not required, i.e. do not sort if the computational cost is
-   * prohibitive.
-   */
-
-  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
-  // refcount; ownership is held throughout by `metrics`). It is unsorted for efficiency, but will
-  // be sorted before producing the final output to satisfy the "preferred" ordering from the
-  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
-  // consistent across calls.
-  using StatTypeUnsortedCollection = std::vector<const StatType*>;
-
-  // Return early to avoid crashing when getting the symbol table from the first metric.
-  if (metrics.empty()) {
-    return 0;
-  }
+/**
+ * Groups the metrics of one stat type that should be output into families.
+ *
+ * @param params The request parameters, used to filter metrics.
+ * @param metrics The metrics to group. This must contain all stats of the given type to be
+ *        included in the same output, and must not be empty.
+ */
+template <class StatType>
+MetricFamilies<StatType> groupMetricFamilies(const StatsParams& params,
+                                             const std::vector<Stats::RefcountPtr<StatType>>& metrics) {
+  ASSERT(!metrics.empty());
 
   // There should only be one symbol table for all of the stats in the admin
   // interface. If this assumption changes, the name comparisons in this function
   // will have to change to compare to convert all StatNames to strings before
   // comparison.
   const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
-
-  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
-  // of the exposition format.
-  std::map<Stats::StatName, StatTypeUnsortedCollection, Stats::StatNameLessThan> groups(
-      global_symbol_table);
-
+  MetricFamilies<StatType> families(global_symbol_table);
   for (const auto& metric : metrics) {
     ASSERT(&global_symbol_table == &metric->constSymbolTable());
     if (!params.shouldShowMetric(*metric)) {
       continue;
     }
-    groups[metric->tagExtractedStatName()].push_back(metric.get());
+    families[metric->tagExtractedStatName()].push_back(metric.get());
   }
+  return families;
+}
 
-  auto result = groups.size();
-  for (auto& group : groups) {
-    const absl::optional<std::string> prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group.first),
-                                             custom_namespaces);
-    if (!prefixed_tag_extracted_name.has_value()) {
-      --result;
-      continue;
-    }
-    response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name.value(), type));
+/**
+ * Outputs a family of metrics, with its TYPE annotation.
+ *
+ * @param response The buffer to put the output into.
+ * @param tag_extracted_name The name of the family.
+ * @param metrics The metrics in the family, which are sorted here.
+ * @param generate_output A function which returns the output text for this metric.
+ * @param type The name of the prometheus metric type for used in TYPE annotations.
+ * @return false if the family name is not valid in Prometheus, in which case nothing is output.
+ */
+template <class StatType>
+bool outputMetricFamily(Buffer::Instance& response, Stats::StatName tag_extracted_name,
+                        std::vector<const StatType*>& metrics,
+                        const GenerateOutputFn<StatType>& generate_output, absl::string_view type,
+                        const Stats::CustomStatNamespaces& custom_namespaces) {
+  ASSERT(!metrics.empty());
+  const absl::optional<std::string> prefixed_tag_extracted_name =
+      PrometheusStatsFormatter::metricName(
+          metrics.front()->constSymbolTable().toString(tag_extracted_name), custom_namespaces);
+  if (!prefixed_tag_extracted_name.has_value()) {
+    return false;
+  }
+  response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name.value(), type));
 
-    // Sort before producing the final output to satisfy the "preferred" ordering from the
-    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
-    // be consistent across calls.
-    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
+  // Sort before producing the final output to satisfy the "preferred" ordering from the
+  // prometheus spec: metrics will be sorted by their tags' textual representation, which will
+  // be consistent across calls.
+  std::sort(metrics.begin(), metrics.end(), MetricLessThan());
 
-    for (const auto& metric : group.second) {
-      response.add(generate_output(*metric, prefixed_tag_extracted_name.value()));
+  for (const StatType* metric : metrics) {
+    response.add(generate_output(*metric, prefixed_tag_extracted_name.value()));
+  }
+  return true;
+}
+
+/**
+ * Processes a stat type (counter, gauge, histogram) by generating all output lines, sorting
+ * them by tag-extracted metric name, and then outputting them in the correct sorted order into
+ * response.
+ *
+ * @param response The buffer to put the output into.
+ * @param params The request parameters, used to filter metrics.
+ * @param metrics The metrics to output stats for. This must contain all stats of the given type
+ *        to be included in the same output.
+ * @param generate_output A function which returns the output text for this metric.
+ * @param type The name of the prometheus metric type for used in TYPE annotations.
+ * @return the number of families that were output.
+ */
+template <class StatType>
+uint64_t outputStatType(Buffer::Instance& response, const StatsParams& params,
+                        const std::vector<Stats::RefcountPtr<StatType>>& metrics,
+                        const GenerateOutputFn<StatType>& generate_output, absl::string_view type,
+                        const Stats::CustomStatNamespaces& custom_namespaces) {
+  // Return early to avoid crashing when getting the symbol table from the first metric.
+  if (metrics.empty()) {
+    return 0;
+  }
+
+  uint64_t result = 0;
+  for (auto& [tag_extracted_name, family] : groupMetricFamilies(params, metrics)) {
+    if (outputMetricFamily(response, tag_extracted_name, family, generate_output, type,
+                           custom_namespaces)) {
+      ++result;
     }
   }
   return result;
@@ -276,6 +321,28 @@ uint64_t outputPrimitiveStatType(Buffer::Instance& response, const StatsParams&
   return result;
 }
 
+/*
+ * Outputs the per-endpoint counters and gauges, which are not held in the stats store.
+ */
+uint64_t outputHostMetrics(Buffer::Instance& response, const StatsParams& params,
+                           const Upstream::ClusterManager& cluster_manager,
+                           const Stats::CustomStatNamespaces& custom_namespaces) {
+  // Note: This assumes that there is no overlap in stat name between per-endpoint stats and all
+  // other stats. If this is not true, then the counters/gauges for per-endpoint need to be combined
+  // with the other counter/gauge calls so that stats can be properly grouped.
+  std::vector<Stats::PrimitiveCounterSnapshot> host_counters;
+  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges;
+  Upstream::HostUtility::forEachHostMetric(
+      cluster_manager,
+      [&](Stats::PrimitiveCounterSnapshot&& metric) {
+        host_counters.emplace_back(std::move(metric));
+      },
+      [&](Stats::PrimitiveGaugeSnapshot&& metric) { host_gauges.emplace_back(std::move(metric)); });
+
+  return outputPrimitiveStatType(response, params, host_counters, "counter", custom_namespaces) +
+         outputPrimitiveStatType(response, params, host_gauges, "gauge", custom_namespaces);
+}
+
 /*
  * Returns the prometheus output for a summary. The output is a multi-line string (with embedded
  * newlines) that contains all the individual quantile values and sum/count for a single histogram
@@ -307,6 +374,149 @@ std::string generateSummaryOutput(const Stats::ParentHistogram& histogram,
 
 } // namespace
 
+/**
+ * Renders the metric families of one stat type, one family at a time.
+ */
+class PrometheusFamilyRenderer {
+public:
+  virtual ~PrometheusFamilyRenderer() = default;
+
+  /**
+   * Renders the next family into response.
+   * @return false if all the families have been rendered.
+   */
+  virtual bool renderNextFamily(Buffer::Instance& response) PURE;
+};
+
+namespace {
+
+template <class StatType> class TypedPrometheusFamilyRenderer : public PrometheusFamilyRenderer {
+public:
+  // Holds a reference to every metric of the type until they have all been rendered.
+  TypedPrometheusFamilyRenderer(std::vector<Stats::RefcountPtr<StatType>>&& metrics,
+                                const StatsParams& params,
+                                GenerateOutputFn<StatType> generate_output, absl::string_view type,
+                                const Stats::CustomStatNamespaces& custom_namespaces)
+      : metrics_(std::move(metrics)), families_(groupMetricFamilies(params, metrics_)),
+        generate_output_(std::move(generate_output)), type_(type),
+        custom_namespaces_(custom_namespaces) {}
+
+  bool renderNextFamily(Buffer::Instance& response) override {
+    // Families whose name is not valid in Prometheus are skipped.
+    while (!families_.empty()) {
+      auto iter = families_.begin();
+      const bool rendered = outputMetricFamily(response, iter->first, iter->second,
+                                               generate_output_, type_, custom_namespaces_);
+      families_.erase(iter);
+      if (rendered) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  const std::vector<Stats::RefcountPtr<StatType>> metrics_;
+  MetricFamilies<StatType> families_;
+  const GenerateOutputFn<StatType> generate_output_;
+  const absl::string_view type_;
+  const Stats::CustomStatNamespaces& custom_namespaces_;
+};
+
+template <class StatType>
+std::unique_ptr<PrometheusFamilyRenderer>
+makeFamilyRenderer(std::vector<Stats::RefcountPtr<StatType>>&& metrics, const StatsParams& params,
+                   GenerateOutputFn<StatType> generate_output, absl::string_view type,
+                   const Stats::CustomStatNamespaces& custom_namespaces) {
+  if (metrics.empty()) {
+    return nullptr;
+  }
+  return std::make_unique<TypedPrometheusFamilyRenderer<StatType>>(
+      std::move(metrics), params, std::move(generate_output), type, custom_namespaces);
+}
+
+} // namespace
+
+PrometheusStatsRequest::PrometheusStatsRequest(
+    Stats::Store& stats, const StatsParams& params, const Upstream::ClusterManager& cluster_manager,
+    const Stats::CustomStatNamespaces& custom_namespaces)
+    : params_(params), stats_(stats), cluster_manager_(cluster_manager),
+      custom_namespaces_(custom_namespaces) {}
+
+PrometheusStatsRequest::~PrometheusStatsRequest() = default;
+
+Http::Code PrometheusStatsRequest::start(Http::ResponseHeaderMap&) {
+  phase_ = Phase::Counters;
+  renderer_ = makeFamilyRenderer<Stats::Counter>(stats_.counters(), params_,
+                                                 generateStatNumericOutput<Stats::Counter>,
+                                                 "counter", custom_namespaces_);
+  return Http::Code::OK;
+}
+
+bool PrometheusStatsRequest::nextChunk(Buffer::Instance& response) {
+  // nextChunk's contract is to add up to chunk_size_ additional bytes. The
+  // caller is not required to drain the bytes after each call to nextChunk.
+  const uint64_t starting_response_length = response.length();
+  while (response.length() - starting_response_length < chunk_size_) {
+    if (renderer_ == nullptr || !renderer_->renderNextFamily(response)) {
+      if (!startNextPhase(response)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool PrometheusStatsRequest::startNextPhase(Buffer::Instance& response) {
+  // Release the metrics of the previous phase before collecting the next ones.
+  renderer_.reset();
+  switch (phase_) {
+  case Phase::Counters:
+    phase_ = Phase::Gauges;
+    renderer_ = makeFamilyRenderer<Stats::Gauge>(stats_.gauges(), params_,
+                                                 generateStatNumericOutput<Stats::Gauge>, "gauge",
+                                                 custom_namespaces_);
+    return true;
+  case Phase::Gauges:
+    phase_ = Phase::TextReadouts;
+    if (params_.prometheus_text_readouts_) {
+      // TextReadout stats are returned in gauge format, so "gauge" type is set intentionally.
+      renderer_ = makeFamilyRenderer<Stats::TextReadout>(
+          stats_.textReadouts(), params_, generateTextReadoutOutput, "gauge", custom_namespaces_);
+    }
+    return true;
+  case Phase::TextReadouts:
+    phase_ = Phase::Histograms;
+    switch (params_.histogram_buckets_mode_) {
+    case Utility::HistogramBucketsMode::Summary:
+      renderer_ = makeFamilyRenderer<Stats::ParentHistogram>(
+          stats_.histograms(), params_, generateSummaryOutput, "summary", custom_namespaces_);
+      break;
+    case Utility::HistogramBucketsMode::Unset:
+    case Utility::HistogramBucketsMode::Cumulative:
+      renderer_ = makeFamilyRenderer<Stats::ParentHistogram>(
+          stats_.histograms(), params_, generateHistogramOutput, "histogram", custom_namespaces_);
+      break;
+    // "Detailed" and "Disjoint" are rejected by validateParams().
+    case Utility::HistogramBucketsMode::Detailed:
+    case Utility::HistogramBucketsMode::Disjoint:
+      IS_ENVOY_BUG("unsupported prometheus histogram bucket mode");
+      break;
+    }
+    return true;
+  case Phase::Histograms:
+    // This does not adhere to the streaming contract, as there is nothing to
+    // hold onto while pausing the iteration over hosts. See
+    // StatsRequest::renderPerHostMetrics().
+    phase_ = Phase::HostMetrics;
+    outputHostMetrics(response, params_, cluster_manager_, custom_namespaces_);
+    return false;
+  case Phase::HostMetrics:
+    break;
+  }
+  return false;
+}
+
 std::string PrometheusStatsFormatter::formattedTags(const std::vector<Stats::Tag>& tags) {
   std::vector<std::string> buf;
   buf.reserve(tags.size());
@@ -397,24 +607,7 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     break;
   }
 
-  // Note: This assumes that there is no overlap in stat name between per-endpoint stats and all
-  // other stats. If this is not true, then the counters/gauges for per-endpoint need to be combined
-  // with the above counter/gauge calls so that stats can be properly grouped.
-  std::vector<Stats::PrimitiveCounterSnapshot> host_counters;
-  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges;
-  Upstream::HostUtility::forEachHostMetric(
-      cluster_manager,
-      [&](Stats::PrimitiveCounterSnapshot&& metric) {
-        host_counters.emplace_back(std::move(metric));
-      },
-      [&](Stats::PrimitiveGaugeSnapshot&& metric) { host_gauges.emplace_back(std::move(metric)); });
-
-  metric_name_count +=
-      outputPrimitiveStatType(response, params, host_counters, "counter", custom_namespaces);
-
-  metric_name_count +=
-      outputPrimitiveStatType(response, params, host_gauges, "gauge", custom_namespaces);
-
+  metric_name_count += outputHostMetrics(response, params, cluster_manager, custom_namespaces);
   return metric_name_count;
 }
 
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/server/admin.h"
 #include "envoy/stats/custom_stat_namespaces.h"
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
@@ -53,5 +54,53 @@ public:
              const Stats::CustomStatNamespaces& custom_namespace_factory);
 };
 
+class PrometheusFamilyRenderer;
+
+/**
+ * Streams the Prometheus exposition of the stats in chunks. The metrics of one type are only
+ * grouped into families when that type is reached, and each chunk renders whole families until
+ * it reaches the chunk size. So the response is never held in memory in full, unlike with
+ * PrometheusStatsFormatter::statsAsPrometheus(), and rendering is spread over several main
+ * thread dispatcher iterations as the admin filter drains the chunks.
+ *
+ * The output is the same as that of PrometheusStatsFormatter::statsAsPrometheus().
+ */
+class PrometheusStatsRequest : public Admin::Request {
+public:
+  static constexpr uint64_t DefaultChunkSize = 2 * 1000 * 1000;
+
+  /**
+   * @param params the request parameters, which must have been checked with
+   *        PrometheusStatsFormatter::validateParams().
+   */
+  PrometheusStatsRequest(Stats::Store& stats, const StatsParams& params,
+                         const Upstream::ClusterManager& cluster_manager,
+                         const Stats::CustomStatNamespaces& custom_namespaces);
+  ~PrometheusStatsRequest() override;
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override;
+  bool nextChunk(Buffer::Instance& response) override;
+
+  // Sets the chunk size.
+  void setChunkSize(uint64_t chunk_size) { chunk_size_ = chunk_size; }
+
+private:
+  // The stat types in the order in which they are output.
+  enum class Phase { Counters, Gauges, TextReadouts, Histograms, HostMetrics };
+
+  // Moves on to the next phase, returning false once all phases are done.
+  bool startNextPhase(Buffer::Instance& response);
+
+  const StatsParams params_;
+  Stats::Store& stats_;
+  const Upstream::ClusterManager& cluster_manager_;
+  const Stats::CustomStatNamespaces& custom_namespaces_;
+  Phase phase_{Phase::Counters};
+  // Renders the families of the current phase, or null if it has none.
+  std::unique_ptr<PrometheusFamilyRenderer> renderer_;
+  uint64_t chunk_size_{DefaultChunkSize};
+};
+
 } // namespace Server
 } // namespace Envoy
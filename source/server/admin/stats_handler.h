@@ -33,32 +33,13 @@ public:
                                               Buffer::Instance& response, AdminStream&);
   Http::Code handlerStatsRecentLookupsEnable(Http::ResponseHeaderMap& response_headers,
                                              Buffer::Instance& response, AdminStream&);
-  Http::Code handlerPrometheusStats(Http::ResponseHeaderMap& response_headers,
-                                    Buffer::Instance& response, AdminStream&);
 
   /**
-   * Parses and executes a prometheus stats request.
-   *
-   * @param path_and_query the URL path and query
-   * @param response buffer into which to write response
-   * @return http response code
-   */
-  Http::Code prometheusStats(absl::string_view path_and_query, Buffer::Instance& response);
-
-  /**
-   * Checks the server_ to see if a flush is needed, and then renders the
-   * prometheus stats request.
-   *
-   * @params params the already-parsed parameters.
-   * @param response buffer into which to write response
-   */
-  Http::Code prometheusFlushAndRender(const StatsParams& params, Buffer::Instance& response);
-
-  /**
-   * Renders the stats as prometheus. This is broken out as a separately
-   * callable API to facilitate the benchmark
+   * Renders the stats as prometheus, buffering the whole response. This is
+   * broken out as a separately callable API to facilitate the benchmark
    * (test/server/admin/stats_handler_speed_test.cc) which does not have a
-   * server object.
+   * server object. The admin endpoints stream the response with
+   * makePrometheusRequest() instead.
    *
    * @params stats the stats store to read
    * @param custom_namespaces namespace mappings used for prometheus
@@ -87,15 +68,33 @@ public:
    */
   Admin::UrlHandler statsHandler(bool active_mode);
 
+  /**
+   * @return the URL handler for /stats/prometheus, which streams the stats in
+   *         the Prometheus text exposition format.
+   */
+  Admin::UrlHandler prometheusStatsHandler();
+
   static Admin::RequestPtr makeRequest(Stats::Store& stats, const StatsParams& params,
                                        const Upstream::ClusterManager& cm,
                                        StatsRequest::UrlHandlerFn url_handler_fn = nullptr);
   Admin::RequestPtr makeRequest(AdminStream&);
 
+  /**
+   * Makes a request streaming the stats in the Prometheus text exposition
+   * format, or one responding with an error if the params are not supported.
+   *
+   * @param stats the stats store to read
+   * @param params the already-parsed parameters.
+   * @param cm the cluster manager, for the per-endpoint stats.
+   * @param custom_namespaces namespace mappings used for prometheus
+   */
+  static Admin::RequestPtr makePrometheusRequest(Stats::Store& stats, const StatsParams& params,
+                                                 const Upstream::ClusterManager& cm,
+                                                 const Stats::CustomStatNamespaces& custom_namespaces);
+
 private:
-  static Http::Code prometheusStats(absl::string_view path_and_query, Buffer::Instance& response,
-                                    Stats::Store& stats,
-                                    Stats::CustomStatNamespaces& custom_namespaces);
+  Admin::RequestPtr makePrometheusRequest(AdminStream& admin_stream);
+  Admin::RequestPtr makePrometheusRequest(const StatsParams& params);
 };
 
 } // namespace Server
@@ -171,7 +171,11 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store,
       },
       [this](Stats::Counter& counter) {
         snapped_counters_.push_back(Stats::CounterSharedPtr(&counter));
-        counters_.push_back({counter.latch(), counter});
+        const uint64_t delta = counter.latch();
+        counters_.push_back({delta, counter});
+        if (delta > 0) {
+          changed_counters_.push_back({delta, counter});
+        }
       });
 
   store.forEachSinkedGauge(
@@ -182,6 +186,9 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store,
       [this](Stats::Gauge& gauge) {
         snapped_gauges_.push_back(Stats::GaugeSharedPtr(&gauge));
         gauges_.push_back(gauge);
+        if (gauge.latchChanged()) {
+          changed_gauges_.push_back(gauge);
+        }
       });
 
   store.forEachSinkedHistogram(
@@ -192,6 +199,9 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store,
       [this](Stats::ParentHistogram& histogram) {
         snapped_histograms_.push_back(Stats::ParentHistogramSharedPtr(&histogram));
         histograms_.push_back(histogram);
+        if (histogram.intervalStatistics().sampleCount() > 0) {
+          changed_histograms_.push_back(histogram);
+        }
       });
 
   store.forEachSinkedTextReadout(
@@ -202,6 +212,9 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store,
       [this](Stats::TextReadout& text_readout) {
         snapped_text_readouts_.push_back(Stats::TextReadoutSharedPtr(&text_readout));
         text_readouts_.push_back(text_readout);
+        if (text_readout.latchChanged()) {
+          changed_text_readouts_.push_back(text_readout);
+        }
       });
 
   Upstream::HostUtility::forEachHostMetric(
@@ -260,6 +273,13 @@ void InstanceBase::updateServerStats() {
                                        parent_stats.parent_memory_allocated_);
   server_stats_->memory_heap_size_.set(Memory::Stats::totalCurrentlyReserved());
   server_stats_->memory_physical_size_.set(Memory::Stats::totalPhysicalBytes());
+  const Buffer::SlicePoolStats slice_pool_stats = Buffer::SlicePool::stats();
+  server_stats_->memory_slice_pool_hits_.add(slice_pool_stats.hits_ -
+                                             last_slice_pool_stats_.hits_);
+  server_stats_->memory_slice_pool_misses_.add(slice_pool_stats.misses_ -
+                                               last_slice_pool_stats_.misses_);
+  server_stats_->memory_slice_pool_resident_bytes_.set(slice_pool_stats.resident_bytes_);
+  last_slice_pool_stats_ = slice_pool_stats;
   if (!options().hotRestartDisabled()) {
     server_stats_->parent_connections_.set(parent_stats.parent_connections_);
   }
@@ -25,6 +25,7 @@
 #include "envoy/tracing/tracer.h"
 
 #include "source/common/access_log/access_log_manager_impl.h"
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/cleanup.h"
 #include "source/common/common/logger_delegates.h"
@@ -76,6 +77,8 @@ struct ServerCompilationSettingsStats {
   COUNTER(static_unknown_fields)                                                                   \
   COUNTER(wip_protos)                                                                              \
   COUNTER(dropped_stat_flushes)                                                                    \
+  COUNTER(memory_slice_pool_hits)                                                                  \
+  COUNTER(memory_slice_pool_misses)                                                                \
   GAUGE(concurrency, NeverImport)                                                                  \
   GAUGE(days_until_first_cert_expiring, NeverImport)                                               \
   GAUGE(seconds_until_first_ocsp_response_expiring, NeverImport)                                   \
@@ -85,6 +88,7 @@ struct ServerCompilationSettingsStats {
   GAUGE(memory_allocated, Accumulate)                                                              \
   GAUGE(memory_heap_size, Accumulate)                                                              \
   GAUGE(memory_physical_size, Accumulate)                                                          \
+  GAUGE(memory_slice_pool_resident_bytes, NeverImport)                                             \
   GAUGE(parent_connections, Accumulate)                                                            \
   GAUGE(state, NeverImport)                                                                        \
   GAUGE(stats_recent_lookups, NeverImport)                                                         \
@@ -439,6 +443,8 @@ private:
   Regex::EnginePtr regex_engine_;
   bool stats_flush_in_progress_ : 1;
   std::unique_ptr<Memory::AllocatorManager> memory_allocator_manager_;
+  // Slice pool totals as of the last server stats update, used to compute counter deltas.
+  Buffer::SlicePoolStats last_slice_pool_stats_;
 
   template <class T>
   class LifecycleCallbackHandle : public ServerLifecycleNotifier::Handle, RaiiListElement<T> {
@@ -476,6 +482,18 @@ public:
   const std::vector<std::reference_wrapper<const Stats::TextReadout>>& textReadouts() override {
     return text_readouts_;
   }
+  const std::vector<CounterSnapshot>& changedCounters() override { return changed_counters_; }
+  const std::vector<std::reference_wrapper<const Stats::Gauge>>& changedGauges() override {
+    return changed_gauges_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>&
+  changedHistograms() override {
+    return changed_histograms_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::TextReadout>>&
+  changedTextReadouts() override {
+    return changed_text_readouts_;
+  }
   const std::vector<Stats::PrimitiveCounterSnapshot>& hostCounters() override {
     return host_counters_;
   }
@@ -491,6 +509,12 @@ private:
   std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
   std::vector<Stats::TextReadoutSharedPtr> snapped_text_readouts_;
   std::vector<std::reference_wrapper<const Stats::TextReadout>> text_readouts_;
+  // Subsets of the above holding only the stats updated since the previous snapshot, so that sinks
+  // can do work proportional to activity rather than to the number of stats.
+  std::vector<CounterSnapshot> changed_counters_;
+  std::vector<std::reference_wrapper<const Stats::Gauge>> changed_gauges_;
+  std::vector<std::reference_wrapper<const Stats::ParentHistogram>> changed_histograms_;
+  std::vector<std::reference_wrapper<const Stats::TextReadout>> changed_text_readouts_;
   std::vector<Stats::PrimitiveCounterSnapshot> host_counters_;
   std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges_;
   SystemTime snapshot_time_;
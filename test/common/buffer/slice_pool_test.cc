@@ -0,0 +1,135 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_pool.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class SlicePoolTest : public testing::Test {
+protected:
+  SlicePoolTest() : initial_stats_(SlicePool::stats()) {}
+  ~SlicePoolTest() override { SlicePool::setMaxFreeBlocksPerThread(0); }
+
+  uint64_t hits() const { return SlicePool::stats().hits_ - initial_stats_.hits_; }
+  uint64_t misses() const { return SlicePool::stats().misses_ - initial_stats_.misses_; }
+
+  const SlicePoolStats initial_stats_;
+};
+
+TEST_F(SlicePoolTest, DisabledByDefault) {
+  EXPECT_EQ(nullptr, SlicePool::threadLocalPool());
+
+  Slice::StoragePtr storage = Slice::allocateStorage(Slice::default_slice_size_);
+  EXPECT_EQ(nullptr, storage.get_deleter().pool_);
+}
+
+TEST_F(SlicePoolTest, ReusesBlocksOnOwningThread) {
+  SlicePool::setMaxFreeBlocksPerThread(4);
+  SlicePool* pool = SlicePool::threadLocalPool();
+  ASSERT_NE(nullptr, pool);
+  EXPECT_EQ(pool, SlicePool::threadLocalPool());
+
+  uint8_t* first = pool->allocate();
+  EXPECT_EQ(1, misses());
+  pool->release(first);
+  uint8_t* second = pool->allocate();
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(1, hits());
+  pool->release(second);
+}
+
+TEST_F(SlicePoolTest, FreeListIsBounded) {
+  SlicePool::setMaxFreeBlocksPerThread(1);
+  SlicePool* pool = SlicePool::threadLocalPool();
+  ASSERT_NE(nullptr, pool);
+
+  const uint64_t resident_before = SlicePool::stats().resident_bytes_;
+  uint8_t* first = pool->allocate();
+  uint8_t* second = pool->allocate();
+  pool->release(first);
+  pool->release(second);
+  EXPECT_LE(SlicePool::stats().resident_bytes_, resident_before + SlicePool::BlockSize);
+}
+
+TEST_F(SlicePoolTest, OnlyDefaultSizedStorageIsPooled) {
+  SlicePool::setMaxFreeBlocksPerThread(4);
+
+  Slice::StoragePtr pooled = Slice::allocateStorage(Slice::default_slice_size_);
+  EXPECT_EQ(SlicePool::threadLocalPool(), pooled.get_deleter().pool_);
+
+  Slice::StoragePtr unpooled = Slice::allocateStorage(4096);
+  EXPECT_EQ(nullptr, unpooled.get_deleter().pool_);
+}
+
+TEST_F(SlicePoolTest, BufferStorageReturnsToPool) {
+  SlicePool::setMaxFreeBlocksPerThread(4);
+
+  const uint8_t* mem;
+  {
+    OwnedImpl buffer;
+    auto reservation = buffer.reserveSingleSlice(Slice::default_slice_size_);
+    mem = static_cast<const uint8_t*>(reservation.slice().mem_);
+    reservation.commit(Slice::default_slice_size_);
+    EXPECT_EQ(Slice::default_slice_size_, buffer.length());
+  }
+
+  const uint64_t hits_before = hits();
+  OwnedImpl buffer;
+  auto reservation = buffer.reserveSingleSlice(Slice::default_slice_size_);
+  EXPECT_EQ(mem, reservation.slice().mem_);
+  EXPECT_EQ(hits_before + 1, hits());
+}
+
+TEST_F(SlicePoolTest, CrossThreadReleaseReturnsToOwner) {
+  SlicePool::setMaxFreeBlocksPerThread(4);
+  SlicePool* pool = SlicePool::threadLocalPool();
+  ASSERT_NE(nullptr, pool);
+
+  uint8_t* mem = pool->allocate();
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([pool, mem]() {
+    // This thread has a different pool, so the block must go to the owner's return queue.
+    EXPECT_NE(pool, SlicePool::threadLocalPool());
+    pool->release(mem);
+  });
+  thread->join();
+
+  const uint64_t hits_before = hits();
+  EXPECT_EQ(mem, pool->allocate());
+  EXPECT_EQ(hits_before + 1, hits());
+  pool->release(mem);
+}
+
+TEST_F(SlicePoolTest, PoolOutlivesOwningThread) {
+  SlicePool::setMaxFreeBlocksPerThread(4);
+
+  SlicePool* other_pool = nullptr;
+  uint8_t* mem = nullptr;
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([&]() {
+    other_pool = SlicePool::threadLocalPool();
+    mem = other_pool->allocate();
+  });
+  thread->join();
+
+  // The owning thread is gone; releasing the block must still be safe.
+  ASSERT_NE(nullptr, other_pool);
+  other_pool->release(mem);
+}
+
+TEST_F(SlicePoolTest, DisablingFreesReleasedBlocks) {
+  SlicePool::setMaxFreeBlocksPerThread(4);
+  Slice::StoragePtr storage = Slice::allocateStorage(Slice::default_slice_size_);
+  const uint64_t resident_before = SlicePool::stats().resident_bytes_;
+
+  SlicePool::setMaxFreeBlocksPerThread(0);
+  storage.reset();
+  EXPECT_EQ(resident_before, SlicePool::stats().resident_bytes_);
+  EXPECT_EQ(nullptr, SlicePool::threadLocalPool());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
@@ -1,3 +1,5 @@
+#include <vector>
+
 #include "source/common/common/trie_lookup_table.h"
 
 #include "gtest/gtest.h"
@@ -65,6 +67,35 @@ TEST(TrieLookupTable, LongestPrefix) {
   EXPECT_EQ(nullptr, trie.findLongestPrefix(" "));
 }
 
+TEST(TrieLookupTable, VisitPrefixes) {
+  TrieLookupTable<const char*> trie;
+  const char* cstr_a = "a";
+  const char* cstr_b = "b";
+  const char* cstr_c = "c";
+  const char* cstr_d = "d";
+
+  EXPECT_TRUE(trie.add("", cstr_a));
+  EXPECT_TRUE(trie.add("foo", cstr_b));
+  EXPECT_TRUE(trie.add("foo/bar", cstr_c));
+  EXPECT_TRUE(trie.add("fob", cstr_d));
+
+  auto collect = [&trie](absl::string_view key, size_t limit = SIZE_MAX) {
+    std::vector<const char*> values;
+    trie.visitPrefixes(key, [&values, limit](const char* value) {
+      values.push_back(value);
+      return values.size() < limit;
+    });
+    return values;
+  };
+
+  EXPECT_EQ((std::vector<const char*>{cstr_a}), collect(""));
+  EXPECT_EQ((std::vector<const char*>{cstr_a}), collect("fo"));
+  EXPECT_EQ((std::vector<const char*>{cstr_a, cstr_b}), collect("foo/ba"));
+  EXPECT_EQ((std::vector<const char*>{cstr_a, cstr_b, cstr_c}), collect("foo/bar/baz"));
+  EXPECT_EQ((std::vector<const char*>{cstr_a, cstr_d}), collect("fob"));
+  EXPECT_EQ((std::vector<const char*>{cstr_a, cstr_b}), collect("foo/bar", 2));
+}
+
 TEST(TrieLookupTable, VeryDeepTrieDoesNotStackOverflowOnDestructor) {
   TrieLookupTable<const char*> trie;
   const char* cstr_a = "a";
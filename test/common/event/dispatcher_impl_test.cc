@@ -865,6 +865,105 @@ TEST_P(DispatcherMonotonicTimeTest, ApproximateMonotonicTime) {
   dispatcher_->run(Dispatcher::RunType::Block);
 }
 
+class MockDeferredFlushCallback : public DeferredFlushCallback {
+public:
+  MOCK_METHOD(void, onDeferredFlush, ());
+};
+
+class DeferredFlushTest : public testing::Test {
+protected:
+  DeferredFlushTest() : api_(Api::createApiForTest()) {
+    runtime_.mergeValues({{"envoy.restart_features.dispatcher_batch_flushes", "true"}});
+    dispatcher_ = api_->allocateDispatcher("test_thread");
+  }
+
+  TestScopedRuntime runtime_;
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+};
+
+TEST(DeferredFlushDisabledTest, NotDeferredByDefault) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  MockDeferredFlushCallback callback;
+  EXPECT_CALL(callback, onDeferredFlush()).Times(0);
+  EXPECT_FALSE(dispatcher->deferFlush(callback));
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+}
+
+// Flushes run once, after the rest of the work queued in the same iteration.
+TEST_F(DeferredFlushTest, RunsAfterQueuedWork) {
+  MockDeferredFlushCallback callback;
+  MockFunction<void()> queued_work;
+  SchedulableCallbackPtr work_cb = dispatcher_->createSchedulableCallback([&]() {
+    queued_work.Call();
+  });
+  {
+    InSequence s;
+    EXPECT_CALL(queued_work, Call());
+    EXPECT_CALL(callback, onDeferredFlush());
+  }
+
+  dispatcher_->post([&]() {
+    EXPECT_TRUE(dispatcher_->deferFlush(callback));
+    work_cb->scheduleCallbackCurrentIteration();
+  });
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+}
+
+// Work scheduled after the flush request is still flushed in the same batch.
+TEST_F(DeferredFlushTest, CollectsChainedWork) {
+  MockDeferredFlushCallback first;
+  MockDeferredFlushCallback second;
+  SchedulableCallbackPtr second_cb =
+      dispatcher_->createSchedulableCallback([&]() { dispatcher_->deferFlush(second); });
+  SchedulableCallbackPtr first_cb = dispatcher_->createSchedulableCallback([&]() {
+    dispatcher_->deferFlush(first);
+    second_cb->scheduleCallbackCurrentIteration();
+  });
+  {
+    InSequence s;
+    EXPECT_CALL(first, onDeferredFlush());
+    EXPECT_CALL(second, onDeferredFlush());
+  }
+
+  first_cb->scheduleCallbackCurrentIteration();
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+}
+
+TEST_F(DeferredFlushTest, Cancel) {
+  MockDeferredFlushCallback callback;
+  EXPECT_CALL(callback, onDeferredFlush()).Times(0);
+  EXPECT_TRUE(dispatcher_->deferFlush(callback));
+  dispatcher_->cancelDeferredFlush(callback);
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+}
+
+// A flush callback can cancel a flush that is later in the same batch.
+TEST_F(DeferredFlushTest, CancelDuringFlush) {
+  MockDeferredFlushCallback first;
+  MockDeferredFlushCallback second;
+  EXPECT_CALL(first, onDeferredFlush()).WillOnce([&]() {
+    dispatcher_->cancelDeferredFlush(second);
+  });
+  EXPECT_CALL(second, onDeferredFlush()).Times(0);
+
+  EXPECT_TRUE(dispatcher_->deferFlush(first));
+  EXPECT_TRUE(dispatcher_->deferFlush(second));
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+}
+
+// A flush callback can request another flush, which runs in a later batch.
+TEST_F(DeferredFlushTest, DeferFromFlush) {
+  MockDeferredFlushCallback callback;
+  EXPECT_CALL(callback, onDeferredFlush())
+      .WillOnce([&]() { EXPECT_TRUE(dispatcher_->deferFlush(callback)); })
+      .WillOnce(Return());
+
+  EXPECT_TRUE(dispatcher_->deferFlush(callback));
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+}
+
 class TimerImplTest : public testing::Test {
 protected:
   TimerImplTest() {
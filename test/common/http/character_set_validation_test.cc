@@ -1,3 +1,5 @@
+#include <string>
+
 #include "source/common/http/character_set_validation.h"
 
 #include "gtest/gtest.h"
@@ -33,5 +35,77 @@ TEST(CharacterSetValidationTest, Test) {
   }
 }
 
+class CharacterSetScannerTest : public testing::TestWithParam<CharacterScanImpl> {
+protected:
+  void SetUp() override {
+    if (!CharacterSetScanner::implSupported(GetParam())) {
+      GTEST_SKIP() << "implementation not supported by this CPU";
+    }
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(Impls, CharacterSetScannerTest,
+                         testing::Values(CharacterScanImpl::Scalar, CharacterScanImpl::Sse42,
+                                         CharacterScanImpl::Avx2));
+
+TEST_P(CharacterSetScannerTest, HeaderNames) {
+  constexpr CharacterSetScanner scanner(kGenericHeaderNameCharTable);
+  const std::string long_name(100, 'x');
+  EXPECT_EQ(0U, scanner.findFirstNotInSet("", GetParam()));
+  EXPECT_EQ(12U, scanner.findFirstNotInSet("content-type", GetParam()));
+  EXPECT_EQ(long_name.size(), scanner.findFirstNotInSet(long_name, GetParam()));
+  EXPECT_EQ(long_name.size(), scanner.findFirstInSet(std::string(100, ' '), GetParam()));
+
+  // Place an invalid character at every offset of strings spanning several SIMD blocks and a
+  // tail, including characters with the top bit set.
+  for (const char invalid : {' ', ':', '\0', '\x7f', '\x80', '\xff'}) {
+    for (size_t i = 0; i < long_name.size(); ++i) {
+      std::string name = long_name;
+      name[i] = invalid;
+      EXPECT_EQ(i, scanner.findFirstNotInSet(name, GetParam()));
+      EXPECT_EQ(i, scanner.findFirstNotInSet(name.substr(0, i + 1), GetParam()));
+    }
+  }
+}
+
+TEST_P(CharacterSetScannerTest, MatchesTableLookup) {
+  // Every character in each position of a block, for a table including extended ASCII.
+  constexpr std::array<uint32_t, 8> kCharTable = {
+      0b10000000100000001000000010000000, 0b01000000010000000100000001000000,
+      0b00100000001000000010000000100000, 0b00010000000100000001000000010000,
+      0b00001000000010000000100000001000, 0b00000100000001000000010000000100,
+      0b00000010000000100000001000000010, 0b00000001000000010000000100000001,
+  };
+  constexpr CharacterSetScanner scanner(kCharTable);
+  constexpr char kInSet = '\0';
+  constexpr char kNotInSet = '\x01';
+  ASSERT_TRUE(testCharInTable(kCharTable, kInSet));
+  ASSERT_FALSE(testCharInTable(kCharTable, kNotInSet));
+
+  for (unsigned c = 0; c < 256; ++c) {
+    const bool in_set = testCharInTable(kCharTable, static_cast<char>(c));
+    for (size_t i = 0; i < 48; ++i) {
+      std::string str(48, in_set ? kNotInSet : kInSet);
+      str[i] = static_cast<char>(c);
+      if (in_set) {
+        EXPECT_EQ(i, scanner.findFirstInSet(str, GetParam())) << c;
+      } else {
+        EXPECT_EQ(i, scanner.findFirstNotInSet(str, GetParam())) << c;
+      }
+    }
+  }
+}
+
+TEST(CharacterSetScannerBestImplTest, Supported) {
+  EXPECT_TRUE(CharacterSetScanner::implSupported(CharacterScanImpl::Scalar));
+  EXPECT_TRUE(CharacterSetScanner::implSupported(CharacterSetScanner::bestImpl()));
+
+  constexpr CharacterSetScanner scanner(kGenericHeaderNameCharTable);
+  EXPECT_TRUE(scanner.containsOnly("x-forwarded-for"));
+  EXPECT_FALSE(scanner.containsOnly("x-forwarded-for "));
+  EXPECT_TRUE(scanner.containsAny(" x"));
+  EXPECT_FALSE(scanner.containsAny("  "));
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -4854,5 +4854,39 @@ TEST_F(HttpConnectionManagerImplTest, DecodingWithAddedTrailersByNonTerminalEnco
   decoder_filters_[ecoder_filter_index]->callbacks_->encodeData(fake_response, true);
 }
 
+
+TEST_F(HttpConnectionManagerImplTest, HeaderMapPoolRecyclesStorageAcrossStreams) {
+  header_map_pool_max_blocks_ = 8;
+  setup();
+  setupFilterChain(1, 0, 2);
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_CALL(*decoder_filters_[i], decodeHeaders(_, true))
+        .WillOnce(Return(FilterHeadersStatus::StopIteration));
+    startRequest(true);
+
+    EXPECT_CALL(*decoder_filters_[i], onStreamComplete());
+    EXPECT_CALL(*decoder_filters_[i], onDestroy());
+    EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, deferredDelete_(_));
+    ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+    decoder_filters_[i]->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
+
+    // Destroying the stream returns the storage of its request headers to the pool.
+    filter_callbacks_.connection_.dispatcher_.to_delete_.clear();
+    EXPECT_LT(0U, stats_.named_.downstream_cx_header_pool_blocks_.value());
+    EXPECT_LT(0U, stats_.named_.downstream_cx_header_pool_bytes_.value());
+  }
+
+  // The first request allocated its header storage, the second one reused it.
+  EXPECT_LT(0U, stats_.named_.downstream_cx_header_pool_miss_.value());
+  EXPECT_EQ(stats_.named_.downstream_cx_header_pool_miss_.value(),
+            stats_.named_.downstream_cx_header_pool_hit_.value());
+
+  // Closing the connection frees everything the pool holds.
+  conn_manager_.reset();
+  EXPECT_EQ(0U, stats_.named_.downstream_cx_header_pool_blocks_.value());
+  EXPECT_EQ(0U, stats_.named_.downstream_cx_header_pool_bytes_.value());
+}
+
 } // namespace Http
 } // namespace Envoy
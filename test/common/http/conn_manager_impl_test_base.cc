@@ -142,6 +142,7 @@ public:
   bool addProxyProtocolConnectionState() const override {
     return parent_.addProxyProtocolConnectionState();
   }
+  uint32_t headerMapPoolMaxBlocks() const override { return parent_.headerMapPoolMaxBlocks(); }
 
 private:
   ConnectionManagerConfig& parent_;
@@ -213,6 +213,7 @@ public:
   bool addProxyProtocolConnectionState() const override {
     return add_proxy_protocol_connection_state_;
   }
+  uint32_t headerMapPoolMaxBlocks() const override { return header_map_pool_max_blocks_; }
 
   // Simple helper to wrapper filter to the factory function.
   FilterFactoryCb createDecoderFilterFactoryCb(StreamDecoderFilterSharedPtr filter) {
@@ -320,6 +321,7 @@ public:
   std::vector<Http::OriginalIPDetectionSharedPtr> ip_detection_extensions_{};
   std::vector<Http::EarlyHeaderMutationPtr> early_header_mutations_{};
   bool add_proxy_protocol_connection_state_ = true;
+  uint32_t header_map_pool_max_blocks_ = 0;
 
   const LocalReply::LocalReplyPtr local_reply_;
 
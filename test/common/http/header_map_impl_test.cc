@@ -990,6 +990,58 @@ TEST(HeaderMapImplTest, ClearHeaderMap) {
   EXPECT_TRUE(headers.empty());
 }
 
+// Entries are carved out of blocks owned by the map. Verify they keep their address and order
+// while the map grows past several blocks, and that removed entries are recycled.
+TEST(HeaderMapImplTest, EntryStorageAcrossBlocks) {
+  TestRequestHeaderMapImpl headers;
+  headers.setPath("/");
+  const HeaderEntry* path = headers.Path();
+  headers.addCopy(LowerCaseString("first"), "1");
+  const HeaderEntry* first = headers.get(LowerCaseString("first"))[0];
+
+  std::vector<std::string> expected_keys = {":path", "first"};
+  for (int i = 0; i < 200; ++i) {
+    const std::string key = absl::StrCat("key-", i);
+    headers.addCopy(LowerCaseString(key), absl::StrCat(i));
+    expected_keys.push_back(key);
+  }
+  EXPECT_EQ(path, headers.Path());
+  EXPECT_EQ("/", path->value().getStringView());
+  EXPECT_EQ(first, headers.get(LowerCaseString("first"))[0]);
+
+  // Remove every other header, then add the same number back. The new headers go at the end.
+  headers.removeIf([](const HeaderEntry& entry) {
+    return absl::StartsWith(entry.key().getStringView(), "key-") &&
+           entry.value().getStringView().back() % 2 == 0;
+  });
+  expected_keys.erase(std::remove_if(expected_keys.begin(), expected_keys.end(),
+                                     [](const std::string& key) {
+                                       return absl::StartsWith(key, "key-") && key.back() % 2 == 0;
+                                     }),
+                      expected_keys.end());
+  for (int i = 0; i < 100; ++i) {
+    const std::string key = absl::StrCat("new-", i);
+    headers.addCopy(LowerCaseString(key), "v");
+    expected_keys.push_back(key);
+  }
+
+  std::vector<std::string> keys;
+  headers.iterate([&keys](const HeaderEntry& header) -> HeaderMap::Iterate {
+    keys.emplace_back(header.key().getStringView());
+    return HeaderMap::Iterate::Continue;
+  });
+  EXPECT_EQ(expected_keys, keys);
+  EXPECT_EQ(path, headers.Path());
+
+  // The map is usable after being cleared, with its storage retained.
+  headers.clear();
+  EXPECT_TRUE(headers.empty());
+  headers.setPath("/again");
+  headers.addCopy(LowerCaseString("first"), "1");
+  EXPECT_EQ("/again", headers.getPathValue());
+  EXPECT_EQ(2UL, headers.size());
+}
+
 // Validates byte size is properly accounted for in different inline header setting scenarios.
 TEST(HeaderMapImplTest, InlineHeaderByteSize) {
   {
@@ -0,0 +1,173 @@
+#include "source/common/http/header_map_impl.h"
+#include "source/common/http/header_map_pool.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class HeaderMapPoolTest : public testing::Test {
+protected:
+  HeaderMapPoolTest()
+      : hits_(store_.counterFromString("hits")), misses_(store_.counterFromString("misses")),
+        blocks_(store_.gaugeFromString("blocks", Stats::Gauge::ImportMode::Accumulate)),
+        bytes_(store_.gaugeFromString("bytes", Stats::Gauge::ImportMode::Accumulate)) {}
+
+  void createPool(uint32_t max_blocks) {
+    pool_ = std::make_shared<HeaderMapPool>(max_blocks, hits_, misses_, blocks_, bytes_);
+  }
+
+  // Returns a request header map with `num_headers` entries, which take 3 blocks for 20 entries.
+  static RequestHeaderMapPtr makeHeaders(uint32_t num_headers) {
+    RequestHeaderMapPtr headers = RequestHeaderMapImpl::create();
+    for (uint32_t i = 0; i < num_headers; ++i) {
+      headers->addCopy(LowerCaseString(absl::StrCat("x-header-", i)), "value");
+    }
+    return headers;
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  Stats::Counter& hits_;
+  Stats::Counter& misses_;
+  Stats::Gauge& blocks_;
+  Stats::Gauge& bytes_;
+  HeaderMapPoolSharedPtr pool_;
+};
+
+TEST_F(HeaderMapPoolTest, NoActivePoolByDefault) {
+  createPool(8);
+  EXPECT_EQ(nullptr, HeaderMapPool::active());
+
+  makeHeaders(20).reset();
+  EXPECT_EQ(0U, misses_.value());
+  EXPECT_EQ(0U, pool_->size());
+}
+
+TEST_F(HeaderMapPoolTest, ScopesNest) {
+  createPool(8);
+  auto other = std::make_shared<HeaderMapPool>(8, hits_, misses_, blocks_, bytes_);
+  {
+    HeaderMapPool::ActiveScope scope(pool_.get());
+    EXPECT_EQ(pool_, HeaderMapPool::active());
+    {
+      HeaderMapPool::ActiveScope inner_scope(other.get());
+      EXPECT_EQ(other, HeaderMapPool::active());
+      {
+        HeaderMapPool::ActiveScope disabled_scope(nullptr);
+        EXPECT_EQ(nullptr, HeaderMapPool::active());
+      }
+      EXPECT_EQ(other, HeaderMapPool::active());
+    }
+    EXPECT_EQ(pool_, HeaderMapPool::active());
+  }
+  EXPECT_EQ(nullptr, HeaderMapPool::active());
+}
+
+TEST_F(HeaderMapPoolTest, ReusesBlocksAcrossMaps) {
+  createPool(8);
+
+  RequestHeaderMapPtr headers;
+  {
+    HeaderMapPool::ActiveScope scope(pool_.get());
+    headers = makeHeaders(20);
+  }
+  EXPECT_EQ(3U, misses_.value());
+  EXPECT_EQ(0U, hits_.value());
+
+  // Blocks go back to the pool even though the pool is no longer active.
+  headers.reset();
+  EXPECT_EQ(3U, pool_->size());
+  EXPECT_EQ(3U, blocks_.value());
+  EXPECT_LT(0U, bytes_.value());
+
+  {
+    HeaderMapPool::ActiveScope scope(pool_.get());
+    headers = makeHeaders(20);
+  }
+  EXPECT_EQ(3U, misses_.value());
+  EXPECT_EQ(3U, hits_.value());
+  EXPECT_EQ(0U, pool_->size());
+  EXPECT_EQ(0U, blocks_.value());
+  EXPECT_EQ(0U, bytes_.value());
+
+  // Entries that are removed and re-added keep using the same storage.
+  headers->remove(LowerCaseString("x-header-0"));
+  headers->addCopy(LowerCaseString("x-header-0"), "value");
+  EXPECT_EQ(3U, misses_.value());
+}
+
+TEST_F(HeaderMapPoolTest, MapsStartedOutsideScopeUseHeap) {
+  createPool(8);
+
+  RequestHeaderMapPtr headers = makeHeaders(2);
+  {
+    HeaderMapPool::ActiveScope scope(pool_.get());
+    // The map already has a block from the heap, so later blocks come from the heap too.
+    for (uint32_t i = 0; i < 20; ++i) {
+      headers->addCopy(LowerCaseString(absl::StrCat("x-more-", i)), "value");
+    }
+  }
+  headers.reset();
+  EXPECT_EQ(0U, misses_.value());
+  EXPECT_EQ(0U, pool_->size());
+}
+
+TEST_F(HeaderMapPoolTest, BoundedByMaxBlocks) {
+  createPool(2);
+
+  RequestHeaderMapPtr headers;
+  {
+    HeaderMapPool::ActiveScope scope(pool_.get());
+    headers = makeHeaders(20);
+  }
+  headers.reset();
+  EXPECT_EQ(2U, pool_->size());
+  EXPECT_EQ(2U, blocks_.value());
+}
+
+TEST_F(HeaderMapPoolTest, DrainFreesBlocksAndStopsPooling) {
+  createPool(8);
+
+  RequestHeaderMapPtr first;
+  RequestHeaderMapPtr second;
+  {
+    HeaderMapPool::ActiveScope scope(pool_.get());
+    first = makeHeaders(20);
+    second = makeHeaders(20);
+  }
+  first.reset();
+  EXPECT_EQ(3U, blocks_.value());
+
+  pool_->drain();
+  EXPECT_EQ(0U, pool_->size());
+  EXPECT_EQ(0U, blocks_.value());
+  EXPECT_EQ(0U, bytes_.value());
+
+  // The map keeps the pool alive; its blocks are freed rather than cached.
+  pool_.reset();
+  second.reset();
+}
+
+TEST_F(HeaderMapPoolTest, ReleaseOnOtherThreadUsesHeap) {
+  createPool(8);
+
+  RequestHeaderMapPtr headers;
+  {
+    HeaderMapPool::ActiveScope scope(pool_.get());
+    headers = makeHeaders(20);
+  }
+  Thread::ThreadPtr thread =
+      Thread::threadFactoryForTest().createThread([&headers]() { headers.reset(); });
+  thread->join();
+  EXPECT_EQ(0U, pool_->size());
+  EXPECT_EQ(0U, blocks_.value());
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
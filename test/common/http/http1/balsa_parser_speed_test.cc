@@ -0,0 +1,119 @@
+// Measures HTTP/1 request-line and header parsing throughput of BalsaParser, and the character set
+// scans it relies on with each scanner implementation.
+
+#include <string>
+
+#include "source/common/http/character_set_validation.h"
+#include "source/common/http/http1/balsa_parser.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+class NullParserCallbacks : public ParserCallbacks {
+public:
+  CallbackResult onMessageBegin() override { return CallbackResult::Success; }
+  CallbackResult onUrl(const char*, size_t) override { return CallbackResult::Success; }
+  CallbackResult onStatus(const char*, size_t) override { return CallbackResult::Success; }
+  CallbackResult onHeaderField(const char*, size_t) override { return CallbackResult::Success; }
+  CallbackResult onHeaderValue(const char*, size_t) override { return CallbackResult::Success; }
+  CallbackResult onHeadersComplete() override { return CallbackResult::Success; }
+  void bufferBody(const char*, size_t) override {}
+  CallbackResult onMessageComplete() override {
+    ++messages_;
+    return CallbackResult::Success;
+  }
+  void onChunkHeader(bool) override {}
+
+  uint64_t messages_{};
+};
+
+enum class HeaderSet {
+  // A browser-like request.
+  Typical,
+  // Hundreds of tiny headers.
+  ManyHeaders,
+  // A few headers with values of several kilobytes.
+  LongValues,
+  // Long header names and a long URL.
+  LongNamesAndUrl,
+};
+
+std::string makeRequest(HeaderSet header_set) {
+  switch (header_set) {
+  case HeaderSet::Typical:
+    return "GET /api/v1/users/12345/profile?fields=name,email&locale=en-US HTTP/1.1\r\n"
+           "Host: www.example.com\r\n"
+           "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+           "Chrome/120.0.0.0 Safari/537.36\r\n"
+           "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+           "Accept-Language: en-US,en;q=0.5\r\n"
+           "Accept-Encoding: gzip, deflate, br\r\n"
+           "Cookie: session=8f14e45fceea167a5a36dedd4bea2543; theme=dark; tz=Europe%2FBerlin\r\n"
+           "X-Request-Id: 5d41402a-bc4b-2a76-b971-9d911017c592\r\n"
+           "Connection: keep-alive\r\n"
+           "\r\n";
+  case HeaderSet::ManyHeaders: {
+    std::string request = "GET / HTTP/1.1\r\nHost: a\r\n";
+    for (int i = 0; i < 500; ++i) {
+      absl::StrAppend(&request, "x", i, ": y\r\n");
+    }
+    return absl::StrCat(request, "\r\n");
+  }
+  case HeaderSet::LongValues:
+    return absl::StrCat("GET / HTTP/1.1\r\nHost: a\r\n", "Cookie: ", std::string(8192, 'c'),
+                        "\r\n", "Authorization: Bearer ", std::string(4096, 't'), "\r\n",
+                        "X-Trace: ", std::string(16384, 'v'), "\r\n\r\n");
+  case HeaderSet::LongNamesAndUrl: {
+    std::string request = absl::StrCat("GET /", std::string(4096, 'p'), "?",
+                                       std::string(4096, 'q'), " HTTP/1.1\r\nHost: a\r\n");
+    for (int i = 0; i < 16; ++i) {
+      absl::StrAppend(&request, "x-", std::string(256, 'n'), "-", i, ": v\r\n");
+    }
+    return absl::StrCat(request, "\r\n");
+  }
+  }
+  return "";
+}
+
+// Benchmark args: header set.
+void bmParseRequestHeaders(benchmark::State& state) {
+  const std::string request = makeRequest(static_cast<HeaderSet>(state.range(0)));
+  NullParserCallbacks callbacks;
+  BalsaParser parser(MessageType::Request, &callbacks, 96 * 1024, false, false);
+
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    parser.execute(request.data(), request.size());
+  }
+  if (parser.getStatus() != ParserStatus::Ok || callbacks.messages_ != state.iterations()) {
+    state.SkipWithError("request failed to parse");
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+BENCHMARK(bmParseRequestHeaders)->DenseRange(0, 3);
+
+// Benchmark args: scanner implementation, string length.
+void bmScanHeaderName(benchmark::State& state) {
+  const auto impl = static_cast<CharacterScanImpl>(state.range(0));
+  if (!CharacterSetScanner::implSupported(impl)) {
+    state.SkipWithError("implementation not supported by this CPU");
+    return;
+  }
+  constexpr CharacterSetScanner scanner(kGenericHeaderNameCharTable);
+  const std::string name(state.range(1), 'n');
+
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    benchmark::DoNotOptimize(scanner.findFirstNotInSet(name, impl));
+  }
+  state.SetBytesProcessed(state.iterations() * name.size());
+}
+BENCHMARK(bmScanHeaderName)->ArgsProduct({{0, 1, 2}, {8, 32, 256, 16384}});
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
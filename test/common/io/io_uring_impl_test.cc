@@ -401,6 +401,95 @@ TEST_F(IoUringImplTest, PrepareReadvQueueOverflow) {
   EXPECT_EQ(static_cast<char*>(iov3.iov_base)[1], 'f');
 }
 
+TEST_F(IoUringImplTest, PrepareReadvRegisteredFile) {
+  if (!io_uring_->setupRegisteredFiles(4)) {
+    GTEST_SKIP() << "registered files are not supported";
+  }
+  std::string test_file =
+      TestEnvironment::writeStringToFileForTest("prepare_readv_registered", "test text", true);
+  os_fd_t fd = open(test_file.c_str(), O_RDONLY);
+  ASSERT_TRUE(fd >= 0);
+  ASSERT_TRUE(io_uring_->registerFile(fd));
+
+  auto dispatcher = api_->allocateDispatcher("test_thread");
+  uint8_t buffer[4096]{};
+  struct iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = 4096;
+
+  os_fd_t event_fd = io_uring_->registerEventfd();
+  int32_t completions_nr = 0;
+  auto file_event = dispatcher->createFileEvent(
+      event_fd,
+      [this, &completions_nr](uint32_t) {
+        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, bool) {
+          completions_nr++;
+          EXPECT_EQ(res, strlen("test text"));
+        });
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  io_uring_->prepareReadv(fd, &iov, 1, 0, nullptr);
+  io_uring_->submit();
+  waitForCondition(*dispatcher, [&completions_nr]() { return completions_nr == 1; });
+  EXPECT_STREQ(static_cast<char*>(iov.iov_base), "test text");
+
+  io_uring_->unregisterFile(fd);
+  // Unregistering twice is a no-op.
+  io_uring_->unregisterFile(fd);
+  close(fd);
+}
+
+TEST_F(IoUringImplTest, PrepareRecvMultishot) {
+  if (!io_uring_->setupProvidedBuffers(4, 16)) {
+    GTEST_SKIP() << "multishot recv is not supported";
+  }
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+  auto dispatcher = api_->allocateDispatcher("test_thread");
+  os_fd_t event_fd = io_uring_->registerEventfd();
+  std::vector<std::string> received;
+  std::vector<uint32_t> completion_flags;
+  auto file_event = dispatcher->createFileEvent(
+      event_fd,
+      [this, &received, &completion_flags](uint32_t) {
+        io_uring_->forEveryCompletion(
+            [this, &received, &completion_flags](Request* user_data, int32_t res, bool) {
+              const uint32_t flags = user_data->completionFlags();
+              completion_flags.push_back(flags);
+              if (res > 0) {
+                received.emplace_back(io_uring_->providedBuffer(flags, res));
+                io_uring_->recycleProvidedBuffer(flags);
+              }
+            });
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  int data = 0;
+  TestRequest request(data);
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareRecvMultishot(fds[0], &request));
+  io_uring_->submit();
+
+  // Every chunk of data is delivered by the same request, which stays armed.
+  for (absl::string_view chunk : {"hello", "world"}) {
+    ASSERT_EQ(static_cast<ssize_t>(chunk.size()), write(fds[1], chunk.data(), chunk.size()));
+    const size_t expected = received.size() + 1;
+    waitForCondition(*dispatcher, [&received, expected]() { return received.size() == expected; });
+    EXPECT_EQ(chunk, received.back());
+    EXPECT_TRUE(completion_flags.back() & IORING_CQE_F_MORE);
+    EXPECT_TRUE(completion_flags.back() & IORING_CQE_F_BUFFER);
+  }
+
+  // The remote close terminates the request.
+  close(fds[1]);
+  waitForCondition(*dispatcher, [&completion_flags]() { return completion_flags.size() == 3; });
+  EXPECT_FALSE(completion_flags.back() & IORING_CQE_F_MORE);
+  close(fds[0]);
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
@@ -0,0 +1,85 @@
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "source/common/io/io_uring_impl.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Io {
+
+// Runs the lifetime of a connection, which submits state.range(0) pairs of writes and reads. With
+// state.range(1) set, the connection registers its file descriptors before the first request and
+// unregisters them after the last one, so the results show how many requests a socket has to submit
+// before registering it pays off.
+static void ioUringSocketLifetime(benchmark::State& state) {
+  if (!isIoUringSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  const int64_t requests = state.range(0);
+  const bool registered = state.range(1) != 0;
+  IoUringImpl io_uring(64, false);
+  if (!io_uring.setupRegisteredFiles(2)) {
+    state.SkipWithError("registered files are not supported");
+    return;
+  }
+  io_uring.registerEventfd();
+
+  // The file table is only reference counted once it is shared by several threads, as it is in
+  // Envoy.
+  absl::Notification done;
+  Thread::ThreadPtr idle_thread =
+      Thread::threadFactoryForTest().createThread([&done]() { done.WaitForNotification(); });
+
+  int fds[2];
+  RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+  uint8_t write_data[64]{};
+  uint8_t read_data[64];
+  struct iovec write_iov {
+    write_data, sizeof(write_data)
+  };
+  struct iovec read_iov {
+    read_data, sizeof(read_data)
+  };
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    if (registered) {
+      io_uring.registerFile(fds[0]);
+      io_uring.registerFile(fds[1]);
+    }
+    for (int64_t i = 0; i < requests; i++) {
+      io_uring.prepareWritev(fds[0], &write_iov, 1, 0, nullptr);
+      io_uring.prepareReadv(fds[1], &read_iov, 1, 0, nullptr);
+      io_uring.submit();
+      uint32_t completions = 0;
+      while (completions < 2) {
+        io_uring.forEveryCompletion([&completions](Request*, int32_t result, bool) {
+          RELEASE_ASSERT(result == sizeof(write_data), "");
+          completions++;
+        });
+      }
+    }
+    if (registered) {
+      io_uring.unregisterFile(fds[0]);
+      io_uring.unregisterFile(fds[1]);
+    }
+  }
+
+  done.Notify();
+  idle_thread->join();
+  io_uring.unregisterEventfd();
+  close(fds[0]);
+  close(fds[1]);
+}
+
+BENCHMARK(ioUringSocketLifetime)
+    ->ArgsProduct({{1, 4, 16, 32, 64, 256}, {0, 1}})
+    ->ArgNames({"requests", "registered"});
+
+} // namespace Io
+} // namespace Envoy
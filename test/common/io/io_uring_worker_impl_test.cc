@@ -34,8 +34,9 @@ public:
 
 class IoUringWorkerTestImpl : public IoUringWorkerImpl {
 public:
-  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher)
-      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, dispatcher) {}
+  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher,
+                        const IoUringOptions& options = {})
+      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, dispatcher, options) {}
 
   IoUringSocket& addTestSocket(os_fd_t fd) {
     return addSocket(std::make_unique<IoUringSocketTestImpl>(fd, *this));
@@ -699,6 +700,376 @@ TEST(IoUringWorkerImplTest, NoEnableReadOnConnectError) {
   delete static_cast<Request*>(connect_req);
 }
 
+TEST(IoUringWorkerImplTest, RegisteredFiles) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, setupRegisteredFiles(64)).WillOnce(Return(true));
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  IoUringOptions options;
+  options.registered_files_ = 64;
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, options);
+  EXPECT_CALL(mock_io_uring, prepareReadv(5, _, _, _, _))
+      .WillRepeatedly(Return<IoUringResult>(IoUringResult::Ok));
+  EXPECT_CALL(mock_io_uring, submit()).Times(testing::AnyNumber());
+
+  // A socket is only registered once it has submitted enough requests to pay for it.
+  EXPECT_CALL(mock_io_uring, registerFile(_)).Times(0);
+  auto& socket = dynamic_cast<IoUringSocketTestImpl&>(worker.addTestSocket(5));
+  for (uint32_t i = 1; i < IoUringWorkerImpl::RegisterFileAfterRequests; i++) {
+    delete worker.submitReadRequest(socket);
+  }
+  EXPECT_CALL(mock_io_uring, registerFile(5)).WillOnce(Return(true));
+  delete worker.submitReadRequest(socket);
+  delete worker.submitReadRequest(socket);
+
+  // Closing the socket releases the slot right away, before the fd is closed by its owner.
+  EXPECT_CALL(mock_io_uring, unregisterFile(5));
+  socket.close(true);
+
+  // A new socket reusing the fd number takes a slot while the closed one is not removed yet.
+  auto& new_socket = dynamic_cast<IoUringSocketTestImpl&>(worker.addTestSocket(5));
+  EXPECT_CALL(mock_io_uring, registerFile(5)).WillOnce(Return(true));
+  for (uint32_t i = 0; i < IoUringWorkerImpl::RegisterFileAfterRequests; i++) {
+    delete worker.submitReadRequest(new_socket);
+  }
+
+  // Removing the closed socket leaves the slot of the new socket alone.
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(5));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  socket.cleanupForTest();
+
+  EXPECT_CALL(mock_io_uring, unregisterFile(5));
+  new_socket.close(false);
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(5));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  new_socket.cleanupForTest();
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+}
+
+TEST(IoUringWorkerImplTest, RegisteredFilesListenerFdReuse) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, isFeatureSupported(IoUringFeature::MultishotAccept))
+      .WillOnce(Return(true));
+  EXPECT_CALL(mock_io_uring, setupRegisteredFiles(64)).WillOnce(Return(true));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringOptions options;
+  options.multishot_accept_ = true;
+  options.registered_files_ = 64;
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, options);
+  Request* accept_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareAcceptMultishot(7, _))
+      .WillRepeatedly(DoAll(SaveArg<1>(&accept_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(testing::AnyNumber());
+
+  // The listener is registered once it has armed enough accept requests, each failed accept
+  // terminating the previous one.
+  OptRef<IoUringSocket> listener =
+      worker.addAcceptSocket(7, [](uint32_t) { return absl::OkStatus(); });
+  ASSERT_TRUE(listener.has_value());
+  EXPECT_CALL(mock_io_uring, registerFile(7)).WillOnce(Return(true));
+  for (uint32_t i = 1; i < IoUringWorkerImpl::RegisterFileAfterRequests; i++) {
+    Request* failed_req = accept_req;
+    listener->onAccept(failed_req, -EMFILE, false);
+    delete failed_req;
+  }
+
+  // Closing the listener releases the slot before the IoHandle closes the fd, while the accept
+  // request is still being canceled.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(accept_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, unregisterFile(7));
+  listener->close(true);
+  Request* closed_accept_req = accept_req;
+
+  // A new listener reusing the fd number registers it again without a conflict.
+  OptRef<IoUringSocket> new_listener =
+      worker.addAcceptSocket(7, [](uint32_t) { return absl::OkStatus(); });
+  ASSERT_TRUE(new_listener.has_value());
+  EXPECT_CALL(mock_io_uring, registerFile(7)).WillOnce(Return(true));
+  for (uint32_t i = 1; i < IoUringWorkerImpl::RegisterFileAfterRequests; i++) {
+    Request* failed_req = accept_req;
+    new_listener->onAccept(failed_req, -EMFILE, false);
+    delete failed_req;
+  }
+
+  // The cancellation of the closed listener completes late and leaves the new slot alone.
+  listener->onCancel(cancel_req, 0, false);
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(7));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  listener->onAccept(closed_accept_req, -ECANCELED, false);
+  delete closed_accept_req;
+  delete cancel_req;
+  EXPECT_EQ(1, worker.getNumOfSockets());
+
+  EXPECT_CALL(mock_io_uring, prepareCancel(accept_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, unregisterFile(7));
+  new_listener->close(true);
+  new_listener->onCancel(cancel_req, 0, false);
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(7));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  new_listener->onAccept(accept_req, -ECANCELED, false);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete accept_req;
+  delete cancel_req;
+}
+
+TEST(IoUringWorkerImplTest, MultishotRecv) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, setupProvidedBuffers(16, 8192)).WillOnce(Return(true));
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  IoUringOptions options;
+  options.provided_buffers_ = 16;
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, options);
+
+  // A read enabled socket reads with a multishot recv request.
+  Request* recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvMultishot(0, _))
+      .WillOnce(DoAll(SaveArg<1>(&recv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  IoUringSocket* socket_ptr = nullptr;
+  std::string received;
+  auto& socket = worker.addServerSocket(
+      0,
+      [&socket_ptr, &received](uint32_t events) {
+        EXPECT_EQ(events, Event::FileReadyType::Read);
+        Buffer::Instance& buf = socket_ptr->getReadParam()->buf_;
+        received.append(buf.toString());
+        buf.drain(buf.length());
+        return absl::OkStatus();
+      },
+      false);
+  socket_ptr = &socket;
+
+  // The data is copied out of the provided buffer, which is recycled right away, and the request
+  // stays armed.
+  const uint32_t data_flags =
+      IORING_CQE_F_MORE | IORING_CQE_F_BUFFER | (3 << IORING_CQE_BUFFER_SHIFT);
+  EXPECT_CALL(mock_io_uring, providedBuffer(data_flags, 5)).WillOnce(Return("hello"));
+  EXPECT_CALL(mock_io_uring, recycleProvidedBuffer(data_flags));
+  EXPECT_CALL(mock_io_uring, prepareRecvMultishot(_, _)).Times(0);
+  EXPECT_CALL(mock_io_uring, prepareReadv(_, _, _, _, _)).Times(0);
+  recv_req->setCompletionFlags(data_flags);
+  socket.onRead(recv_req, 5, false);
+  EXPECT_EQ("hello", received);
+
+  // Disabling read cancels the multishot recv request.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(recv_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.disableRead();
+  socket.onCancel(cancel_req, 0, false);
+
+  // Once the multishot recv request is done, a regular read request watches for the remote close.
+  Request* read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadv(0, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&read_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  recv_req->setCompletionFlags(0);
+  socket.onRead(recv_req, -ECANCELED, false);
+
+  // Close the socket, but keep the fd open.
+  Request* close_cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(read_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&close_cancel_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.close(true);
+  socket.onCancel(close_cancel_req, 0, false);
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(0));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  socket.onRead(read_req, -ECANCELED, false);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete recv_req;
+  delete cancel_req;
+  delete read_req;
+  delete close_cancel_req;
+}
+
+TEST(IoUringWorkerImplTest, ZeroCopySend) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, isFeatureSupported(IoUringFeature::ZeroCopySend))
+      .WillOnce(Return(true));
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  IoUringOptions options;
+  options.zero_copy_send_threshold_ = 8;
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, options);
+
+  Request* read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadv(0, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&read_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  auto& socket = worker.addServerSocket(
+      0, [](uint32_t) { return absl::OkStatus(); }, false);
+
+  // A write of at least the threshold is sent with zero copy send.
+  Request* send_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareSendmsgZc(0, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&send_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  Buffer::OwnedImpl large_data("0123456789abcdef");
+  socket.write(large_data);
+
+  // The first completion doesn't release the data, so nothing else is written yet.
+  EXPECT_CALL(mock_io_uring, prepareSendmsgZc(_, _, _)).Times(0);
+  EXPECT_CALL(mock_io_uring, prepareWritev(_, _, _, _, _)).Times(0);
+  send_req->setCompletionFlags(IORING_CQE_F_MORE);
+  socket.onWrite(send_req, 16, false);
+  Buffer::OwnedImpl small_data("tail");
+  socket.write(small_data);
+
+  // The notification releases the sent data. The remainder is below the threshold and is written
+  // with a regular write request.
+  Request* write_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareWritev(0, _, 1, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&write_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  send_req->setCompletionFlags(IORING_CQE_F_NOTIF);
+  socket.onWrite(send_req, 0, false);
+  socket.onWrite(write_req, 4, false);
+
+  // Close the socket, but keep the fd open.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(read_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.close(true);
+  socket.onCancel(cancel_req, 0, false);
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(0));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  socket.onRead(read_req, -ECANCELED, false);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete read_req;
+  delete send_req;
+  delete write_req;
+  delete cancel_req;
+}
+
+TEST(IoUringWorkerImplTest, MultishotAccept) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, isFeatureSupported(IoUringFeature::MultishotAccept))
+      .WillOnce(Return(true));
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringOptions options;
+  options.multishot_accept_ = true;
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, options);
+
+  Request* accept_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareAcceptMultishot(0, _))
+      .WillOnce(DoAll(SaveArg<1>(&accept_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  IoUringSocket* socket_ptr = nullptr;
+  std::vector<os_fd_t> accepted;
+  bool take_fd = true;
+  OptRef<IoUringSocket> socket =
+      worker.addAcceptSocket(0, [&socket_ptr, &accepted, &take_fd](uint32_t events) {
+        EXPECT_EQ(events, Event::FileReadyType::Read);
+        if (take_fd) {
+          accepted.push_back(socket_ptr->takeAcceptedFd());
+        }
+        return absl::OkStatus();
+      });
+  ASSERT_TRUE(socket.has_value());
+  socket_ptr = socket.ptr();
+
+  // Accepted connections are queued while the request stays armed.
+  accept_req->setCompletionFlags(IORING_CQE_F_MORE);
+  socket->onAccept(accept_req, 42, false);
+  socket->onAccept(accept_req, 43, false);
+  EXPECT_THAT(accepted, testing::ElementsAre(42, 43));
+
+  // The listener leaves a connection behind, so the event fires again.
+  take_fd = false;
+  Request* injected_req = nullptr;
+  EXPECT_CALL(mock_io_uring, injectCompletion(0, _, -EAGAIN)).WillOnce(SaveArg<1>(&injected_req));
+  socket->onAccept(accept_req, 44, false);
+  ASSERT_NE(nullptr, injected_req);
+  take_fd = true;
+  socket->onAccept(injected_req, -EAGAIN, true);
+  delete injected_req;
+  EXPECT_THAT(accepted, testing::ElementsAre(42, 43, 44));
+  EXPECT_EQ(INVALID_SOCKET, socket->takeAcceptedFd());
+
+  // Disabling the listener cancels the request, and enabling it arms a new one.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(accept_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket->disableRead();
+  socket->onCancel(cancel_req, 0, false);
+  accept_req->setCompletionFlags(0);
+  socket->onAccept(accept_req, -ECANCELED, false);
+  delete accept_req;
+  delete cancel_req;
+
+  EXPECT_CALL(mock_io_uring, prepareAcceptMultishot(0, _))
+      .WillOnce(DoAll(SaveArg<1>(&accept_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket->enableRead();
+
+  // Closing cancels the request and leaves the listening fd open.
+  EXPECT_CALL(mock_io_uring, prepareCancel(accept_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, prepareClose(_, _)).Times(0);
+  socket->close(true);
+  socket->onCancel(cancel_req, 0, false);
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(0));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  accept_req->setCompletionFlags(0);
+  socket->onAccept(accept_req, -ECANCELED, false);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete accept_req;
+  delete cancel_req;
+}
+
+TEST(IoUringWorkerImplTest, MultishotAcceptDisabled) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(mock_io_uring, isFeatureSupported(IoUringFeature::MultishotAccept))
+      .WillOnce(Return(false));
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  IoUringOptions options;
+  options.multishot_accept_ = true;
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, options);
+
+  // The kernel does not support multishot accept, so the caller accepts through the event loop.
+  EXPECT_FALSE(worker.addAcceptSocket(0, [](uint32_t) { return absl::OkStatus(); }).has_value());
+  EXPECT_EQ(0, worker.getNumOfSockets());
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
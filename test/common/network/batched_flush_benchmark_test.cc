@@ -0,0 +1,135 @@
+// Measures socket writes per request with and without batched dispatcher flushes
+// (envoy.restart_features.dispatcher_batch_flushes). Each request is answered by several small
+// writes issued from chained callbacks within one event loop iteration, as happens when filters or
+// multiplexed streams respond asynchronously.
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <vector>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/connection_impl.h"
+#include "source/common/network/connection_socket_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/raw_buffer_socket.h"
+#include "source/common/network/utility.h"
+#include "source/common/runtime/runtime_features.h"
+#include "source/common/stream_info/stream_info_impl.h"
+
+#include "test/test_common/threadsafe_singleton_injector.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class CountingOsSysCalls : public Api::OsSysCallsImpl {
+public:
+  Api::SysCallSizeResult writev(os_fd_t fd, const iovec* iov, int num_iov) override {
+    ++writes_;
+    return Api::OsSysCallsImpl::writev(fd, iov, num_iov);
+  }
+
+  uint64_t writes_{};
+};
+
+class BatchedFlushFixture {
+public:
+  BatchedFlushFixture(bool batch_flushes, uint32_t num_connections) {
+    Runtime::maybeSetRuntimeGuard("envoy.restart_features.dispatcher_batch_flushes",
+                                  batch_flushes);
+    api_ = Api::createApiForTest();
+    dispatcher_ = api_->allocateDispatcher("bench");
+    stream_info_ = std::make_unique<StreamInfo::StreamInfoImpl>(
+        dispatcher_->timeSource(), nullptr, StreamInfo::FilterState::LifeSpan::Connection);
+    const auto address = Utility::getCanonicalIpv4LoopbackAddress();
+    for (uint32_t i = 0; i < num_connections; i++) {
+      int fds[2];
+      RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+      auto socket = std::make_unique<ConnectionSocketImpl>(
+          std::make_unique<IoSocketHandleImpl>(fds[0]), address, address);
+      connections_.push_back(dispatcher_->createServerConnection(
+          std::move(socket), std::make_unique<RawBufferSocket>(), *stream_info_));
+      peers_.push_back(fds[1]);
+    }
+  }
+
+  ~BatchedFlushFixture() {
+    for (auto& connection : connections_) {
+      connection->close(ConnectionCloseType::NoFlush);
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    for (int fd : peers_) {
+      ::close(fd);
+    }
+    Runtime::maybeSetRuntimeGuard("envoy.restart_features.dispatcher_batch_flushes", false);
+  }
+
+  // Sends one response of `writes_per_request` chunks on every connection and runs the loop once.
+  // Each chunk is written by its own callback, and each callback schedules the next one, so later
+  // writes are queued behind the write events activated by earlier ones.
+  void respond(uint32_t writes_per_request) {
+    std::vector<Event::SchedulableCallbackPtr> callbacks(connections_.size() * writes_per_request);
+    for (size_t i = callbacks.size(); i-- > 0;) {
+      ServerConnection* connection = connections_[i % connections_.size()].get();
+      Event::SchedulableCallback* next =
+          i + 1 < callbacks.size() ? callbacks[i + 1].get() : nullptr;
+      callbacks[i] = dispatcher_->createSchedulableCallback([connection, next]() {
+        Buffer::OwnedImpl chunk("0123456789abcdef");
+        connection->write(chunk, false);
+        if (next != nullptr) {
+          next->scheduleCallbackCurrentIteration();
+        }
+      });
+    }
+    callbacks.front()->scheduleCallbackCurrentIteration();
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    drainPeers();
+  }
+
+private:
+  void drainPeers() {
+    char buf[16384];
+    for (int fd : peers_) {
+      while (::read(fd, buf, sizeof(buf)) > 0) {
+      }
+    }
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::unique_ptr<StreamInfo::StreamInfoImpl> stream_info_;
+  std::vector<ServerConnectionPtr> connections_;
+  std::vector<int> peers_;
+};
+
+// Benchmark args: batch flushes (0/1), connections, writes per request.
+static void bmConnectionWrites(benchmark::State& state) {
+  const bool batch_flushes = state.range(0) != 0;
+  const uint32_t num_connections = state.range(1);
+  const uint32_t writes_per_request = state.range(2);
+
+  CountingOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  BatchedFlushFixture fixture(batch_flushes, num_connections);
+
+  uint64_t requests = 0;
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    fixture.respond(writes_per_request);
+    requests += num_connections;
+  }
+  state.counters["writev_per_request"] =
+      benchmark::Counter(static_cast<double>(os_sys_calls.writes_) / requests);
+}
+BENCHMARK(bmConnectionWrites)
+    ->ArgsProduct({{0, 1}, {1, 64}, {1, 4, 16}})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -1678,6 +1678,39 @@ TEST_P(ConnectionImplTest, BasicWrite) {
   disconnect(true);
 }
 
+// With batched flushes, writes issued by different callbacks in the same event loop iteration are
+// written to the socket together.
+TEST_P(ConnectionImplTest, BatchedFlushWrite) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.restart_features.dispatcher_batch_flushes", "true"}});
+  useMockBuffer();
+
+  setUpBasicConnection();
+
+  connect();
+
+  std::string data_written;
+  EXPECT_CALL(*client_write_buffer_, move(_))
+      .WillRepeatedly(DoAll(AddBufferToStringWithoutDraining(&data_written),
+                            Invoke(client_write_buffer_, &MockWatermarkBuffer::baseMove)));
+  // Both writes go out in a single flush.
+  EXPECT_CALL(*client_write_buffer_, drain(_))
+      .WillOnce(Invoke(client_write_buffer_, &MockWatermarkBuffer::trackDrains));
+  Event::SchedulableCallbackPtr second_write = dispatcher_->createSchedulableCallback([&]() {
+    Buffer::OwnedImpl buffer_to_write("world");
+    client_connection_->write(buffer_to_write, false);
+  });
+  dispatcher_->post([&]() {
+    Buffer::OwnedImpl buffer_to_write("hello ");
+    client_connection_->write(buffer_to_write, false);
+    second_write->scheduleCallbackCurrentIteration();
+  });
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ("hello world", data_written);
+
+  disconnect(true);
+}
+
 // Similar to BasicWrite, only with watermarks set.
 TEST_P(ConnectionImplTest, WriteWithWatermarks) {
   useMockBuffer();
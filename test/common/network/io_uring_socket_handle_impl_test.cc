@@ -15,6 +15,7 @@ public:
   IoUringSocketHandleTestImpl(Io::IoUringWorkerFactory& factory, bool is_server_socket)
       : IoUringSocketHandleImpl(factory, INVALID_SOCKET, false, absl::nullopt, is_server_socket) {}
   IoUringSocketType ioUringSocketType() const { return io_uring_socket_type_; }
+  void setAcceptSocketType() { io_uring_socket_type_ = IoUringSocketType::Accept; }
 };
 
 class IoUringSocketHandleTest : public ::testing::Test {
@@ -42,6 +43,57 @@ TEST_F(IoUringSocketHandleTest, CreateClientSocket) {
   EXPECT_EQ(IoUringSocketType::Client, impl.ioUringSocketType());
 }
 
+TEST_F(IoUringSocketHandleTest, MultishotAccept) {
+  IoUringSocketHandleTestImpl impl(factory_, false);
+  impl.setAcceptSocketType();
+  EXPECT_CALL(worker_, addAcceptSocket(_, _))
+      .WillOnce(testing::Return(OptRef<Io::IoUringSocket>(socket_)));
+  EXPECT_CALL(factory_, getIoUringWorker())
+      .WillOnce(testing::Return(OptRef<Io::IoUringWorker>(worker_)));
+  EXPECT_CALL(dispatcher_, createFileEvent_(_, _, _, _)).Times(0);
+  impl.initializeFileEvent(
+      dispatcher_, [](uint32_t) { return absl::OkStatus(); }, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read);
+
+  // Connections whose peer is already gone are closed and skipped.
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(socket_, takeAcceptedFd())
+      .WillOnce(testing::Return(10))
+      .WillOnce(testing::Return(INVALID_SOCKET));
+  EXPECT_CALL(os_sys_calls, getpeername(10, _, _))
+      .WillOnce(testing::Return(Api::SysCallIntResult{-1, ENOTCONN}));
+  EXPECT_CALL(os_sys_calls, close(10)).WillOnce(testing::Return(Api::SysCallIntResult{0, 0}));
+  sockaddr_storage addr;
+  socklen_t addrlen = sizeof(addr);
+  EXPECT_EQ(nullptr, impl.accept(reinterpret_cast<sockaddr*>(&addr), &addrlen));
+}
+
+TEST_F(IoUringSocketHandleTest, AcceptWithoutMultishotAccept) {
+  IoUringSocketHandleTestImpl impl(factory_, false);
+  impl.setAcceptSocketType();
+  EXPECT_CALL(worker_, addAcceptSocket(_, _)).WillOnce(testing::Return(absl::nullopt));
+  EXPECT_CALL(factory_, getIoUringWorker())
+      .WillOnce(testing::Return(OptRef<Io::IoUringWorker>(worker_)));
+  EXPECT_CALL(dispatcher_, createFileEvent_(_, _, _, Event::FileReadyType::Read))
+      .WillOnce(testing::Return(new testing::NiceMock<Event::MockFileEvent>()));
+  impl.initializeFileEvent(
+      dispatcher_, [](uint32_t) { return absl::OkStatus(); }, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read);
+}
+
+TEST_F(IoUringSocketHandleTest, AcceptWithoutIoUringWorker) {
+  IoUringSocketHandleTestImpl impl(factory_, false);
+  impl.setAcceptSocketType();
+  EXPECT_CALL(worker_, addAcceptSocket(_, _)).Times(0);
+  EXPECT_CALL(factory_, getIoUringWorker()).WillOnce(testing::Return(OptRef<Io::IoUringWorker>()));
+  EXPECT_CALL(dispatcher_, createFileEvent_(_, _, _, Event::FileReadyType::Read))
+      .WillOnce(testing::Return(new testing::NiceMock<Event::MockFileEvent>()));
+  impl.initializeFileEvent(
+      dispatcher_, [](uint32_t) { return absl::OkStatus(); }, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read);
+}
+
 TEST_F(IoUringSocketHandleTest, ReadError) {
   IoUringSocketHandleTestImpl impl(factory_, false);
   EXPECT_CALL(worker_, addClientSocket(_, _, _)).WillOnce(testing::ReturnRef(socket_));
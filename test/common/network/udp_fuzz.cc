@@ -38,6 +38,8 @@ public:
   FuzzUdpListenerCallbacks(UdpFuzz* upf) : my_upf_(upf) {}
   ~FuzzUdpListenerCallbacks() override = default;
   void onData(Network::UdpRecvData&& data) override;
+  void onDataBatch(absl::Span<const Network::UdpRecvPacket> packets) override;
+  bool supportsPacketBatches() const override { return false; }
   void onReadReady() override;
   void onWriteReady(const Network::Socket& socket) override;
   void onReceiveError(Api::IoError::IoErrorCode error_code) override;
@@ -154,6 +156,10 @@ void FuzzUdpListenerCallbacks::onData(Network::UdpRecvData&& data) {
   UNREFERENCED_PARAMETER(data);
 }
 
+void FuzzUdpListenerCallbacks::onDataBatch(absl::Span<const Network::UdpRecvPacket> packets) {
+  UNREFERENCED_PARAMETER(packets);
+}
+
 void FuzzUdpListenerCallbacks::onReadReady() {}
 
 void FuzzUdpListenerCallbacks::onWriteReady(const Network::Socket& socket) {
@@ -0,0 +1,111 @@
+// Measures the datagrams per second a single core ingests from a UDP socket, as QUIC listeners read
+// them: QUIC sized datagrams are read with recvmmsg or recvmsg either into a buffer allocated per
+// datagram, or into an arena reused across reads and passed on in batches
+// (envoy.reloadable_features.quic_listener_packet_batches).
+
+#include <memory>
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/socket_option_factory.h"
+#include "source/common/network/udp_packet_arena.h"
+#include "source/common/network/utility.h"
+
+#include "test/test_common/network_utility.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+// A typical size of the QUIC packets of a bulk transfer.
+constexpr uint64_t DatagramSize = 1350;
+// The datagrams sent between reads, which fit in the default receive buffer of a socket.
+constexpr uint64_t DatagramsPerIteration = 64;
+
+class IngestPacketProcessor : public UdpPacketProcessor {
+public:
+  explicit IngestPacketProcessor(bool use_arena) {
+    if (use_arena) {
+      arena_ = std::make_unique<UdpPacketArena>(NUM_DATAGRAMS_PER_RECEIVE, maxDatagramSize());
+    }
+  }
+
+  // UdpPacketProcessor
+  void processPacket(Address::InstanceConstSharedPtr, Address::InstanceConstSharedPtr,
+                     Buffer::InstancePtr buffer, MonotonicTime, uint8_t,
+                     Buffer::OwnedImpl) override {
+    const Buffer::RawSlice slice = buffer->frontSlice();
+    consume({static_cast<const char*>(slice.mem_), slice.len_});
+  }
+  void processPacketBatch(absl::Span<const UdpRecvPacket> packets) override {
+    for (const UdpRecvPacket& packet : packets) {
+      consume(packet.payload_);
+    }
+  }
+  UdpPacketArena* packetArena() override { return arena_.get(); }
+  void onDatagramsDropped(uint32_t dropped) override { dropped_ += dropped; }
+  uint64_t maxDatagramSize() const override { return DEFAULT_UDP_MAX_DATAGRAM_SIZE; }
+  size_t numPacketsExpectedPerEventLoop() const override { return MAX_NUM_PACKETS_PER_EVENT_LOOP; }
+  const IoHandle::UdpSaveCmsgConfig& saveCmsgConfig() const override { return save_cmsg_config_; }
+
+  uint64_t packets_{};
+  uint64_t dropped_{};
+
+private:
+  // Reads the header of the packet, as the QUIC dispatcher does to find its connection ID.
+  void consume(absl::string_view payload) {
+    benchmark::DoNotOptimize(payload.front());
+    packets_++;
+  }
+
+  UdpPacketArenaPtr arena_;
+  const IoHandle::UdpSaveCmsgConfig save_cmsg_config_{};
+};
+
+// Benchmark args: read into an arena (0/1), read with recvmmsg (0/1).
+static void bmUdpIngest(benchmark::State& state) {
+  const bool use_arena = state.range(0) != 0;
+  const bool allow_mmsg = state.range(1) != 0;
+
+  auto server_socket = std::make_shared<UdpListenSocket>(
+      Test::getCanonicalLoopbackAddress(Address::IpVersion::v4), nullptr, true);
+  server_socket->addOptions(SocketOptionFactory::buildIpPacketInfoOptions());
+  server_socket->addOptions(SocketOptionFactory::buildRxQueueOverFlowOptions());
+  RELEASE_ASSERT(Socket::applyOptions(server_socket->options(), *server_socket,
+                                      envoy::config::core::v3::SocketOption::STATE_BOUND),
+                 "");
+  const Address::InstanceConstSharedPtr& server_address =
+      server_socket->connectionInfoProvider().localAddress();
+  UdpListenSocket client_socket(Test::getCanonicalLoopbackAddress(Address::IpVersion::v4),
+                                nullptr, true);
+
+  Event::SimulatedTimeSystem time_system;
+  IngestPacketProcessor processor(use_arena);
+  const Buffer::OwnedImpl datagram(std::string(DatagramSize, 'q'));
+  uint32_t packets_dropped = 0;
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    state.PauseTiming();
+    for (uint64_t i = 0; i < DatagramsPerIteration; i++) {
+      RELEASE_ASSERT(Utility::writeToSocket(client_socket.ioHandle(), datagram, nullptr,
+                                            *server_address)
+                         .ok(),
+                     "");
+    }
+    state.ResumeTiming();
+    Utility::readPacketsFromSocket(server_socket->ioHandle(), *server_address, processor,
+                                   time_system, /*allow_gro=*/false, allow_mmsg, packets_dropped);
+  }
+  state.counters["packets_per_second"] =
+      benchmark::Counter(processor.packets_, benchmark::Counter::kIsRate);
+  state.counters["dropped"] = processor.dropped_;
+}
+BENCHMARK(bmUdpIngest)->ArgsProduct({{0, 1}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
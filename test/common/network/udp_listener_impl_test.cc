@@ -170,6 +170,77 @@ TEST_P(UdpListenerImplTest, LargeDatagramRecvmmsg) {
   EXPECT_EQ(2, listener_->packetsDropped());
 }
 
+// Datagrams are read into the arena of the listener and delivered in batches if the callbacks
+// support it.
+TEST_P(UdpListenerImplTest, PacketBatches) {
+  setup();
+  ON_CALL(listener_callbacks_, supportsPacketBatches()).WillByDefault(Return(true));
+
+  const std::string first("first");
+  client_.write(first, *send_to_addr_);
+  // This will get dropped.
+  client_.write(std::string(4096, 'a'), *send_to_addr_);
+  const std::string second("second");
+  client_.write(second, *send_to_addr_);
+
+  std::vector<std::string> payloads;
+  EXPECT_CALL(listener_callbacks_, onReadReady());
+  EXPECT_CALL(listener_callbacks_, onData(_)).Times(0);
+  EXPECT_CALL(listener_callbacks_, onDatagramsDropped(_)).Times(AtLeast(1));
+  EXPECT_CALL(listener_callbacks_, onDataBatch(_))
+      .Times(testing::Between(1, 2))
+      .WillRepeatedly(Invoke([&](absl::Span<const UdpRecvPacket> packets) {
+        for (const UdpRecvPacket& packet : packets) {
+          ASSERT_NE(packet.addresses_.local_, nullptr);
+          ASSERT_NE(packet.addresses_.peer_, nullptr);
+          EXPECT_EQ(*packet.addresses_.local_, *send_to_addr_);
+          EXPECT_EQ(packet.addresses_.peer_->ip()->addressAsString(),
+                    client_.localAddress()->ip()->addressAsString());
+          payloads.emplace_back(packet.payload_);
+        }
+        if (payloads.size() == 2) {
+          dispatcher_->exit();
+        }
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_THAT(payloads, testing::ElementsAre(first, second));
+  EXPECT_EQ(1, listener_->packetsDropped());
+}
+
+// With GRO, the whole read goes into the arena, and datagrams up to 64KiB aren't dropped.
+TEST_P(UdpListenerImplTest, PacketBatchesGro) {
+  if (!Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.udp_socket_apply_aggregated_read_limit")) {
+    return;
+  }
+  setup(true);
+  ON_CALL(override_syscall_, supportsUdpGro()).WillByDefault(Return(true));
+  ON_CALL(listener_callbacks_, supportsPacketBatches()).WillByDefault(Return(true));
+
+  const std::string first(32 * 1024, 'a');
+  client_.write(first, *send_to_addr_);
+  const std::string second("second");
+  client_.write(second, *send_to_addr_);
+
+  std::vector<std::string> payloads;
+  EXPECT_CALL(listener_callbacks_, onReadReady());
+  EXPECT_CALL(listener_callbacks_, onData(_)).Times(0);
+  EXPECT_CALL(listener_callbacks_, onDatagramsDropped(_)).Times(0);
+  EXPECT_CALL(listener_callbacks_, onDataBatch(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](absl::Span<const UdpRecvPacket> packets) {
+        ASSERT_EQ(1U, packets.size());
+        payloads.emplace_back(packets[0].payload_);
+        if (payloads.size() == 2) {
+          dispatcher_->exit();
+        }
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_THAT(payloads, testing::ElementsAre(first, second));
+}
+
 TEST_P(UdpListenerImplTest, LimitNumberOfReadsPerLoop) {
   setup();
   const uint64_t num_packets_per_read =
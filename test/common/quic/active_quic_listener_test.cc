@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "envoy/config/listener/v3/quic_config.pb.validate.h"
 #include "envoy/network/exception.h"
@@ -10,6 +13,7 @@
 #include "source/common/network/listen_socket_impl.h"
 #include "source/common/network/socket_option_factory.h"
 #include "source/common/network/udp_packet_writer_handler_impl.h"
+#include "source/common/network/utility.h"
 #include "source/common/quic/active_quic_listener.h"
 #include "source/common/quic/envoy_quic_clock.h"
 #include "source/common/quic/envoy_quic_utils.h"
@@ -300,6 +304,31 @@ protected:
     ASSERT_EQ(slice[0].len_, send_rc.return_value_);
   }
 
+  // Builds a batch of CHLOs as read into the arena of the listener, each from a peer of its own.
+  // The packets refer to the payloads, which must outlive them.
+  std::vector<Network::UdpRecvPacket>
+  chloPacketBatch(const std::vector<quic::QuicConnectionId>& connection_ids,
+                  std::vector<std::string>& payloads) {
+    const std::string loopback = Network::Test::getLoopbackAddressString(version_);
+    Network::Address::InstanceConstSharedPtr local_address =
+        Network::Utility::parseInternetAddressNoThrow(
+            loopback, listen_socket_->connectionInfoProvider().localAddress()->ip()->port());
+    for (const quic::QuicConnectionId& connection_id : connection_ids) {
+      payloads.push_back(
+          generateChloPacketToSend(quic_version_, quic_config_, connection_id).toString());
+    }
+    std::vector<Network::UdpRecvPacket> packets;
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      Network::UdpRecvPacket packet;
+      packet.addresses_.local_ = local_address;
+      packet.addresses_.peer_ = Network::Utility::parseInternetAddressNoThrow(loopback, 10000 + i);
+      packet.payload_ = payloads[i];
+      packet.receive_time_ = dispatcher_->timeSource().monotonicTime();
+      packets.push_back(packet);
+    }
+    return packets;
+  }
+
   void readFromClientSockets() {
     for (auto& client_socket : client_sockets_) {
       Buffer::InstancePtr result_buffer(new Buffer::OwnedImpl());
@@ -421,6 +450,8 @@ TEST_P(ActiveQuicListenerTest, ReceiveCHLO) {
 #else
   EXPECT_FALSE(quic_listener_->udpPacketWriter().isBatchMode());
 #endif
+  // Packets are read into the arena of the listener and dispatched in batches.
+  EXPECT_TRUE(quic_listener_->supportsPacketBatches());
   // The listener ignores read error.
   quic_listener_->onReceiveError(Api::IoError::IoErrorCode::InvalidArgument);
   quic::QuicBufferedPacketStore* const buffered_packets =
@@ -456,6 +487,20 @@ TEST_P(ActiveQuicListenerTest, ReceiveCHLO) {
   readFromClientSockets();
 }
 
+// Packets are dispatched one at a time if batches are disabled.
+TEST_P(ActiveQuicListenerTest, ReceiveCHLOWithoutPacketBatches) {
+  scoped_runtime_.mergeValues(
+      {{"envoy.reloadable_features.quic_listener_packet_batches", "false"}});
+  initialize();
+  EXPECT_FALSE(quic_listener_->supportsPacketBatches());
+  maybeConfigureMocks(/* connection_count = */ 1);
+  quic::QuicConnectionId connection_id = quic::test::TestConnectionId(1);
+  sendCHLO(connection_id);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_NE(nullptr, quic::test::QuicDispatcherPeer::FindSession(quic_dispatcher_, connection_id));
+  readFromClientSockets();
+}
+
 class MockNonDispatchedUdpPacketHandler : public Network::NonDispatchedUdpPacketHandler {
 public:
   MOCK_METHOD(void, handle, (uint32_t worker_index, const Network::UdpRecvData& packet));
@@ -478,6 +523,62 @@ TEST_P(ActiveQuicListenerTest, ReceiveCHLODuringHotRestartShouldForwardPacket) {
   EXPECT_EQ(0u, quic_dispatcher_->NumSessions());
 }
 
+// Every datagram of a batch is dispatched, creating a session for each CHLO.
+TEST_P(ActiveQuicListenerTest, ReceiveCHLOBatch) {
+  initialize();
+  ASSERT_TRUE(quic_listener_->supportsPacketBatches());
+  quic::QuicBufferedPacketStore* const buffered_packets =
+      quic::test::QuicDispatcherPeer::GetBufferedPackets(quic_dispatcher_);
+  maybeConfigureMocks(/* connection_count = */ 3);
+  const std::vector<quic::QuicConnectionId> connection_ids = {
+      quic::test::TestConnectionId(1), quic::test::TestConnectionId(2),
+      quic::test::TestConnectionId(3)};
+  std::vector<std::string> payloads;
+  const std::vector<Network::UdpRecvPacket> packets = chloPacketBatch(connection_ids, payloads);
+  quic_listener_->onDataBatch(packets);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_FALSE(buffered_packets->HasChlosBuffered());
+  EXPECT_EQ(3u, quic_dispatcher_->NumSessions());
+  for (const quic::QuicConnectionId& connection_id : connection_ids) {
+    EXPECT_NE(nullptr,
+              quic::test::QuicDispatcherPeer::FindSession(quic_dispatcher_, connection_id));
+  }
+}
+
+// The datagrams of a batch that aren't dispatched during hot restart are forwarded as copies that
+// don't refer to the memory they were read into.
+TEST_P(ActiveQuicListenerTest, ReceiveCHLOBatchDuringHotRestartShouldForwardPacketCopies) {
+  initialize();
+  MockNonDispatchedUdpPacketHandler mock_packet_forwarding;
+  Network::ExtraShutdownListenerOptions options;
+  options.non_dispatched_udp_packet_handler_ = mock_packet_forwarding;
+  quic_listener_->shutdownListener(options);
+  quic::QuicBufferedPacketStore* const buffered_packets =
+      quic::test::QuicDispatcherPeer::GetBufferedPackets(quic_dispatcher_);
+  maybeConfigureMocks(/* connection_count = */ 0);
+  std::vector<std::string> payloads;
+  const std::vector<Network::UdpRecvPacket> packets = chloPacketBatch(
+      {quic::test::TestConnectionId(1), quic::test::TestConnectionId(2)}, payloads);
+  const std::vector<std::string> expected_payloads = payloads;
+
+  testing::InSequence s;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    EXPECT_CALL(mock_packet_forwarding, handle(_, _))
+        .WillOnce(Invoke([&, i](uint32_t, const Network::UdpRecvData& data) {
+          // Reusing the memory of the read doesn't affect the forwarded packet.
+          std::fill(payloads[i].begin(), payloads[i].end(), '\0');
+          EXPECT_EQ(expected_payloads[i], data.buffer_->toString());
+          EXPECT_EQ(*packets[i].addresses_.local_, *data.addresses_.local_);
+          EXPECT_EQ(*packets[i].addresses_.peer_, *data.addresses_.peer_);
+          EXPECT_EQ(packets[i].receive_time_, data.receive_time_);
+        }));
+  }
+  quic_listener_->onDataBatch(packets);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_FALSE(buffered_packets->HasChlosBuffered());
+  EXPECT_EQ(0u, quic_dispatcher_->NumSessions());
+}
+
 TEST_P(ActiveQuicListenerTest, NormalizeTimeouts) {
   idle_timeout_ = 0.0005;      // 0.5ms
   handshake_timeout_ = 0.0009; // 0.9ms
@@ -4,6 +4,7 @@
 
 #include "source/common/http/header_map_impl.h"
 #include "source/common/router/config_impl.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/utility.h"
@@ -82,5 +83,57 @@ BENCHMARK(manyCountryRoutesLongHeaders)
     ->Arg(5000)
     ->Arg(10000);
 
+/**
+ * Measure route selection in a virtual host with many path-only routes, with and without the path
+ * index (envoy.reloadable_features.router_path_index). Routes alternate between a prefix and an
+ * exact path per service, and the request hits the last service, which is the worst case for
+ * evaluating routes in order.
+ */
+static void manyPathRoutes(benchmark::State& state) {
+  const bool use_index = state.range(0) != 0;
+  const size_t routes_num = state.range(1);
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.router_path_index", use_index);
+
+  envoy::config::route::v3::RouteConfiguration proto_config;
+  auto main_virtual_host = proto_config.mutable_virtual_hosts()->Add();
+  main_virtual_host->set_name("default");
+  main_virtual_host->mutable_domains()->Add("*");
+  for (size_t i = 0; i < routes_num / 2; i++) {
+    auto exact_route = main_virtual_host->mutable_routes()->Add();
+    exact_route->mutable_match()->set_path(absl::StrCat("/service", i, "/health"));
+    exact_route->mutable_route()->set_cluster("health");
+    auto prefix_route = main_virtual_host->mutable_routes()->Add();
+    prefix_route->mutable_match()->set_prefix(absl::StrCat("/service", i, "/"));
+    prefix_route->mutable_route()->set_cluster(absl::StrCat("service", i));
+  }
+  auto default_route = main_virtual_host->mutable_routes()->Add();
+  default_route->mutable_match()->set_prefix("/");
+  default_route->mutable_route()->set_cluster("default");
+
+  Api::ApiPtr api(Api::createApiForTest());
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  std::shared_ptr<ConfigImpl> config = *ConfigImpl::create(
+      proto_config, factory_context, ProtobufMessage::getNullValidationVisitor(), true);
+
+  const auto stream_info = NiceMock<Envoy::StreamInfo::MockStreamInfo>();
+  const std::string expected_cluster = absl::StrCat("service", routes_num / 2 - 1);
+  auto req_headers = Http::TestRequestHeaderMapImpl{
+      {":authority", "www.lyft.com"},
+      {":path", absl::StrCat("/service", routes_num / 2 - 1, "/api/v1/items/12345?verbose=1")},
+      {":method", "GET"},
+      {":scheme", "http"}};
+  for (auto _ : state) { // NOLINT
+    auto& result = config->route(req_headers, stream_info, 0)->routeEntry()->clusterName();
+    benchmark::DoNotOptimize(result);
+  }
+  if (config->route(req_headers, stream_info, 0)->routeEntry()->clusterName() !=
+      expected_cluster) {
+    state.SkipWithError("unexpected route selected");
+  }
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.router_path_index", true);
+}
+BENCHMARK(manyPathRoutes)->ArgsProduct({{0, 1}, {10, 100, 1000, 10000}});
+
 } // namespace Router
 } // namespace Envoy
@@ -3,6 +3,7 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/router/config_impl.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "test/mocks/server/instance.h"
 #include "test/mocks/stream_info/mocks.h"
@@ -311,6 +312,48 @@ static void bmRouteTableSizeWithPrefixMatcherTree(benchmark::State& state) {
   }
 }
 
+/**
+ * Measure the time to apply a route configuration update that changes one of `n` virtual hosts,
+ * with and without sharing the unchanged virtual hosts of the configuration being replaced.
+ */
+static void bmRouteConfigUpdate(benchmark::State& state) {
+  const bool reuse_virtual_hosts = state.range(0) != 0;
+  const int num_virtual_hosts = state.range(1);
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.rds_reuse_virtual_hosts",
+                                reuse_virtual_hosts);
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+
+  RouteConfiguration route_config;
+  for (int i = 0; i < num_virtual_hosts; ++i) {
+    VirtualHost* v_host = route_config.add_virtual_hosts();
+    v_host->set_name(absl::StrCat("vhost_", i));
+    v_host->add_domains(absl::StrCat("vhost-", i, ".example.com"));
+    Route* regex_route = v_host->add_routes();
+    regex_route->mutable_match()->mutable_safe_regex()->set_regex(
+        absl::StrCat("^/shelves/[^/]+/route_", i, "$"));
+    regex_route->mutable_direct_response()->set_status(200);
+    Route* prefix_route = v_host->add_routes();
+    prefix_route->mutable_match()->set_prefix("/");
+    prefix_route->mutable_direct_response()->set_status(404);
+  }
+  std::shared_ptr<ConfigImpl> config = *ConfigImpl::create(
+      route_config, factory_context, ProtobufMessage::getNullValidationVisitor(), false);
+
+  int update = 0;
+  for (auto _ : state) { // NOLINT
+    DirectResponseAction* direct_response =
+        route_config.mutable_virtual_hosts(update++ % num_virtual_hosts)
+            ->mutable_routes(0)
+            ->mutable_direct_response();
+    direct_response->set_status(direct_response->status() == 200 ? 201 : 200);
+    config = *ConfigImpl::create(route_config, factory_context,
+                                 ProtobufMessage::getNullValidationVisitor(), false, config.get());
+  }
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.rds_reuse_virtual_hosts", true);
+}
+
 BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
@@ -318,6 +361,9 @@ BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 <<
 BENCHMARK(bmRouteTableSizeWithExactMatcherTree)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithPrefixMatcherTree)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 
+// Benchmark args: reuse virtual hosts (0/1), number of virtual hosts.
+BENCHMARK(bmRouteConfigUpdate)->ArgsProduct({{0, 1}, {100, 10000}})->Unit(benchmark::kMillisecond);
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
@@ -4,6 +4,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "envoy/common/hashable.h"
@@ -2293,6 +2294,136 @@ virtual_hosts:
   }
 }
 
+// Tests that looking routes up through the path index selects the same route as evaluating them
+// in order, for a virtual host with enough path-only routes to be indexed.
+TEST_F(RouteMatcherTest, PathIndexPreservesFirstMatch) {
+  std::string yaml = R"EOF(
+virtual_hosts:
+- name: local_service
+  domains: ["*"]
+  routes:
+  - match: { prefix: "/api/v1/users" }
+    route: { cluster: users }
+  - match: { path: "/api/v1/users/me" }
+    route: { cluster: shadowed }
+  - match:
+      prefix: "/api/v2"
+      headers:
+      - name: x-canary
+        present_match: true
+    route: { cluster: canary }
+  - match: { prefix: "/api/v2" }
+    route: { cluster: v2 }
+  - match: { path: "/Static/Index.html", case_sensitive: false }
+    route: { cluster: static }
+  - match: { prefix: "/Assets", case_sensitive: false }
+    route: { cluster: assets }
+  - match: { path_separated_prefix: "/filler/0" }
+    route: { cluster: separated }
+)EOF";
+  for (int i = 0; i < 10; ++i) {
+    absl::StrAppend(&yaml, "  - match: { prefix: \"/filler/", i, "\" }\n",
+                    "    route: { cluster: filler }\n");
+  }
+  absl::StrAppend(&yaml, "  - match: { prefix: \"/\" }\n", "    route: { cluster: catchall }\n");
+
+  factory_context_.cluster_manager_.initializeClusters({"users", "shadowed", "canary", "v2",
+                                                        "static", "assets", "separated",
+                                                        "filler", "catchall"},
+                                                       {});
+
+  const std::vector<std::tuple<std::string, bool, std::string>> cases = {
+      {"/api/v1/users/me", false, "users"},
+      {"/api/v1/users?id=1", false, "users"},
+      {"/api/v2/items", false, "v2"},
+      {"/api/v2/items", true, "canary"},
+      {"/static/index.html", false, "static"},
+      {"/STATIC/INDEX.HTML?q=1#top", false, "static"},
+      {"/static/index.html/extra", false, "catchall"},
+      {"/ASSETS/app.js", false, "assets"},
+      {"/filler/0/x", false, "separated"},
+      {"/filler/7/x", false, "filler"},
+      {"/unknown", false, "catchall"},
+  };
+  for (const bool use_index : {false, true}) {
+    mergeValues({{"envoy.reloadable_features.router_path_index", use_index ? "true" : "false"}});
+    TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true,
+                          creation_status_);
+    for (const auto& [path, canary, cluster] : cases) {
+      Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", path, "GET");
+      if (canary) {
+        headers.addCopy("x-canary", "1");
+      }
+      EXPECT_EQ(cluster, config.route(headers, 0)->routeEntry()->clusterName())
+          << path << " use_index=" << use_index;
+    }
+  }
+}
+
+// Virtual hosts whose proto is unchanged are shared with the configuration being replaced, as
+// long as nothing outside of the virtual hosts changed and clusters are not validated.
+TEST_F(RouteMatcherTest, ReusesUnchangedVirtualHosts) {
+  const std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+- name: a
+  domains: ["a.example.com"]
+  routes:
+  - match: { prefix: "/" }
+    route: { cluster: a }
+- name: b
+  domains: ["b.example.com"]
+  routes:
+  - match: { prefix: "/" }
+    route: { cluster: b }
+)EOF";
+  factory_context_.cluster_manager_.initializeClusters({"a", "b", "c"}, {});
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  const auto virtual_host = [&stream_info](const ConfigImpl& config, const std::string& host) {
+    return &config.route(genHeaders(host, "/", "GET"), stream_info, 0)->virtualHost();
+  };
+  const auto create = [this](const envoy::config::route::v3::RouteConfiguration& route_config,
+                             const ConfigImpl* previous) {
+    return *ConfigImpl::create(route_config, factory_context_,
+                               ProtobufMessage::getNullValidationVisitor(), false, previous);
+  };
+
+  const envoy::config::route::v3::RouteConfiguration route_config =
+      parseRouteConfigurationFromYaml(yaml);
+  const std::shared_ptr<ConfigImpl> first = create(route_config, nullptr);
+
+  envoy::config::route::v3::RouteConfiguration changed_vhost = route_config;
+  changed_vhost.mutable_virtual_hosts(1)->mutable_routes(0)->mutable_route()->set_cluster("c");
+  const std::shared_ptr<ConfigImpl> second = create(changed_vhost, first.get());
+  EXPECT_EQ(virtual_host(*first, "a.example.com"), virtual_host(*second, "a.example.com"));
+  EXPECT_NE(virtual_host(*first, "b.example.com"), virtual_host(*second, "b.example.com"));
+  EXPECT_EQ("c", second->route(genHeaders("b.example.com", "/", "GET"), stream_info, 0)
+                     ->routeEntry()
+                     ->clusterName());
+
+  // Reuse carries over to configurations built from one that reused virtual hosts itself.
+  const std::shared_ptr<ConfigImpl> third = create(changed_vhost, second.get());
+  EXPECT_EQ(virtual_host(*first, "a.example.com"), virtual_host(*third, "a.example.com"));
+  EXPECT_EQ(virtual_host(*second, "b.example.com"), virtual_host(*third, "b.example.com"));
+
+  // Routes refer to settings outside of their virtual host, so those must not change.
+  envoy::config::route::v3::RouteConfiguration changed_common = changed_vhost;
+  changed_common.add_internal_only_headers("x-internal");
+  const std::shared_ptr<ConfigImpl> fourth = create(changed_common, third.get());
+  EXPECT_NE(virtual_host(*third, "a.example.com"), virtual_host(*fourth, "a.example.com"));
+
+  // A reused virtual host would skip cluster validation.
+  envoy::config::route::v3::RouteConfiguration validated = changed_common;
+  validated.mutable_validate_clusters()->set_value(true);
+  const std::shared_ptr<ConfigImpl> fifth = create(validated, fourth.get());
+  const std::shared_ptr<ConfigImpl> sixth = create(validated, fifth.get());
+  EXPECT_NE(virtual_host(*fifth, "a.example.com"), virtual_host(*sixth, "a.example.com"));
+
+  mergeValues({{"envoy.reloadable_features.rds_reuse_virtual_hosts", "false"}});
+  const std::shared_ptr<ConfigImpl> seventh = create(changed_common, fourth.get());
+  EXPECT_NE(virtual_host(*fourth, "a.example.com"), virtual_host(*seventh, "a.example.com"));
+}
+
 // Tests that when 'ignore_path_parameters_in_path_matching' is true, port from host header
 // is ignored in host matching.
 TEST_F(RouteMatcherTest, IgnorePathParametersInPathMatching) {
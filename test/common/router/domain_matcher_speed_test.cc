@@ -0,0 +1,93 @@
+// Measures virtual host domain lookup and compilation time of DomainMatcher for route
+// configurations with many virtual hosts.
+
+#include <string>
+#include <vector>
+
+#include "source/common/router/domain_matcher.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+// Each tenant has an exact domain, a label aligned suffix wildcard, a prefix wildcard and a suffix
+// wildcard that is not label aligned.
+std::vector<std::string> makeDomains(int num_tenants) {
+  std::vector<std::string> domains;
+  domains.reserve(num_tenants * 4);
+  for (int i = 0; i < num_tenants; ++i) {
+    domains.push_back(absl::StrCat("tenant-", i, ".example.com"));
+    domains.push_back(absl::StrCat("*.tenant-", i, ".example.com"));
+    domains.push_back(absl::StrCat("tenant-", i, ".example.*"));
+    domains.push_back(absl::StrCat("*-", i, ".example.org"));
+  }
+  return domains;
+}
+
+enum class HostKind {
+  Exact,
+  SuffixWildcard,
+  PrefixWildcard,
+  UnalignedSuffixWildcard,
+  NoMatch,
+};
+
+std::string makeHost(HostKind kind, int tenant) {
+  switch (kind) {
+  case HostKind::Exact:
+    return absl::StrCat("tenant-", tenant, ".example.com");
+  case HostKind::SuffixWildcard:
+    return absl::StrCat("api.tenant-", tenant, ".example.com");
+  case HostKind::PrefixWildcard:
+    return absl::StrCat("tenant-", tenant, ".example.net");
+  case HostKind::UnalignedSuffixWildcard:
+    return absl::StrCat("api-", tenant, ".example.org");
+  case HostKind::NoMatch:
+    return absl::StrCat("www.tenant-", tenant, ".example.io");
+  }
+  return "";
+}
+
+// Benchmark args: host kind, number of tenants.
+void bmDomainLookup(benchmark::State& state) {
+  const auto kind = static_cast<HostKind>(state.range(0));
+  const int num_tenants = state.range(1);
+  const std::vector<std::string> domains = makeDomains(num_tenants);
+  DomainMatcher<const std::string*> matcher;
+  for (const std::string& domain : domains) {
+    matcher.add(domain, &domain);
+  }
+  matcher.compile();
+
+  std::vector<std::string> hosts;
+  for (int i = 0; i < 64; ++i) {
+    hosts.push_back(makeHost(kind, (i * 7919) % num_tenants));
+  }
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    benchmark::DoNotOptimize(matcher.find(hosts[i++ % hosts.size()]));
+  }
+}
+BENCHMARK(bmDomainLookup)->ArgsProduct({{0, 1, 2, 3, 4}, {10, 1000, 20000}});
+
+// Benchmark args: number of tenants.
+void bmDomainCompile(benchmark::State& state) {
+  const std::vector<std::string> domains = makeDomains(state.range(0));
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    DomainMatcher<const std::string*> matcher;
+    for (const std::string& domain : domains) {
+      matcher.add(domain, &domain);
+    }
+    matcher.compile();
+    benchmark::DoNotOptimize(matcher.find(domains.front()));
+  }
+  state.counters["domains"] = domains.size();
+}
+BENCHMARK(bmDomainCompile)->Arg(10)->Arg(1000)->Arg(20000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
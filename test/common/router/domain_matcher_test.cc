@@ -0,0 +1,123 @@
+#include <string>
+#include <vector>
+
+#include "source/common/router/domain_matcher.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+class DomainMatcherTest : public testing::Test {
+protected:
+  // Adds each domain with its own name as the value, so that tests can assert on which one
+  // matched.
+  void build(const std::vector<std::string>& domains) {
+    domains_ = domains;
+    for (const std::string& domain : domains_) {
+      EXPECT_TRUE(matcher_.add(domain, &domain)) << domain;
+    }
+    matcher_.compile();
+  }
+
+  std::string find(absl::string_view host) const {
+    const std::string* domain = matcher_.find(host);
+    return domain == nullptr ? "" : *domain;
+  }
+
+  std::vector<std::string> domains_;
+  DomainMatcher<const std::string*> matcher_;
+};
+
+TEST_F(DomainMatcherTest, Empty) {
+  build({});
+  EXPECT_TRUE(matcher_.empty());
+  EXPECT_EQ("", find("www.example.com"));
+  EXPECT_EQ("", find(""));
+}
+
+TEST_F(DomainMatcherTest, Precedence) {
+  build({"www.example.com", "*.example.com", "*-bar.example.com", "www.*", "*.com", "www.example.*",
+         "*ample.com"});
+  EXPECT_FALSE(matcher_.empty());
+  // Exact beats any wildcard.
+  EXPECT_EQ("www.example.com", find("www.example.com"));
+  // The longest suffix wildcard wins, whether or not it is label aligned.
+  EXPECT_EQ("*-bar.example.com", find("foo-bar.example.com"));
+  EXPECT_EQ("*.example.com", find("foo.example.com"));
+  EXPECT_EQ("*ample.com", find("example.com"));
+  EXPECT_EQ("*.com", find("foo.com"));
+  // Suffix wildcards beat prefix wildcards, and the longest prefix wildcard wins.
+  EXPECT_EQ("*.com", find("www.example.com.com"));
+  EXPECT_EQ("www.example.*", find("www.example.org"));
+  EXPECT_EQ("www.*", find("www.foo.org"));
+  EXPECT_EQ("", find("foo.org"));
+}
+
+TEST_F(DomainMatcherTest, WildcardsMatchAtLeastOneCharacter) {
+  build({"*.example.com", "*bar.com", "www.*", "api-*"});
+  EXPECT_EQ("", find(".example.com"));
+  EXPECT_EQ("*.example.com", find("a.example.com"));
+  EXPECT_EQ("", find("bar.com"));
+  EXPECT_EQ("*bar.com", find("foobar.com"));
+  EXPECT_EQ("", find("www."));
+  EXPECT_EQ("www.*", find("www.a"));
+  EXPECT_EQ("", find("api-"));
+  EXPECT_EQ("api-*", find("api-a"));
+}
+
+TEST_F(DomainMatcherTest, EmptyLabelsInHost) {
+  build({"*.example.com", "*..example.com", "www.*"});
+  EXPECT_EQ("*..example.com", find("a..example.com"));
+  EXPECT_EQ("*.example.com", find("a.b.example.com"));
+  EXPECT_EQ("", find("a.example.com."));
+  EXPECT_EQ("www.*", find("www..a"));
+}
+
+TEST_F(DomainMatcherTest, Duplicates) {
+  std::string value;
+  EXPECT_TRUE(matcher_.add("www.example.com", &value));
+  EXPECT_FALSE(matcher_.add("www.example.com", &value));
+  EXPECT_TRUE(matcher_.add("*.example.com", &value));
+  EXPECT_FALSE(matcher_.add("*.example.com", &value));
+  EXPECT_TRUE(matcher_.add("*-bar.example.com", &value));
+  EXPECT_FALSE(matcher_.add("*-bar.example.com", &value));
+  EXPECT_TRUE(matcher_.add("www.*", &value));
+  EXPECT_FALSE(matcher_.add("www.*", &value));
+  // The same string is a different domain depending on where the wildcard is.
+  EXPECT_TRUE(matcher_.add("*www.", &value));
+  EXPECT_TRUE(matcher_.add("www.", &value));
+}
+
+TEST_F(DomainMatcherTest, ManyDomains) {
+  std::vector<std::string> domains;
+  for (int i = 0; i < 1000; ++i) {
+    domains.push_back(absl::StrCat("tenant-", i, ".example.com"));
+    domains.push_back(absl::StrCat("*.tenant-", i, ".example.com"));
+    domains.push_back(absl::StrCat("*-", i, ".example.org"));
+  }
+  build(domains);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(absl::StrCat("tenant-", i, ".example.com"),
+              find(absl::StrCat("tenant-", i, ".example.com")));
+    EXPECT_EQ(absl::StrCat("*.tenant-", i, ".example.com"),
+              find(absl::StrCat("a.b.tenant-", i, ".example.com")));
+    EXPECT_EQ(absl::StrCat("*-", i, ".example.org"), find(absl::StrCat("x-", i, ".example.org")));
+  }
+  EXPECT_EQ("", find("tenant-1000.example.com"));
+}
+
+TEST_F(DomainMatcherTest, LongExactDomains) {
+  // Keys of the same length that only differ beyond the 256th character.
+  const std::string base(300, 'a');
+  build({absl::StrCat(base, "b"), absl::StrCat(base, "c")});
+  EXPECT_EQ(absl::StrCat(base, "b"), find(absl::StrCat(base, "b")));
+  EXPECT_EQ(absl::StrCat(base, "c"), find(absl::StrCat(base, "c")));
+  EXPECT_EQ("", find(absl::StrCat(base, "d")));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -6968,5 +6968,80 @@ TEST_F(RouterTest, OrcaLoadReportInvalidHeaderValue) {
   response_decoder->decodeHeaders(std::move(response_headers), true);
 }
 
+class TestResponseTimeLbData : public Upstream::HostLbPolicyData {
+public:
+  MOCK_METHOD(void, onResponseTime, (std::chrono::microseconds), (override));
+  MOCK_METHOD(void, onRequestFailure, (std::chrono::microseconds), (override));
+};
+
+// Verify that the response time of a completed request is reported to the host lb policy data.
+TEST_F(RouterTest, ResponseTimeLbPolicyDataCallback) {
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+  expectResponseTimerCreate();
+
+  auto host_lb_policy_data = std::make_unique<TestResponseTimeLbData>();
+  auto host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->lb_policy_data_ = std::move(host_lb_policy_data);
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), false);
+  test_time_.advanceTimeWait(std::chrono::milliseconds(80));
+
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onResponseTime(std::chrono::microseconds(80000)));
+  Buffer::OwnedImpl data;
+  response_decoder->decodeData(data, true);
+}
+
+// Verify that a request to a timing out host is reported as a failure to the host lb policy data,
+// with the time elapsed since the upstream request started.
+TEST_F(RouterTest, ResponseTimeoutLbPolicyDataCallback) {
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+  expectResponseTimerCreate();
+
+  auto host_lb_policy_data = std::make_unique<TestResponseTimeLbData>();
+  auto host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->lb_policy_data_ = std::move(host_lb_policy_data);
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+  test_time_.advanceTimeWait(std::chrono::milliseconds(200));
+
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onResponseTime(_)).Times(0);
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onRequestFailure(std::chrono::microseconds(200000)));
+  EXPECT_CALL(encoder.stream_, resetStream(Http::StreamResetReason::LocalReset));
+  response_timeout_->invokeCallback();
+}
+
+// Verify that an upstream reset is reported as a failure to the host lb policy data.
+TEST_F(RouterTest, UpstreamResetLbPolicyDataCallback) {
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+  expectResponseTimerCreate();
+
+  auto host_lb_policy_data = std::make_unique<TestResponseTimeLbData>();
+  auto host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->lb_policy_data_ = std::move(host_lb_policy_data);
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+  test_time_.advanceTimeWait(std::chrono::milliseconds(30));
+
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onResponseTime(_)).Times(0);
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onRequestFailure(std::chrono::microseconds(30000)));
+  encoder.stream_.resetStream(Http::StreamResetReason::RemoteReset);
+}
+
 } // namespace Router
 } // namespace Envoy
@@ -154,6 +154,30 @@ TEST_F(AllocatorImplTest, HiddenGauge) {
   EXPECT_FALSE(never_import_hidden_gauge->hidden());
 }
 
+TEST_F(AllocatorImplTest, LatchChanged) {
+  GaugeSharedPtr gauge =
+      alloc_.makeGauge(makeStat("gauge"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->set(5);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->sub(1);
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->add(1);
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->setParentValue(3);
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->setParentValue(3);
+  EXPECT_FALSE(gauge->latchChanged());
+  EXPECT_TRUE(gauge->used());
+
+  TextReadoutSharedPtr text_readout = alloc_.makeTextReadout(makeStat("text"), StatName(), {});
+  EXPECT_FALSE(text_readout->latchChanged());
+  text_readout->set("value");
+  EXPECT_TRUE(text_readout->latchChanged());
+  EXPECT_FALSE(text_readout->latchChanged());
+}
+
 TEST_F(AllocatorImplTest, ForEachCounter) {
   StatNameHashSet stat_names;
   std::vector<CounterSharedPtr> counters;
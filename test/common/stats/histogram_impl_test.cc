@@ -1,3 +1,5 @@
+#include <limits>
+
 #include "envoy/config/metrics/v3/stats.pb.h"
 
 #include "source/common/stats/histogram_impl.h"
@@ -109,5 +111,66 @@ TEST_F(HistogramSettingsImplTest, ScaledPercent) {
   EXPECT_EQ(settings_->buckets("abcd"), ConstSupportedBuckets({0.1, 2}));
 }
 
+class HistogramBucketRecorderTest : public testing::Test {
+public:
+  HistogramBucketRecorderTest() : expected_(hist_alloc()), actual_(hist_alloc()) {}
+  ~HistogramBucketRecorderTest() override {
+    hist_free(expected_);
+    hist_free(actual_);
+  }
+
+  void record(uint64_t value) {
+    hist_insert_intscale(expected_, value, 0, 1);
+    recorder_.recordValue(value);
+  }
+
+  // The recorder must produce exactly the bins direct insertion does, and hence the same quantiles
+  // and bucket counts.
+  void expectSameHistogram() {
+    recorder_.mergeInto(actual_);
+    const uint32_t num_buckets = hist_num_buckets(expected_);
+    ASSERT_EQ(num_buckets, hist_num_buckets(actual_));
+    for (uint32_t i = 0; i < num_buckets; ++i) {
+      hist_bucket_t expected_bucket;
+      hist_bucket_t actual_bucket;
+      uint64_t expected_count;
+      uint64_t actual_count;
+      hist_bucket_idx_bucket(expected_, i, &expected_bucket, &expected_count);
+      hist_bucket_idx_bucket(actual_, i, &actual_bucket, &actual_count);
+      EXPECT_EQ(expected_bucket.val, actual_bucket.val);
+      EXPECT_EQ(expected_bucket.exp, actual_bucket.exp);
+      EXPECT_EQ(expected_count, actual_count);
+    }
+    HistogramStatisticsImpl expected_stats(expected_);
+    HistogramStatisticsImpl actual_stats(actual_);
+    EXPECT_EQ(expected_stats.computedQuantiles(), actual_stats.computedQuantiles());
+    EXPECT_EQ(expected_stats.computedBuckets(), actual_stats.computedBuckets());
+    EXPECT_EQ(expected_stats.sampleCount(), actual_stats.sampleCount());
+  }
+
+  histogram_t* expected_;
+  histogram_t* actual_;
+  HistogramBucketRecorder recorder_;
+};
+
+TEST_F(HistogramBucketRecorderTest, Empty) { expectSameHistogram(); }
+
+TEST_F(HistogramBucketRecorderTest, MatchesDirectInsertion) {
+  for (uint64_t value = 0; value < 100000; value = value * 3 / 2 + 1) {
+    record(value);
+    record(value);
+  }
+  record(0);
+  record(std::numeric_limits<int64_t>::max());
+  // Values which do not fit an int64_t are converted the same way hist_insert_intscale() does.
+  record(std::numeric_limits<uint64_t>::max());
+  expectSameHistogram();
+
+  // The recorder is cleared by a merge, so the next interval accumulates on top of the first.
+  record(7);
+  record(12345);
+  expectSameHistogram();
+}
+
 } // namespace Stats
 } // namespace Envoy
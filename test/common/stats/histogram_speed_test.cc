@@ -0,0 +1,82 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares recording samples directly into a circllhist, as thread-local histograms used to, with
+// recording them through HistogramBucketRecorder and merging into a circllhist once per interval.
+//
+// NOLINT(namespace-envoy)
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "source/common/stats/histogram_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// Latency-like samples: log-uniformly spread over [1, 10^decades), so that the number of distinct
+// bins grows with the number of decades.
+std::vector<uint64_t> makeSamples(int64_t decades) {
+  std::mt19937_64 engine(42);
+  std::uniform_real_distribution<double> exponent(0, decades);
+  std::vector<uint64_t> samples(64 * 1024);
+  for (uint64_t& sample : samples) {
+    sample = static_cast<uint64_t>(std::pow(10, exponent(engine)));
+  }
+  return samples;
+}
+
+} // namespace
+
+// Benchmark args: number of decades spanned by the samples.
+static void bmCircllhistInsert(benchmark::State& state) {
+  const std::vector<uint64_t> samples = makeSamples(state.range(0));
+  histogram_t* histogram = hist_alloc();
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    for (uint64_t sample : samples) {
+      hist_insert_intscale(histogram, sample, 0, 1);
+    }
+  }
+  benchmark::DoNotOptimize(hist_sample_count(histogram));
+  hist_free(histogram);
+  state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(bmCircllhistInsert)->DenseRange(1, 6);
+
+// Benchmark args: number of decades spanned by the samples.
+static void bmBucketRecorder(benchmark::State& state) {
+  const std::vector<uint64_t> samples = makeSamples(state.range(0));
+  Envoy::Stats::HistogramBucketRecorder recorder;
+  histogram_t* histogram = hist_alloc();
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    for (uint64_t sample : samples) {
+      recorder.recordValue(sample);
+    }
+  }
+  recorder.mergeInto(histogram);
+  benchmark::DoNotOptimize(hist_sample_count(histogram));
+  hist_free(histogram);
+  state.SetItemsProcessed(state.iterations() * samples.size());
+}
+BENCHMARK(bmBucketRecorder)->DenseRange(1, 6);
+
+// The cost paid once per flush interval, per thread-local histogram.
+// Benchmark args: number of decades spanned by the samples.
+static void bmBucketRecorderMerge(benchmark::State& state) {
+  const std::vector<uint64_t> samples = makeSamples(state.range(0));
+  Envoy::Stats::HistogramBucketRecorder recorder;
+  histogram_t* histogram = hist_alloc();
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    state.PauseTiming();
+    for (uint64_t sample : samples) {
+      recorder.recordValue(sample);
+    }
+    state.ResumeTiming();
+    recorder.mergeInto(histogram);
+  }
+  benchmark::DoNotOptimize(hist_sample_count(histogram));
+  hist_free(histogram);
+}
+BENCHMARK(bmBucketRecorderMerge)->DenseRange(1, 6);
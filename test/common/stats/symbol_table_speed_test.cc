@@ -13,6 +13,7 @@
 #include "test/common/stats/make_elements_helper.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -63,6 +64,59 @@ static void bmCreateRace(benchmark::State& state) {
 }
 BENCHMARK(bmCreateRace)->Unit(::benchmark::kMillisecond);
 
+// Measures encode/free throughput when many workers create stat names at once, as happens when
+// scopes are created per request or per connection. Either every token already exists in the
+// table (hot names, served under shard reader locks), or each name adds and then removes a new
+// token (served under the shard's exclusive lock).
+//
+// Benchmark args: number of threads, and whether each name contains a new token.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeContention(benchmark::State& state) {
+  const uint32_t num_threads = state.range(0);
+  const bool new_tokens = state.range(1) != 0;
+  constexpr uint32_t names_per_thread = 10 * 1000;
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  Envoy::Stats::SymbolTableImpl table;
+
+  // Hold a reference to the shared tokens, as live stats in a running server would.
+  Envoy::Stats::StatNamePool held(table);
+  std::vector<std::vector<std::string>> names(num_threads);
+  for (uint32_t t = 0; t < num_threads; ++t) {
+    names[t].reserve(names_per_thread);
+    for (uint32_t i = 0; i < names_per_thread; ++i) {
+      const std::string cluster =
+          new_tokens ? absl::StrCat("new_", t, "_", i) : absl::StrCat("cluster_", i % 100);
+      names[t].push_back(absl::StrCat("cluster.", cluster, ".upstream_rq_total"));
+      if (!new_tokens && t == 0 && i < 100) {
+        held.add(names[t].back());
+      }
+    }
+  }
+  held.add("cluster.upstream_rq_total");
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    for (uint32_t t = 0; t < num_threads; ++t) {
+      threads.push_back(thread_factory.createThread([&table, &thread_names = names[t]]() {
+        for (const std::string& name : thread_names) {
+          Envoy::Stats::StatNameStorage storage(name, table);
+          storage.free(table);
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * names_per_thread);
+}
+BENCHMARK(bmEncodeContention)
+    ->ArgsProduct({{1, 2, 4, 8, 16}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(::benchmark::kMillisecond);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void bmJoinStatNames(benchmark::State& state) {
   Envoy::Stats::SymbolTableImpl symbol_table;
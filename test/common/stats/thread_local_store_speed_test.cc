@@ -13,12 +13,14 @@
 #include "source/common/stats/thread_local_store.h"
 #include "source/common/thread_local/thread_local_impl.h"
 
+#include "test/common/stats/real_thread_test_base.h"
 #include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/server/server_factory_context.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -138,5 +140,75 @@ static void BM_StatsWithTlsAndRejectionsWithoutDot(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
-// TODO(jmarantz): add multi-threaded variant of this test, that aggressively
-// looks up stats in multiple threads to try to trigger contention issues.
+namespace Envoy {
+
+class ThreadLocalStoreContentionPerf : public Stats::ThreadLocalRealThreadsMixin {
+public:
+  explicit ThreadLocalStoreContentionPerf(uint32_t num_workers)
+      : ThreadLocalRealThreadsMixin(num_workers) {
+    runOnMainBlocking([this]() {
+      scope_ = store_->createScope("cluster.service_0.");
+      for (uint32_t i = 0; i < 100; ++i) {
+        names_.push_back(absl::StrCat("upstream_rq_", i));
+        stat_names_.push_back(makeStatName(names_.back()));
+      }
+    });
+  }
+
+  ~ThreadLocalStoreContentionPerf() {
+    runOnMainBlocking([this]() { scope_.reset(); });
+    shutdownThreading();
+    // Wait for the main thread to initiate the TLS cleanup, for the workers to
+    // complete it, and for the final central-cache cleanup on the main thread.
+    mainDispatchBlock();
+    tlsBlock();
+    mainDispatchBlock();
+  }
+
+  // Looks up every stat 10 times on each worker, by string or by StatName.
+  void accessCounters(bool by_string) {
+    runOnAllWorkersBlocking([this, by_string]() {
+      for (uint32_t i = 0; i < 10; ++i) {
+        for (uint32_t j = 0; j < names_.size(); ++j) {
+          Stats::Counter& counter = by_string ? scope_->counterFromString(names_[j])
+                                              : scope_->counterFromStatName(stat_names_[j]);
+          counter.inc();
+        }
+      }
+    });
+  }
+
+  uint64_t lookupsPerAccess(uint32_t num_workers) const { return 10 * names_.size() * num_workers; }
+
+private:
+  Stats::ScopeSharedPtr scope_;
+  std::vector<std::string> names_;
+  std::vector<Stats::StatName> stat_names_;
+};
+
+} // namespace Envoy
+
+// Tests the multi-threaded performance of looking up known stats on the worker
+// threads, which all contend on any lock taken in the lookup.
+//
+// Benchmark args: 1 to look up stats by string, 0 by StatName; number of workers.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StatsLookupContention(benchmark::State& state) {
+  if (!Envoy::Event::Libevent::Global::initialized()) {
+    Envoy::Event::Libevent::Global::initialize();
+  }
+  const bool by_string = state.range(0) == 1;
+  const uint32_t num_workers = state.range(1);
+  Envoy::ThreadLocalStoreContentionPerf context(num_workers);
+  // The first access populates the TLS caches.
+  context.accessCounters(by_string);
+
+  for (auto _ : state) { // NOLINT
+    context.accessCounters(by_string);
+  }
+  state.SetItemsProcessed(state.iterations() * context.lookupsPerAccess(num_workers));
+}
+BENCHMARK(BM_StatsLookupContention)
+    ->ArgsProduct({{0, 1}, {1, 2, 4, 8}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
@@ -67,6 +67,23 @@ public:
         },
         [num_tls_hist_cb, num_tls_histograms]() { num_tls_hist_cb(*num_tls_histograms); });
   }
+
+  // Calculates the number of stats cached by string name across all threads,
+  // with the same threading requirements as numTlsHistograms().
+  static void numTlsStringCachedStats(ThreadLocalStoreImpl& thread_local_store_impl,
+                                      const std::function<void(uint32_t)>& num_stats_cb) {
+    auto num_stats = std::make_shared<std::atomic<uint32_t>>(0);
+    thread_local_store_impl.tls_cache_->runOnAllThreads(
+        [num_stats](OptRef<ThreadLocalStoreImpl::TlsCache> tls_cache) {
+          for (const auto& id_entry : tls_cache->scope_cache_) {
+            const ThreadLocalStoreImpl::TlsCacheEntry& entry = id_entry.second;
+            *num_stats += entry.counters_by_string_.size() + entry.gauges_by_string_.size() +
+                          entry.histograms_by_string_.size() +
+                          entry.text_readouts_by_string_.size();
+          }
+        },
+        [num_stats_cb, num_stats]() { num_stats_cb(*num_stats); });
+  }
 };
 
 class StatsThreadLocalStoreTest : public testing::Test {
@@ -103,6 +120,21 @@ public:
     return num_tls_histograms;
   }
 
+  uint32_t numTlsStringCachedStats() {
+    uint32_t num_stats;
+    absl::Mutex mutex;
+    bool done = false;
+    ThreadLocalStoreTestingPeer::numTlsStringCachedStats(
+        *store_, [&mutex, &done, &num_stats](uint32_t num) {
+          absl::MutexLock lock(&mutex);
+          num_stats = num;
+          done = true;
+        });
+    absl::MutexLock lock(&mutex);
+    mutex.Await(absl::Condition(&done));
+    return num_stats;
+  }
+
   NiceMock<Server::Configuration::MockServerFactoryContext> context_;
   SymbolTableImpl symbol_table_;
   NiceMock<Event::MockDispatcher> main_thread_dispatcher_;
@@ -606,6 +638,61 @@ TEST_F(StatsThreadLocalStoreTest, ScopeDelete) {
   tls_.shutdownThread();
 }
 
+TEST_F(StatsThreadLocalStoreTest, StringLookupsCached) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+  EXPECT_EQ(0, numTlsStringCachedStats());
+
+  ScopeSharedPtr scope1 = store_->createScope("scope1.");
+  Counter& counter = scope1->counterFromString("counter");
+  EXPECT_EQ(&counter, &scope1->counterFromString("counter"));
+  Gauge& gauge = scope1->gaugeFromString("gauge", Gauge::ImportMode::Accumulate);
+  EXPECT_EQ(&gauge, &scope1->gaugeFromString("gauge", Gauge::ImportMode::Accumulate));
+  TextReadout& text_readout = scope1->textReadoutFromString("tr");
+  EXPECT_EQ(&text_readout, &scope1->textReadoutFromString("tr"));
+  Histogram& histogram = scope1->histogramFromString("histogram", Histogram::Unit::Unspecified);
+  EXPECT_EQ(&histogram, &scope1->histogramFromString("histogram", Histogram::Unit::Unspecified));
+  EXPECT_EQ(4, numTlsStringCachedStats());
+
+  // The cached stats are the same as the ones looked up by StatName.
+  StatNameManagedStorage counter_name("counter", symbol_table_);
+  EXPECT_EQ(&counter, &scope1->counterFromStatName(counter_name.statName()));
+  EXPECT_EQ("scope1.counter", counter.name());
+
+  // Names are cached per scope.
+  ScopeSharedPtr scope2 = store_->createScope("scope2.");
+  Counter& counter2 = scope2->counterFromString("counter");
+  EXPECT_NE(&counter, &counter2);
+  EXPECT_EQ("scope2.counter", counter2.name());
+  EXPECT_EQ(5, numTlsStringCachedStats());
+
+  // Hidden gauges are not cached.
+  Gauge& hidden = scope1->gaugeFromString("hidden", Gauge::ImportMode::HiddenAccumulate);
+  EXPECT_EQ(&hidden, &scope1->gaugeFromString("hidden", Gauge::ImportMode::HiddenAccumulate));
+  EXPECT_EQ(5, numTlsStringCachedStats());
+
+  tls_.shutdownGlobalThreading();
+  store_->shutdownThreading();
+  scope1.reset();
+  scope2.reset();
+  tls_.shutdownThread();
+}
+
+TEST_F(StatsThreadLocalStoreTest, StringLookupsNotCachedOnMainThread) {
+  InSequence s;
+  store_->initializeThreading(tls_.dispatcher_, tls_);
+
+  ScopeSharedPtr scope1 = store_->createScope("scope1.");
+  Counter& counter = scope1->counterFromString("counter");
+  EXPECT_EQ(&counter, &scope1->counterFromString("counter"));
+  EXPECT_EQ(0, numTlsStringCachedStats());
+
+  tls_.shutdownGlobalThreading();
+  store_->shutdownThreading();
+  scope1.reset();
+  tls_.shutdownThread();
+}
+
 TEST_F(StatsThreadLocalStoreTest, NestedScopes) {
   InSequence s;
   store_->initializeThreading(main_thread_dispatcher_, tls_);
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "source/common/common/utility.h"
+#include "source/common/tls/kernel_tls.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+struct KernelTlsTestParams {
+  uint16_t version_;
+  std::string cipher_suites_;
+};
+
+// Runs a handshake over a loopback TCP connection, as the kernel only supports TLS on TCP
+// sockets, and then offloads one side of the connection while the other side stays in BoringSSL.
+class KernelTlsTest : public testing::TestWithParam<KernelTlsTestParams> {
+public:
+  KernelTlsTest()
+      : server_ctx_(SSL_CTX_new(TLS_method())), client_ctx_(SSL_CTX_new(TLS_method())) {
+    const std::string cert_path = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem");
+    const std::string key_path = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem");
+    RELEASE_ASSERT(SSL_CTX_use_certificate_file(server_ctx_.get(), cert_path.c_str(),
+                                                SSL_FILETYPE_PEM) == 1,
+                   "");
+    RELEASE_ASSERT(
+        SSL_CTX_use_PrivateKey_file(server_ctx_.get(), key_path.c_str(), SSL_FILETYPE_PEM) == 1,
+        "");
+    for (SSL_CTX* ctx : {server_ctx_.get(), client_ctx_.get()}) {
+      RELEASE_ASSERT(SSL_CTX_set_min_proto_version(ctx, GetParam().version_) == 1, "");
+      RELEASE_ASSERT(SSL_CTX_set_max_proto_version(ctx, GetParam().version_) == 1, "");
+    }
+    if (!GetParam().cipher_suites_.empty()) {
+      RELEASE_ASSERT(
+          SSL_CTX_set_strict_cipher_list(client_ctx_.get(), GetParam().cipher_suites_.c_str()),
+          "");
+    }
+  }
+
+  ~KernelTlsTest() override {
+    ::close(client_fd_);
+    ::close(server_fd_);
+  }
+
+  void connect() {
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(listen_fd >= 0, "");
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    RELEASE_ASSERT(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0,
+                   "");
+    RELEASE_ASSERT(::listen(listen_fd, 1) == 0, "");
+    RELEASE_ASSERT(
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_length) == 0, "");
+    client_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(
+        ::connect(client_fd_, reinterpret_cast<sockaddr*>(&address), address_length) == 0, "");
+    server_fd_ = ::accept(listen_fd, nullptr, nullptr);
+    RELEASE_ASSERT(server_fd_ >= 0, "");
+    ::close(listen_fd);
+
+    client_ssl_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_fd(client_ssl_.get(), client_fd_);
+    SSL_set_connect_state(client_ssl_.get());
+    server_ssl_.reset(SSL_new(server_ctx_.get()));
+    SSL_set_fd(server_ssl_.get(), server_fd_);
+    SSL_set_accept_state(server_ssl_.get());
+
+    // Both sides handshake on this thread, so the sockets don't block during the handshake.
+    setBlocking(false);
+    bool client_done = false;
+    bool server_done = false;
+    for (int i = 0; i < 50 && !(client_done && server_done); i++) {
+      client_done = client_done || SSL_do_handshake(client_ssl_.get()) == 1;
+      server_done = server_done || SSL_do_handshake(server_ssl_.get()) == 1;
+    }
+    RELEASE_ASSERT(client_done && server_done, "handshake failed");
+    setBlocking(true);
+  }
+
+  void setBlocking(bool blocking) {
+    for (int fd : {client_fd_, server_fd_}) {
+      const int flags = ::fcntl(fd, F_GETFL, 0);
+      ::fcntl(fd, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+    }
+  }
+
+  // Offloads the writes of a connection, or skips the test where the kernel can't offload them.
+  bool enableTransmit(SSL* ssl, int fd) {
+    const absl::Status status = KernelTls::enableTransmit(ssl, fd);
+    if (status.code() == absl::StatusCode::kUnavailable ||
+        (status.code() == absl::StatusCode::kUnimplemented && GetParam().cipher_suites_.empty())) {
+      // The kernel has no TLS support, or BoringSSL chose ChaCha20-Poly1305 for TLS 1.3 for lack
+      // of AES hardware support.
+      return false;
+    }
+    EXPECT_TRUE(status.ok()) << status;
+    return status.ok();
+  }
+
+  std::string receive(int fd, uint8_t& record_type) {
+    char data[256];
+    Buffer::RawSlice slice{data, sizeof(data)};
+    const Api::SysCallSizeResult result = KernelTls::receive(fd, &slice, 1, record_type);
+    EXPECT_LE(0, result.return_value_) << errorDetails(result.errno_);
+    return {data, static_cast<size_t>(std::max<ssize_t>(result.return_value_, 0))};
+  }
+
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> server_ssl_;
+  bssl::UniquePtr<SSL> client_ssl_;
+  int client_fd_{-1};
+  int server_fd_{-1};
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    Versions, KernelTlsTest,
+    testing::Values(KernelTlsTestParams{TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256"},
+                    KernelTlsTestParams{TLS1_2_VERSION, "ECDHE-RSA-AES256-GCM-SHA384"},
+                    KernelTlsTestParams{TLS1_3_VERSION, ""}));
+
+// Records written by the kernel are read by BoringSSL, including the close_notify alert.
+TEST_P(KernelTlsTest, Transmit) {
+  connect();
+  // Write some records before the offload, so that the sequence numbers don't start at 0.
+  ASSERT_EQ(5, SSL_write(client_ssl_.get(), "hello", 5));
+  char data[16];
+  ASSERT_EQ(5, SSL_read(server_ssl_.get(), data, sizeof(data)));
+
+  if (!enableTransmit(client_ssl_.get(), client_fd_)) {
+    GTEST_SKIP() << "kernel TLS is not available";
+  }
+  ASSERT_EQ(5, ::write(client_fd_, "world", 5));
+  ASSERT_EQ(5, SSL_read(server_ssl_.get(), data, sizeof(data)));
+  EXPECT_EQ("world", absl::string_view(data, 5));
+
+  ASSERT_EQ(2, KernelTls::sendCloseNotify(client_fd_).return_value_);
+  const int rc = SSL_read(server_ssl_.get(), data, sizeof(data));
+  EXPECT_EQ(SSL_ERROR_ZERO_RETURN, SSL_get_error(server_ssl_.get(), rc));
+}
+
+// Records written by BoringSSL are read by the kernel, including the close_notify alert.
+TEST_P(KernelTlsTest, Receive) {
+  connect();
+  ASSERT_EQ(5, SSL_write(server_ssl_.get(), "hello", 5));
+  char data[16];
+  ASSERT_EQ(5, SSL_read(client_ssl_.get(), data, sizeof(data)));
+
+  if (!enableTransmit(server_ssl_.get(), server_fd_)) {
+    GTEST_SKIP() << "kernel TLS is not available";
+  }
+  ASSERT_TRUE(KernelTls::enableReceive(server_ssl_.get(), server_fd_).ok());
+
+  ASSERT_EQ(5, SSL_write(client_ssl_.get(), "world", 5));
+  uint8_t record_type;
+  EXPECT_EQ("world", receive(server_fd_, record_type));
+  EXPECT_EQ(KernelTls::RecordTypeApplicationData, record_type);
+
+  ASSERT_EQ(5, ::write(server_fd_, "again", 5));
+  ASSERT_EQ(5, SSL_read(client_ssl_.get(), data, sizeof(data)));
+  EXPECT_EQ("again", absl::string_view(data, 5));
+
+  SSL_shutdown(client_ssl_.get());
+  const std::string alert = receive(server_fd_, record_type);
+  EXPECT_EQ(KernelTls::RecordTypeAlert, record_type);
+  ASSERT_EQ(2U, alert.size());
+  EXPECT_EQ(SSL_AD_CLOSE_NOTIFY, alert[1]);
+}
+
+// Reads can't be offloaded once BoringSSL has buffered data past the handshake.
+TEST_P(KernelTlsTest, ReceivePendingData) {
+  connect();
+  ASSERT_EQ(5, SSL_write(client_ssl_.get(), "hello", 5));
+  char data[1];
+  ASSERT_EQ(1, SSL_read(server_ssl_.get(), data, sizeof(data)));
+
+  const absl::Status status = KernelTls::enableReceive(server_ssl_.get(), server_fd_);
+  EXPECT_EQ(absl::StatusCode::kFailedPrecondition, status.code());
+}
+
+// Connections without AES-GCM stay in userspace.
+TEST_P(KernelTlsTest, UnsupportedCipher) {
+  if (GetParam().version_ == TLS1_3_VERSION) {
+    GTEST_SKIP() << "TLS 1.3 cipher suites can't be configured";
+  }
+  ASSERT_TRUE(SSL_CTX_set_strict_cipher_list(client_ctx_.get(), "ECDHE-RSA-CHACHA20-POLY1305"));
+  connect();
+
+  const absl::Status status = KernelTls::enableTransmit(client_ssl_.get(), client_fd_);
+  EXPECT_EQ(absl::StatusCode::kUnimplemented, status.code());
+  // The connection is left untouched.
+  ASSERT_EQ(5, SSL_write(client_ssl_.get(), "hello", 5));
+  char data[16];
+  ASSERT_EQ(5, SSL_read(server_ssl_.get(), data, sizeof(data)));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
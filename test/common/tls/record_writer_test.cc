@@ -0,0 +1,165 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/tls/record_writer.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// The client writes its records with a RecordWriter, which the server reads with BoringSSL.
+class RecordWriterTest : public testing::Test {
+public:
+  RecordWriterTest()
+      : server_ctx_(SSL_CTX_new(TLS_method())), client_ctx_(SSL_CTX_new(TLS_method())) {
+    const std::string cert_path = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem");
+    const std::string key_path = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem");
+    RELEASE_ASSERT(SSL_CTX_use_certificate_file(server_ctx_.get(), cert_path.c_str(),
+                                                SSL_FILETYPE_PEM) == 1,
+                   "");
+    RELEASE_ASSERT(
+        SSL_CTX_use_PrivateKey_file(server_ctx_.get(), key_path.c_str(), SSL_FILETYPE_PEM) == 1,
+        "");
+  }
+
+  ~RecordWriterTest() override {
+    ::close(sockets_[0]);
+    ::close(sockets_[1]);
+  }
+
+  void connect(uint16_t version) {
+    for (SSL_CTX* ctx : {server_ctx_.get(), client_ctx_.get()}) {
+      RELEASE_ASSERT(SSL_CTX_set_min_proto_version(ctx, version) == 1, "");
+      RELEASE_ASSERT(SSL_CTX_set_max_proto_version(ctx, version) == 1, "");
+    }
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets_) == 0, "");
+    server_ssl_.reset(SSL_new(server_ctx_.get()));
+    SSL_set_fd(server_ssl_.get(), sockets_[0]);
+    SSL_set_accept_state(server_ssl_.get());
+    client_ssl_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_fd(client_ssl_.get(), sockets_[1]);
+    SSL_set_connect_state(client_ssl_.get());
+
+    bool client_done = false;
+    bool server_done = false;
+    for (int i = 0; i < 50 && !(client_done && server_done); i++) {
+      client_done = client_done || SSL_do_handshake(client_ssl_.get()) == 1;
+      server_done = server_done || SSL_do_handshake(server_ssl_.get()) == 1;
+    }
+    RELEASE_ASSERT(client_done && server_done, "handshake failed");
+  }
+
+  // Writes the whole output of the writer to the socket.
+  uint64_t writeOutput() {
+    const uint64_t length = writer_.output().length();
+    const std::string output = writer_.output().toString();
+    EXPECT_EQ(static_cast<ssize_t>(length), ::write(sockets_[1], output.data(), output.size()));
+    writer_.output().drain(length);
+    return length;
+  }
+
+  std::string read(uint64_t length) {
+    std::string data(length, '\0');
+    uint64_t bytes_read = 0;
+    while (bytes_read < length) {
+      const int rc = SSL_read(server_ssl_.get(), data.data() + bytes_read, length - bytes_read);
+      EXPECT_LT(0, rc);
+      if (rc <= 0) {
+        break;
+      }
+      bytes_read += rc;
+    }
+    return data;
+  }
+
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> server_ssl_;
+  bssl::UniquePtr<SSL> client_ssl_;
+  int sockets_[2]{-1, -1};
+  RecordWriter writer_;
+};
+
+TEST_F(RecordWriterTest, Supported) {
+  connect(TLS1_2_VERSION);
+  EXPECT_TRUE(RecordWriter::supported(client_ssl_.get()));
+}
+
+TEST_F(RecordWriterTest, UnsupportedTls13) {
+  connect(TLS1_3_VERSION);
+  EXPECT_FALSE(RecordWriter::supported(client_ssl_.get()));
+}
+
+// Records are coalesced across slices, and a batch is limited in size.
+TEST_F(RecordWriterTest, SealFromSlices) {
+  connect(TLS1_2_VERSION);
+  Buffer::OwnedImpl plaintext;
+  plaintext.appendSliceForTest(std::string(100, 'a'));
+  plaintext.appendSliceForTest(std::string(40000, 'b'));
+  plaintext.appendSliceForTest(std::string(10, 'c'));
+  plaintext.appendSliceForTest(std::string(30000, 'd'));
+  const std::string expected = plaintext.toString();
+  const uint64_t batch_length = RecordWriter::MaxRecordLength * RecordWriter::MaxRecordsPerBatch;
+
+  ASSERT_TRUE(writer_.seal(client_ssl_.get(), plaintext));
+  // The plaintext isn't drained until its records are written.
+  EXPECT_EQ(expected.size(), plaintext.length());
+  EXPECT_EQ(batch_length, writer_.onWritten(writeOutput()));
+  EXPECT_TRUE(writer_.empty());
+  plaintext.drain(batch_length);
+  EXPECT_EQ(expected.substr(0, batch_length), read(batch_length));
+
+  ASSERT_TRUE(writer_.seal(client_ssl_.get(), plaintext));
+  EXPECT_EQ(expected.size() - batch_length, writer_.onWritten(writeOutput()));
+  EXPECT_EQ(expected.substr(batch_length), read(expected.size() - batch_length));
+}
+
+// The plaintext of a record is only reported as written once the whole record is written.
+TEST_F(RecordWriterTest, PartialWrites) {
+  connect(TLS1_2_VERSION);
+  Buffer::OwnedImpl plaintext(std::string(RecordWriter::MaxRecordLength + 100, 'a'));
+  ASSERT_TRUE(writer_.seal(client_ssl_.get(), plaintext));
+  const uint64_t length = writer_.output().length();
+  EXPECT_LT(RecordWriter::MaxRecordLength + 100, length);
+
+  EXPECT_EQ(0U, writer_.onWritten(1));
+  EXPECT_EQ(RecordWriter::MaxRecordLength, writer_.onWritten(length - 2));
+  EXPECT_EQ(100U, writer_.onWritten(1));
+}
+
+// Records written by BoringSSL put the writer out of sync until it is told about them.
+TEST_F(RecordWriterTest, Sync) {
+  connect(TLS1_2_VERSION);
+  EXPECT_FALSE(writer_.inSync(client_ssl_.get()));
+  writer_.sync(client_ssl_.get());
+  EXPECT_TRUE(writer_.inSync(client_ssl_.get()));
+
+  ASSERT_EQ(5, SSL_write(client_ssl_.get(), "hello", 5));
+  EXPECT_FALSE(writer_.inSync(client_ssl_.get()));
+  writer_.sync(client_ssl_.get());
+
+  Buffer::OwnedImpl plaintext("world");
+  ASSERT_TRUE(writer_.seal(client_ssl_.get(), plaintext));
+  EXPECT_TRUE(writer_.inSync(client_ssl_.get()));
+  EXPECT_EQ(5U, writer_.onWritten(writeOutput()));
+  EXPECT_EQ("helloworld", read(10));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
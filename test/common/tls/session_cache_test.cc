@@ -0,0 +1,154 @@
+#include "source/common/tls/session_cache.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class ClientSessionCacheTest : public testing::Test {
+public:
+  ClientSessionCacheTest() : ssl_ctx_(SSL_CTX_new(TLS_method())) {}
+
+  bssl::UniquePtr<SSL_SESSION> newSession(uint16_t version = TLS1_2_VERSION) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ssl_ctx_.get()));
+    SSL_SESSION_set_protocol_version(session.get(), version);
+    return session;
+  }
+
+  std::unique_ptr<ClientSessionCache> makeCache(size_t max_sessions_per_key, size_t max_keys,
+                                                KeyValueStorePtr store = nullptr) {
+    return std::make_unique<ClientSessionCache>(*store_.rootScope(), max_sessions_per_key,
+                                                max_keys, dispatcher_, std::move(store),
+                                                ssl_ctx_.get());
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counter("ssl.session_cache." + name).value();
+  }
+
+  uint64_t hosts() {
+    return store_.gauge("ssl.session_cache.hosts", Stats::Gauge::ImportMode::NeverImport).value();
+  }
+
+  Stats::TestUtil::TestStore store_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+};
+
+// Sessions are only returned for the key they were inserted with.
+TEST_F(ClientSessionCacheTest, SessionsArePerKey) {
+  auto cache = makeCache(1, 1024);
+  bssl::UniquePtr<SSL_SESSION> session = newSession();
+  SSL_SESSION* session_ptr = session.get();
+  cache->insert("10.0.0.1:443/example.com", std::move(session));
+
+  EXPECT_EQ(nullptr, cache->lookup("10.0.0.2:443/example.com"));
+  EXPECT_EQ(nullptr, cache->lookup("10.0.0.1:443/other.example.com"));
+  EXPECT_EQ(session_ptr, cache->lookup("10.0.0.1:443/example.com").get());
+  // Multi-use sessions stay in the cache.
+  EXPECT_EQ(session_ptr, cache->lookup("10.0.0.1:443/example.com").get());
+
+  EXPECT_EQ(2, counter("hit"));
+  EXPECT_EQ(2, counter("miss"));
+  EXPECT_EQ(1, hosts());
+  cache.reset();
+  EXPECT_EQ(0, hosts());
+}
+
+// The most recently inserted session is used first, and the oldest sessions are evicted once a key
+// holds the maximum number of sessions.
+TEST_F(ClientSessionCacheTest, MaxSessionsPerKey) {
+  auto cache = makeCache(2, 1024);
+  std::vector<SSL_SESSION*> sessions;
+  for (int i = 0; i < 3; ++i) {
+    bssl::UniquePtr<SSL_SESSION> session = newSession(TLS1_3_VERSION);
+    sessions.push_back(session.get());
+    cache->insert("host", std::move(session));
+  }
+
+  // TLS 1.3 sessions are single use, so each lookup consumes the session it returns.
+  bssl::UniquePtr<SSL_SESSION> first = cache->lookup("host");
+  EXPECT_EQ(sessions[2], first.get());
+  bssl::UniquePtr<SSL_SESSION> second = cache->lookup("host");
+  EXPECT_EQ(sessions[1], second.get());
+  EXPECT_EQ(nullptr, cache->lookup("host"));
+  EXPECT_EQ(0, hosts());
+}
+
+// The least recently used keys are evicted once the cache holds the maximum number of keys.
+TEST_F(ClientSessionCacheTest, MaxKeys) {
+  // Allows a single key per shard.
+  auto cache = makeCache(1, 1);
+  constexpr uint64_t num_keys = 100;
+  for (uint64_t i = 0; i < num_keys; ++i) {
+    const std::string key = absl::StrCat("host", i);
+    cache->insert(key, newSession());
+    // The key that was just inserted is the most recently used one of its shard.
+    EXPECT_NE(nullptr, cache->lookup(key));
+  }
+
+  EXPECT_LE(hosts(), ClientSessionCache::NumShards);
+  EXPECT_EQ(num_keys, hosts() + counter("evicted"));
+}
+
+// Evicted keys are removed from the store.
+TEST_F(ClientSessionCacheTest, PersistEviction) {
+  auto store = std::make_unique<NiceMock<MockKeyValueStore>>();
+  MockKeyValueStore& store_ref = *store;
+  std::vector<std::string> removed_keys;
+  EXPECT_CALL(store_ref, remove(_)).WillRepeatedly(Invoke([&](absl::string_view key) {
+    removed_keys.emplace_back(key);
+  }));
+  auto cache = makeCache(1, 1, std::move(store));
+
+  constexpr uint64_t num_keys = 100;
+  for (uint64_t i = 0; i < num_keys; ++i) {
+    cache->insert(absl::StrCat("host", i), newSession());
+  }
+  EXPECT_EQ(counter("evicted"), removed_keys.size());
+  for (const std::string& key : removed_keys) {
+    EXPECT_EQ(nullptr, cache->lookup(key));
+  }
+}
+
+// Consuming the last single use session of a key removes the key from the store.
+TEST_F(ClientSessionCacheTest, PersistSingleUseLookup) {
+  auto store = std::make_unique<NiceMock<MockKeyValueStore>>();
+  EXPECT_CALL(*store, remove(absl::string_view("host")));
+  auto cache = makeCache(1, 1024, std::move(store));
+
+  cache->insert("host", newSession(TLS1_3_VERSION));
+  EXPECT_NE(nullptr, cache->lookup("host"));
+}
+
+// Invalid persisted sessions are ignored when loading the store.
+TEST_F(ClientSessionCacheTest, LoadInvalidSession) {
+  auto store = std::make_unique<NiceMock<MockKeyValueStore>>();
+  EXPECT_CALL(*store, iterate(_)).WillOnce(Invoke([](KeyValueStore::ConstIterateCb cb) {
+    cb("host", "not a session");
+  }));
+  auto cache = makeCache(1, 1024, std::move(store));
+
+  EXPECT_EQ(0, counter("loaded"));
+  EXPECT_EQ(0, hosts());
+  EXPECT_EQ(nullptr, cache->lookup("host"));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -13,6 +13,7 @@
 #include "source/common/json/json_loader.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/socket_option_impl.h"
 #include "source/common/network/tcp_listener_impl.h"
 #include "source/common/network/transport_socket_options_impl.h"
 #include "source/common/network/utility.h"
@@ -43,6 +44,7 @@
 #include "test/common/tls/test_data/san_uri_cert_info.h"
 #include "test/common/tls/test_data/selfsigned_ecdsa_p256_cert_info.h"
 #include "test/common/tls/test_private_key_method_provider.h"
+#include "test/integration/socket_interface_swap.h"
 #include "test/mocks/buffer/mocks.h"
 #include "test/mocks/init/mocks.h"
 #include "test/mocks/local_info/mocks.h"
@@ -1209,6 +1211,9 @@ protected:
                                    const std::string& client_ctx_yaml, bool expect_reuse,
                                    const Network::Address::IpVersion version);
 
+  void testKernelTlsHalfClose(const std::string& client_ctx_yaml, bool expect_fallback);
+  void testTls12LargeWrite();
+
   Network::ListenerPtr createListener(Network::SocketSharedPtr&& socket,
                                       Network::TcpListenerCallbacks& cb, Runtime::Loader& runtime,
                                       const Network::ListenerConfig& listener_config,
@@ -3732,6 +3737,309 @@ TEST_P(SslSocketTest, HalfClose) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+void SslSocketTest::testKernelTlsHalfClose(const std::string& client_ctx_yaml,
+                                           bool expect_fallback) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+)EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = *ServerContextConfigImpl::create(server_tls_context, factory_context_, false);
+  NiceMock<Server::Configuration::MockServerFactoryContext> server_factory_context;
+  ContextManagerImpl manager(server_factory_context);
+  Stats::TestUtil::TestStore server_stats_store;
+  auto server_ssl_socket_factory = *ServerSslSocketFactory::create(
+      std::move(server_cfg), manager, *server_stats_store.rootScope(), std::vector<std::string>{});
+
+  auto socket = std::make_shared<Network::Test::TcpListenSocketImmediateListen>(
+      Network::Test::getCanonicalLoopbackAddress(version_));
+  Network::MockTcpListenerCallbacks listener_callbacks;
+  NiceMock<Network::MockListenerConfig> listener_config;
+  Server::ThreadLocalOverloadStateOptRef overload_state;
+  Network::ListenerPtr listener = createListener(socket, listener_callbacks, runtime_,
+                                                 listener_config, overload_state, *dispatcher_);
+  std::shared_ptr<Network::MockReadFilter> server_read_filter(new Network::MockReadFilter());
+  std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), tls_context);
+  auto client_cfg = *ClientContextConfigImpl::create(tls_context, factory_context_);
+  Stats::TestUtil::TestStore client_stats_store;
+  auto client_ssl_socket_factory = *ClientSslSocketFactory::create(std::move(client_cfg), manager,
+                                                                   *client_stats_store.rootScope());
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket->connectionInfoProvider().localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory->createTransportSocket(nullptr, nullptr), nullptr, nullptr);
+  client_connection->enableHalfClose(true);
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->connect();
+  Network::MockConnectionCallbacks client_connection_callbacks;
+  client_connection->addConnectionCallbacks(client_connection_callbacks);
+
+  // Large enough to span many records.
+  const std::string request(100000, 'a');
+  Network::ConnectionPtr server_connection;
+  Network::MockConnectionCallbacks server_connection_callbacks;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory->createDownstreamTransportSocket(),
+            stream_info_);
+        server_connection->enableHalfClose(true);
+        server_connection->addReadFilter(server_read_filter);
+        server_connection->addConnectionCallbacks(server_connection_callbacks);
+        Buffer::OwnedImpl data("hello");
+        server_connection->write(data, true);
+      }));
+  EXPECT_CALL(listener_callbacks, recordConnectionsAcceptedOnSocketEvent(_));
+
+  EXPECT_CALL(*server_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(*client_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("hello"), true))
+      .WillOnce(Invoke([&](Buffer::Instance&, bool) -> Network::FilterStatus {
+        Buffer::OwnedImpl buffer(request);
+        client_connection->write(buffer, true);
+        return Network::FilterStatus::Continue;
+      }));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+  std::string received;
+  EXPECT_CALL(*server_read_filter, onData(_, _))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool end_stream) {
+        received.append(data.toString());
+        data.drain(data.length());
+        if (end_stream) {
+          EXPECT_EQ(request, received);
+        }
+        return Network::FilterStatus::Continue;
+      }));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(request, received);
+
+  // Whether the connections are offloaded depends on the kernel, but they are always accounted
+  // for.
+  for (Stats::TestUtil::TestStore* store : {&server_stats_store, &client_stats_store}) {
+    const uint64_t transmit = store->counter("ssl.ktls_transmit").value();
+    const uint64_t fallback = store->counter("ssl.ktls_fallback").value();
+    EXPECT_EQ(1, transmit + fallback);
+    EXPECT_LE(store->counter("ssl.ktls_receive").value(), transmit);
+    if (expect_fallback) {
+      EXPECT_EQ(1, fallback);
+    }
+  }
+}
+
+// Data and close_notify alerts flow in both directions with kernel TLS offload on TLS 1.2.
+TEST_P(SslSocketTest, KernelTlsOffloadTls12HalfClose) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-AES128-GCM-SHA256
+)EOF";
+  testKernelTlsHalfClose(client_ctx_yaml, false);
+}
+
+// Data and close_notify alerts flow in both directions with kernel TLS offload on TLS 1.3, where
+// reads of the client stay in userspace.
+TEST_P(SslSocketTest, KernelTlsOffloadTls13HalfClose) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+)EOF";
+  testKernelTlsHalfClose(client_ctx_yaml, false);
+}
+
+// Connections with ciphers the kernel doesn't support stay in userspace.
+TEST_P(SslSocketTest, KernelTlsOffloadUnsupportedCipher) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-CHACHA20-POLY1305
+)EOF";
+  testKernelTlsHalfClose(client_ctx_yaml, true);
+}
+
+// Connections whose sockets are handled by IO handles other than the default one stay in
+// userspace, as offloaded reads would bypass them.
+TEST_P(SslSocketTest, KernelTlsOffloadUnsupportedIoHandle) {
+  SocketInterfaceSwap socket_interface_swap(Network::Socket::Type::Stream);
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-AES128-GCM-SHA256
+)EOF";
+  testKernelTlsHalfClose(client_ctx_yaml, true);
+}
+
+// Sends a large write from a TLS 1.2 AES-GCM client through small socket buffers, so that the
+// socket only takes part of the records at a time, and the last record is only partially filled.
+void SslSocketTest::testTls12LargeWrite() {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+)EOF";
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-AES128-GCM-SHA256
+)EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = *ServerContextConfigImpl::create(server_tls_context, factory_context_, false);
+  NiceMock<Server::Configuration::MockServerFactoryContext> server_factory_context;
+  ContextManagerImpl manager(server_factory_context);
+  Stats::TestUtil::TestStore server_stats_store;
+  auto server_ssl_socket_factory = *ServerSslSocketFactory::create(
+      std::move(server_cfg), manager, *server_stats_store.rootScope(), std::vector<std::string>{});
+
+  auto socket = std::make_shared<Network::Test::TcpListenSocketImmediateListen>(
+      Network::Test::getCanonicalLoopbackAddress(version_));
+  // Accepted sockets inherit the receive buffer size of the listen socket.
+  const int buffer_size = 16384;
+  ASSERT_EQ(0, socket->ioHandle()
+                   .setOption(SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size))
+                   .return_value_);
+  Network::MockTcpListenerCallbacks listener_callbacks;
+  NiceMock<Network::MockListenerConfig> listener_config;
+  Server::ThreadLocalOverloadStateOptRef overload_state;
+  Network::ListenerPtr listener = createListener(socket, listener_callbacks, runtime_,
+                                                 listener_config, overload_state, *dispatcher_);
+  std::shared_ptr<Network::MockReadFilter> server_read_filter(new Network::MockReadFilter());
+  std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), tls_context);
+  auto client_cfg = *ClientContextConfigImpl::create(tls_context, factory_context_);
+  Stats::TestUtil::TestStore client_stats_store;
+  auto client_ssl_socket_factory = *ClientSslSocketFactory::create(std::move(client_cfg), manager,
+                                                                   *client_stats_store.rootScope());
+  auto client_options = std::make_shared<Network::Socket::Options>();
+  client_options->push_back(std::make_shared<Network::SocketOptionImpl>(
+      envoy::config::core::v3::SocketOption::STATE_PREBIND,
+      ENVOY_MAKE_SOCKET_OPTION_NAME(SOL_SOCKET, SO_SNDBUF), buffer_size));
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket->connectionInfoProvider().localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory->createTransportSocket(nullptr, nullptr), client_options,
+      nullptr);
+  client_connection->enableHalfClose(true);
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->connect();
+  Network::MockConnectionCallbacks client_connection_callbacks;
+  client_connection->addConnectionCallbacks(client_connection_callbacks);
+
+  // Many times the socket buffers, and not a multiple of the record size. The client and the
+  // server share the dispatcher, so the client can't write it all before the server reads.
+  std::string request(4 * 1024 * 1024 + 1234, 0);
+  for (size_t i = 0; i < request.size(); ++i) {
+    request[i] = 'a' + i % 26;
+  }
+  Network::ConnectionPtr server_connection;
+  Network::MockConnectionCallbacks server_connection_callbacks;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory->createDownstreamTransportSocket(),
+            stream_info_);
+        server_connection->enableHalfClose(true);
+        server_connection->addReadFilter(server_read_filter);
+        server_connection->addConnectionCallbacks(server_connection_callbacks);
+        Buffer::OwnedImpl data("hello");
+        server_connection->write(data, true);
+      }));
+  EXPECT_CALL(listener_callbacks, recordConnectionsAcceptedOnSocketEvent(_));
+
+  EXPECT_CALL(*server_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(*client_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("hello"), true))
+      .WillOnce(Invoke([&](Buffer::Instance&, bool) -> Network::FilterStatus {
+        Buffer::OwnedImpl buffer(request);
+        client_connection->write(buffer, true);
+        return Network::FilterStatus::Continue;
+      }));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+  std::string received;
+  EXPECT_CALL(*server_read_filter, onData(_, _))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) {
+        received.append(data.toString());
+        data.drain(data.length());
+        return Network::FilterStatus::Continue;
+      }));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(request, received);
+  EXPECT_EQ(0, client_stats_store.counter("ssl.connection_error").value());
+}
+
+// A large TLS 1.2 AES-GCM write, partially taken by the socket, arrives intact when the records
+// are sealed.
+TEST_P(SslSocketTest, SealRecordsTls12LargeWrite) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.tls_seal_records", "true"}});
+  testTls12LargeWrite();
+}
+
+// A large TLS 1.2 AES-GCM write, partially taken by the socket, arrives intact when the records
+// are written with SSL_write.
+TEST_P(SslSocketTest, SealRecordsDisabledTls12LargeWrite) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.tls_seal_records", "false"}});
+  testTls12LargeWrite();
+}
+
+// TLS 1.2 connections staying in userspace seal their records by default, and write them with
+// SSL_write when the runtime guard is disabled.
+TEST_P(SslSocketTest, SealRecordsDisabledHalfClose) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.tls_seal_records", "false"}});
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-CHACHA20-POLY1305
+)EOF";
+  testKernelTlsHalfClose(client_ctx_yaml, true);
+}
+
 TEST_P(SslSocketTest, ShutdownWithCloseNotify) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -5230,6 +5538,58 @@ TEST_P(SslSocketTest, ClientSessionResumptionEnabledTls13) {
   testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, version_);
 }
 
+// Test client session resumption with the per host session cache.
+TEST_P(SslSocketTest, ClientSessionResumptionSessionCacheTls12) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+  max_session_keys: 2
+  session_cache: {}
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, version_);
+}
+
+TEST_P(SslSocketTest, ClientSessionResumptionSessionCacheTls13) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+  max_session_keys: 2
+  session_cache:
+    max_hosts: 16
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, version_);
+}
+
 TEST_P(SslSocketTest, SslError) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -7311,6 +7671,90 @@ TEST_P(SslSocketTest, EcdsaPrivateKeyProviderSuccess) {
   testUtil(test_options.setPrivateKeyMethodExpected(true));
 }
 
+// Test signing (ECDHE) on the thread pool private key provider.
+TEST_P(SslSocketTest, ThreadPoolPrivateKeyProviderRsaSignSuccess) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key_provider:
+        provider_name: envoy.tls.key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.extensions.transport_sockets.tls.v3.ThreadPoolPrivateKeyMethodConfig
+          private_key:
+            filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+          num_threads: 2
+)EOF";
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      cipher_suites:
+      - ECDHE-RSA-AES128-GCM-SHA256
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, version_);
+  testUtil(test_options.setPrivateKeyMethodExpected(true));
+}
+
+// Test decryption (RSA) on the thread pool private key provider.
+TEST_P(SslSocketTest, ThreadPoolPrivateKeyProviderRsaDecryptSuccess) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      cipher_suites:
+      - TLS_RSA_WITH_AES_128_GCM_SHA256
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key_provider:
+        provider_name: envoy.tls.key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.extensions.transport_sockets.tls.v3.ThreadPoolPrivateKeyMethodConfig
+          private_key:
+            filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+)EOF";
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      cipher_suites:
+      - TLS_RSA_WITH_AES_128_GCM_SHA256
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, version_);
+  testUtil(test_options.setPrivateKeyMethodExpected(true));
+}
+
+// Test ECDSA signing with TLS 1.3 on the thread pool private key provider, with a single thread.
+TEST_P(SslSocketTest, ThreadPoolPrivateKeyProviderEcdsaSignSuccess) {
+  const std::string client_ctx_yaml = absl::StrCat(R"EOF(
+    common_tls_context:
+      tls_params:
+        tls_minimum_protocol_version: TLSv1_3
+        tls_maximum_protocol_version: TLSv1_3
+      validation_context:
+        verify_certificate_hash: )EOF",
+                                                   TEST_SELFSIGNED_ECDSA_P256_CERT_256_HASH);
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/selfsigned_ecdsa_p256_cert.pem"
+      private_key_provider:
+        provider_name: envoy.tls.key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.extensions.transport_sockets.tls.v3.ThreadPoolPrivateKeyMethodConfig
+          private_key:
+            filename: "{{ test_rundir }}/test/common/tls/test_data/selfsigned_ecdsa_p256_key.pem"
+          num_threads: 1
+          max_pending_operations: 1
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, version_);
+  testUtil(test_options.setPrivateKeyMethodExpected(true));
+}
+
 // Test having two certs with different private key method modes. It's expected that the ECDSA
 // provider mode is being used. RSA provider mode is set to fail with "async_method_error", but
 // that's not happening.
@@ -0,0 +1,153 @@
+#include "source/common/tls/private_key/thread_pool_private_key_provider.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ecdsa.h"
+#include "openssl/pem.h"
+#include "openssl/sha.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class MockPrivateKeyConnectionCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  MOCK_METHOD(void, onPrivateKeyMethodComplete, ());
+};
+
+class PrivateKeyOperationPoolTest : public testing::Test {
+public:
+  PrivateKeyOperationPoolTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        stats_(PrivateKeyOperationPoolManager::generateStats(*store_.rootScope())) {
+    bssl::UniquePtr<EC_KEY> ec_key(EC_KEY_new_by_curve_name(NID_X9_62_prime256v1));
+    RELEASE_ASSERT(EC_KEY_generate_key(ec_key.get()), "");
+    pkey_.reset(EVP_PKEY_new());
+    RELEASE_ASSERT(EVP_PKEY_assign_EC_KEY(pkey_.get(), ec_key.release()), "");
+  }
+
+  PrivateKeyOperationSharedPtr newOperation() {
+    auto operation = std::make_shared<PrivateKeyOperation>(*dispatcher_, callbacks_,
+                                                           bssl::UpRef(pkey_), input_, 4);
+    operation->signature_algorithm_ = SSL_SIGN_ECDSA_SECP256R1_SHA256;
+    return operation;
+  }
+
+  const uint8_t input_[4] = {1, 2, 3, 4};
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Stats::TestUtil::TestStore store_;
+  PrivateKeyOperationPoolStats stats_;
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  testing::StrictMock<MockPrivateKeyConnectionCallbacks> callbacks_;
+};
+
+// Operations are run on the pool and handed back to the worker.
+TEST_F(PrivateKeyOperationPoolTest, Sign) {
+  PrivateKeyOperationPool pool(api_->threadFactory(), 2, 16, 4, stats_);
+  std::vector<PrivateKeyOperationSharedPtr> operations;
+  for (int i = 0; i < 8; ++i) {
+    operations.push_back(newOperation());
+    EXPECT_TRUE(pool.enqueue(operations.back()));
+  }
+
+  int completed = 0;
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(8).WillRepeatedly([&]() {
+    if (++completed == 8) {
+      dispatcher_->exit();
+    }
+  });
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+
+  for (const PrivateKeyOperationSharedPtr& operation : operations) {
+    EXPECT_TRUE(operation->done_);
+    EXPECT_TRUE(operation->succeeded_);
+    bssl::UniquePtr<EC_KEY> ec_key(EVP_PKEY_get1_EC_KEY(pkey_.get()));
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256(input_, sizeof(input_), digest);
+    EXPECT_EQ(1, ECDSA_verify(0, digest, sizeof(digest), operation->out_.data(),
+                              operation->out_.size(), ec_key.get()));
+  }
+  EXPECT_LE(2, stats_.batches_.value());
+  EXPECT_EQ(0, stats_.pending_.value());
+}
+
+// Operations are refused once the maximum number of operations are pending.
+TEST_F(PrivateKeyOperationPoolTest, MaxPendingOperations) {
+  // Without threads, no operation is ever taken from the queue.
+  PrivateKeyOperationPool pool(api_->threadFactory(), 0, 2, 4, stats_);
+  EXPECT_TRUE(pool.enqueue(newOperation()));
+  EXPECT_TRUE(pool.enqueue(newOperation()));
+  EXPECT_FALSE(pool.enqueue(newOperation()));
+  EXPECT_EQ(2, stats_.pending_.value());
+}
+
+// Cancelled operations are never handed back.
+TEST_F(PrivateKeyOperationPoolTest, Cancel) {
+  PrivateKeyOperationPool pool(api_->threadFactory(), 1, 16, 4, stats_);
+  PrivateKeyOperationSharedPtr cancelled = newOperation();
+  PrivateKeyOperationSharedPtr operation = newOperation();
+  pool.cancel(*cancelled);
+  EXPECT_TRUE(pool.enqueue(cancelled));
+  EXPECT_TRUE(pool.enqueue(operation));
+
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).WillOnce([&]() { dispatcher_->exit(); });
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_TRUE(operation->done_);
+  EXPECT_FALSE(cancelled->done_);
+}
+
+// Providers with the same pool settings share one pool.
+TEST_F(PrivateKeyOperationPoolTest, ProvidersSharePool) {
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  ON_CALL(factory_context.api_, threadFactory())
+      .WillByDefault(testing::ReturnRef(Thread::threadFactoryForTest()));
+
+  bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
+  RELEASE_ASSERT(
+      PEM_write_bio_PrivateKey(bio.get(), pkey_.get(), nullptr, nullptr, 0, nullptr, nullptr), "");
+  const uint8_t* pem;
+  size_t pem_len;
+  RELEASE_ASSERT(BIO_mem_contents(bio.get(), &pem, &pem_len), "");
+  envoy::extensions::transport_sockets::tls::v3::ThreadPoolPrivateKeyMethodConfig config;
+  config.mutable_private_key()->set_inline_string(reinterpret_cast<const char*>(pem), pem_len);
+  config.mutable_num_threads()->set_value(2);
+
+  auto provider1 = std::make_unique<ThreadPoolPrivateKeyMethodProvider>(config, factory_context);
+  auto provider2 = std::make_unique<ThreadPoolPrivateKeyMethodProvider>(config, factory_context);
+  EXPECT_EQ(&provider1->pool(), &provider2->pool());
+
+  config.mutable_num_threads()->set_value(1);
+  auto provider3 = std::make_unique<ThreadPoolPrivateKeyMethodProvider>(config, factory_context);
+  EXPECT_NE(&provider1->pool(), &provider3->pool());
+
+  // The pool is kept while any provider uses it.
+  config.mutable_num_threads()->set_value(2);
+  provider1.reset();
+  auto provider4 = std::make_unique<ThreadPoolPrivateKeyMethodProvider>(config, factory_context);
+  EXPECT_EQ(&provider2->pool(), &provider4->pool());
+}
+
+// Operations with a key that doesn't match the signature algorithm fail.
+TEST_F(PrivateKeyOperationPoolTest, WrongKeyType) {
+  PrivateKeyOperationSharedPtr operation = newOperation();
+  operation->signature_algorithm_ = SSL_SIGN_RSA_PSS_RSAE_SHA256;
+  EXPECT_FALSE(operation->run());
+  // Decryption requires an RSA key.
+  operation->signature_algorithm_ = absl::nullopt;
+  EXPECT_FALSE(operation->run());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -1,6 +1,16 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/tls/kernel_tls.h"
+#include "source/common/tls/private_key/thread_pool_private_key_provider.h"
+#include "source/common/tls/record_writer.h"
 
+#include "test/mocks/server/transport_socket_factory_context.h"
 #include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
 
 #include "benchmark/benchmark.h"
 #include "openssl/ssl.h"
@@ -192,5 +202,426 @@ static void testParams(benchmark::internal::Benchmark* b) {
 
 BENCHMARK(testThroughput)->Unit(::benchmark::kMicrosecond)->Apply(testParams);
 
+namespace {
+
+// A client and server connection pair, handshaking over a socket pair.
+struct HandshakePair : public Ssl::PrivateKeyConnectionCallbacks {
+  HandshakePair(SSL_CTX* client_ctx, SSL_CTX* server_ctx)
+      : client_ssl_(SSL_new(client_ctx)), server_ssl_(SSL_new(server_ctx)) {
+    socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets_);
+    SSL_set_fd(server_ssl_.get(), sockets_[0]);
+    SSL_set_accept_state(server_ssl_.get());
+    SSL_set_fd(client_ssl_.get(), sockets_[1]);
+    SSL_set_connect_state(client_ssl_.get());
+  }
+  ~HandshakePair() override {
+    ::close(sockets_[0]);
+    ::close(sockets_[1]);
+  }
+
+  // Ssl::PrivateKeyConnectionCallbacks
+  void onPrivateKeyMethodComplete() override {}
+
+  bssl::UniquePtr<SSL> client_ssl_;
+  bssl::UniquePtr<SSL> server_ssl_;
+  int sockets_[2];
+  bool client_done_{};
+  bool server_done_{};
+};
+
+} // namespace
+
+// Runs full handshakes for many connections at once, like a worker after a load balancer failover.
+// The server's private key operations are run inline, or on the thread pool private key provider if
+// it has threads. The time spent in server handshakes measures how long the worker is kept from
+// processing other connections.
+static void testHandshakes(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  const bool ecdsa = state.range(0);
+  const uint32_t num_threads = state.range(1);
+  const uint32_t num_connections = state.range(2);
+  const std::string key_name = ecdsa ? "selfsigned_ecdsa_p256" : "san_dns";
+
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  std::string cert_path = TestEnvironment::substitute(
+      absl::StrCat("{{ test_rundir }}/test/common/tls/test_data/", key_name, "_cert.pem"));
+  std::string key_path = TestEnvironment::substitute(
+      absl::StrCat("{{ test_rundir }}/test/common/tls/test_data/", key_name, "_key.pem"));
+  auto err = SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM);
+  drainErrorQueue();
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  ON_CALL(factory_context.server_context_, api()).WillByDefault(testing::ReturnRef(*api));
+  std::unique_ptr<ThreadPoolPrivateKeyMethodProvider> provider;
+  if (num_threads > 0) {
+    envoy::extensions::transport_sockets::tls::v3::ThreadPoolPrivateKeyMethodConfig config;
+    config.mutable_private_key()->set_filename(key_path);
+    config.mutable_num_threads()->set_value(num_threads);
+    provider = std::make_unique<ThreadPoolPrivateKeyMethodProvider>(config, factory_context);
+    SSL_CTX_set_private_key_method(server_ctx.get(),
+                                   provider->getBoringSslPrivateKeyMethod().get());
+  } else {
+    err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
+    RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
+  }
+
+  std::chrono::nanoseconds server_time{};
+  uint64_t handshakes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    std::vector<std::unique_ptr<HandshakePair>> pairs;
+    for (uint32_t i = 0; i < num_connections; ++i) {
+      pairs.push_back(std::make_unique<HandshakePair>(client_ctx.get(), server_ctx.get()));
+      if (provider != nullptr) {
+        provider->registerPrivateKeyMethod(pairs.back()->server_ssl_.get(), *pairs.back(),
+                                           *dispatcher);
+      }
+    }
+    state.ResumeTiming();
+
+    uint32_t num_done = 0;
+    while (num_done < num_connections) {
+      for (auto& pair : pairs) {
+        if (!pair->client_done_) {
+          int rc = SSL_do_handshake(pair->client_ssl_.get());
+          handleSslError(pair->client_ssl_.get(), rc, false);
+          pair->client_done_ = rc == 1;
+        }
+        if (!pair->server_done_) {
+          const auto start = std::chrono::steady_clock::now(); // NO_CHECK_FORMAT(real_time)
+          int rc = SSL_do_handshake(pair->server_ssl_.get());
+          server_time += std::chrono::steady_clock::now() - start; // NO_CHECK_FORMAT(real_time)
+          if (SSL_get_error(pair->server_ssl_.get(), rc) != SSL_ERROR_WANT_PRIVATE_KEY_OPERATION) {
+            handleSslError(pair->server_ssl_.get(), rc, true);
+          }
+          pair->server_done_ = rc == 1;
+        }
+      }
+      num_done = std::count_if(pairs.begin(), pairs.end(), [](const auto& pair) {
+        return pair->client_done_ && pair->server_done_;
+      });
+      // Deliver the completed private key operations.
+      dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    }
+    handshakes += num_connections;
+
+    state.PauseTiming();
+    if (provider != nullptr) {
+      for (auto& pair : pairs) {
+        provider->unregisterPrivateKeyMethod(pair->server_ssl_.get());
+      }
+    }
+    pairs.clear();
+    state.ResumeTiming();
+  }
+  state.counters["handshakes"] = benchmark::Counter(handshakes, benchmark::Counter::kIsRate);
+  state.counters["server_us_per_handshake"] =
+      std::chrono::duration<double, std::micro>(server_time).count() / handshakes;
+}
+
+static void handshakeParams(benchmark::internal::Benchmark* b) {
+  for (auto ecdsa : {false, true}) {
+    for (auto num_threads : {0, 1, 4}) {
+      for (auto num_connections : {1, 64}) {
+        b->Args({ecdsa, num_threads, num_connections});
+      }
+    }
+  }
+}
+
+BENCHMARK(testHandshakes)->Unit(::benchmark::kMicrosecond)->Apply(handshakeParams);
+
+// Connects a pair of non-blocking sockets over loopback TCP, as the kernel only supports TLS on
+// TCP sockets.
+static void connectLoopback(int& client_fd, int& server_fd) {
+  const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_length = sizeof(address);
+  RELEASE_ASSERT(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0,
+                 "bind");
+  RELEASE_ASSERT(::listen(listen_fd, 1) == 0, "listen");
+  ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_length);
+  client_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  RELEASE_ASSERT(::connect(client_fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0,
+                 "connect");
+  server_fd = ::accept(listen_fd, nullptr, nullptr);
+  RELEASE_ASSERT(server_fd >= 0, "accept");
+  ::close(listen_fd);
+  for (int fd : {client_fd, server_fd}) {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  }
+}
+
+// Compares the throughput of records encrypted and decrypted by BoringSSL with records encrypted
+// and decrypted by the kernel, over a loopback TCP connection. With kernel TLS, the client writes
+// its buffer slices with writev and the server reads the plaintext with read.
+static void testKernelTlsThroughput(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  const bool kernel_tls = state.range(0);
+  const uint16_t version = state.range(1) == 13 ? TLS1_3_VERSION : TLS1_2_VERSION;
+
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  std::string cert_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem");
+  std::string key_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem");
+  auto err = SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM);
+  drainErrorQueue();
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
+  err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
+  for (SSL_CTX* ctx : {server_ctx.get(), client_ctx.get()}) {
+    SSL_CTX_set_min_proto_version(ctx, version);
+    SSL_CTX_set_max_proto_version(ctx, version);
+  }
+  // Both the kernel and BoringSSL support AES-128-GCM.
+  SSL_CTX_set_strict_cipher_list(client_ctx.get(), "ECDHE-RSA-AES128-GCM-SHA256");
+
+  int client_fd;
+  int server_fd;
+  connectLoopback(client_fd, server_fd);
+  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
+  SSL_set_fd(server_ssl.get(), server_fd);
+  SSL_set_accept_state(server_ssl.get());
+  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
+  SSL_set_fd(client_ssl.get(), client_fd);
+  SSL_set_connect_state(client_ssl.get());
+
+  bool handshake_success = false;
+  for (int i = 0; i < 50; i++) {
+    int client_err = SSL_do_handshake(client_ssl.get());
+    int server_err = SSL_do_handshake(server_ssl.get());
+    if (client_err == 1 && server_err == 1) {
+      handshake_success = true;
+      break;
+    }
+    handleSslError(client_ssl.get(), client_err, false);
+    handleSslError(server_ssl.get(), server_err, true);
+  }
+  RELEASE_ASSERT(handshake_success, "handshake completed successfully");
+
+  if (kernel_tls) {
+    absl::Status status = KernelTls::enableTransmit(client_ssl.get(), client_fd);
+    if (status.ok()) {
+      status = KernelTls::enableTransmit(server_ssl.get(), server_fd);
+    }
+    if (status.ok()) {
+      status = KernelTls::enableReceive(server_ssl.get(), server_fd);
+    }
+    if (!status.ok()) {
+      state.SkipWithError(status.ToString().c_str());
+      ::close(client_fd);
+      ::close(server_fd);
+      return;
+    }
+  }
+
+  static uint8_t read_buf[1024 * 1024];
+  uint64_t bytes_written = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl write_buf;
+    addFullSlices(write_buf, 64, false);
+    const uint64_t length = write_buf.length();
+    state.ResumeTiming();
+
+    uint64_t bytes_read = 0;
+    while (bytes_read < length) {
+      if (write_buf.length() > 0) {
+        if (kernel_tls) {
+          Buffer::RawSliceVector slices = write_buf.getRawSlices();
+          std::vector<iovec> iov;
+          for (const Buffer::RawSlice& slice : slices) {
+            iov.push_back({slice.mem_, slice.len_});
+          }
+          const ssize_t rc = ::writev(client_fd, iov.data(), iov.size());
+          if (rc > 0) {
+            write_buf.drain(rc);
+          }
+        } else {
+          const size_t len = std::min<uint64_t>(write_buf.length(), 16384);
+          const int rc = SSL_write(client_ssl.get(), write_buf.linearize(len), len);
+          if (rc > 0) {
+            write_buf.drain(rc);
+          } else {
+            handleSslError(client_ssl.get(), rc, false);
+          }
+        }
+      }
+
+      if (kernel_tls) {
+        const ssize_t rc = ::read(server_fd, read_buf, sizeof(read_buf));
+        if (rc > 0) {
+          bytes_read += rc;
+        }
+      } else {
+        const int rc = SSL_read(server_ssl.get(), read_buf, sizeof(read_buf));
+        if (rc > 0) {
+          bytes_read += rc;
+        } else {
+          handleSslError(server_ssl.get(), rc, true);
+        }
+      }
+    }
+    bytes_written += length;
+  }
+  state.counters["throughput"] = benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
+
+  ::close(client_fd);
+  ::close(server_fd);
+}
+
+static void kernelTlsParams(benchmark::internal::Benchmark* b) {
+  for (auto kernel_tls : {false, true}) {
+    for (auto version : {12, 13}) {
+      b->Args({kernel_tls, version});
+    }
+  }
+}
+
+BENCHMARK(testKernelTlsThroughput)->Unit(::benchmark::kMicrosecond)->Apply(kernelTlsParams);
+
+// Compares writing records with SSL_write, as SslSocket does for TLS 1.3, with sealing batches of
+// records with a RecordWriter, as SslSocket does for TLS 1.2. The write buffer starts with a short
+// slice, so that the full slices following it are misaligned with the records.
+static void testRecordWriterThroughput(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  const bool record_writer = state.range(0);
+  const unsigned short_slice_size = state.range(1);
+
+  int sockets[2];
+  socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets);
+
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  std::string cert_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem");
+  std::string key_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem");
+  auto err = SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM);
+  drainErrorQueue();
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
+  err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
+  for (SSL_CTX* ctx : {server_ctx.get(), client_ctx.get()}) {
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(ctx, TLS1_2_VERSION);
+  }
+  SSL_CTX_set_strict_cipher_list(client_ctx.get(), "ECDHE-RSA-AES128-GCM-SHA256");
+
+  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
+  SSL_set_fd(server_ssl.get(), sockets[0]);
+  SSL_set_accept_state(server_ssl.get());
+  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
+  SSL_set_fd(client_ssl.get(), sockets[1]);
+  SSL_set_connect_state(client_ssl.get());
+
+  bool handshake_success = false;
+  for (int i = 0; i < 50; i++) {
+    int client_err = SSL_do_handshake(client_ssl.get());
+    int server_err = SSL_do_handshake(server_ssl.get());
+    if (client_err == 1 && server_err == 1) {
+      handshake_success = true;
+      break;
+    }
+    handleSslError(client_ssl.get(), client_err, false);
+    handleSslError(server_ssl.get(), server_err, true);
+  }
+  RELEASE_ASSERT(handshake_success, "handshake completed successfully");
+
+  static uint8_t read_buf[1024 * 1024];
+  RecordWriter writer;
+  uint64_t bytes_written = 0;
+  uint64_t num_writes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl write_buf;
+    if (short_slice_size > 0) {
+      appendSlice(write_buf, short_slice_size);
+    }
+    addFullSlices(write_buf, 64, true);
+    const uint64_t length = write_buf.length();
+    state.ResumeTiming();
+
+    uint64_t bytes_read = 0;
+    while (bytes_read < length) {
+      if (write_buf.length() > 0) {
+        if (record_writer) {
+          if (writer.empty() && !writer.seal(client_ssl.get(), write_buf)) {
+            drainErrorQueue();
+            PANIC("SealRecord failed");
+          }
+          Buffer::RawSliceVector slices = writer.output().getRawSlices();
+          std::vector<iovec> iov;
+          for (const Buffer::RawSlice& slice : slices) {
+            iov.push_back({slice.mem_, slice.len_});
+          }
+          const ssize_t rc = ::writev(sockets[1], iov.data(), iov.size());
+          if (rc > 0) {
+            writer.output().drain(rc);
+            write_buf.drain(writer.onWritten(rc));
+            num_writes++;
+          }
+        } else {
+          const size_t len = std::min<uint64_t>(write_buf.length(), 16384);
+          const int rc = SSL_write(client_ssl.get(), write_buf.linearize(len), len);
+          if (rc > 0) {
+            write_buf.drain(rc);
+            num_writes++;
+          } else {
+            handleSslError(client_ssl.get(), rc, false);
+          }
+        }
+      }
+
+      const int rc = SSL_read(server_ssl.get(), read_buf, sizeof(read_buf));
+      if (rc > 0) {
+        bytes_read += rc;
+      } else {
+        handleSslError(server_ssl.get(), rc, true);
+      }
+    }
+    bytes_written += length;
+  }
+  state.counters["throughput"] = benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
+  state.counters["writes_per_iteration"] =
+      benchmark::Counter(num_writes, benchmark::Counter::kAvgIterations);
+
+  ::close(sockets[0]);
+  ::close(sockets[1]);
+}
+
+static void recordWriterParams(benchmark::internal::Benchmark* b) {
+  for (auto record_writer : {false, true}) {
+    for (auto short_slice_size : {0, 128, 4097}) {
+      b->Args({record_writer, short_slice_size});
+    }
+  }
+}
+
+BENCHMARK(testRecordWriterThroughput)->Unit(::benchmark::kMicrosecond)->Apply(recordWriterParams);
+
 } // namespace Extensions::TransportSockets::Tls
 } // namespace Envoy
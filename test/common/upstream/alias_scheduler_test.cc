@@ -0,0 +1,162 @@
+#include "source/common/upstream/alias_scheduler.h"
+
+#include "test/mocks/common.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// Returns a random value picking the given column of a table with the given number of columns,
+// with the coin set to the given fraction of its range.
+uint64_t randomValue(uint32_t column, uint32_t num_columns, double coin) {
+  const uint64_t column_bits = ((uint64_t(column) << 32) + num_columns - 1) / num_columns;
+  return (static_cast<uint64_t>(coin * (uint64_t(1) << 32)) << 32) | column_bits;
+}
+
+TEST(AliasSchedulerTest, Empty) {
+  NiceMock<Random::MockRandomGenerator> random;
+  AliasScheduler<uint32_t> sched(random);
+  EXPECT_TRUE(sched.empty());
+  EXPECT_EQ(nullptr, sched.peekAgain([](const uint32_t&) { return 1; }));
+  EXPECT_EQ(nullptr, sched.pickAndAdd([](const uint32_t&) { return 1; }));
+  EXPECT_EQ(nullptr, sched.pick(0));
+}
+
+// Validate that each column picks its own entry, regardless of the coin, when all weights are the
+// same.
+TEST(AliasSchedulerTest, Unweighted) {
+  NiceMock<Random::MockRandomGenerator> random;
+  AliasScheduler<uint32_t> sched(random);
+  constexpr uint32_t num_entries = 5;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(1, entries[i]);
+  }
+  EXPECT_FALSE(sched.empty());
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    EXPECT_EQ(i, *sched.pick(randomValue(i, num_entries, 0)));
+    EXPECT_EQ(i, *sched.pick(randomValue(i, num_entries, 0.999)));
+  }
+}
+
+// Validate selection probabilities.
+TEST(AliasSchedulerTest, ProbabilityVerification) {
+  NiceMock<Random::MockRandomGenerator> random;
+  AliasScheduler<uint32_t> sched(random);
+  constexpr uint32_t num_entries = 16;
+  std::shared_ptr<uint32_t> entries[num_entries];
+  uint32_t pick_count[num_entries] = {};
+
+  double weight_sum = 0;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(i + 1, entries[i]);
+    weight_sum += (i + 1);
+  }
+
+  // Trying every column with evenly spread coins should select each object a number of times
+  // proportional to its weight, give or take one coin step per column.
+  constexpr uint32_t coins = 1000;
+  for (uint32_t column = 0; column < num_entries; ++column) {
+    for (uint32_t coin = 0; coin < coins; ++coin) {
+      ++pick_count[*sched.pick(randomValue(column, num_entries, double(coin) / coins))];
+    }
+  }
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    EXPECT_NEAR((i + 1) / weight_sum * num_entries * coins, pick_count[i], num_entries);
+  }
+}
+
+// Ensure the values that are peeked are the ones returned via calls to `pickAndAdd`.
+TEST(AliasSchedulerTest, ManyPeekahead) {
+  Random::MockRandomGenerator random;
+  AliasScheduler<uint32_t> sched(random);
+  auto e1 = std::make_shared<uint32_t>(1);
+  auto e2 = std::make_shared<uint32_t>(2);
+  sched.add(1, e1);
+  sched.add(3, e2);
+
+  EXPECT_CALL(random, random())
+      .WillOnce(Return(randomValue(0, 2, 0)))
+      .WillOnce(Return(randomValue(0, 2, 0.75)))
+      .WillOnce(Return(randomValue(1, 2, 0)));
+  EXPECT_EQ(1, *sched.peekAgain({}));
+  EXPECT_EQ(2, *sched.peekAgain({}));
+  EXPECT_EQ(2, *sched.peekAgain({}));
+  EXPECT_EQ(1, *sched.pickAndAdd({}));
+  EXPECT_EQ(2, *sched.pickAndAdd({}));
+  EXPECT_EQ(2, *sched.pickAndAdd({}));
+
+  EXPECT_CALL(random, random()).WillOnce(Return(randomValue(0, 2, 0.25)));
+  EXPECT_EQ(1, *sched.pickAndAdd({}));
+}
+
+// Validate that expired entries are ignored.
+TEST(AliasSchedulerTest, Expired) {
+  Random::MockRandomGenerator random;
+  AliasScheduler<uint32_t> sched(random);
+
+  auto second_entry = std::make_shared<uint32_t>(42);
+  {
+    auto first_entry = std::make_shared<uint32_t>(37);
+    sched.add(1000, first_entry);
+    sched.add(1, second_entry);
+    EXPECT_EQ(37, *sched.pick(randomValue(0, 2, 0)));
+  }
+
+  EXPECT_CALL(random, random()).WillOnce(Return(0)).WillOnce(Return(1337));
+  EXPECT_EQ(42, *sched.pick(randomValue(0, 2, 0)));
+  EXPECT_EQ(42, *sched.pickAndAdd({}));
+}
+
+// Validate that expired entries are not peeked, and that nullptr is returned once all entries
+// expired.
+TEST(AliasSchedulerTest, ExpireAll) {
+  NiceMock<Random::MockRandomGenerator> random;
+  AliasScheduler<uint32_t> sched(random);
+
+  {
+    auto e1 = std::make_shared<uint32_t>(42);
+    auto e2 = std::make_shared<uint32_t>(37);
+    sched.add(2, e1);
+    sched.add(1, e2);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(sched.peekAgain({}) != nullptr);
+    }
+  }
+
+  EXPECT_TRUE(sched.peekAgain({}) == nullptr);
+  EXPECT_TRUE(sched.pickAndAdd({}) == nullptr);
+  EXPECT_TRUE(sched.empty());
+}
+
+// Validate that the table is rebuilt when entries are added after picks.
+TEST(AliasSchedulerTest, AddAfterPick) {
+  NiceMock<Random::MockRandomGenerator> random;
+  AliasScheduler<uint32_t> sched(random);
+
+  auto e1 = std::make_shared<uint32_t>(123);
+  auto e2 = std::make_shared<uint32_t>(456);
+  sched.add(1, e1);
+  EXPECT_EQ(123, *sched.pick(randomValue(0, 1, 0.999)));
+
+  // Weights are now {e1=1, e2=3}, so the first column is only half e1.
+  sched.add(3, e2);
+  EXPECT_EQ(123, *sched.pick(randomValue(0, 2, 0.25)));
+  EXPECT_EQ(456, *sched.pick(randomValue(0, 2, 0.75)));
+  EXPECT_EQ(456, *sched.pick(randomValue(1, 2, 0.25)));
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
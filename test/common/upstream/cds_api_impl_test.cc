@@ -46,18 +46,19 @@ protected:
   }
 
   void expectAdd(const std::string& cluster_name, const std::string& version = std::string("")) {
-    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(cluster_name), version, false))
+    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(cluster_name), version, false, _))
         .WillOnce(Return(true));
   }
 
   void expectAddToThrow(const std::string& cluster_name, const std::string& exception_msg) {
-    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(cluster_name), _, false))
+    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(cluster_name), _, false, _))
         .WillOnce(Throw(EnvoyException(exception_msg)));
   }
 
   ClusterManager::ClusterInfoMaps
   makeClusterInfoMaps(const std::vector<std::string>& active_clusters,
-                      const std::vector<std::string>& warming_clusters = {}) {
+                      const std::vector<std::string>& warming_clusters = {},
+                      const std::vector<std::string>& lazy_clusters = {}) {
     ClusterManager::ClusterInfoMaps maps;
     for (const auto& cluster : active_clusters) {
       maps.active_clusters_.emplace(cluster, cm_.thread_local_cluster_.cluster_);
@@ -65,10 +66,24 @@ protected:
     for (const auto& cluster : warming_clusters) {
       maps.warming_clusters_.emplace(cluster, cm_.thread_local_cluster_.cluster_);
     }
+    lazy_clusters_.names_.insert(lazy_clusters.begin(), lazy_clusters.end());
+    maps.lazy_clusters_ = lazy_clusters_;
     return maps;
   }
 
+  struct TestLazyClusters : public ClusterManager::LazyClusters {
+    bool contains(absl::string_view cluster) const override { return names_.contains(cluster); }
+    void iterate(const std::function<void(const std::string&)>& cb) const override {
+      for (const std::string& name : names_) {
+        cb(name);
+      }
+    }
+
+    absl::flat_hash_set<std::string> names_;
+  };
+
   NiceMock<MockClusterManager> cm_;
+  TestLazyClusters lazy_clusters_;
   Upstream::MockClusterMockPrioritySet mock_cluster_;
   Stats::IsolatedStoreImpl store_;
   CdsApiPtr cds_;
@@ -124,6 +139,33 @@ resources:
   EXPECT_EQ("1", cds_->versionInfo());
 }
 
+// Validate that a state-of-the-world update removes the lazy clusters it does not list, and only
+// those.
+TEST_F(CdsApiImplTest, RemoveLazyClusters) {
+  {
+    InSequence s;
+    setup();
+  }
+
+  EXPECT_CALL(cm_, clusters())
+      .WillOnce(Return(makeClusterInfoMaps({"cluster_1"}, {}, {"cluster_2", "cluster_3"})));
+  EXPECT_CALL(initialized_, ready());
+
+  envoy::config::cluster::v3::Cluster cluster_1;
+  cluster_1.set_name("cluster_1");
+  expectAdd("cluster_1");
+  envoy::config::cluster::v3::Cluster cluster_3;
+  cluster_3.set_name("cluster_3");
+  expectAdd("cluster_3");
+  EXPECT_CALL(cm_, removeCluster("cluster_1", _)).Times(0);
+  EXPECT_CALL(cm_, removeCluster("cluster_2", false)).WillOnce(Return(true));
+  EXPECT_CALL(cm_, removeCluster("cluster_3", _)).Times(0);
+
+  const auto decoded_resources = TestUtility::decodeResources({cluster_1, cluster_3});
+  EXPECT_TRUE(cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "1").ok());
+  EXPECT_EQ("1", cds_->versionInfo());
+}
+
 // Validate onConfigUpdate throws EnvoyException with duplicate clusters.
 TEST_F(CdsApiImplTest, ValidateDuplicateClusters) {
   InSequence s;
@@ -662,6 +662,143 @@ TEST_F(ODCDTest, TestMainThreadDiscoveryInProgressDetection) {
       odcds_handle_->requestOnDemandClusterDiscovery("cluster_foo", std::move(cb2), timeout_);
 }
 
+class LazyCdsClustersTest : public ODCDTest {
+public:
+  void SetUp() override {
+    Bootstrap bootstrap = defaultConfig();
+    bootstrap.mutable_cluster_manager()->set_enable_lazy_cds_clusters(true);
+    create(bootstrap);
+    odcds_ = MockOdCdsApi::create();
+    odcds_handle_ = cluster_manager_->createOdCdsApiHandle(odcds_);
+  }
+
+  uint64_t lazyClusters() {
+    return factory_.stats_
+        .gauge("cluster_manager.lazy_clusters", Stats::Gauge::ImportMode::NeverImport)
+        .value();
+  }
+};
+
+// Check that a cluster received via CDS is only recorded, and gets loaded without calling into
+// ODCDS when it is first requested.
+TEST_F(LazyCdsClustersTest, LoadOnFirstRequest) {
+  const auto cluster = defaultStaticCluster("cluster_foo");
+  const uint64_t hash = MessageUtil::hash(cluster);
+  EXPECT_TRUE(*cluster_manager_->addOrUpdateCdsCluster(cluster, "version1", hash));
+  EXPECT_FALSE(*cluster_manager_->addOrUpdateCdsCluster(cluster, "version2", hash));
+  EXPECT_EQ(1, lazyClusters());
+  EXPECT_TRUE(cluster_manager_->clusters().hasCluster("cluster_foo"));
+  EXPECT_FALSE(cluster_manager_->clusters().getCluster("cluster_foo").has_value());
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("cluster_foo"));
+
+  EXPECT_CALL(*odcds_, updateOnDemand(_)).Times(0);
+  auto handle = odcds_handle_->requestOnDemandClusterDiscovery(
+      "cluster_foo", createCallback(ClusterDiscoveryStatus::Available), timeout_);
+  EXPECT_EQ(callback_call_count_, 1);
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("cluster_foo"));
+  EXPECT_EQ(0, lazyClusters());
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.lazy_cluster_loaded").value());
+
+  // Once loaded, CDS updates the cluster as usual.
+  auto modified = cluster;
+  modified.mutable_connect_timeout()->set_seconds(5);
+  EXPECT_TRUE(*cluster_manager_->addOrUpdateCdsCluster(modified, "version3",
+                                                       MessageUtil::hash(modified)));
+  EXPECT_EQ(0, lazyClusters());
+}
+
+// Check that a removed lazy cluster is discovered via ODCDS again.
+TEST_F(LazyCdsClustersTest, RemoveBeforeLoad) {
+  const auto cluster = defaultStaticCluster("cluster_foo");
+  EXPECT_TRUE(
+      *cluster_manager_->addOrUpdateCdsCluster(cluster, "version1", MessageUtil::hash(cluster)));
+  EXPECT_TRUE(cluster_manager_->removeCluster("cluster_foo"));
+  EXPECT_EQ(0, lazyClusters());
+  EXPECT_FALSE(cluster_manager_->clusters().hasCluster("cluster_foo"));
+
+  EXPECT_CALL(*odcds_, updateOnDemand("cluster_foo"));
+  auto handle = odcds_handle_->requestOnDemandClusterDiscovery("cluster_foo", createCallback(),
+                                                               timeout_);
+  EXPECT_EQ(callback_call_count_, 0);
+}
+
+// Check that an invalid cluster is rejected when it is received, rather than recorded and ACKed,
+// without building the cluster.
+TEST_F(LazyCdsClustersTest, RejectInvalidCluster) {
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _)).Times(0);
+  auto cluster = defaultStaticCluster("cluster_foo");
+  cluster.mutable_cluster_type()->set_name("envoy.clusters.unknown");
+  EXPECT_EQ(
+      cluster_manager_->addOrUpdateCdsCluster(cluster, "version1", MessageUtil::hash(cluster))
+          .status()
+          .message(),
+      "Didn't find a registered cluster factory implementation for name: "
+      "'envoy.clusters.unknown'");
+
+  cluster = defaultStaticCluster("cluster_foo");
+  cluster.set_lb_policy(envoy::config::cluster::v3::Cluster::CLUSTER_PROVIDED);
+  EXPECT_EQ(
+      cluster_manager_->addOrUpdateCdsCluster(cluster, "version1", MessageUtil::hash(cluster))
+          .status()
+          .message(),
+      "cluster manager: cluster provided LB specified but cluster 'cluster_foo' did not provide "
+      "one. Check cluster documentation.");
+
+  EXPECT_EQ(0, lazyClusters());
+  EXPECT_FALSE(cluster_manager_->clusters().hasCluster("cluster_foo"));
+}
+
+// Check that a valid lazy cluster is only built when it is first requested.
+TEST_F(LazyCdsClustersTest, BuildOnlyOnLoad) {
+  testing::MockFunction<void()> requested;
+  {
+    testing::InSequence s;
+    EXPECT_CALL(requested, Call());
+    EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _));
+  }
+  const auto cluster = defaultStaticCluster("cluster_foo");
+  EXPECT_TRUE(
+      *cluster_manager_->addOrUpdateCdsCluster(cluster, "version1", MessageUtil::hash(cluster)));
+
+  requested.Call();
+  auto handle = odcds_handle_->requestOnDemandClusterDiscovery(
+      "cluster_foo", createCallback(ClusterDiscoveryStatus::Available), timeout_);
+  EXPECT_EQ(callback_call_count_, 1);
+}
+
+// Check that clusters that are not loaded yet are dumped as dynamic active clusters.
+TEST_F(LazyCdsClustersTest, ConfigDump) {
+  time_system_.setSystemTime(std::chrono::milliseconds(1234567891234));
+  const auto cluster = parseClusterFromV3Yaml(R"EOF(
+name: cluster_foo
+connect_timeout: 0.250s
+lb_policy: ROUND_ROBIN
+)EOF");
+  EXPECT_TRUE(
+      *cluster_manager_->addOrUpdateCdsCluster(cluster, "version1", MessageUtil::hash(cluster)));
+  checkConfigDump(R"EOF(
+static_clusters:
+dynamic_active_clusters:
+  - version_info: "version1"
+    cluster:
+      "@type": type.googleapis.com/envoy.config.cluster.v3.Cluster
+      name: cluster_foo
+      connect_timeout: 0.250s
+      lb_policy: ROUND_ROBIN
+    last_updated:
+      seconds: 1234567891
+      nanos: 234000000
+dynamic_warming_clusters:
+)EOF");
+
+  EXPECT_TRUE(cluster_manager_->removeCluster("cluster_foo"));
+  checkConfigDump(R"EOF(
+static_clusters:
+dynamic_active_clusters:
+dynamic_warming_clusters:
+)EOF");
+}
+
 class AlpnSocketFactory : public Network::RawBufferSocketFactory {
 public:
   bool supportsAlpn() const override { return true; }
@@ -1346,6 +1483,15 @@ TEST_F(ClusterManagerImplTest, ClusterProvidedLbNotConfigured) {
                             "'cluster_0' provided one. Check cluster documentation.");
 }
 
+// Verify that a precomputed cluster hash is used to detect unmodified clusters as usual.
+TEST_F(ClusterManagerImplTest, PrecomputedClusterHash) {
+  create(Bootstrap());
+  const envoy::config::cluster::v3::Cluster cluster = defaultStaticCluster("dynamic");
+  const uint64_t hash = MessageUtil::hash(cluster);
+  EXPECT_TRUE(*cluster_manager_->addOrUpdateCluster(cluster, "version1", false, hash));
+  EXPECT_FALSE(*cluster_manager_->addOrUpdateCluster(cluster, "version2", false, hash));
+}
+
 // Verify that multiple load balancing policies can be specified, and Envoy selects the first
 // policy that it has a factory for.
 TEST_F(ClusterManagerImplTest, LbPolicyConfig) {
@@ -0,0 +1,137 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures cluster manager startup and large CDS updates with synthetic cluster counts.
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/router/context_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/test_cluster_manager.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/config/mocks.h"
+#include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/server/instance.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// A STATIC cluster with a handful of endpoints and some of the settings commonly found in large
+// deployments, so that its configuration is of a realistic size.
+envoy::config::cluster::v3::Cluster syntheticCluster(uint32_t index) {
+  envoy::config::cluster::v3::Cluster cluster =
+      defaultStaticCluster(absl::StrCat("cluster_", index));
+  cluster.mutable_circuit_breakers()->add_thresholds()->mutable_max_requests()->set_value(1000);
+  cluster.mutable_common_lb_config()->mutable_healthy_panic_threshold()->set_value(25);
+  auto* endpoints = cluster.mutable_load_assignment()->mutable_endpoints(0);
+  for (uint32_t port = 1; port < 8; ++port) {
+    auto* address = endpoints->add_lb_endpoints()
+                        ->mutable_endpoint()
+                        ->mutable_address()
+                        ->mutable_socket_address();
+    address->set_address(absl::StrCat("10.0.", index % 256, ".", port));
+    address->set_port_value(8000 + port);
+  }
+  return cluster;
+}
+
+class ClusterManagerBenchmark {
+public:
+  ClusterManagerBenchmark()
+      : http_context_(factory_.stats_.symbolTable()), grpc_context_(factory_.stats_.symbolTable()),
+        router_context_(factory_.stats_.symbolTable()) {}
+
+  void create(const envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
+    cluster_manager_ = TestClusterManagerImpl::createAndInit(
+        bootstrap, factory_, factory_.server_context_, factory_.stats_, factory_.tls_,
+        factory_.runtime_, factory_.local_info_, log_manager_, factory_.dispatcher_, admin_,
+        validation_context_, *factory_.api_, http_context_, grpc_context_, router_context_, server_,
+        xds_manager_);
+  }
+
+  NiceMock<TestClusterManagerFactory> factory_;
+  NiceMock<ProtobufMessage::MockValidationContext> validation_context_;
+  NiceMock<Config::MockXdsManager> xds_manager_;
+  NiceMock<AccessLog::MockAccessLogManager> log_manager_;
+  NiceMock<Server::MockAdmin> admin_;
+  Http::ContextImpl http_context_;
+  Grpc::ContextImpl grpc_context_;
+  Router::ContextImpl router_context_;
+  NiceMock<Server::MockInstance> server_;
+  std::unique_ptr<TestClusterManagerImpl> cluster_manager_;
+};
+
+envoy::config::bootstrap::v3::Bootstrap syntheticBootstrap(uint32_t num_clusters) {
+  envoy::config::bootstrap::v3::Bootstrap bootstrap;
+  for (uint32_t i = 0; i < num_clusters; ++i) {
+    *bootstrap.mutable_static_resources()->add_clusters() = syntheticCluster(i);
+  }
+  return bootstrap;
+}
+
+} // namespace
+
+// Benchmark args: number of static clusters.
+static void bmStartup(::benchmark::State& state) {
+  const uint32_t num_clusters = Envoy::benchmark::skipExpensiveBenchmarks() ? 100 : state.range(0);
+  const envoy::config::bootstrap::v3::Bootstrap bootstrap = syntheticBootstrap(num_clusters);
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    ClusterManagerBenchmark harness;
+    harness.create(bootstrap);
+    state.PauseTiming();
+    harness.cluster_manager_->shutdown();
+    harness.cluster_manager_.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * num_clusters);
+}
+BENCHMARK(bmStartup)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->UseRealTime()
+    ->Unit(::benchmark::kMillisecond);
+
+// A CDS update re-sending every cluster, with a single one modified, as management servers that
+// send the full state of the world do.
+//
+// Benchmark args: number of dynamic clusters.
+static void bmUnmodifiedCdsUpdate(::benchmark::State& state) {
+  const uint32_t num_clusters = Envoy::benchmark::skipExpensiveBenchmarks() ? 100 : state.range(0);
+  ClusterManagerBenchmark harness;
+  harness.create(syntheticBootstrap(0));
+
+  std::vector<envoy::config::cluster::v3::Cluster> clusters;
+  clusters.reserve(num_clusters);
+  for (uint32_t i = 0; i < num_clusters; ++i) {
+    clusters.push_back(syntheticCluster(i));
+    THROW_IF_NOT_OK(harness.cluster_manager_->addOrUpdateCluster(clusters.back(), "v0").status());
+  }
+
+  uint32_t version = 0;
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    clusters[0].mutable_common_lb_config()->mutable_healthy_panic_threshold()->set_value(
+        ++version % 100);
+    for (uint32_t i = 0; i < num_clusters; ++i) {
+      THROW_IF_NOT_OK(
+          harness.cluster_manager_->addOrUpdateCluster(clusters[i], absl::StrCat("v", version))
+              .status());
+    }
+  }
+  harness.cluster_manager_->shutdown();
+  state.SetItemsProcessed(state.iterations() * num_clusters);
+}
+BENCHMARK(bmUnmodifiedCdsUpdate)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(30000)
+    ->UseRealTime()
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Upstream
+} // namespace Envoy
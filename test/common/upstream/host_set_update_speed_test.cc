@@ -0,0 +1,116 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the cost of a host set update in which a single host changes health, as happens when a
+// host fails or passes a health check in a large cluster: re-partitioning the hosts on the main
+// thread, then applying the update to a worker's priority set and load balancer.
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/core/v3/base.pb.h"
+
+#include "source/common/common/random_generator.h"
+#include "source/common/runtime/runtime_features.h"
+#include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/least_request/least_request_lb.h"
+#include "source/extensions/load_balancing_policies/round_robin/round_robin_lb.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+constexpr uint32_t NumLocalities = 10;
+
+class HostSetUpdateTester : public Event::TestUsingSimulatedTime {
+public:
+  HostSetUpdateTester(uint32_t num_hosts, bool weighted, bool least_request) {
+    std::vector<HostVector> hosts_per_locality(NumLocalities);
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      envoy::config::core::v3::Locality locality;
+      locality.set_zone(absl::StrCat("zone_", i % NumLocalities));
+      hosts_per_locality[i % NumLocalities].push_back(
+          makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256), simTime(),
+                       locality, weighted ? 1 + i % 3 : 1));
+    }
+    for (const HostVector& locality_hosts : hosts_per_locality) {
+      hosts_.insert(hosts_.end(), locality_hosts.begin(), locality_hosts.end());
+    }
+    hosts_per_locality_ =
+        makeHostsPerLocality(std::move(hosts_per_locality), /*force_no_local_locality=*/true);
+    update();
+
+    if (least_request) {
+      lb_ = std::make_unique<LeastRequestLoadBalancer>(worker_priority_set_, nullptr, stats_,
+                                                       runtime_, random_, common_config_,
+                                                       least_request_lb_config_, simTime());
+    } else {
+      lb_ = std::make_unique<RoundRobinLoadBalancer>(worker_priority_set_, nullptr, stats_,
+                                                     runtime_, random_, common_config_,
+                                                     round_robin_lb_config_, simTime());
+    }
+  }
+
+  // Re-partitions the hosts on the main thread, as health check and outlier detection updates do,
+  // and applies the result to the worker's priority set.
+  void update() {
+    main_priority_set_.updateHosts(
+        0,
+        HostSetImpl::partitionHosts(std::make_shared<const HostVector>(hosts_),
+                                    hosts_per_locality_->clone()),
+        {}, {}, {}, random_.random(), absl::nullopt);
+    worker_priority_set_.updateHosts(
+        0, HostSetImpl::updateHostsParams(*main_priority_set_.hostSetsPerPriority()[0]), {}, {},
+        {}, random_.random(), absl::nullopt);
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterLbStatNames stat_names_{stats_store_.symbolTable()};
+  ClusterLbStats stats_{stat_names_, *stats_store_.rootScope()};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
+  envoy::config::cluster::v3::Cluster::RoundRobinLbConfig round_robin_lb_config_;
+  envoy::config::cluster::v3::Cluster::LeastRequestLbConfig least_request_lb_config_;
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  HostVector hosts_;
+  HostsPerLocalityConstSharedPtr hosts_per_locality_;
+  MainPrioritySetImpl main_priority_set_;
+  PrioritySetImpl worker_priority_set_;
+  std::unique_ptr<LoadBalancer> lb_;
+};
+
+} // namespace
+
+// Benchmark args: number of hosts, whether host weights differ, whether the load balancer is least
+// request rather than round robin, and whether incremental host set updates are enabled.
+static void bmSingleHostHealthChange(::benchmark::State& state) {
+  const uint32_t num_hosts = Envoy::benchmark::skipExpensiveBenchmarks() ? 100 : state.range(0);
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.incremental_host_set_updates",
+                                state.range(3) != 0);
+  HostSetUpdateTester tester(num_hosts, state.range(1) != 0, state.range(2) != 0);
+
+  const HostSharedPtr& flapping_host = tester.hosts_[num_hosts / 2];
+  for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+    if (flapping_host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
+      flapping_host->healthFlagClear(Host::HealthFlag::FAILED_ACTIVE_HC);
+    } else {
+      flapping_host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+    }
+    tester.update();
+  }
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.incremental_host_set_updates", true);
+}
+BENCHMARK(bmSingleHostHealthChange)
+    ->ArgsProduct({{1000, 10000}, {0, 1}, {0, 1}, {0, 1}})
+    ->Unit(::benchmark::kMicrosecond);
+
+} // namespace Upstream
+} // namespace Envoy
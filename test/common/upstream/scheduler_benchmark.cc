@@ -4,6 +4,7 @@
 #include <random>
 
 #include "source/common/common/random_generator.h"
+#include "source/common/upstream/alias_scheduler.h"
 #include "source/common/upstream/edf_scheduler.h"
 #include "source/common/upstream/wrsq_scheduler.h"
 
@@ -159,6 +160,63 @@ void uniqueWeightPickWRSQ(::benchmark::State& state) {
                             });
 }
 
+// Adding objects to an alias table is a constant time append. The O(n) cost of building the table
+// is paid by the first pick that follows, which is measured by the build benchmarks.
+void splitWeightAddAlias(::benchmark::State& state) {
+  Random::RandomGeneratorImpl random;
+  AliasScheduler<SchedulerTester::ObjInfo> alias(random);
+  const size_t num_objs = state.range(0);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    SchedulerTester::setupSplitWeights(alias, num_objs, state);
+  }
+}
+
+void uniqueWeightAddAlias(::benchmark::State& state) {
+  Random::RandomGeneratorImpl random;
+  AliasScheduler<SchedulerTester::ObjInfo> alias(random);
+  const size_t num_objs = state.range(0);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    SchedulerTester::setupUniqueWeights(alias, num_objs, state);
+  }
+}
+
+// Builds a new alias table and picks from it once, as a load balancer does for each host set
+// update.
+void uniqueWeightBuildAlias(::benchmark::State& state) {
+  Random::RandomGeneratorImpl random;
+  const size_t num_objs = state.range(0);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    AliasScheduler<SchedulerTester::ObjInfo> alias(random);
+    auto obj_info = SchedulerTester::setupUniqueWeights(alias, num_objs, state);
+    ::benchmark::DoNotOptimize(alias.pickAndAdd({}));
+    state.PauseTiming();
+    obj_info.clear();
+    state.ResumeTiming();
+  }
+}
+
+void splitWeightPickAlias(::benchmark::State& state) {
+  Random::RandomGeneratorImpl random;
+  AliasScheduler<SchedulerTester::ObjInfo> alias(random);
+  const size_t num_objs = state.range(0);
+
+  SchedulerTester::pickTest(alias, state,
+                            [num_objs, &state](Scheduler<SchedulerTester::ObjInfo>& sched) {
+                              return SchedulerTester::setupSplitWeights(sched, num_objs, state);
+                            });
+}
+
+void uniqueWeightPickAlias(::benchmark::State& state) {
+  Random::RandomGeneratorImpl random;
+  AliasScheduler<SchedulerTester::ObjInfo> alias(random);
+  const size_t num_objs = state.range(0);
+
+  SchedulerTester::pickTest(alias, state,
+                            [num_objs, &state](Scheduler<SchedulerTester::ObjInfo>& sched) {
+                              return SchedulerTester::setupUniqueWeights(sched, num_objs, state);
+                            });
+}
+
 BENCHMARK(splitWeightAddEdf)
     ->Unit(::benchmark::kMicrosecond)
     ->RangeMultiplier(8)
@@ -167,8 +225,13 @@ BENCHMARK(splitWeightAddWRSQ)
     ->Unit(::benchmark::kMicrosecond)
     ->RangeMultiplier(8)
     ->Range(1 << 6, 1 << 14);
+BENCHMARK(splitWeightAddAlias)
+    ->Unit(::benchmark::kMicrosecond)
+    ->RangeMultiplier(8)
+    ->Range(1 << 6, 1 << 14);
 BENCHMARK(splitWeightPickEdf)->RangeMultiplier(8)->Range(1 << 6, 1 << 14);
 BENCHMARK(splitWeightPickWRSQ)->RangeMultiplier(8)->Range(1 << 6, 1 << 14);
+BENCHMARK(splitWeightPickAlias)->RangeMultiplier(8)->Range(1 << 6, 1 << 14);
 BENCHMARK(uniqueWeightAddEdf)
     ->Unit(::benchmark::kMicrosecond)
     ->RangeMultiplier(8)
@@ -177,8 +240,17 @@ BENCHMARK(uniqueWeightAddWRSQ)
     ->Unit(::benchmark::kMicrosecond)
     ->RangeMultiplier(8)
     ->Range(1 << 6, 1 << 14);
+BENCHMARK(uniqueWeightAddAlias)
+    ->Unit(::benchmark::kMicrosecond)
+    ->RangeMultiplier(8)
+    ->Range(1 << 6, 1 << 14);
+BENCHMARK(uniqueWeightBuildAlias)
+    ->Unit(::benchmark::kMicrosecond)
+    ->RangeMultiplier(8)
+    ->Range(1 << 6, 1 << 14);
 BENCHMARK(uniqueWeightPickEdf)->RangeMultiplier(8)->Range(1 << 6, 1 << 14);
 BENCHMARK(uniqueWeightPickWRSQ)->RangeMultiplier(8)->Range(1 << 6, 1 << 14);
+BENCHMARK(uniqueWeightPickAlias)->RangeMultiplier(8)->Range(1 << 6, 1 << 14);
 
 } // namespace
 } // namespace Upstream
@@ -4155,6 +4155,54 @@ TEST(PrioritySet, Extend) {
   EXPECT_EQ(2, membership_changes);
 }
 
+// Vectors whose hosts are not affected by an update keep their identity, so that load balancers
+// can tell they are unchanged without comparing them.
+TEST(PrioritySet, ReusesUnchangedHostVectors) {
+  PrioritySetImpl priority_set;
+  std::shared_ptr<MockClusterInfo> info{new NiceMock<MockClusterInfo>()};
+  auto time_source = std::make_unique<NiceMock<MockTimeSystem>>();
+  HostVector hosts{makeTestHost(info, "tcp://127.0.0.1:80", *time_source),
+                   makeTestHost(info, "tcp://127.0.0.1:81", *time_source)};
+
+  const auto update = [&]() {
+    priority_set.updateHosts(0,
+                             HostSetImpl::partitionHosts(std::make_shared<const HostVector>(hosts),
+                                                         makeHostsPerLocality({HostVector(hosts)})),
+                             {}, {}, {}, 0, absl::nullopt);
+  };
+  update();
+  const HostSet& host_set = *priority_set.hostSetsPerPriority()[0];
+  const HostVectorConstSharedPtr initial_hosts = host_set.hostsPtr();
+  const HealthyHostVectorConstSharedPtr initial_healthy_hosts = host_set.healthyHostsPtr();
+  const DegradedHostVectorConstSharedPtr initial_degraded_hosts = host_set.degradedHostsPtr();
+  const HostsPerLocalityConstSharedPtr initial_healthy_hosts_per_locality =
+      host_set.healthyHostsPerLocalityPtr();
+
+  // Re-partitioning the same hosts reuses every vector.
+  update();
+  EXPECT_EQ(initial_hosts, host_set.hostsPtr());
+  EXPECT_EQ(initial_healthy_hosts, host_set.healthyHostsPtr());
+  EXPECT_EQ(initial_healthy_hosts_per_locality, host_set.healthyHostsPerLocalityPtr());
+
+  // A host failing health checks only replaces the vectors of healthy hosts.
+  hosts[1]->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  update();
+  EXPECT_EQ(initial_hosts, host_set.hostsPtr());
+  EXPECT_EQ(initial_degraded_hosts, host_set.degradedHostsPtr());
+  EXPECT_NE(initial_healthy_hosts, host_set.healthyHostsPtr());
+  EXPECT_NE(initial_healthy_hosts_per_locality, host_set.healthyHostsPerLocalityPtr());
+  EXPECT_EQ(1, host_set.healthyHosts().size());
+
+  {
+    TestScopedRuntime scoped_runtime;
+    scoped_runtime.mergeValues(
+        {{"envoy.reloadable_features.incremental_host_set_updates", "false"}});
+    const HostVectorConstSharedPtr current_hosts = host_set.hostsPtr();
+    update();
+    EXPECT_NE(current_hosts, host_set.hostsPtr());
+  }
+}
+
 // Helper class used to test MainPrioritySetImpl.
 class TestMainPrioritySetImpl : public MainPrioritySetImpl {
 public:
@@ -139,7 +139,7 @@ TEST_F(AwsClusterManagerTest, CreateQueuedViaInitManager) {
       envoy::config::cluster::v3::Cluster::DiscoveryType::Cluster_DiscoveryType_STRICT_DNS,
       "new_url");
   // Cluster creation should be queued at this point
-  EXPECT_CALL(cm_, addOrUpdateCluster(_, _, _));
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _, _, _));
 
   init_target_->initialize(init_watcher_);
 }
@@ -150,7 +150,7 @@ TEST_F(AwsClusterManagerTest, CreateQueuedViaInitManagerWithFailedCluster) {
     init_target_ = target.createHandle("test");
   }));
   EXPECT_CALL(context_, clusterManager()).WillRepeatedly(ReturnRef(cm_));
-  EXPECT_CALL(cm_, addOrUpdateCluster(_, _, _)).WillOnce(Return(absl::InternalError("")));
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _, _, _)).WillOnce(Return(absl::InternalError("")));
 
   auto aws_cluster_manager = std::make_shared<AwsClusterManagerImpl>(context_);
   auto status = aws_cluster_manager->addManagedCluster(
@@ -199,7 +199,7 @@ TEST_F(AwsClusterManagerTest, CallbacksTriggeredImmediatelyWhenClusterIsLive) {
 // Cluster manager cannot add a cluster
 TEST_F(AwsClusterManagerTest, ClusterManagerCannotAdd) {
   EXPECT_CALL(context_, clusterManager()).WillRepeatedly(ReturnRef(cm_));
-  EXPECT_CALL(cm_, addOrUpdateCluster(_, _, _)).WillOnce(Return(absl::InternalError("")));
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _, _, _)).WillOnce(Return(absl::InternalError("")));
   EXPECT_CALL(context_.init_manager_, state())
       .WillRepeatedly(Return(Envoy::Init::Manager::State::Initialized));
 
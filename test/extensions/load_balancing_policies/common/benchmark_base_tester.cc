@@ -36,5 +36,14 @@ BaseTester::BaseTester(uint64_t num_hosts, uint32_t weighted_subset_percent, uin
       random_.random(), absl::nullopt);
 }
 
+void BaseTester::updateHosts(const HostVector& hosts, const HostVector& hosts_added,
+                             const HostVector& hosts_removed) {
+  Upstream::HostVectorConstSharedPtr updated_hosts = std::make_shared<Upstream::HostVector>(hosts);
+  priority_set_.updateHosts(0,
+                            Upstream::HostSetImpl::partitionHosts(
+                                updated_hosts, Upstream::makeHostsPerLocality({hosts})),
+                            {}, hosts_added, hosts_removed, random_.random(), absl::nullopt);
+}
+
 } // namespace Upstream
 } // namespace Envoy
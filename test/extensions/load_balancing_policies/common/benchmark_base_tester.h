@@ -25,6 +25,10 @@ public:
   BaseTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
              bool attach_metadata = false);
 
+  // Replaces the hosts of priority 0 with the given hosts, all of which are healthy.
+  void updateHosts(const HostVector& hosts, const HostVector& hosts_added,
+                   const HostVector& hosts_removed);
+
   Envoy::Thread::MutexBasicLockable lock_;
   // Reduce default log level to warn while running this benchmark to avoid problems due to
   // excessive debug logging in upstream_impl.cc
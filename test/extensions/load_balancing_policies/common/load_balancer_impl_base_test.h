@@ -47,6 +47,9 @@ public:
   static double slowStartMinWeightPercent(const EdfLoadBalancerBase& edf_lb) {
     return edf_lb.slow_start_min_weight_percent_;
   }
+  static size_t numSchedulers(const EdfLoadBalancerBase& edf_lb) {
+    return edf_lb.scheduler_.size();
+  }
 };
 
 class TestZoneAwareLoadBalancer : public ZoneAwareLoadBalancerBase {
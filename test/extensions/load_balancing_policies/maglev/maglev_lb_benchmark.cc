@@ -1,7 +1,10 @@
+#include "envoy/extensions/load_balancing_policies/maglev/v3/maglev.pb.h"
+
 #include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
 
 #include "test/benchmark/main.h"
 #include "test/extensions/load_balancing_policies/common/benchmark_base_tester.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -9,14 +12,23 @@ namespace {
 
 class MaglevTester : public BaseTester {
 public:
-  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
+               bool build_tables_in_background = false)
       : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    if (build_tables_in_background) {
+      envoy::extensions::load_balancing_policies::maglev::v3::Maglev config;
+      config.mutable_consistent_hashing_lb_config()->set_build_tables_in_background(true);
+      maglev_lb_ = std::make_unique<MaglevLoadBalancer>(
+          priority_set_, stats_, stats_scope_, runtime_, random_, 50, config, simTime(),
+          std::make_shared<TableBuildThread>(Thread::threadFactoryForTest()));
+      return;
+    }
     maglev_lb_ = std::make_unique<MaglevLoadBalancer>(
         priority_set_, stats_, stats_scope_, runtime_, random_,
         config_.has_value()
             ? makeOptRef<const envoy::config::cluster::v3::Cluster::MaglevLbConfig>(config_.value())
             : absl::nullopt,
-        common_config_);
+        common_config_, simTime());
   }
 
   absl::optional<envoy::config::cluster::v3::Cluster::MaglevLbConfig> config_;
@@ -184,6 +196,44 @@ BENCHMARK(benchmarkMaglevLoadBalancerWeighted)
     ->Args({500, 95, 75, 25, 10000})
     ->Unit(::benchmark::kMillisecond);
 
+// Benchmark args:
+// 1. Number of hosts.
+// 2. Whether tables are built in the background (0 or 1).
+void benchmarkMaglevLoadBalancerHostChurn(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const bool build_tables_in_background = state.range(1) != 0;
+
+  MaglevTester tester(num_hosts, 0, 0, build_tables_in_background);
+  ASSERT_TRUE(tester.maglev_lb_->initialize().ok());
+  const HostVector hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  const HostVector hosts_without_last(hosts.begin(), hosts.end() - 1);
+
+  // Flap the last host in and out of the cluster. Only the main thread's handling of the updates
+  // is timed, which includes the table builds unless they are moved to the background.
+  bool removed = false;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    removed = !removed;
+    if (removed) {
+      tester.updateHosts(hosts_without_last, {}, {hosts.back()});
+    } else {
+      tester.updateHosts(hosts, {hosts.back()}, {});
+    }
+  }
+
+  // Wait for any ongoing build before reporting how many were done.
+  tester.maglev_lb_.reset();
+  state.counters["table_builds"] =
+      tester.stats_store_.counterFromString("maglev_lb.table_builds").value();
+  state.counters["table_builds_collapsed"] =
+      tester.stats_store_.counterFromString("maglev_lb.table_builds_collapsed").value();
+}
+BENCHMARK(benchmarkMaglevLoadBalancerHostChurn)
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({500, 0})
+    ->Args({500, 1})
+    ->Unit(::benchmark::kMicrosecond);
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -1,6 +1,7 @@
 #include <memory>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/extensions/load_balancing_policies/maglev/v3/maglev.pb.h"
 
 #include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
 
@@ -13,6 +14,8 @@
 #include "test/mocks/upstream/priority_set.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
 
 #include "absl/types/optional.h"
 
@@ -56,7 +59,7 @@ public:
         config_.has_value()
             ? makeOptRef<const envoy::config::cluster::v3::Cluster::MaglevLbConfig>(config_.value())
             : absl::nullopt,
-        common_config_);
+        common_config_, simTime());
   }
 
   void init(uint64_t table_size, bool locality_weighted_balancing = false) {
@@ -566,6 +569,102 @@ TEST_F(MaglevLoadBalancerTest, LocalityWeightedLopsided) {
   EXPECT_EQ(MaglevTable::DefaultTableSize - 1023, counts[0]);
 }
 
+// Table builds are counted, and the tables of unchanged priorities are reused. Worker load
+// balancers pick up new tables without being recreated.
+TEST_F(MaglevLoadBalancerTest, TableBuildStats) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  init(7);
+  EXPECT_EQ("maglev_lb.table_builds", lb_->tableBuildStats().table_builds_.name());
+  EXPECT_EQ("maglev_lb.last_table_build_time_ms",
+            lb_->tableBuildStats().last_table_build_time_ms_.name());
+  EXPECT_EQ(1, lb_->tableBuildStats().table_builds_.value());
+  EXPECT_EQ(0, lb_->tableBuildStats().tables_reused_.value());
+
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+
+  // Nothing changed, so the table is reused.
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(2, lb_->tableBuildStats().table_builds_.value());
+  EXPECT_EQ(1, lb_->tableBuildStats().tables_reused_.value());
+
+  host_set_.healthy_hosts_ = {host_set_.hosts_[0], host_set_.hosts_[1]};
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(3, lb_->tableBuildStats().table_builds_.value());
+  EXPECT_EQ(1, lb_->tableBuildStats().tables_reused_.value());
+  EXPECT_EQ(0, lb_->tableBuildStats().table_builds_collapsed_.value());
+
+  for (uint32_t i = 0; i < 7; ++i) {
+    TestLoadBalancerContext context(i);
+    EXPECT_NE(host_set_.hosts_[2], lb->chooseHost(&context).host);
+  }
+}
+
+// Tables are built on a background thread once the load balancer is initialized.
+TEST_F(MaglevLoadBalancerTest, BackgroundTableBuilds) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+
+  envoy::extensions::load_balancing_policies::maglev::v3::Maglev config;
+  config.mutable_table_size()->set_value(7);
+  config.mutable_consistent_hashing_lb_config()->set_build_tables_in_background(true);
+  auto table_build_thread = std::make_shared<TableBuildThread>(Thread::threadFactoryForTest());
+  lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, *stats_store_.rootScope(),
+                                             runtime_, random_, 50, config, simTime(),
+                                             table_build_thread);
+
+  // The initial table is built synchronously.
+  EXPECT_TRUE(lb_->initialize().ok());
+  EXPECT_EQ(1, lb_->tableBuildStats().table_builds_.value());
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  TestLoadBalancerContext initial_context(0);
+  EXPECT_NE(nullptr, lb->chooseHost(&initial_context).host);
+
+  host_set_.healthy_hosts_ = {host_set_.hosts_[0], host_set_.hosts_[1]};
+  host_set_.runCallbacks({}, {});
+  EXPECT_TRUE(
+      TestUtility::waitForCounterEq(stats_store_, "maglev_lb.table_builds", 2, simTime()));
+
+  for (uint32_t i = 0; i < 7; ++i) {
+    TestLoadBalancerContext context(i);
+    EXPECT_NE(host_set_.hosts_[2], lb->chooseHost(&context).host);
+  }
+
+  // Load balancers share the build thread. Destroying one drops its pending build, and neither
+  // waits for nor stops the builds of the other ones.
+  NiceMock<MockPrioritySet> other_priority_set;
+  MockHostSet& other_host_set = *other_priority_set.getMockHostSet(0);
+  other_host_set.hosts_ = host_set_.hosts_;
+  other_host_set.healthy_hosts_ = host_set_.hosts_;
+  Stats::IsolatedStoreImpl other_stats_store;
+  auto other_lb = std::make_unique<MaglevLoadBalancer>(
+      other_priority_set, stats_, *other_stats_store.rootScope(), runtime_, random_, 50, config,
+      simTime(), table_build_thread);
+  EXPECT_TRUE(other_lb->initialize().ok());
+
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  lb_.reset();
+  EXPECT_NE(nullptr, lb->chooseHost(&initial_context).host);
+
+  other_host_set.healthy_hosts_ = {other_host_set.hosts_[0], other_host_set.hosts_[1]};
+  other_host_set.runCallbacks({}, {});
+  EXPECT_TRUE(
+      TestUtility::waitForCounterEq(other_stats_store, "maglev_lb.table_builds", 2, simTime()));
+  LoadBalancerPtr other_worker_lb = other_lb->factory()->create(lb_params_);
+  for (uint32_t i = 0; i < 7; ++i) {
+    TestLoadBalancerContext context(i);
+    EXPECT_NE(other_host_set.hosts_[2], other_worker_lb->chooseHost(&context).host);
+  }
+  other_lb.reset();
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -0,0 +1,90 @@
+#include "envoy/config/core/v3/extension.pb.h"
+
+#include "source/extensions/load_balancing_policies/peak_ewma/config.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/mocks/upstream/priority_set.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace PeakEwma {
+namespace {
+
+TEST(PeakEwmaConfigTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  NiceMock<Upstream::MockClusterInfo> cluster_info;
+  NiceMock<Upstream::MockPrioritySet> main_thread_priority_set;
+  NiceMock<Upstream::MockPrioritySet> thread_local_priority_set;
+
+  envoy::config::core::v3::TypedExtensionConfig config;
+  config.set_name("envoy.load_balancing_policies.peak_ewma");
+  envoy::extensions::load_balancing_policies::peak_ewma::v3::PeakEwma config_msg;
+  config.mutable_typed_config()->PackFrom(config_msg);
+
+  auto& factory = Config::Utility::getAndCheckFactory<Upstream::TypedLoadBalancerFactory>(config);
+  EXPECT_EQ("envoy.load_balancing_policies.peak_ewma", factory.name());
+
+  auto lb_config = factory.loadConfig(context, *factory.createEmptyConfigProto()).value();
+  auto thread_aware_lb =
+      factory.create(*lb_config, cluster_info, main_thread_priority_set, context.runtime_loader_,
+                     context.api_.random_, context.time_system_);
+  EXPECT_NE(nullptr, thread_aware_lb);
+
+  ASSERT_TRUE(thread_aware_lb->initialize().ok());
+
+  auto thread_local_lb_factory = thread_aware_lb->factory();
+  EXPECT_NE(nullptr, thread_local_lb_factory);
+  EXPECT_FALSE(thread_local_lb_factory->recreateOnHostChange());
+
+  auto thread_local_lb = thread_local_lb_factory->create({thread_local_priority_set, nullptr});
+  EXPECT_NE(nullptr, thread_local_lb);
+}
+
+TEST(PeakEwmaConfigTest, Durations) {
+  Upstream::PeakEwmaLbConfig lb_config(PeakEwmaLbProto{});
+  EXPECT_EQ(std::chrono::seconds(10), lb_config.decay_time_);
+  EXPECT_EQ(std::chrono::milliseconds(10), lb_config.default_rtt_);
+
+  PeakEwmaLbProto lb_proto;
+  lb_proto.mutable_decay_time()->set_seconds(1);
+  lb_proto.mutable_default_rtt()->set_nanos(50000000);
+  Upstream::PeakEwmaLbConfig configured_lb_config(lb_proto);
+  EXPECT_EQ(std::chrono::seconds(1), configured_lb_config.decay_time_);
+  EXPECT_EQ(std::chrono::milliseconds(50), configured_lb_config.default_rtt_);
+}
+
+// Hosts get peak EWMA data when the load balancer is initialized, and whenever they are added.
+TEST(PeakEwmaConfigTest, AttachesLbPolicyDataToHosts) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  NiceMock<Upstream::MockClusterInfo> cluster_info;
+  NiceMock<Upstream::MockPrioritySet> main_thread_priority_set;
+  auto info = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+
+  auto initial_host = Upstream::makeTestHost(info, "tcp://127.0.0.1:80", context.time_system_);
+  main_thread_priority_set.getMockHostSet(0)->hosts_ = {initial_host};
+
+  auto& factory = Config::Utility::getAndCheckFactoryByName<Upstream::TypedLoadBalancerFactory>(
+      "envoy.load_balancing_policies.peak_ewma");
+  auto lb_config = factory.loadConfig(context, *factory.createEmptyConfigProto()).value();
+  auto thread_aware_lb =
+      factory.create(*lb_config, cluster_info, main_thread_priority_set, context.runtime_loader_,
+                     context.api_.random_, context.time_system_);
+  ASSERT_TRUE(thread_aware_lb->initialize().ok());
+  EXPECT_TRUE(initial_host->typedLbPolicyData<Upstream::PeakEwmaHostLbPolicyData>().has_value());
+
+  auto added_host = Upstream::makeTestHost(info, "tcp://127.0.0.1:81", context.time_system_);
+  main_thread_priority_set.getMockHostSet(0)->hosts_ = {initial_host, added_host};
+  main_thread_priority_set.runUpdateCallbacks(0, {added_host}, {});
+  EXPECT_TRUE(added_host->typedLbPolicyData<Upstream::PeakEwmaHostLbPolicyData>().has_value());
+}
+
+} // namespace
+} // namespace PeakEwma
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
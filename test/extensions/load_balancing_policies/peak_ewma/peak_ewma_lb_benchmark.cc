@@ -0,0 +1,121 @@
+#include "source/common/common/utility.h"
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include "test/benchmark/main.h"
+#include "test/extensions/load_balancing_policies/common/benchmark_base_tester.h"
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class PeakEwmaTester : public BaseTester {
+public:
+  PeakEwmaTester(uint64_t num_hosts) : BaseTester(num_hosts) {
+    peak_ewma_lb_ = std::make_unique<PeakEwmaThreadAwareLoadBalancer>(
+        lb_config_, *info_, priority_set_, runtime_, random_, simTime());
+  }
+
+  PeakEwmaLbConfig lb_config_{PeakEwmaLbProto{}};
+  std::unique_ptr<PeakEwmaThreadAwareLoadBalancer> peak_ewma_lb_;
+};
+
+void benchmarkPeakEwmaLoadBalancerChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t keys_to_simulate = state.range(1);
+
+  if (benchmark::skipExpensiveBenchmarks() && keys_to_simulate > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    PeakEwmaTester tester(num_hosts);
+    ASSERT_TRUE(tester.peak_ewma_lb_->initialize().ok());
+    LoadBalancerPtr lb = tester.peak_ewma_lb_->factory()->create(tester.lb_params_);
+    absl::node_hash_map<std::string, uint64_t> hit_counter;
+    TestLoadBalancerContext context;
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < keys_to_simulate; ++i) {
+      hit_counter[lb->chooseHost(&context).host->address()->asString()] += 1;
+    }
+
+    // Do not time computation of mean, standard deviation, and relative standard deviation.
+    state.PauseTiming();
+    computeHitStats(state, hit_counter);
+    state.ResumeTiming();
+  }
+}
+// Benchmark args: number of hosts, number of picks.
+BENCHMARK(benchmarkPeakEwmaLoadBalancerChooseHost)
+    ->Args({100, 1000})
+    ->Args({10000, 1000})
+    ->Args({100, 1000000})
+    ->Args({10000, 1000000})
+    ->Unit(::benchmark::kMillisecond);
+
+// Feeds the response time of every pick back to the picked host, with a tenth of the hosts
+// responding ten times slower than the others, and reports the share of picks that went to the
+// slow hosts.
+void benchmarkPeakEwmaLoadBalancerWithSlowHosts(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t keys_to_simulate = state.range(1);
+
+  if (benchmark::skipExpensiveBenchmarks() && keys_to_simulate > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    PeakEwmaTester tester(num_hosts);
+    ASSERT_TRUE(tester.peak_ewma_lb_->initialize().ok());
+    LoadBalancerPtr lb = tester.peak_ewma_lb_->factory()->create(tester.lb_params_);
+    absl::flat_hash_set<const Host*> slow_hosts;
+    const HostVector& hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+    for (uint64_t i = 0; i < num_hosts / 10; ++i) {
+      slow_hosts.insert(hosts[i].get());
+    }
+    uint64_t slow_host_picks = 0;
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < keys_to_simulate; ++i) {
+      HostConstSharedPtr host = lb->chooseHost(nullptr).host;
+      const bool slow = slow_hosts.contains(host.get());
+      slow_host_picks += slow;
+      host->lbPolicyData()->onResponseTime(std::chrono::milliseconds(slow ? 100 : 10));
+    }
+
+    state.counters["slow_host_pick_ratio"] = double(slow_host_picks) / keys_to_simulate;
+  }
+}
+// Benchmark args: number of hosts, number of picks.
+BENCHMARK(benchmarkPeakEwmaLoadBalancerWithSlowHosts)
+    ->Args({100, 1000})
+    ->Args({10000, 1000})
+    ->Args({100, 1000000})
+    ->Args({10000, 1000000})
+    ->Unit(::benchmark::kMillisecond);
+
+// Reports response times to a single host from several threads at once, to measure the cost of
+// contended updates to the lock-free per host state.
+void benchmarkPeakEwmaResponseTimeUpdates(::benchmark::State& state) {
+  static RealTimeSource time_source;
+  static PeakEwmaHostLbPolicyData lb_policy_data(std::chrono::seconds(10), std::chrono::seconds(1),
+                                                 time_source);
+
+  uint64_t response_time_us = 1000 + state.thread_index();
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    lb_policy_data.onResponseTime(std::chrono::microseconds(response_time_us));
+    response_time_us = response_time_us % 20000 + 1000;
+  }
+  ::benchmark::DoNotOptimize(lb_policy_data.rtt(time_source.monotonicTime(), false));
+}
+BENCHMARK(benchmarkPeakEwmaResponseTimeUpdates)->ThreadRange(1, 8);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,229 @@
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include "test/extensions/load_balancing_policies/common/load_balancer_impl_base_test.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+using testing::Return;
+
+class PeakEwmaHostLbPolicyDataTest : public Event::TestUsingSimulatedTime, public testing::Test {
+public:
+  PeakEwmaHostLbPolicyData data_{std::chrono::seconds(10), std::chrono::seconds(1), simTime()};
+};
+
+TEST_F(PeakEwmaHostLbPolicyDataTest, NoResponseTimes) {
+  EXPECT_EQ(0, data_.rtt(simTime().monotonicTime(), false));
+}
+
+// Response times above the average replace it immediately.
+TEST_F(PeakEwmaHostLbPolicyDataTest, PeakReplacesAverage) {
+  data_.onResponseTime(std::chrono::milliseconds(10));
+  EXPECT_DOUBLE_EQ(10000, data_.rtt(simTime().monotonicTime(), false));
+  data_.onResponseTime(std::chrono::milliseconds(30));
+  EXPECT_DOUBLE_EQ(30000, data_.rtt(simTime().monotonicTime(), false));
+}
+
+// Response times below the average are blended in following the time since the last response.
+TEST_F(PeakEwmaHostLbPolicyDataTest, AverageDecays) {
+  data_.onResponseTime(std::chrono::milliseconds(30));
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_DOUBLE_EQ(30000 * std::exp(-1.0), data_.rtt(simTime().monotonicTime(), false));
+
+  data_.onResponseTime(std::chrono::milliseconds(10));
+  const double expected = 30000 * std::exp(-1.0) + 10000 * (1 - std::exp(-1.0));
+  EXPECT_DOUBLE_EQ(expected, data_.rtt(simTime().monotonicTime(), false));
+
+  // Without elapsed time, a lower response time does not move the average at all.
+  data_.onResponseTime(std::chrono::milliseconds(1));
+  EXPECT_DOUBLE_EQ(expected, data_.rtt(simTime().monotonicTime(), false));
+}
+
+// Failed requests are reported with the penalty added to their elapsed time.
+TEST_F(PeakEwmaHostLbPolicyDataTest, FailurePenalty) {
+  data_.onResponseTime(std::chrono::milliseconds(10));
+  data_.onRequestFailure(std::chrono::milliseconds(500));
+  EXPECT_DOUBLE_EQ(1500000, data_.rtt(simTime().monotonicTime(), false));
+}
+
+// The average does not decay below the last response time while requests are outstanding.
+TEST_F(PeakEwmaHostLbPolicyDataTest, NoDecayBelowLastResponseTimeWhileOutstanding) {
+  data_.onRequestFailure(std::chrono::milliseconds(500));
+  simTime().advanceTimeWait(std::chrono::seconds(60));
+  EXPECT_DOUBLE_EQ(1500000, data_.rtt(simTime().monotonicTime(), true));
+  EXPECT_DOUBLE_EQ(1500000 * std::exp(-6.0), data_.rtt(simTime().monotonicTime(), false));
+}
+
+class PeakEwmaLoadBalancerTest : public LoadBalancerTestBase {
+public:
+  void init() {
+    lb_ = std::make_shared<PeakEwmaLoadBalancer>(priority_set_, nullptr, stats_, runtime_, random_,
+                                                 50, lb_config_, simTime());
+  }
+
+  void initHosts(uint32_t num_hosts) {
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      hostSet().healthy_hosts_.push_back(
+          makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 80 + i), simTime()));
+      hostSet().healthy_hosts_.back()->setLbPolicyData(std::make_unique<PeakEwmaHostLbPolicyData>(
+          lb_config_.decay_time_, lb_config_.failure_penalty_, simTime()));
+    }
+    hostSet().hosts_ = hostSet().healthy_hosts_;
+    hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+  }
+
+  void respond(uint32_t host_index, std::chrono::microseconds response_time) {
+    hostSet().healthy_hosts_[host_index]->lbPolicyData()->onResponseTime(response_time);
+  }
+
+  void fail(uint32_t host_index, std::chrono::microseconds elapsed) {
+    hostSet().healthy_hosts_[host_index]->lbPolicyData()->onRequestFailure(elapsed);
+  }
+
+  // The low 32 bits of the random value pick the first host, and the high 32 bits pick how many
+  // hosts to skip for the second one.
+  static uint64_t randomValue(uint32_t first, uint32_t skip) {
+    return (uint64_t(skip) << 32) | first;
+  }
+
+  PeakEwmaLbConfig lb_config_{PeakEwmaLbProto{}};
+  std::shared_ptr<LoadBalancer> lb_;
+};
+
+TEST_P(PeakEwmaLoadBalancerTest, NoHosts) {
+  init();
+  EXPECT_EQ(nullptr, lb_->peekAnotherHost(nullptr));
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, SingleHost) {
+  init();
+  initHosts(1);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
+// The host with the lower response time wins, regardless of the order of the candidates.
+TEST_P(PeakEwmaLoadBalancerTest, LowerResponseTimeWins) {
+  init();
+  initHosts(2);
+  respond(0, std::chrono::milliseconds(100));
+  respond(1, std::chrono::milliseconds(20));
+
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(randomValue(0, 0)))
+      .WillOnce(Return(randomValue(1, 0)));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+}
+
+// The second candidate skips over the first one, so the two candidates are always distinct.
+TEST_P(PeakEwmaLoadBalancerTest, DistinctCandidates) {
+  init();
+  initHosts(3);
+  respond(0, std::chrono::milliseconds(30));
+  respond(1, std::chrono::milliseconds(20));
+  respond(2, std::chrono::milliseconds(10));
+
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(randomValue(0, 0)))
+      .WillOnce(Return(randomValue(0, 1)))
+      .WillOnce(Return(randomValue(2, 0)))
+      .WillOnce(Return(randomValue(2, 1)));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
+}
+
+// The response time is scaled by the number of active requests plus one.
+TEST_P(PeakEwmaLoadBalancerTest, ActiveRequestsRaiseCost) {
+  init();
+  initHosts(2);
+  respond(0, std::chrono::milliseconds(10));
+  respond(1, std::chrono::milliseconds(20));
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(2);
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(randomValue(0, 0)));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+
+  // Ties go to the first candidate.
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(1);
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(randomValue(0, 0)))
+      .WillOnce(Return(randomValue(1, 0)));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+}
+
+// Hosts without response times are assumed to respond in the default response time.
+TEST_P(PeakEwmaLoadBalancerTest, DefaultResponseTime) {
+  init();
+  initHosts(3);
+  // Hosts without lb policy data are treated the same as hosts without response times.
+  hostSet().healthy_hosts_[2]->setLbPolicyData(nullptr);
+  respond(0, std::chrono::milliseconds(20));
+
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(randomValue(0, 0)))
+      .WillOnce(Return(randomValue(0, 1)));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
+
+  respond(1, std::chrono::milliseconds(5));
+  EXPECT_CALL(random_, random()).WillOnce(Return(randomValue(1, 1)));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+}
+
+// A host whose requests time out stays more expensive than a responsive host while it still has
+// outstanding requests, however long it has been since its last timeout.
+TEST_P(PeakEwmaLoadBalancerTest, TimingOutHost) {
+  init();
+  initHosts(2);
+  respond(0, std::chrono::milliseconds(20));
+  respond(1, std::chrono::milliseconds(20));
+  fail(0, std::chrono::seconds(15));
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(1);
+
+  simTime().advanceTimeWait(std::chrono::seconds(100));
+  respond(1, std::chrono::milliseconds(20));
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(randomValue(0, 0)))
+      .WillOnce(Return(randomValue(1, 0)));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+
+  // Once its requests complete, the host decays like any idle host and is probed again.
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(0);
+  EXPECT_CALL(random_, random()).WillOnce(Return(randomValue(0, 0)));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
+// Peeked hosts are chosen in order, using the random values they were peeked with.
+TEST_P(PeakEwmaLoadBalancerTest, PeekThenChoose) {
+  init();
+  initHosts(2);
+  respond(0, std::chrono::milliseconds(10));
+  respond(1, std::chrono::milliseconds(20));
+
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(randomValue(0, 0)))
+      .WillOnce(Return(randomValue(1, 0)));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->peekAnotherHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->peekAnotherHost(nullptr));
+
+  EXPECT_CALL(random_, random()).Times(0);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, PeakEwmaLoadBalancerTest,
+                         ::testing::Values(LoadBalancerTestParam{true},
+                                           LoadBalancerTestParam{false}));
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
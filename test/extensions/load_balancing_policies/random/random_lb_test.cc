@@ -45,6 +45,52 @@ TEST_P(RandomLoadBalancerTest, Normal) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
 }
 
+// With an alias table, hosts are picked following their weights. The low bits of the random
+// value choose a column of the table, and the high bits choose between the column's host and its
+// alias.
+TEST_P(RandomLoadBalancerTest, WeightedWithAliasTable) {
+  envoy::extensions::load_balancing_policies::random::v3::Random random_config;
+  random_config.set_use_alias_table(true);
+  lb_ = std::make_shared<RandomLoadBalancer>(priority_set_, nullptr, stats_, runtime_, random_, 50,
+                                             random_config);
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 3)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  // The first column is half the first host, and half the second one. The second column is the
+  // second host only.
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(0))
+      .WillOnce(Return(uint64_t(1) << 63))
+      .WillOnce(Return(uint64_t(1) << 31))
+      .WillOnce(Return(uint64_t(1) << 62));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->peekAnotherHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->peekAnotherHost(nullptr));
+
+  // Peeked hosts are chosen in order.
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
+// Without differing weights, no alias table is needed and hosts are picked uniformly.
+TEST_P(RandomLoadBalancerTest, AliasTableWithEqualWeights) {
+  envoy::extensions::load_balancing_policies::random::v3::Random random_config;
+  random_config.set_use_alias_table(true);
+  lb_ = std::make_shared<RandomLoadBalancer>(priority_set_, nullptr, stats_, runtime_, random_, 50,
+                                             random_config);
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 2),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(2)).WillOnce(Return(3));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+}
+
 TEST_P(RandomLoadBalancerTest, FailClusterOnPanic) {
   common_config_.mutable_zone_aware_lb_config()->set_fail_traffic_on_panic(true);
   init();
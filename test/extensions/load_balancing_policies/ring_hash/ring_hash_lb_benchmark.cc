@@ -1,7 +1,10 @@
+#include "envoy/extensions/load_balancing_policies/ring_hash/v3/ring_hash.pb.h"
+
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
 
 #include "test/benchmark/main.h"
 #include "test/extensions/load_balancing_policies/common/benchmark_base_tester.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -9,7 +12,18 @@ namespace {
 
 class RingHashTester : public BaseTester {
 public:
-  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
+  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size,
+                 bool build_tables_in_background = false)
+      : BaseTester(num_hosts) {
+    if (build_tables_in_background) {
+      envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash config;
+      config.mutable_minimum_ring_size()->set_value(min_ring_size);
+      config.mutable_consistent_hashing_lb_config()->set_build_tables_in_background(true);
+      ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(
+          priority_set_, stats_, stats_scope_, runtime_, random_, 50, config, simTime(),
+          std::make_shared<TableBuildThread>(Thread::threadFactoryForTest()));
+      return;
+    }
     config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
     config_.value().mutable_minimum_ring_size()->set_value(min_ring_size);
     ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(
@@ -18,7 +32,7 @@ public:
             ? makeOptRef<const envoy::config::cluster::v3::Cluster::RingHashLbConfig>(
                   config_.value())
             : absl::nullopt,
-        common_config_);
+        common_config_, simTime());
   }
 
   absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig> config_;
@@ -146,6 +160,53 @@ BENCHMARK(benchmarkRingHashLoadBalancerHostLoss)
     ->Args({500, 256000, 3, 10000})
     ->Unit(::benchmark::kMillisecond);
 
+// Benchmark args:
+// 1. Number of hosts.
+// 2. Minimum ring size.
+// 3. Whether rings are built in the background (0 or 1).
+void benchmarkRingHashLoadBalancerHostChurn(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  const bool build_tables_in_background = state.range(2) != 0;
+
+  if (benchmark::skipExpensiveBenchmarks() && min_ring_size > 65536) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  RingHashTester tester(num_hosts, min_ring_size, build_tables_in_background);
+  ASSERT_TRUE(tester.ring_hash_lb_->initialize().ok());
+  const HostVector hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  const HostVector hosts_without_last(hosts.begin(), hosts.end() - 1);
+
+  // Flap the last host in and out of the cluster. Only the main thread's handling of the updates
+  // is timed, which includes the ring builds unless they are moved to the background.
+  bool removed = false;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    removed = !removed;
+    if (removed) {
+      tester.updateHosts(hosts_without_last, {}, {hosts.back()});
+    } else {
+      tester.updateHosts(hosts, {hosts.back()}, {});
+    }
+  }
+
+  // Wait for any ongoing build before reporting how many were done.
+  tester.ring_hash_lb_.reset();
+  state.counters["table_builds"] =
+      tester.stats_store_.counterFromString("ring_hash_lb.table_builds").value();
+  state.counters["table_builds_collapsed"] =
+      tester.stats_store_.counterFromString("ring_hash_lb.table_builds_collapsed").value();
+}
+BENCHMARK(benchmarkRingHashLoadBalancerHostChurn)
+    ->Args({100, 65536, 0})
+    ->Args({100, 65536, 1})
+    ->Args({500, 65536, 0})
+    ->Args({500, 65536, 1})
+    ->Args({500, 256000, 0})
+    ->Args({500, 256000, 1})
+    ->Unit(::benchmark::kMicrosecond);
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
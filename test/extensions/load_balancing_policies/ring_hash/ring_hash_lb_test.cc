@@ -4,6 +4,7 @@
 #include <string>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/extensions/load_balancing_policies/ring_hash/v3/ring_hash.pb.h"
 #include "envoy/router/router.h"
 
 #include "source/common/network/utility.h"
@@ -19,6 +20,8 @@
 #include "test/mocks/upstream/load_balancer_context.h"
 #include "test/mocks/upstream/priority_set.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
 
 #include "absl/container/node_hash_map.h"
 #include "absl/types/optional.h"
@@ -72,7 +75,7 @@ public:
             ? makeOptRef<const envoy::config::cluster::v3::Cluster::RingHashLbConfig>(
                   config_.value())
             : absl::nullopt,
-        common_config_);
+        common_config_, simTime());
     EXPECT_TRUE(lb_->initialize().ok());
   }
 
@@ -112,7 +115,7 @@ TEST_P(RingHashLoadBalancerTest, ChooseHostBeforeInit) {
       config_.has_value()
           ? makeOptRef<const envoy::config::cluster::v3::Cluster::RingHashLbConfig>(config_.value())
           : absl::nullopt,
-      common_config_);
+      common_config_, simTime());
   EXPECT_EQ(nullptr, lb_->factory()->create(lb_params_)->chooseHost(nullptr).host);
 }
 
@@ -272,6 +275,72 @@ TEST_P(RingHashFailoverTest, BasicFailover) {
   EXPECT_EQ(failover_host_set_.healthy_hosts_[0], lb->chooseHost(nullptr).host);
 }
 
+// Ensure that only the tables of priorities whose hosts changed are rebuilt.
+TEST_P(RingHashFailoverTest, TablesOfUnchangedPrioritiesReused) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  failover_host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:82", simTime())};
+  failover_host_set_.healthy_hosts_ = failover_host_set_.hosts_;
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  init();
+  EXPECT_EQ("ring_hash_lb.tables_reused", lb_->tableBuildStats().tables_reused_.name());
+  EXPECT_EQ(1, lb_->tableBuildStats().table_builds_.value());
+  EXPECT_EQ(0, lb_->tableBuildStats().tables_reused_.value());
+
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  EXPECT_EQ(host_set_.healthy_hosts_[0], lb->chooseHost(nullptr).host);
+
+  // Only P=1 changes, so the P=0 ring is reused.
+  failover_host_set_.hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:83", simTime()));
+  failover_host_set_.healthy_hosts_ = failover_host_set_.hosts_;
+  failover_host_set_.runCallbacks({failover_host_set_.hosts_[1]}, {});
+  EXPECT_EQ(2, lb_->tableBuildStats().table_builds_.value());
+  EXPECT_EQ(1, lb_->tableBuildStats().tables_reused_.value());
+
+  // P=0 is now in panic, so its ring is still built from the same hosts and reused. The worker
+  // load balancer picks up the new priority loads without being recreated.
+  host_set_.healthy_hosts_ = {};
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(3, lb_->tableBuildStats().table_builds_.value());
+  EXPECT_EQ(3, lb_->tableBuildStats().tables_reused_.value());
+  EXPECT_NE(host_set_.hosts_[0], lb->chooseHost(nullptr).host);
+}
+
+// Ensure that rings are rebuilt on a background thread once the load balancer is initialized.
+TEST_P(RingHashFailoverTest, BackgroundTableBuilds) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:81", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:82", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+
+  envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash config;
+  config.mutable_minimum_ring_size()->set_value(12);
+  config.mutable_consistent_hashing_lb_config()->set_build_tables_in_background(true);
+  auto table_build_thread = std::make_shared<TableBuildThread>(Thread::threadFactoryForTest());
+  lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, *stats_store_.rootScope(),
+                                               runtime_, random_, 50, config, simTime(),
+                                               table_build_thread);
+
+  // The initial ring is built synchronously.
+  EXPECT_TRUE(lb_->initialize().ok());
+  EXPECT_EQ(1, lb_->tableBuildStats().table_builds_.value());
+  EXPECT_EQ(12, lb_->stats().size_.value());
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+
+  host_set_.healthy_hosts_ = {host_set_.hosts_[0], host_set_.hosts_[1]};
+  host_set_.runCallbacks({}, {});
+  EXPECT_TRUE(
+      TestUtility::waitForCounterEq(stats_store_, "ring_hash_lb.table_builds", 2, simTime()));
+
+  for (uint64_t hash : {0UL, 3551244743356806947UL, 7700377290971790572UL,
+                        std::numeric_limits<uint64_t>::max()}) {
+    TestLoadBalancerContext context(hash);
+    EXPECT_NE(host_set_.hosts_[2], lb->chooseHost(&context).host);
+  }
+}
+
 // Expect reasonable results with Murmur2 hash.
 TEST_P(RingHashLoadBalancerTest, BasicWithMurmur2) {
   hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
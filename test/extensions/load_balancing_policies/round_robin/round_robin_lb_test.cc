@@ -407,22 +407,22 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
-  // Add a host, it should participate in next round of scheduling.
+  // Add a host, it is added to the current schedule and participates from the next pick on.
   hostSet().healthy_hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 3));
   hostSet().hosts_.push_back(hostSet().healthy_hosts_.back());
   hostSet().runCallbacks({hostSet().healthy_hosts_.back()}, {});
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
-  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
-  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
   // Remove last two hosts, add a new one with different weights.
   HostVector removed_hosts = {hostSet().hosts_[1], hostSet().hosts_[2]};
   hostSet().healthy_hosts_.pop_back();
@@ -445,6 +445,89 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
 }
 
+// Host set updates that leave the hosts of a weighted source unchanged keep its schedule, while
+// removing a host from it rebuilds the schedule.
+TEST_P(RoundRobinLoadBalancerTest, WeightedScheduleKeptAcrossUpdates) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  // The schedule continues where it was rather than starting over.
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+
+  // A host turning unhealthy is removed from the schedule.
+  const HostSharedPtr unhealthy_host = hostSet().healthy_hosts_[1];
+  hostSet().healthy_hosts_.pop_back();
+  hostSet().healthy_hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 3));
+  hostSet().hosts_.push_back(hostSet().healthy_hosts_.back());
+  hostSet().runCallbacks({hostSet().healthy_hosts_.back()}, {});
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_NE(unhealthy_host, lb_->chooseHost(nullptr).host);
+  }
+}
+
+TEST_P(RoundRobinLoadBalancerTest, WeightedScheduleRebuiltWithoutIncrementalUpdates) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.incremental_host_set_updates", "false"}});
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  // The schedule starts over.
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+}
+
+// The schedulers of localities that are gone are dropped along with the hosts they hold.
+TEST_P(RoundRobinLoadBalancerTest, RemovedLocalitySchedulersDropped) {
+  envoy::config::core::v3::Locality zone_a;
+  zone_a.set_zone("A");
+  envoy::config::core::v3::Locality zone_b;
+  zone_b.set_zone("B");
+  envoy::config::core::v3::Locality zone_c;
+  zone_c.set_zone("C");
+
+  HostVector hosts({makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), zone_a, 1),
+                    makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), zone_a, 2),
+                    makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), zone_b, 1),
+                    makeTestHost(info_, "tcp://127.0.0.1:83", simTime(), zone_b, 2),
+                    makeTestHost(info_, "tcp://127.0.0.1:84", simTime(), zone_c, 1),
+                    makeTestHost(info_, "tcp://127.0.0.1:85", simTime(), zone_c, 2)});
+  hostSet().hosts_ = hosts;
+  hostSet().healthy_hosts_ = hosts;
+  hostSet().healthy_hosts_per_locality_ =
+      makeHostsPerLocality({{hosts[0], hosts[1]}, {hosts[2], hosts[3]}, {hosts[4], hosts[5]}});
+  init(false, true);
+  const auto& edf_lb = dynamic_cast<const EdfLoadBalancerBase&>(*lb_);
+  const size_t num_schedulers = EdfLoadBalancerBasePeer::numSchedulers(edf_lb);
+
+  // Zones B and C go away.
+  const HostVector removed_hosts(hosts.begin() + 2, hosts.end());
+  hosts.resize(2);
+  hostSet().hosts_ = hosts;
+  hostSet().healthy_hosts_ = hosts;
+  hostSet().healthy_hosts_per_locality_ = makeHostsPerLocality({{hosts[0], hosts[1]}});
+  hostSet().runCallbacks({}, removed_hosts);
+  EXPECT_EQ(num_schedulers - 2, EdfLoadBalancerBasePeer::numSchedulers(edf_lb));
+
+  EXPECT_CALL(hostSet(), chooseHealthyLocality()).WillRepeatedly(Return(0));
+  for (int i = 0; i < 6; ++i) {
+    const HostConstSharedPtr host = lb_->chooseHost(nullptr).host;
+    EXPECT_TRUE(host == hosts[0] || host == hosts[1]);
+  }
+}
+
 // Validate that the RNG seed influences pick order when weighted RR.
 TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
@@ -461,6 +544,61 @@ TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
 }
 
+// With an alias table, weighted picks are random selections following the host weights. The low
+// bits of the random value choose a column of the table, and the high bits choose between the
+// column's host and its alias.
+TEST_P(RoundRobinLoadBalancerTest, WeightedWithAliasTable) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 3)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  envoy::extensions::load_balancing_policies::round_robin::v3::RoundRobin round_robin_config;
+  round_robin_config.set_use_alias_table(true);
+  lb_ = std::make_shared<RoundRobinLoadBalancer>(priority_set_, nullptr, stats_, runtime_, random_,
+                                                 50, round_robin_config, simTime());
+
+  // The first column is half the first host, and half the second one.
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(uint64_t(1) << 62));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(uint64_t(1) << 63));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  // The second column is the second host only.
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(uint64_t(1) << 31));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->peekAnotherHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+
+  // Added hosts are picked once the table is rebuilt. The last column is now mostly the new host.
+  hostSet().healthy_hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 4));
+  hostSet().hosts_.push_back(hostSet().healthy_hosts_.back());
+  hostSet().runCallbacks({hostSet().healthy_hosts_.back()}, {});
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0xFFFFFFFF));
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr).host);
+}
+
+// An update that only changes host weights rebuilds the alias table.
+TEST_P(RoundRobinLoadBalancerTest, AliasTableRebuiltOnWeightChange) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 3)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  envoy::extensions::load_balancing_policies::round_robin::v3::RoundRobin round_robin_config;
+  round_robin_config.set_use_alias_table(true);
+  lb_ = std::make_shared<RoundRobinLoadBalancer>(priority_set_, nullptr, stats_, runtime_, random_,
+                                                 50, round_robin_config, simTime());
+
+  // The second column is the second host only, whatever the high bits.
+  const uint64_t second_column_high = (uint64_t(0xC0000000) << 32) | (uint64_t(1) << 31);
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(second_column_high));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+
+  // With the weights swapped, the second column is half the second host and half the first one.
+  hostSet().healthy_hosts_[0]->weight(3);
+  hostSet().healthy_hosts_[1]->weight(1);
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
 // Validate that low weighted hosts will be chosen when the LB is created.
 TEST_P(RoundRobinLoadBalancerTest, WeightedInitializationPicksAllHosts) {
   TestScopedRuntime scoped_runtime;
@@ -14,6 +14,7 @@
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -255,6 +256,36 @@ TEST(UdpStatsdSinkTest, CheckActualStats) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, SkipsUnchangedCounters) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  writer_ptr->delegateBufferFake();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false, getDefaultPrefix(), 1024);
+
+  NiceMock<Stats::MockCounter> moved;
+  moved.name_ = "moved";
+  moved.used_ = true;
+  snapshot.counters_.push_back({2, moved});
+  NiceMock<Stats::MockCounter> idle;
+  idle.name_ = "idle";
+  idle.used_ = true;
+  snapshot.counters_.push_back({0, idle});
+
+  sink.flush(snapshot);
+  ASSERT_EQ(writer_ptr->buffer_writes.size(), 1);
+  EXPECT_EQ(writer_ptr->buffer_writes.at(0), "envoy.moved:2|c");
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.statsd_skip_unchanged_counters", "false"}});
+  sink.flush(snapshot);
+  ASSERT_EQ(writer_ptr->buffer_writes.size(), 2);
+  EXPECT_EQ(writer_ptr->buffer_writes.at(1), "envoy.moved:2|c\nenvoy.idle:0|c");
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkTest, CheckMetricLargerThanBuffer) {
   NiceMock<Stats::MockMetricSnapshot> snapshot;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
@@ -135,6 +135,8 @@ public:
   MOCK_METHOD(void, deferredDelete_, (DeferredDeletable * to_delete));
   MOCK_METHOD(void, exit, ());
   MOCK_METHOD(SignalEvent*, listenForSignal_, (signal_t signal_num, SignalCb cb));
+  MOCK_METHOD(bool, deferFlush, (DeferredFlushCallback & callback));
+  MOCK_METHOD(void, cancelDeferredFlush, (DeferredFlushCallback & callback));
   MOCK_METHOD(void, post, (PostCb callback));
   MOCK_METHOD(void, deleteInDispatcherThread, (DispatcherThreadDeletableConstPtr deletable));
   MOCK_METHOD(void, run, (RunType type));
@@ -83,6 +83,12 @@ public:
     return impl_.listenForSignal(signal_num, std::move(cb));
   }
 
+  bool deferFlush(DeferredFlushCallback& callback) override { return impl_.deferFlush(callback); }
+
+  void cancelDeferredFlush(DeferredFlushCallback& callback) override {
+    impl_.cancelDeferredFlush(callback);
+  }
+
   void post(Event::PostCb callback) override { impl_.post(std::move(callback)); }
 
   void deleteInDispatcherThread(DispatcherThreadDeletableConstPtr deletable) override {
@@ -16,21 +16,32 @@ public:
   MOCK_METHOD(IoUringResult, prepareAccept,
               (os_fd_t fd, struct sockaddr* remote_addr, socklen_t* remote_addr_len,
                Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareAcceptMultishot, (os_fd_t fd, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareConnect,
               (os_fd_t fd, const Network::Address::InstanceConstSharedPtr& address,
                Request* user_data));
   MOCK_METHOD(IoUringResult, prepareReadv,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareRecvMultishot, (os_fd_t fd, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareWritev,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareSendmsgZc,
+              (os_fd_t fd, const struct msghdr* msg, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareClose, (os_fd_t fd, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareCancel, (Request * cancelling_user_data, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareShutdown, (os_fd_t fd, int how, Request* user_data));
   MOCK_METHOD(IoUringResult, submit, ());
   MOCK_METHOD(void, injectCompletion, (os_fd_t fd, Request* user_data, int32_t result));
   MOCK_METHOD(void, removeInjectedCompletion, (os_fd_t fd));
+  MOCK_METHOD(bool, isFeatureSupported, (IoUringFeature feature), (const));
+  MOCK_METHOD(bool, setupProvidedBuffers, (uint32_t buffer_count, uint32_t buffer_size));
+  MOCK_METHOD(absl::string_view, providedBuffer, (uint32_t completion_flags, uint32_t length));
+  MOCK_METHOD(void, recycleProvidedBuffer, (uint32_t completion_flags));
+  MOCK_METHOD(bool, setupRegisteredFiles, (uint32_t size));
+  MOCK_METHOD(bool, registerFile, (os_fd_t fd));
+  MOCK_METHOD(void, unregisterFile, (os_fd_t fd));
 };
 
 class MockIoUringSocket : public IoUringSocket {
@@ -57,6 +68,7 @@ public:
   MOCK_METHOD(const OptRef<ReadParam>&, getReadParam, (), (const));
   MOCK_METHOD(const OptRef<WriteParam>&, getWriteParam, (), (const));
   MOCK_METHOD(void, setFileReadyCb, (Event::FileReadyCb cb));
+  MOCK_METHOD(os_fd_t, takeAcceptedFd, ());
 };
 
 class MockIoUringWorker : public IoUringWorker {
@@ -68,6 +80,7 @@ public:
                bool enable_close_event));
   MOCK_METHOD(IoUringSocket&, addClientSocket,
               (os_fd_t fd, Event::FileReadyCb cb, bool enable_close_event));
+  MOCK_METHOD(OptRef<IoUringSocket>, addAcceptSocket, (os_fd_t fd, Event::FileReadyCb cb));
   MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
   MOCK_METHOD(Request*, submitConnectRequest,
               (IoUringSocket & socket, const Network::Address::InstanceConstSharedPtr& address));
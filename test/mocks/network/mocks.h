@@ -181,6 +181,8 @@ public:
   ~MockUdpListenerCallbacks() override;
 
   MOCK_METHOD(void, onData, (UdpRecvData && data));
+  MOCK_METHOD(void, onDataBatch, (absl::Span<const UdpRecvPacket> packets));
+  MOCK_METHOD(bool, supportsPacketBatches, (), (const));
   MOCK_METHOD(void, onDatagramsDropped, (uint32_t dropped));
   MOCK_METHOD(void, onReadReady, ());
   MOCK_METHOD(void, onWriteReady, (const Socket& socket));
@@ -68,6 +68,19 @@ MockMetricSnapshot::MockMetricSnapshot() {
   ON_CALL(*this, counters()).WillByDefault(ReturnRef(counters_));
   ON_CALL(*this, gauges()).WillByDefault(ReturnRef(gauges_));
   ON_CALL(*this, histograms()).WillByDefault(ReturnRef(histograms_));
+  ON_CALL(*this, changedCounters())
+      .WillByDefault(Invoke([this]() -> const std::vector<CounterSnapshot>& {
+        changed_counters_.clear();
+        for (const CounterSnapshot& counter : counters_) {
+          if (counter.delta_ > 0) {
+            changed_counters_.push_back(counter);
+          }
+        }
+        return changed_counters_;
+      }));
+  ON_CALL(*this, changedGauges()).WillByDefault(ReturnRef(gauges_));
+  ON_CALL(*this, changedHistograms()).WillByDefault(ReturnRef(histograms_));
+  ON_CALL(*this, changedTextReadouts()).WillByDefault(ReturnRef(text_readouts_));
   ON_CALL(*this, hostCounters()).WillByDefault(ReturnRef(host_counters_));
   ON_CALL(*this, hostGauges()).WillByDefault(ReturnRef(host_gauges_));
   ON_CALL(*this, snapshotTime()).WillByDefault(Return(snapshot_time_));
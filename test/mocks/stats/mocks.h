@@ -166,6 +166,7 @@ public:
   MOCK_METHOD(bool, used, (), (const));
   MOCK_METHOD(bool, hidden, (), (const));
   MOCK_METHOD(uint64_t, value, (), (const));
+  MOCK_METHOD(bool, latchChanged, ());
   MOCK_METHOD(absl::optional<bool>, cachedShouldImport, (), (const));
   MOCK_METHOD(ImportMode, importMode, (), (const));
 
@@ -239,6 +240,7 @@ public:
   MOCK_METHOD(bool, used, (), (const, override));
   MOCK_METHOD(bool, hidden, (), (const));
   MOCK_METHOD(std::string, value, (), (const, override));
+  MOCK_METHOD(bool, latchChanged, (), (override));
 
   bool used_;
   bool hidden_;
@@ -254,6 +256,12 @@ public:
   MOCK_METHOD(const std::vector<std::reference_wrapper<const Gauge>>&, gauges, ());
   MOCK_METHOD(const std::vector<std::reference_wrapper<const ParentHistogram>>&, histograms, ());
   MOCK_METHOD(const std::vector<std::reference_wrapper<const TextReadout>>&, textReadouts, ());
+  MOCK_METHOD(const std::vector<CounterSnapshot>&, changedCounters, ());
+  MOCK_METHOD(const std::vector<std::reference_wrapper<const Gauge>>&, changedGauges, ());
+  MOCK_METHOD(const std::vector<std::reference_wrapper<const ParentHistogram>>&,
+              changedHistograms, ());
+  MOCK_METHOD(const std::vector<std::reference_wrapper<const TextReadout>>&, changedTextReadouts,
+              ());
   MOCK_METHOD(const std::vector<Stats::PrimitiveCounterSnapshot>&, hostCounters, ());
   MOCK_METHOD(const std::vector<Stats::PrimitiveGaugeSnapshot>&, hostGauges, ());
   MOCK_METHOD(SystemTime, snapshotTime, (), (const));
@@ -262,6 +270,9 @@ public:
   std::vector<std::reference_wrapper<const Gauge>> gauges_;
   std::vector<std::reference_wrapper<const ParentHistogram>> histograms_;
   std::vector<std::reference_wrapper<const TextReadout>> text_readouts_;
+  // By default changedCounters() returns the entries of counters_ with a non-zero delta, and the
+  // other changed*() methods return all of their stats.
+  std::vector<CounterSnapshot> changed_counters_;
   std::vector<Stats::PrimitiveCounterSnapshot> host_counters_;
   std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges_;
   SystemTime snapshot_time_;
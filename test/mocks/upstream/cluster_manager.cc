@@ -31,7 +31,12 @@ MockClusterManager::MockClusterManager()
           Invoke([](OdCdsCreationFunction, const envoy::config::core::v3::ConfigSource&,
                     OptRef<xds::core::v3::ResourceLocator>,
                     ProtobufMessage::ValidationVisitor&) { return MockOdCdsApiHandle::create(); }));
-  ON_CALL(*this, addOrUpdateCluster(_, _, _)).WillByDefault(Return(false));
+  ON_CALL(*this, addOrUpdateCluster(_, _, _, _)).WillByDefault(Return(false));
+  ON_CALL(*this, addOrUpdateCdsCluster(_, _, _))
+      .WillByDefault(Invoke([this](const envoy::config::cluster::v3::Cluster& cluster,
+                                   const std::string& version_info, uint64_t cluster_hash) {
+        return addOrUpdateCluster(cluster, version_info, false, cluster_hash);
+      }));
 }
 
 MockClusterManager::~MockClusterManager() = default;
@@ -39,7 +39,10 @@ public:
   MOCK_METHOD(bool, initialized, ());
   MOCK_METHOD(absl::StatusOr<bool>, addOrUpdateCluster,
               (const envoy::config::cluster::v3::Cluster& cluster, const std::string& version_info,
-               const bool avoid_cds_removal));
+               const bool avoid_cds_removal, absl::optional<uint64_t> cluster_hash));
+  MOCK_METHOD(absl::StatusOr<bool>, addOrUpdateCdsCluster,
+              (const envoy::config::cluster::v3::Cluster& cluster, const std::string& version_info,
+               uint64_t cluster_hash));
   MOCK_METHOD(void, setPrimaryClustersInitializedCb, (PrimaryClustersReadyCallback));
   MOCK_METHOD(void, setInitializedCb, (InitializationCompleteCallback));
   MOCK_METHOD(absl::Status, initializeSecondaryClusters,
@@ -194,11 +194,10 @@ public:
    */
   uint64_t handlerStats(const StatsParams& params) {
     Buffer::OwnedImpl data;
-    if (params.format_ == StatsFormat::Prometheus) {
-      StatsHandler::prometheusRender(*store_, custom_namespaces_, cm_, params, data);
-      return data.length();
-    }
-    Admin::RequestPtr request = StatsHandler::makeRequest(*store_, params, cm_);
+    Admin::RequestPtr request =
+        params.format_ == StatsFormat::Prometheus
+            ? StatsHandler::makePrometheusRequest(*store_, params, cm_, custom_namespaces_)
+            : StatsHandler::makeRequest(*store_, params, cm_);
     auto response_headers = Http::ResponseHeaderMapImpl::create();
     request->start(*response_headers);
     uint64_t count = 0;
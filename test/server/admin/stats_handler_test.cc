@@ -4,6 +4,7 @@
 #include "source/common/common/regex.h"
 #include "source/common/stats/custom_stat_namespaces_impl.h"
 #include "source/common/stats/thread_local_store.h"
+#include "source/server/admin/prometheus_stats.h"
 #include "source/server/admin/stats_handler.h"
 #include "source/server/admin/stats_request.h"
 
@@ -1406,6 +1407,48 @@ envoy_cluster_upstream_cx_active{cluster="c2"} 12
   EXPECT_EQ(expected_response, code_response.second);
 }
 
+TEST_F(StatsHandlerPrometheusDefaultTest, StreamsInChunks) {
+  for (uint32_t i = 0; i < 10; ++i) {
+    Stats::StatNameTagVector tags{{makeStat("cluster"), makeStat(absl::StrCat("c", i))}};
+    for (uint32_t j = 0; j < 10; ++j) {
+      store_->rootScope()
+          ->counterFromStatNameWithTags(makeStat(absl::StrCat("cluster.counter_", j)), tags)
+          .add(i * j);
+      store_->rootScope()
+          ->gaugeFromStatNameWithTags(makeStat(absl::StrCat("cluster.gauge_", j)), tags,
+                                      Stats::Gauge::ImportMode::Accumulate)
+          .set(i + j);
+    }
+  }
+  StatsParams params;
+  Buffer::OwnedImpl parse_response;
+  ASSERT_EQ(Http::Code::OK, params.parse("/stats/prometheus", parse_response));
+  Buffer::OwnedImpl expected;
+  StatsHandler::prometheusRender(*store_, custom_namespaces_, endpoints_helper_.cm_, params,
+                                 expected);
+
+  PrometheusStatsRequest request(*store_, params, endpoints_helper_.cm_, custom_namespaces_);
+  request.setChunkSize(100);
+  Http::TestResponseHeaderMapImpl response_headers;
+  EXPECT_EQ(Http::Code::OK, request.start(response_headers));
+  std::string output;
+  uint32_t num_chunks = 0;
+  bool more = true;
+  while (more) {
+    Buffer::OwnedImpl chunk;
+    more = request.nextChunk(chunk);
+    // A chunk ends after the family that reaches the chunk size, and each
+    // family here is well under 1000 bytes.
+    EXPECT_GT(1000, chunk.length());
+    output += chunk.toString();
+    ++num_chunks;
+  }
+  EXPECT_EQ(expected.toString(), output);
+  // There are 20 families, each longer than the chunk size, and the last
+  // chunk finds that there is nothing left.
+  EXPECT_EQ(21, num_chunks);
+}
+
 TEST_F(StatsHandlerPrometheusDefaultTest, StatsHandlerPrometheusInvalidRegex) {
   const std::string url = "/stats?format=prometheus&filter=(+invalid)";
 
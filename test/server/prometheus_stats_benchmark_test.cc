@@ -0,0 +1,124 @@
+// Measures rendering the stats in the Prometheus exposition format, fully buffered as
+// PrometheusStatsFormatter::statsAsPrometheus() does, and streamed in chunks as the admin
+// endpoints do with PrometheusStatsRequest.
+
+#include <cstdint>
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stats/custom_stat_namespaces_impl.h"
+#include "source/common/stats/thread_local_store.h"
+#include "source/server/admin/prometheus_stats.h"
+#include "source/server/admin/stats_handler.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/upstream/cluster_manager.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+namespace Envoy {
+
+// Override the one method used by this test so that using a mock doesn't affect performance.
+class FastMockClusterManager : public testing::StrictMock<Upstream::MockClusterManager> {
+public:
+  ClusterInfoMaps clusters() const override { return ClusterInfoMaps{}; }
+};
+
+class PrometheusStatsSpeedTest {
+public:
+  // Creates num_stats counters, as many gauges and a tenth as many histograms, spread over
+  // families of 100 clusters each, as with cluster stats.
+  explicit PrometheusStatsSpeedTest(uint64_t num_stats)
+      : pool_(symbol_table_), stats_allocator_(symbol_table_), stats_store_(stats_allocator_) {
+    const Stats::StatName cluster_tag = pool_.add("envoy.cluster_name");
+    for (uint64_t idx = 0; idx < num_stats; ++idx) {
+      const Stats::StatNameTagVector tags{{cluster_tag, pool_.add(absl::StrCat("c", idx % 100))}};
+      const std::string family = absl::StrCat("cluster.stat_", idx / 100);
+      Stats::Scope& scope = *stats_store_.rootScope();
+      scope.counterFromStatNameWithTags(pool_.add(family + "_total"), tags).add(idx);
+      scope
+          .gaugeFromStatNameWithTags(pool_.add(family + "_active"), tags,
+                                     Stats::Gauge::ImportMode::Accumulate)
+          .set(idx);
+      if (idx % 10 == 0) {
+        scope.histogramFromStatNameWithTags(pool_.add(family + "_ms"), tags,
+                                            Stats::Histogram::Unit::Milliseconds);
+      }
+    }
+  }
+
+  void buffered(::benchmark::State& state) {
+    uint64_t peak_buffered = 0;
+    for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+      Buffer::OwnedImpl response;
+      Server::StatsHandler::prometheusRender(stats_store_, custom_namespaces_, cm_, params_,
+                                             response);
+      peak_buffered = std::max<uint64_t>(peak_buffered, response.length());
+    }
+    state.counters["peak_buffered_bytes"] = peak_buffered;
+  }
+
+  void streamed(::benchmark::State& state) {
+    uint64_t peak_buffered = 0;
+    for (auto _ : state) { // NOLINT(clang-analyzer-deadcode.DeadStores)
+      Server::PrometheusStatsRequest request(stats_store_, params_, cm_, custom_namespaces_);
+      auto response_headers = Http::ResponseHeaderMapImpl::create();
+      request.start(*response_headers);
+      Buffer::OwnedImpl response;
+      bool more = true;
+      while (more) {
+        more = request.nextChunk(response);
+        peak_buffered = std::max<uint64_t>(peak_buffered, response.length());
+        response.drain(response.length());
+      }
+    }
+    state.counters["peak_buffered_bytes"] = peak_buffered;
+  }
+
+private:
+  Stats::SymbolTableImpl symbol_table_;
+  Stats::StatNamePool pool_;
+  Stats::AllocatorImpl stats_allocator_;
+  Stats::ThreadLocalStoreImpl stats_store_;
+  Stats::CustomStatNamespacesImpl custom_namespaces_;
+  FastMockClusterManager cm_;
+  Server::StatsParams params_;
+};
+
+// Benchmark args: number of counters and gauges.
+static void bmPrometheusBuffered(::benchmark::State& state) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  PrometheusStatsSpeedTest speed_test(state.range(0));
+  speed_test.buffered(state);
+}
+
+// Benchmark args: number of counters and gauges.
+static void bmPrometheusStreamed(::benchmark::State& state) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  PrometheusStatsSpeedTest speed_test(state.range(0));
+  speed_test.streamed(state);
+}
+
+BENCHMARK(bmPrometheusBuffered)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
+BENCHMARK(bmPrometheusStreamed)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
+
+} // namespace Envoy
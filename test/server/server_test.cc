@@ -115,6 +115,57 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, mock_store, cm, time_system);
 }
 
+TEST(ServerInstanceUtil, flushChangedStats) {
+  InSequence s;
+
+  NiceMock<Upstream::MockClusterManager> cm;
+  Stats::TestUtil::TestStore store;
+  Event::SimulatedTimeSystem time_system;
+  Stats::Counter& active = store.counter("active");
+  Stats::Counter& idle = store.counter("idle");
+  Stats::Gauge& moving = store.gauge("moving", Stats::Gauge::ImportMode::Accumulate);
+  Stats::Gauge& steady = store.gauge("steady", Stats::Gauge::ImportMode::Accumulate);
+  Stats::TextReadout& text = store.textReadout("text");
+  active.inc();
+  idle.inc();
+  moving.set(5);
+  steady.set(1);
+  text.set("is important");
+
+  std::list<Stats::SinkPtr> sinks;
+  InstanceUtil::flushMetricsToSinks(sinks, store, cm, time_system);
+
+  Stats::MockSink* sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(sink);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_EQ(snapshot.counters().size(), 2);
+    ASSERT_EQ(snapshot.changedCounters().size(), 1);
+    EXPECT_EQ(snapshot.changedCounters()[0].counter_.get().name(), "active");
+    EXPECT_EQ(snapshot.changedCounters()[0].delta_, 2);
+
+    EXPECT_EQ(snapshot.gauges().size(), 2);
+    ASSERT_EQ(snapshot.changedGauges().size(), 1);
+    EXPECT_EQ(snapshot.changedGauges()[0].get().name(), "moving");
+    EXPECT_EQ(snapshot.changedGauges()[0].get().value(), 4);
+
+    EXPECT_EQ(snapshot.textReadouts().size(), 1);
+    EXPECT_TRUE(snapshot.changedTextReadouts().empty());
+  }));
+  active.add(2);
+  moving.dec();
+  InstanceUtil::flushMetricsToSinks(sinks, store, cm, time_system);
+
+  // Nothing moved since the previous flush.
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_EQ(snapshot.counters().size(), 2);
+    EXPECT_TRUE(snapshot.changedCounters().empty());
+    EXPECT_EQ(snapshot.gauges().size(), 2);
+    EXPECT_TRUE(snapshot.changedGauges().empty());
+    EXPECT_TRUE(snapshot.changedTextReadouts().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, cm, time_system);
+}
+
 TEST(ServerInstanceUtil, flushImportModeUninitializedGauges) {
   InSequence s;
 